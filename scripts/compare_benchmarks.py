@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON runs and flag regressions.
+
+    ./benchmarks --benchmark_out=before.json --benchmark_out_format=json
+    ... change the code, rebuild ...
+    ./benchmarks --benchmark_out=after.json --benchmark_out_format=json
+    scripts/compare_benchmarks.py before.json after.json --threshold 5
+
+Benchmarks are matched by name. With --benchmark_repetitions the mean
+aggregate is compared, otherwise the single run. A benchmark regresses when
+its time grows by more than --threshold percent. The exit status is 1 if any
+benchmark regressed, so the script can gate a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    """Returns {name: time in ns} and the context of one JSON report."""
+    with open(path) as f:
+        report = json.load(f)
+    iterations, means = {}, {}
+    for b in report.get("benchmarks", []):
+        if b.get("error_occurred"):
+            continue
+        aggregate = b.get("run_type") == "aggregate"
+        # Median, stddev, cv and the BigO/RMS rows of complexity
+        # benchmarks are skipped; the last two have no time at all.
+        if (aggregate and b.get("aggregate_name") != "mean") or metric not in b:
+            continue
+        time = b[metric] * TO_NS[b.get("time_unit", "ns")]
+        if aggregate:
+            means[b["run_name"]] = time
+        else:
+            # Repetitions without aggregates: keep the first run.
+            iterations.setdefault(b.get("run_name", b["name"]), time)
+    iterations.update(means)
+    return iterations, report.get("context", {})
+
+
+def format_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g} {unit}"
+    return f"{ns:.3g} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="JSON report of the old build")
+    parser.add_argument("contender", help="JSON report of the new build")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="regression threshold in percent (default: 5)")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"),
+                        default="real_time", help="time to compare")
+    parser.add_argument("--all", action="store_true",
+                        help="list every benchmark, not only the changed ones")
+    args = parser.parse_args()
+
+    old, old_context = load(args.baseline, args.metric)
+    new, new_context = load(args.contender, args.metric)
+
+    for key in ("compiler", "host_name", "num_cpus"):
+        if old_context.get(key) != new_context.get(key):
+            print(f"note: {key} differs: {old_context.get(key)!r} vs "
+                  f"{new_context.get(key)!r}")
+
+    regressions = 0
+    width = max((len(name) for name in old), default=10)
+    print(f"{'benchmark':<{width}}  {'baseline':>10}  {'contender':>10}  change")
+    for name, before in old.items():
+        if name not in new:
+            print(f"{name:<{width}}  {format_time(before):>10}  {'missing':>10}")
+            continue
+        after = new[name]
+        change = (after - before) / before * 100 if before > 0 else 0.0
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "  improvement"
+        elif not args.all:
+            continue
+        else:
+            flag = ""
+        print(f"{name:<{width}}  {format_time(before):>10}  "
+              f"{format_time(after):>10}  {change:+6.1f}%{flag}")
+    for name in new.keys() - old.keys():
+        print(f"{name:<{width}}  {'new':>10}  {format_time(new[name]):>10}")
+
+    print(f"\n{regressions} regression(s) above {args.threshold}% "
+          f"out of {len(old.keys() & new.keys())} compared benchmarks")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Generate src/strings/number_tables.hpp, the power tables of numbers.hpp.
+
+    scripts/generate_number_tables.py > src/strings/number_tables.hpp
+
+Both tables hold 128-bit approximations of powers of ten, computed here with
+exact integers:
+
+- powers_of_five: for the Eisel-Lemire parser, the most significant 128 bits
+  of 5^q for q in [-342, 308], as in fast_float. For q >= 0 the bits are
+  truncated; for q < 0 they are those of 2^b / 5^-q, rounded up.
+- powers_of_ten: for the Schubfach formatter, g = floor(10^-k / 2^r) + 1
+  for k in [-324, 292], with 2^125 <= 10^-k / 2^r < 2^126, split into its
+  high and low 63 bits as in Giulietti's paper.
+"""
+
+from fractions import Fraction
+
+FIVE_MIN, FIVE_MAX = -342, 308
+TEN_MIN, TEN_MAX = -324, 292
+MASK_64 = (1 << 64) - 1
+MASK_63 = (1 << 63) - 1
+
+
+def power_of_five(q):
+    """The 128 most significant bits of 5^q, as fast_float's table."""
+    if q >= 0:
+        p = 5**q
+        while p < (1 << 127):
+            p *= 2
+        while p >= (1 << 128):
+            p //= 2
+        return p
+    p = 5**-q
+    z = p.bit_length()
+    b = z + 127 if q >= -27 else 2 * z + 2 * 64
+    c = 2**b // p + 1
+    while c >= (1 << 128):
+        c //= 2
+    return c
+
+
+def floor_log2(v):
+    """floor(log2(v)) of a positive Fraction."""
+    e = v.numerator.bit_length() - v.denominator.bit_length()
+    if Fraction(2) ** e > v:
+        e -= 1
+    elif Fraction(2) ** (e + 1) <= v:
+        e += 1
+    return e
+
+
+def power_of_ten(k):
+    """Schubfach's 126-bit g for 10^-k."""
+    v = Fraction(10) ** -k
+    r = floor_log2(v) - 125
+    g = int(v / Fraction(2) ** r) + 1
+    assert (1 << 125) < g <= (1 << 126)
+    return g
+
+
+def main():
+    print("#ifndef NUMBER_TABLES_HPP")
+    print("#define NUMBER_TABLES_HPP")
+    print()
+    print("// Generated by scripts/generate_number_tables.py; do not edit.")
+    print()
+    print("#include <cstdint>")
+    print()
+    print("namespace strings::detail {")
+    print()
+    print(f"constexpr int smallest_power_of_five = {FIVE_MIN};")
+    print(f"constexpr int largest_power_of_five = {FIVE_MAX};")
+    print()
+    print("// {high, low} 64 bits of 5^q, q from smallest_power_of_five.")
+    print(f"constexpr std::uint64_t powers_of_five[][2] = {{")
+    for q in range(FIVE_MIN, FIVE_MAX + 1):
+        p = power_of_five(q)
+        print(f"    {{0x{p >> 64:016x}, 0x{p & MASK_64:016x}}},")
+    print("};")
+    print()
+    print(f"constexpr int smallest_power_of_ten = {TEN_MIN};")
+    print(f"constexpr int largest_power_of_ten = {TEN_MAX};")
+    print()
+    print("// {g1, g0}: the high and low 63 bits of g(k), k from smallest_power_of_ten.")
+    print(f"constexpr std::uint64_t powers_of_ten[][2] = {{")
+    for k in range(TEN_MIN, TEN_MAX + 1):
+        g = power_of_ten(k)
+        print(f"    {{0x{g >> 63:016x}, 0x{g & MASK_63:016x}}},")
+    print("};")
+    print()
+    print("} // namespace strings::detail")
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
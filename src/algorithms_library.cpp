@@ -501,6 +501,8 @@ bool cmp_sort_algorithm(int x, int y) { return x < y; }
 
 void sort() {
   // only works on vector,deque,container array, native array
+  // for large arrays see sorting/sorting.hpp: pdqsort, radix sort and a
+  // parallel sample sort
 
   std::random_device rd;
   std::mt19937 g(rd());
@@ -687,6 +689,7 @@ void heap() {
 
 void binary_search() {
   // your data shoudl be always sorted
+  // for large arrays see searching/searching.hpp (Eytzinger and B+ tree layouts)
   std::vector<int> vec1 = {3, 6, 7, 9, 12, 5, -1};
   std::sort(vec1.begin(), vec1.end());
   int number_to_search_for = 7;
@@ -710,6 +713,7 @@ void includes() {
 
 void priority_queue() {
   // use heap for finding max/min value,
+  // containers/heap.hpp has faster 4-ary, indexed and radix heaps
   std::priority_queue<int> q;
 
   for (int n : {1, 8, 5, 6, 3, 4, 0, 9, 7, 2})
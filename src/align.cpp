@@ -88,7 +88,7 @@ void perfomanceBenchmarking() {
   int **myarray;
   myarray = new int *[m];
   for (int j = 0; j < m; j++)
-    myarray[j] = new int[j];
+    myarray[j] = new int[n](); // n columns, zero-initialized
 
   // row major traverse
   for (int i = 0; i < m; i++)
@@ -96,11 +96,17 @@ void perfomanceBenchmarking() {
       myarray[i][j] = myarray[i][j] + 1;
 
   // col major traverse
-  for (int i = 0; i < m; i++)
-    for (int j = 0; j < n; j++)
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < m; j++)
       myarray[j][i] = myarray[j][i] + 1;
 
-  constexpr size_t size = 2 << 26;
+  for (int j = 0; j < m; j++)
+    delete[] myarray[j];
+  delete[] myarray;
+
+  // 64 MiB, far larger than any cache. cache_benchmark.cpp measures these
+  // loops for every step, matrix size and working-set size.
+  constexpr size_t size = 1 << 24;
 
   /*
   If we draw perfomace for this code, for step=1..cache_line it is almost fixed
@@ -110,7 +116,7 @@ void perfomanceBenchmarking() {
   */
   int step = 1; // 2,3,...2048
 
-  int *array = new int[size];
+  int *array = new int[size](); // zero-initialized, as array[i]++ reads it
   for (int i = 0; i < int(size); i += step)
     array[i]++;
   std::cout << "size: " << size << std::endl;
@@ -155,7 +161,7 @@ int main(int argc, char *argv[]) {
   printf("offsetof(struct Foo3, i1) = %zu\n", offsetof(struct Foo3, i1));
   printf("offsetof(struct Foo3, i2) = %zu\n", offsetof(struct Foo3, i2));
 
-  // perfomanceBenchmarking();
+  perfomanceBenchmarking();
 
   unsigned char memory_data;
   for (std::size_t i = 0; i < sizeof(Foo3); i++) {
@@ -0,0 +1,622 @@
+#include "alloc_profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define ALLOC_PROFILER_BACKTRACE 1
+#endif
+
+#if __has_include(<dlfcn.h>) && __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#define ALLOC_PROFILER_SYMBOLS 1
+#endif
+
+#if defined(__GNUC__)
+#define ALLOC_PROFILER_NOINLINE __attribute__((noinline))
+// Where operator new returns to; captured stacks are cut there, so they start
+// at the code that allocated and not inside the profiler.
+#define ALLOC_PROFILER_CALLER() __builtin_return_address(0)
+#else
+#define ALLOC_PROFILER_NOINLINE
+#define ALLOC_PROFILER_CALLER() nullptr
+#endif
+
+namespace alloc_profiler {
+
+namespace {
+
+constexpr std::int64_t live_flush_bytes = 64 * 1024;
+constexpr int max_frames = 16;
+// Room for the profiler's own frames, which are cut off again.
+constexpr int own_frames = 8;
+constexpr std::size_t site_table_size = 4096;
+
+struct counters {
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> deallocations{0};
+  std::atomic<std::uint64_t> bytes_allocated{0};
+  std::atomic<std::uint64_t> bytes_freed{0};
+  std::array<std::atomic<std::uint64_t>, size_class_count> class_allocations{};
+  std::array<std::atomic<std::uint64_t>, size_class_count> class_bytes{};
+};
+
+// Written only by the thread that owns it, read by takeSnapshot(). Blocks are
+// never freed: when a thread exits its counts are folded into `retired` and
+// the block is handed to the next new thread.
+struct thread_stats {
+  counters counts;
+  std::int64_t unflushed_live = 0;
+  std::int64_t until_sample = 0;
+  std::uint64_t rng = 0;
+  thread_stats *next = nullptr;
+  bool in_use = false;
+};
+
+struct site_entry {
+  std::uint64_t hash;
+  int depth;
+  void *frames[max_frames];
+  std::uint64_t samples;
+  double estimated_allocations;
+  double estimated_bytes;
+};
+
+// Everything below is constant-initialized, so it works for allocations made
+// before main() and after static destructors have run.
+std::mutex registry_mutex;
+thread_stats *registry = nullptr;
+counters retired; // exited threads, plus allocations made while a thread exits
+std::atomic<std::int64_t> live_bytes{0};
+std::atomic<std::int64_t> peak_live_bytes{0};
+std::atomic<std::size_t> sample_interval{2 * 1024 * 1024};
+
+std::mutex sites_mutex;
+site_entry sites[site_table_size];
+std::uint64_t dropped_samples = 0;
+
+thread_local thread_stats *tl_stats = nullptr;
+thread_local bool tl_exited = false;
+thread_local bool tl_busy = false; // inside the profiler; don't recurse
+
+std::size_t sizeClass(std::size_t size) {
+  if (size <= 16) {
+    return 0;
+  }
+  const auto index = static_cast<std::size_t>(std::bit_width(size - 1)) - 4;
+  return std::min(index, size_class_count - 1);
+}
+
+// Owner-only update: a relaxed load and store instead of a locked fetch_add.
+void bump(std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+void foldInto(counters &to, counters &from) {
+  auto move = [](std::atomic<std::uint64_t> &t, std::atomic<std::uint64_t> &f) {
+    t.fetch_add(f.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+  };
+  move(to.allocations, from.allocations);
+  move(to.deallocations, from.deallocations);
+  move(to.bytes_allocated, from.bytes_allocated);
+  move(to.bytes_freed, from.bytes_freed);
+  for (std::size_t i = 0; i < size_class_count; ++i) {
+    move(to.class_allocations[i], from.class_allocations[i]);
+    move(to.class_bytes[i], from.class_bytes[i]);
+  }
+}
+
+void flushLive(std::int64_t delta) {
+  const std::int64_t now =
+      live_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+  std::int64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+  while (now > peak && !peak_live_bytes.compare_exchange_weak(
+                           peak, now, std::memory_order_relaxed)) {
+  }
+}
+
+// Exponentially distributed distance to the next sample, so that allocation
+// patterns with a fixed period can't hide from (or dominate) the samples.
+std::int64_t nextSampleDistance(thread_stats &s) {
+  const std::size_t interval = sample_interval.load(std::memory_order_relaxed);
+  if (interval == 0) {
+    return 64 * 1024 * 1024; // look again later whether sampling got enabled
+  }
+  s.rng ^= s.rng << 13;
+  s.rng ^= s.rng >> 7;
+  s.rng ^= s.rng << 17;
+  const double u = (static_cast<double>(s.rng >> 11) + 1.0) * 0x1.0p-53;
+  return static_cast<std::int64_t>(-std::log(u) * static_cast<double>(interval)) + 1;
+}
+
+void releaseStats();
+
+struct thread_exit {
+  ~thread_exit() { releaseStats(); }
+};
+thread_local thread_exit tl_exit;
+
+thread_stats *acquireStats() {
+  tl_busy = true;
+  thread_stats *s = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (thread_stats *t = registry; t; t = t->next) {
+      if (!t->in_use) {
+        s = t;
+        break;
+      }
+    }
+    if (!s) {
+      // malloc, not new: this runs inside operator new.
+      s = new (std::malloc(sizeof(thread_stats))) thread_stats;
+      s->next = registry;
+      registry = s;
+    }
+    s->in_use = true;
+  }
+  s->rng = reinterpret_cast<std::uintptr_t>(&tl_stats) | 1;
+  s->until_sample = nextSampleDistance(*s);
+  (void)&tl_exit; // registers the destructor for this thread
+  tl_busy = false;
+  return s;
+}
+
+void releaseStats() {
+  thread_stats *s = tl_stats;
+  tl_stats = nullptr;
+  tl_exited = true;
+  if (!s) {
+    return;
+  }
+  flushLive(std::exchange(s->unflushed_live, 0));
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  foldInto(retired, s->counts);
+  s->in_use = false;
+}
+
+ALLOC_PROFILER_NOINLINE thread_stats *firstUse() {
+  if (tl_exited || tl_busy) {
+    return nullptr;
+  }
+  return tl_stats = acquireStats();
+}
+
+inline thread_stats *localStats() {
+  thread_stats *s = tl_stats;
+  return s ? s : firstUse();
+}
+
+ALLOC_PROFILER_NOINLINE void recordSample(thread_stats &s, std::size_t size,
+                                          void *caller) {
+  s.until_sample = nextSampleDistance(s);
+  const std::size_t interval = sample_interval.load(std::memory_order_relaxed);
+  if (interval == 0 || tl_busy) {
+    return;
+  }
+#if defined(ALLOC_PROFILER_BACKTRACE)
+  tl_busy = true;
+  void *captured[max_frames + own_frames];
+  const int n = backtrace(captured, max_frames + own_frames);
+  void **frames = std::find(captured, captured + n, caller);
+  if (frames == captured + n) {
+    frames = captured; // no caller address on this compiler: keep everything
+  }
+  const int depth = std::min<int>(max_frames, static_cast<int>(captured + n - frames));
+
+  std::uint64_t hash = 14695981039346656037ull; // FNV-1a over the addresses
+  for (int i = 0; i < depth; ++i) {
+    hash = (hash ^ reinterpret_cast<std::uintptr_t>(frames[i])) * 1099511628211ull;
+  }
+  hash |= 1; // 0 marks a free slot
+
+  // An allocation of `size` bytes is sampled with probability
+  // 1 - exp(-size / interval); dividing by it gives unbiased estimates.
+  const double p = 1.0 - std::exp(-static_cast<double>(size) /
+                                  static_cast<double>(interval));
+  {
+    std::lock_guard<std::mutex> lock(sites_mutex);
+    std::size_t slot = hash % site_table_size;
+    for (std::size_t probe = 0; probe < site_table_size;
+         ++probe, slot = (slot + 1) % site_table_size) {
+      site_entry &e = sites[slot];
+      if (e.hash == 0) {
+        e.hash = hash;
+        e.depth = depth;
+        std::copy_n(frames, depth, e.frames);
+      } else if (e.hash != hash) {
+        continue;
+      }
+      ++e.samples;
+      e.estimated_allocations += 1.0 / p;
+      e.estimated_bytes += static_cast<double>(size) / p;
+      break;
+    }
+    if (sites[slot].hash != hash) {
+      ++dropped_samples;
+    }
+  }
+  tl_busy = false;
+#endif
+}
+
+void onAllocate(std::size_t requested, std::size_t block, void *caller) {
+  const std::size_t cls = sizeClass(requested);
+  thread_stats *s = localStats();
+  if (!s) {
+    retired.allocations.fetch_add(1, std::memory_order_relaxed);
+    retired.bytes_allocated.fetch_add(block, std::memory_order_relaxed);
+    retired.class_allocations[cls].fetch_add(1, std::memory_order_relaxed);
+    retired.class_bytes[cls].fetch_add(requested, std::memory_order_relaxed);
+    flushLive(static_cast<std::int64_t>(block));
+    return;
+  }
+  bump(s->counts.allocations, 1);
+  bump(s->counts.bytes_allocated, block);
+  bump(s->counts.class_allocations[cls], 1);
+  bump(s->counts.class_bytes[cls], requested);
+  if ((s->unflushed_live += static_cast<std::int64_t>(block)) >= live_flush_bytes) {
+    flushLive(std::exchange(s->unflushed_live, 0));
+  }
+  if ((s->until_sample -= static_cast<std::int64_t>(requested)) < 0) {
+    recordSample(*s, requested, caller);
+  }
+}
+
+void onDeallocate(std::size_t block) {
+  thread_stats *s = localStats();
+  if (!s) {
+    retired.deallocations.fetch_add(1, std::memory_order_relaxed);
+    retired.bytes_freed.fetch_add(block, std::memory_order_relaxed);
+    flushLive(-static_cast<std::int64_t>(block));
+    return;
+  }
+  bump(s->counts.deallocations, 1);
+  bump(s->counts.bytes_freed, block);
+  if ((s->unflushed_live -= static_cast<std::int64_t>(block)) <= -live_flush_bytes) {
+    flushLive(std::exchange(s->unflushed_live, 0));
+  }
+}
+
+// Every block starts with a header holding the requested size and the
+// pointer malloc returned. Reading the size back is one load from a cache
+// line the caller has just used, where malloc_usable_size() costs a call and
+// a walk of malloc's own chunk header, on every allocation and every free.
+// The byte counters therefore report requested sizes, not what malloc
+// rounded them up to.
+struct alignas(std::max_align_t) block_header {
+  void *raw;
+  std::size_t size;
+};
+
+void *rawAllocate(std::size_t size, std::size_t alignment) {
+  if (alignment <= alignof(std::max_align_t)) {
+    // malloc's alignment, which the end of the header keeps.
+    void *raw = std::malloc(size + sizeof(block_header));
+    if (!raw) {
+      return nullptr;
+    }
+    auto *header = static_cast<block_header *>(raw);
+    header->raw = raw;
+    header->size = size;
+    return header + 1;
+  }
+  void *raw = std::malloc(size + sizeof(block_header) + alignment);
+  if (!raw) {
+    return nullptr;
+  }
+  const auto user = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(block_header) +
+                     alignment - 1) / alignment * alignment;
+  auto *header = reinterpret_cast<block_header *>(user) - 1;
+  header->raw = raw;
+  header->size = size;
+  return reinterpret_cast<void *>(user);
+}
+
+std::size_t blockSize(void *p) { return (static_cast<block_header *>(p) - 1)->size; }
+
+void rawFree(void *p) { std::free((static_cast<block_header *>(p) - 1)->raw); }
+
+void *allocate(std::size_t size, std::size_t alignment, bool nothrow,
+               void *caller) {
+  size = std::max<std::size_t>(size, 1);
+  void *p;
+  while (!(p = rawAllocate(size, alignment))) {
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) {
+      if (nothrow) {
+        return nullptr;
+      }
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+  onAllocate(size, blockSize(p), caller);
+  return p;
+}
+
+void deallocate(void *p) {
+  if (p) {
+    onDeallocate(blockSize(p));
+    rawFree(p);
+  }
+}
+
+std::string symbolize(void *address) {
+#if defined(ALLOC_PROFILER_SYMBOLS)
+  Dl_info info;
+  if (dladdr(address, &info) && info.dli_sname) {
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : info.dli_sname;
+    std::free(demangled);
+    return name + " +" +
+           std::to_string(static_cast<char *>(address) -
+                          static_cast<char *>(info.dli_saddr));
+  }
+#endif
+  char buffer[2 + 2 * sizeof(void *) + 1];
+  std::snprintf(buffer, sizeof(buffer), "%p", address);
+  return buffer;
+}
+
+void writeReport(const std::string &path) {
+  if (path.empty()) {
+    report(std::cerr, takeSnapshot());
+  } else {
+    std::ofstream out(path, std::ios::app);
+    report(out, takeSnapshot());
+  }
+}
+
+std::string at_exit_path;
+
+struct periodic_reporter {
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stop = false;
+  std::thread thread;
+
+  ~periodic_reporter() { join(); }
+
+  void join() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+};
+
+periodic_reporter &reporter() {
+  static periodic_reporter r;
+  return r;
+}
+
+} // namespace
+
+snapshot takeSnapshot() {
+  const bool was_busy = std::exchange(tl_busy, true);
+  snapshot s;
+  auto add = [&s](const counters &c) {
+    s.allocations += c.allocations.load(std::memory_order_relaxed);
+    s.deallocations += c.deallocations.load(std::memory_order_relaxed);
+    s.bytes_allocated += c.bytes_allocated.load(std::memory_order_relaxed);
+    s.bytes_freed += c.bytes_freed.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < size_class_count; ++i) {
+      s.histogram[i].allocations +=
+          c.class_allocations[i].load(std::memory_order_relaxed);
+      s.histogram[i].bytes += c.class_bytes[i].load(std::memory_order_relaxed);
+    }
+  };
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    add(retired);
+    for (thread_stats *t = registry; t; t = t->next) {
+      add(t->counts);
+    }
+  }
+  for (std::size_t i = 0; i < size_class_count; ++i) {
+    s.histogram[i].upper_bound = sizeClassUpperBound(i);
+  }
+  // The sums are exact (up to allocations still in flight); the peak is only
+  // updated every live_flush_bytes per thread, so it can lag behind them.
+  s.live_bytes = static_cast<std::int64_t>(s.bytes_allocated - s.bytes_freed);
+  s.peak_live_bytes =
+      std::max(s.live_bytes, peak_live_bytes.load(std::memory_order_relaxed));
+  {
+    std::lock_guard<std::mutex> lock(sites_mutex);
+    s.dropped_samples = dropped_samples;
+    for (const site_entry &e : sites) {
+      if (e.hash != 0) {
+        s.call_sites.push_back({uncounted_vector<void *>(e.frames, e.frames + e.depth),
+                                e.samples,
+                                static_cast<std::uint64_t>(e.estimated_allocations),
+                                static_cast<std::uint64_t>(e.estimated_bytes)});
+      }
+    }
+  }
+  std::sort(s.call_sites.begin(), s.call_sites.end(),
+            [](const call_site &a, const call_site &b) {
+              return a.estimated_bytes > b.estimated_bytes;
+            });
+  tl_busy = was_busy;
+  return s;
+}
+
+void report(std::ostream &out, const snapshot &s, std::size_t max_call_sites) {
+  out << "allocation profile\n"
+      << "  allocations: " << s.allocations << ", deallocations: " << s.deallocations
+      << "\n  allocated: " << s.bytes_allocated << " bytes, freed: " << s.bytes_freed
+      << " bytes\n  live: " << s.live_bytes << " bytes, peak: " << s.peak_live_bytes
+      << " bytes\n"
+      << "size classes (requested bytes):\n";
+  for (const size_class_stats &c : s.histogram) {
+    if (c.allocations == 0) {
+      continue;
+    }
+    out << "  <= ";
+    if (c.upper_bound == SIZE_MAX) {
+      out << std::setw(8) << "inf";
+    } else {
+      out << std::setw(8) << c.upper_bound;
+    }
+    out << ": " << std::setw(10) << c.allocations << " allocations, "
+        << c.bytes << " bytes\n";
+  }
+  if (s.call_sites.empty()) {
+    return;
+  }
+  out << "call sites (sampled every " << sample_interval.load() << " bytes";
+  if (s.dropped_samples > 0) {
+    out << ", " << s.dropped_samples << " samples dropped";
+  }
+  out << "):\n";
+  for (std::size_t i = 0; i < std::min(max_call_sites, s.call_sites.size()); ++i) {
+    const call_site &site = s.call_sites[i];
+    out << "  #" << i + 1 << " ~" << site.estimated_allocations
+        << " allocations, ~" << site.estimated_bytes << " bytes (" << site.samples
+        << " samples)\n";
+    for (void *frame : site.frames) {
+      out << "      " << symbolize(frame) << "\n";
+    }
+  }
+}
+
+void setSampleInterval(std::size_t bytes) {
+  sample_interval.store(bytes, std::memory_order_relaxed);
+}
+
+void reportAtExit(const char *path) {
+  at_exit_path = path ? path : "";
+  static bool registered = false;
+  if (!std::exchange(registered, true)) {
+    std::atexit([] { writeReport(at_exit_path); });
+  }
+}
+
+void startPeriodicReport(std::chrono::milliseconds period, const char *path) {
+  periodic_reporter &r = reporter();
+  r.join();
+  r.stop = false;
+  r.thread = std::thread([&r, period, file = std::string(path ? path : "")] {
+    std::unique_lock<std::mutex> lock(r.mutex);
+    while (!r.wake.wait_for(lock, period, [&r] { return r.stop; })) {
+      lock.unlock();
+      writeReport(file);
+      lock.lock();
+    }
+  });
+}
+
+void stopPeriodicReport() { reporter().join(); }
+
+} // namespace alloc_profiler
+
+// The replaceable global allocation functions.
+
+void *operator new(std::size_t size) {
+  return alloc_profiler::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, false,
+                                  ALLOC_PROFILER_CALLER());
+}
+
+void *operator new[](std::size_t size) {
+  return alloc_profiler::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, false,
+                                  ALLOC_PROFILER_CALLER());
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return alloc_profiler::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, true,
+                                    ALLOC_PROFILER_CALLER());
+  } catch (...) { // a new_handler may throw
+    return nullptr;
+  }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return alloc_profiler::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, true,
+                                    ALLOC_PROFILER_CALLER());
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return alloc_profiler::allocate(size, static_cast<std::size_t>(alignment), false,
+                                  ALLOC_PROFILER_CALLER());
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return alloc_profiler::allocate(size, static_cast<std::size_t>(alignment), false,
+                                  ALLOC_PROFILER_CALLER());
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  try {
+    return alloc_profiler::allocate(size, static_cast<std::size_t>(alignment), true,
+                                    ALLOC_PROFILER_CALLER());
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  try {
+    return alloc_profiler::allocate(size, static_cast<std::size_t>(alignment), true,
+                                    ALLOC_PROFILER_CALLER());
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void *p) noexcept { alloc_profiler::deallocate(p); }
+void operator delete[](void *p) noexcept { alloc_profiler::deallocate(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete(void *p, std::size_t) noexcept { alloc_profiler::deallocate(p); }
+void operator delete[](void *p, std::size_t) noexcept { alloc_profiler::deallocate(p); }
+void operator delete(void *p, std::align_val_t) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete[](void *p, std::align_val_t) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+  alloc_profiler::deallocate(p);
+}
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+  alloc_profiler::deallocate(p);
+}
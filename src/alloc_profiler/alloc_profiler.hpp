@@ -0,0 +1,110 @@
+#ifndef ALLOC_PROFILER_HPP
+#define ALLOC_PROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#include <vector>
+
+///
+/// Allocation profiler. Linking alloc_profiler replaces the global operator
+/// new/delete (all sized, aligned, array and nothrow forms) with versions that
+/// count every call:
+///
+/// - Counters live in a per-thread block that only its own thread writes, so
+///   the hot path is a few plain stores: no locks, no shared cache lines, no I/O.
+/// - Live bytes are flushed to a global counter in steps of 64 KiB per thread;
+///   the high-water mark is taken at those flushes and is therefore exact to
+///   within 64 KiB per thread.
+/// - Roughly every sample_interval bytes (exponentially distributed, as in
+///   tcmalloc) the call stack of the allocation is captured and attributed to
+///   its call site. Allocation counts per site are estimates scaled by the
+///   sampling rate.
+///
+/// takeSnapshot() reads everything without stopping other threads; report()
+/// prints it. reportAtExit() and startPeriodicReport() print it without any
+/// change to the profiled code.
+///
+
+namespace alloc_profiler {
+
+/// Requested sizes are counted in power-of-two buckets: <= 16, <= 32, ...,
+/// <= 1 MiB, and everything larger in the last bucket.
+constexpr std::size_t size_class_count = 18;
+
+inline std::size_t sizeClassUpperBound(std::size_t index) {
+  return index + 1 < size_class_count ? std::size_t{16} << index : SIZE_MAX;
+}
+
+/// Takes memory straight from malloc, so the profiler neither sees nor counts
+/// it. Snapshots are built on it: taking one must not change the counts the
+/// next one reports.
+template <typename T> struct uncounted_allocator {
+  using value_type = T;
+
+  uncounted_allocator() = default;
+  template <typename U> uncounted_allocator(const uncounted_allocator<U> &) noexcept {}
+
+  T *allocate(std::size_t n) {
+    if (void *p = std::malloc(n * sizeof(T))) {
+      return static_cast<T *>(p);
+    }
+    throw std::bad_alloc();
+  }
+  void deallocate(T *p, std::size_t) noexcept { std::free(p); }
+
+  template <typename U> bool operator==(const uncounted_allocator<U> &) const noexcept {
+    return true;
+  }
+};
+
+template <typename T> using uncounted_vector = std::vector<T, uncounted_allocator<T>>;
+
+struct size_class_stats {
+  std::size_t upper_bound;
+  std::uint64_t allocations;
+  std::uint64_t bytes;
+};
+
+struct call_site {
+  uncounted_vector<void *> frames; // innermost first, the profiler's own frames removed
+  std::uint64_t samples;
+  std::uint64_t estimated_allocations;
+  std::uint64_t estimated_bytes;
+};
+
+struct snapshot {
+  std::uint64_t allocations = 0;
+  std::uint64_t deallocations = 0;
+  std::uint64_t bytes_allocated = 0;
+  std::uint64_t bytes_freed = 0;
+  std::int64_t live_bytes = 0;
+  std::int64_t peak_live_bytes = 0;
+  std::array<size_class_stats, size_class_count> histogram{};
+  uncounted_vector<call_site> call_sites; // by estimated bytes, largest first
+  std::uint64_t dropped_samples = 0;  // the call site table was full
+};
+
+snapshot takeSnapshot();
+
+void report(std::ostream &out, const snapshot &s, std::size_t max_call_sites = 10);
+
+/// Average number of bytes between two stack captures; 0 turns sampling off.
+/// The default is 2 MiB.
+void setSampleInterval(std::size_t bytes);
+
+/// Prints a report to stderr (or appends it to `path`) when the program exits.
+void reportAtExit(const char *path = nullptr);
+
+/// Prints a report every `period` from a background thread until
+/// stopPeriodicReport() or exit.
+void startPeriodicReport(std::chrono::milliseconds period, const char *path = nullptr);
+void stopPeriodicReport();
+
+} // namespace alloc_profiler
+
+#endif
@@ -0,0 +1,72 @@
+// Cost of the profiler's operator new/delete against plain malloc/free (which
+// the profiler does not see), single-threaded and with several threads, with
+// the default sampling rate and with sampling off.
+#include "alloc_profiler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void BM_MallocFree(benchmark::State &state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    void *p = std::malloc(size);
+    benchmark::DoNotOptimize(p);
+    std::free(p);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_NewDelete(benchmark::State &state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  alloc_profiler::setSampleInterval(static_cast<std::size_t>(state.range(1)));
+  for (auto _ : state) {
+    void *p = ::operator new(size);
+    benchmark::DoNotOptimize(p);
+    ::operator delete(p);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Many live blocks at once, so malloc does real work and the profiler's share
+// is closer to what a program sees.
+template <bool Profiled> void BM_Churn(benchmark::State &state) {
+  alloc_profiler::setSampleInterval(2 << 20);
+  constexpr std::size_t live = 1024;
+  void *blocks[live] = {};
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t size = 16 + (i * 37) % 512;
+    void *&slot = blocks[i++ % live];
+    if constexpr (Profiled) {
+      ::operator delete(slot);
+      slot = ::operator new(size);
+    } else {
+      std::free(slot);
+      slot = std::malloc(size);
+    }
+    benchmark::DoNotOptimize(slot);
+  }
+  for (void *p : blocks) {
+    if constexpr (Profiled) {
+      ::operator delete(p);
+    } else {
+      std::free(p);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_MallocFree)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_NewDelete)
+    ->ArgsProduct({{16, 256, 4096}, {0, 2 << 20}})
+    ->ArgNames({"size", "sample_interval"});
+BENCHMARK_TEMPLATE(BM_Churn, false)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(BM_Churn, true)->ThreadRange(1, 8);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,12 @@
+#include "allocators.hpp"
+
 #include <iostream>
+#include <list>
+#include <map>
 #include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 /*
 
 Allocators are objects responsible for encapsulating memory management.
@@ -39,22 +46,92 @@ allocator over new
 
 */
 
-int main() {
+void stdAllocator() {
   // allocator for integer values
   std::allocator<int> myAllocator;
+  using traits = std::allocator_traits<std::allocator<int>>;
 
-  // allocate space for five ints
+  // allocate space for four ints
   int *arr = myAllocator.allocate(4);
 
-  // construct arr[0] and arr[3]
-  myAllocator.construct(arr, 10);
-  myAllocator.construct(arr + 3, 100);
+  // construct arr[0] and arr[3]; allocator::construct() is gone in C++20, the
+  // traits forward to it when an allocator has one and use placement new
+  // otherwise
+  traits::construct(myAllocator, arr, 10);
+  traits::construct(myAllocator, arr + 3, 100);
 
   std::cout << arr[0] << std::endl;
   std::cout << arr[3] << std::endl;
 
-  std::cout << myAllocator.max_size() << std::endl;
+  std::cout << traits::max_size(myAllocator) << std::endl;
+
+  traits::destroy(myAllocator, arr);
+  traits::destroy(myAllocator, arr + 3);
+
+  // deallocate exactly what was allocated
+  myAllocator.deallocate(arr, 4);
+}
+
+void arena() {
+  // Everything lives in a stack buffer until it is full; then the arena gets
+  // bigger chunks from new. Nothing is freed until the arena goes away.
+  std::byte buffer[4096];
+  mem::arena_resource arena(buffer, sizeof(buffer));
+
+  std::pmr::vector<int> numbers(&arena);
+  for (int i = 0; i < 100; ++i) {
+    numbers.push_back(i);
+  }
+  std::pmr::map<int, std::pmr::string> names(&arena);
+  names[1] = "one";
+  names[2] = "two";
+  std::cout << "arena: " << numbers.size() << " numbers, " << names.size()
+            << " names, " << arena.bytes_allocated() << " bytes" << std::endl;
+}
+
+void pool() {
+  // Nodes freed by erase() are handed out again to the next insert.
+  mem::pool_resource pool;
+  std::pmr::list<int> list(&pool);
+  std::pmr::unordered_map<int, int> squares(&pool);
+  for (int i = 0; i < 1000; ++i) {
+    list.push_back(i);
+    squares[i] = i * i;
+  }
+  list.clear();
+  for (int i = 0; i < 1000; ++i) {
+    list.push_back(-i);
+  }
+  std::cout << "pool: list " << list.size() << ", squares[12] = "
+            << squares[12] << std::endl;
+
+  // The same pool as a classic allocator, without the pmr virtual calls.
+  using int_allocator = mem::allocator<int, mem::pool_resource>;
+  std::vector<int, int_allocator> v{int_allocator(pool)};
+  v.assign({3, 1, 2});
+  std::cout << "pool: vector with classic allocator " << v.size() << std::endl;
+}
 
-  // deallocate space for five ints
-  myAllocator.deallocate(arr, 5);
+void threadCaching() {
+  mem::thread_caching_resource resource;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&resource, t] {
+      std::pmr::map<int, int> m(&resource);
+      for (int i = 0; i < 10000; ++i) {
+        m[i] = t;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::cout << "thread caching: done" << std::endl;
+}
+
+int main() {
+  stdAllocator();
+  arena();
+  pool();
+  threadCaching();
 }
@@ -0,0 +1,178 @@
+// std::vector, std::list, std::map and std::unordered_map on the resources
+// from allocators.hpp against the default new/delete, plus the standard pmr
+// resources for reference.
+#include "allocators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Each setup lives for one benchmark iteration, so the arenas start empty
+// every time and the cost of releasing them is part of the measurement.
+struct new_delete {
+  template <typename T> using allocator = std::allocator<T>;
+  template <typename T> allocator<T> get() { return {}; }
+};
+
+template <typename Resource> struct pmr {
+  template <typename T> using allocator = std::pmr::polymorphic_allocator<T>;
+  template <typename T> allocator<T> get() { return allocator<T>(&resource); }
+  Resource resource;
+};
+
+template <typename Resource> struct classic {
+  template <typename T> using allocator = mem::allocator<T, Resource>;
+  template <typename T> allocator<T> get() { return allocator<T>(resource); }
+  Resource resource;
+};
+
+std::vector<std::uint32_t> randomKeys(std::size_t n) {
+  std::mt19937 gen(42);
+  std::vector<std::uint32_t> keys(n);
+  for (auto &k : keys) {
+    k = gen();
+  }
+  return keys;
+}
+
+template <typename Setup> void BM_Vector(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    Setup setup;
+    std::vector<std::uint64_t, typename Setup::template allocator<std::uint64_t>>
+        v(setup.template get<std::uint64_t>());
+    for (std::size_t i = 0; i < n; ++i) {
+      v.push_back(i);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Fill, then erase every other node and refill, so the allocator has to hand
+// freed nodes back out.
+template <typename Setup> void BM_List(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    Setup setup;
+    std::list<std::uint64_t, typename Setup::template allocator<std::uint64_t>>
+        l(setup.template get<std::uint64_t>());
+    for (std::size_t i = 0; i < n; ++i) {
+      l.push_back(i);
+    }
+    for (auto it = l.begin(); it != l.end();) {
+      it = l.erase(it);
+      if (it != l.end()) {
+        ++it;
+      }
+    }
+    for (std::size_t i = 0; i < n / 2; ++i) {
+      l.push_front(i);
+    }
+    benchmark::DoNotOptimize(l.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Setup> void BM_Map(benchmark::State &state) {
+  const auto keys = randomKeys(static_cast<std::size_t>(state.range(0)));
+  using value = std::pair<const std::uint32_t, std::uint32_t>;
+  for (auto _ : state) {
+    Setup setup;
+    std::map<std::uint32_t, std::uint32_t, std::less<>,
+             typename Setup::template allocator<value>>
+        m(setup.template get<value>());
+    for (auto k : keys) {
+      m.emplace(k, k);
+    }
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+      m.erase(keys[i]);
+    }
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+      m.emplace(keys[i], 0);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Setup> void BM_UnorderedMap(benchmark::State &state) {
+  const auto keys = randomKeys(static_cast<std::size_t>(state.range(0)));
+  using value = std::pair<const std::uint32_t, std::uint32_t>;
+  for (auto _ : state) {
+    Setup setup;
+    std::unordered_map<std::uint32_t, std::uint32_t, std::hash<std::uint32_t>,
+                       std::equal_to<>, typename Setup::template allocator<value>>
+        m(0, std::hash<std::uint32_t>{}, std::equal_to<>{},
+          setup.template get<value>());
+    for (auto k : keys) {
+      m.emplace(k, k);
+    }
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+      m.erase(keys[i]);
+    }
+    for (std::size_t i = 0; i < keys.size(); i += 2) {
+      m.emplace(keys[i], 0);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Every thread builds and tears down its own map on one shared, thread-safe
+// resource.
+template <typename Setup> void BM_MapPerThread(benchmark::State &state) {
+  static Setup setup;
+  const auto keys = randomKeys(10'000);
+  using value = std::pair<const std::uint32_t, std::uint32_t>;
+  for (auto _ : state) {
+    std::map<std::uint32_t, std::uint32_t, std::less<>,
+             typename Setup::template allocator<value>>
+        m(setup.template get<value>());
+    for (auto k : keys) {
+      m.emplace(k, k);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(keys.size()));
+}
+
+} // namespace
+
+#define ALLOCATOR_BENCHMARKS(bm)                                               \
+  BENCHMARK_TEMPLATE(bm, new_delete)->Range(1 << 10, 1 << 16);                 \
+  BENCHMARK_TEMPLATE(bm, pmr<mem::arena_resource>)->Range(1 << 10, 1 << 16);   \
+  BENCHMARK_TEMPLATE(bm, pmr<mem::pool_resource>)->Range(1 << 10, 1 << 16);    \
+  BENCHMARK_TEMPLATE(bm, pmr<mem::thread_caching_resource>)                    \
+      ->Range(1 << 10, 1 << 16);                                               \
+  BENCHMARK_TEMPLATE(bm, classic<mem::arena_resource>)                         \
+      ->Range(1 << 10, 1 << 16);                                               \
+  BENCHMARK_TEMPLATE(bm, classic<mem::pool_resource>)                          \
+      ->Range(1 << 10, 1 << 16);                                               \
+  BENCHMARK_TEMPLATE(bm, pmr<std::pmr::monotonic_buffer_resource>)             \
+      ->Range(1 << 10, 1 << 16);                                               \
+  BENCHMARK_TEMPLATE(bm, pmr<std::pmr::unsynchronized_pool_resource>)          \
+      ->Range(1 << 10, 1 << 16)
+
+ALLOCATOR_BENCHMARKS(BM_Vector);
+ALLOCATOR_BENCHMARKS(BM_List);
+ALLOCATOR_BENCHMARKS(BM_Map);
+ALLOCATOR_BENCHMARKS(BM_UnorderedMap);
+
+BENCHMARK_TEMPLATE(BM_MapPerThread, new_delete)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MapPerThread, pmr<mem::thread_caching_resource>)
+    ->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MapPerThread, pmr<std::pmr::synchronized_pool_resource>)
+    ->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
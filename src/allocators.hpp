@@ -0,0 +1,394 @@
+#ifndef ALLOCATORS_HPP
+#define ALLOCATORS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+///
+/// Memory resources for containers with allocation-heavy access patterns.
+///
+/// - arena_resource: bump-pointer allocation from large chunks, deallocate()
+///   is a no-op and everything is freed at once. Ideal for data that dies
+///   together (a frame, a request, a parse tree). Not thread-safe.
+/// - pool_resource: one free list per size class, carved from slabs. Freed
+///   blocks are reused immediately, so node-based containers (list, map,
+///   unordered_map) stay compact. Not thread-safe.
+/// - thread_caching_resource: a pool shared by all threads with a small
+///   per-thread cache in front of it, so the common allocate/deallocate path
+///   takes no lock. Blocks move between a thread and the shared pool in
+///   batches.
+///
+/// All three derive from std::pmr::memory_resource and plug into std::pmr
+/// containers. mem::allocator<T, Resource> wraps any of them as a classic
+/// allocator for the ordinary std containers; because the resources are final
+/// the compiler can call them without virtual dispatch.
+///
+
+namespace mem {
+
+namespace detail {
+
+// Size classes: 16-byte steps up to 256 bytes, then powers of two up to 4 KiB.
+// Larger requests, or alignments above 16, go straight to the upstream
+// resource.
+constexpr std::size_t class_alignment = 16;
+constexpr std::size_t small_limit = 256;
+constexpr std::size_t max_pooled = 4096;
+constexpr std::size_t class_count = small_limit / 16 + 4; // + 512..4096
+
+inline bool poolable(std::size_t bytes, std::size_t alignment) {
+  return bytes <= max_pooled && alignment <= class_alignment;
+}
+
+inline std::size_t classIndex(std::size_t bytes) {
+  if (bytes <= small_limit) {
+    return bytes == 0 ? 0 : (bytes - 1) / 16;
+  }
+  std::size_t index = small_limit / 16;
+  for (std::size_t size = 2 * small_limit; size < bytes; size <<= 1) {
+    ++index;
+  }
+  return index;
+}
+
+inline std::size_t classSize(std::size_t index) {
+  return index < small_limit / 16 ? (index + 1) * 16
+                                  : small_limit << (index - small_limit / 16 + 1);
+}
+
+struct free_block {
+  free_block *next;
+};
+
+} // namespace detail
+
+class arena_resource final : public std::pmr::memory_resource {
+public:
+  explicit arena_resource(
+      std::size_t initial_chunk = 64 * 1024,
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : m_upstream(upstream), m_next_chunk(std::max<std::size_t>(initial_chunk, 256)) {}
+
+  /// Serves allocations from `buffer` (e.g. on the stack) before going upstream.
+  arena_resource(
+      void *buffer, std::size_t size,
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : m_upstream(upstream), m_initial_begin(static_cast<std::byte *>(buffer)),
+        m_initial_end(m_initial_begin + size), m_current(m_initial_begin),
+        m_end(m_initial_end), m_next_chunk(std::max<std::size_t>(size, 256) * 2) {}
+
+  arena_resource(const arena_resource &) = delete;
+  arena_resource &operator=(const arena_resource &) = delete;
+
+  ~arena_resource() override { release(); }
+
+  /// Frees every chunk at once. Objects allocated from the arena must already
+  /// be destroyed (or be trivially destructible).
+  void release() {
+    while (m_chunks) {
+      chunk *next = m_chunks->next;
+      m_upstream->deallocate(m_chunks, m_chunks->size, alignof(chunk));
+      m_chunks = next;
+    }
+    m_current = m_initial_begin;
+    m_end = m_initial_end;
+    m_bytes_allocated = 0;
+  }
+
+  std::size_t bytes_allocated() const { return m_bytes_allocated; }
+
+private:
+  struct alignas(detail::class_alignment) chunk {
+    chunk *next;
+    std::size_t size;
+  };
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    void *p = m_current;
+    std::size_t space = static_cast<std::size_t>(m_end - m_current);
+    if (!std::align(alignment, bytes, p, space)) {
+      grow(bytes + alignment);
+      p = m_current;
+      space = static_cast<std::size_t>(m_end - m_current);
+      std::align(alignment, bytes, p, space);
+    }
+    m_current = static_cast<std::byte *>(p) + bytes;
+    m_bytes_allocated += bytes;
+    return p;
+  }
+
+  void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  void grow(std::size_t at_least) {
+    const std::size_t size =
+        std::max(m_next_chunk, at_least + sizeof(chunk));
+    auto *c = static_cast<chunk *>(m_upstream->allocate(size, alignof(chunk)));
+    c->next = m_chunks;
+    c->size = size;
+    m_chunks = c;
+    m_current = reinterpret_cast<std::byte *>(c + 1);
+    m_end = reinterpret_cast<std::byte *>(c) + size;
+    m_next_chunk = size * 2;
+  }
+
+  std::pmr::memory_resource *m_upstream;
+  std::byte *m_initial_begin = nullptr;
+  std::byte *m_initial_end = nullptr;
+  std::byte *m_current = nullptr;
+  std::byte *m_end = nullptr;
+  std::size_t m_next_chunk;
+  std::size_t m_bytes_allocated = 0;
+  chunk *m_chunks = nullptr;
+};
+
+class pool_resource final : public std::pmr::memory_resource {
+public:
+  explicit pool_resource(
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : m_upstream(upstream) {}
+
+  pool_resource(const pool_resource &) = delete;
+  pool_resource &operator=(const pool_resource &) = delete;
+
+  ~pool_resource() override { release(); }
+
+  /// Returns every slab to upstream. Large blocks that were forwarded to
+  /// upstream are not tracked and must be deallocated by their owners.
+  void release() {
+    for (const slab &s : m_slabs) {
+      m_upstream->deallocate(s.memory, s.size, detail::class_alignment);
+    }
+    m_slabs.clear();
+    m_classes = {};
+  }
+
+private:
+  struct size_class {
+    detail::free_block *free = nullptr;
+    std::byte *next = nullptr; // uncarved rest of the newest slab
+    std::byte *end = nullptr;
+    std::size_t slab_blocks = 32;
+  };
+
+  struct slab {
+    void *memory;
+    std::size_t size;
+  };
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (!detail::poolable(bytes, alignment)) {
+      return m_upstream->allocate(bytes, alignment);
+    }
+    const std::size_t index = detail::classIndex(bytes);
+    size_class &c = m_classes[index];
+    if (c.free) {
+      return std::exchange(c.free, c.free->next);
+    }
+    const std::size_t block = detail::classSize(index);
+    if (c.next == c.end) {
+      // Slabs double in size (up to 1 MiB) so a class that is used a lot
+      // costs few upstream calls, and a class used once costs little memory.
+      const std::size_t size = c.slab_blocks * block;
+      void *memory = m_upstream->allocate(size, detail::class_alignment);
+      m_slabs.push_back({memory, size});
+      c.next = static_cast<std::byte *>(memory);
+      c.end = c.next + size;
+      c.slab_blocks = std::min<std::size_t>(c.slab_blocks * 2,
+                                            std::max<std::size_t>(1, (1 << 20) / block));
+    }
+    return std::exchange(c.next, c.next + block);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+    if (!detail::poolable(bytes, alignment)) {
+      m_upstream->deallocate(p, bytes, alignment);
+      return;
+    }
+    size_class &c = m_classes[detail::classIndex(bytes)];
+    auto *block = static_cast<detail::free_block *>(p);
+    block->next = c.free;
+    c.free = block;
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource *m_upstream;
+  std::array<size_class, detail::class_count> m_classes{};
+  std::vector<slab> m_slabs;
+};
+
+class thread_caching_resource final : public std::pmr::memory_resource {
+public:
+  explicit thread_caching_resource(
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+      : m_upstream(upstream), m_central(std::make_shared<central>(upstream)),
+        m_id(nextId()) {}
+
+  thread_caching_resource(const thread_caching_resource &) = delete;
+  thread_caching_resource &operator=(const thread_caching_resource &) = delete;
+
+  /// Caches of other threads still hold blocks; they hand them back (and the
+  /// shared pool is freed) when those threads exit or next use any
+  /// thread_caching_resource.
+  ~thread_caching_resource() override { m_central->alive.store(false); }
+
+private:
+  // Blocks a thread keeps per size class before handing half of them back,
+  // and how many it fetches from the shared pool at once.
+  static constexpr std::uint32_t cache_limit = 256;
+  static constexpr std::uint32_t batch = 64;
+
+  struct central {
+    explicit central(std::pmr::memory_resource *upstream) : pool(upstream) {}
+    std::mutex mutex;
+    pool_resource pool;
+    std::atomic<bool> alive{true};
+  };
+
+  struct thread_cache {
+    std::uint64_t owner;
+    std::shared_ptr<central> shared;
+    std::array<detail::free_block *, detail::class_count> free{};
+    std::array<std::uint32_t, detail::class_count> count{};
+
+    ~thread_cache() {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      for (std::size_t i = 0; i < detail::class_count; ++i) {
+        while (free[i]) {
+          shared->pool.deallocate(std::exchange(free[i], free[i]->next),
+                                  detail::classSize(i), detail::class_alignment);
+        }
+      }
+    }
+  };
+
+  static std::uint64_t nextId() {
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+  }
+
+  thread_cache &localCache() {
+    thread_local std::vector<std::unique_ptr<thread_cache>> caches;
+    thread_local thread_cache *last = nullptr;
+    if (last && last->owner == m_id) {
+      return *last;
+    }
+    for (auto &c : caches) {
+      if (c->owner == m_id) {
+        return *(last = c.get());
+      }
+    }
+    // First use from this thread: also drop caches of destroyed resources.
+    caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                [](const std::unique_ptr<thread_cache> &c) {
+                                  return !c->shared->alive.load();
+                                }),
+                 caches.end());
+    caches.push_back(std::make_unique<thread_cache>());
+    caches.back()->owner = m_id;
+    caches.back()->shared = m_central;
+    return *(last = caches.back().get());
+  }
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (!detail::poolable(bytes, alignment)) {
+      return m_upstream->allocate(bytes, alignment);
+    }
+    const std::size_t index = detail::classIndex(bytes);
+    thread_cache &cache = localCache();
+    if (!cache.free[index]) {
+      const std::size_t size = detail::classSize(index);
+      std::lock_guard<std::mutex> lock(m_central->mutex);
+      for (std::uint32_t i = 0; i < batch; ++i) {
+        auto *b = static_cast<detail::free_block *>(
+            m_central->pool.allocate(size, detail::class_alignment));
+        b->next = cache.free[index];
+        cache.free[index] = b;
+      }
+      cache.count[index] += batch;
+    }
+    --cache.count[index];
+    return std::exchange(cache.free[index], cache.free[index]->next);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+    if (!detail::poolable(bytes, alignment)) {
+      m_upstream->deallocate(p, bytes, alignment);
+      return;
+    }
+    const std::size_t index = detail::classIndex(bytes);
+    thread_cache &cache = localCache();
+    auto *block = static_cast<detail::free_block *>(p);
+    block->next = cache.free[index];
+    cache.free[index] = block;
+    if (++cache.count[index] > cache_limit) {
+      const std::size_t size = detail::classSize(index);
+      std::lock_guard<std::mutex> lock(m_central->mutex);
+      while (cache.count[index] > cache_limit / 2) {
+        m_central->pool.deallocate(
+            std::exchange(cache.free[index], cache.free[index]->next), size,
+            detail::class_alignment);
+        --cache.count[index];
+      }
+    }
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource *m_upstream;
+  std::shared_ptr<central> m_central;
+  const std::uint64_t m_id;
+};
+
+/// A classic (non-polymorphic) allocator on top of one of the resources above,
+/// for the ordinary std containers: std::vector<int, mem::allocator<int,
+/// mem::pool_resource>> v(mem::allocator<int, mem::pool_resource>(pool));
+template <typename T, typename Resource> class allocator {
+public:
+  using value_type = T;
+
+  explicit allocator(Resource &resource) noexcept : m_resource(&resource) {}
+
+  template <typename U>
+  allocator(const allocator<U, Resource> &other) noexcept
+      : m_resource(other.resource()) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(m_resource->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    m_resource->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  Resource *resource() const noexcept { return m_resource; }
+
+  template <typename U>
+  bool operator==(const allocator<U, Resource> &other) const noexcept {
+    return m_resource == other.resource();
+  }
+
+private:
+  Resource *m_resource;
+};
+
+} // namespace mem
+
+#endif
@@ -240,6 +240,8 @@ void readingWrittingFilesExample() {
 ////////////////////////////////////// stringstream
 /////////////////////////////////////////
 
+// strings/numbers.hpp parses a buffer of numbers without a stream:
+// parseNumbers().
 void stringstreamExample() {
   /*
   typedef basic_stringstream<char> stringstream;
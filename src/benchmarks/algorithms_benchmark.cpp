@@ -0,0 +1,111 @@
+// Algorithms (algorithms_library.cpp): sorting, selection, searching and the
+// numeric algorithms on random data.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int> randomInts(std::size_t n) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist;
+  std::vector<int> v(n);
+  for (auto &x : v) {
+    x = dist(gen);
+  }
+  return v;
+}
+
+// The copy is part of every iteration but is the same for all three, and is
+// cheap next to the sort.
+void BM_Sort(benchmark::State &state) {
+  const auto input = randomInts(static_cast<std::size_t>(state.range(0)));
+  std::vector<int> v;
+  for (auto _ : state) {
+    v = input;
+    std::sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StableSort(benchmark::State &state) {
+  const auto input = randomInts(static_cast<std::size_t>(state.range(0)));
+  std::vector<int> v;
+  for (auto _ : state) {
+    v = input;
+    std::stable_sort(v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_NthElement(benchmark::State &state) {
+  const auto input = randomInts(static_cast<std::size_t>(state.range(0)));
+  std::vector<int> v;
+  for (auto _ : state) {
+    v = input;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    benchmark::DoNotOptimize(v[v.size() / 2]);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_LinearFind(benchmark::State &state) {
+  const auto v = randomInts(static_cast<std::size_t>(state.range(0)));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto it = std::find(v.begin(), v.end(), v[(i++ * 7919) % v.size()]);
+    benchmark::DoNotOptimize(it);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_BinarySearch(benchmark::State &state) {
+  auto v = randomInts(static_cast<std::size_t>(state.range(0)));
+  std::sort(v.begin(), v.end());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto it = std::lower_bound(v.begin(), v.end(), v[(i++ * 7919) % v.size()]);
+    benchmark::DoNotOptimize(it);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Accumulate(benchmark::State &state) {
+  const auto v = randomInts(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto sum = std::accumulate(v.begin(), v.end(), std::int64_t{0});
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(int)));
+}
+
+void BM_Transform(benchmark::State &state) {
+  const auto v = randomInts(static_cast<std::size_t>(state.range(0)));
+  std::vector<int> out(v.size());
+  for (auto _ : state) {
+    std::transform(v.begin(), v.end(), out.begin(), [](int x) { return x / 3 + 1; });
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(2 * sizeof(int)));
+}
+
+} // namespace
+
+BENCHMARK(BM_Sort)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_StableSort)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_NthElement)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_LinearFind)->RangeMultiplier(8)->Range(1 << 4, 1 << 16);
+BENCHMARK(BM_BinarySearch)->RangeMultiplier(8)->Range(1 << 4, 1 << 16);
+BENCHMARK(BM_Accumulate)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_Transform)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,73 @@
+// Allocators (allocator.cpp, allocators.hpp, dynamic_memory_allocation.cpp):
+// small-object allocation through new/delete, std::pmr and the resources
+// from allocators.hpp. allocator_benchmark.cpp has the full container matrix.
+#include "allocators.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+struct node {
+  node *next;
+  long value[3];
+};
+
+// Allocate a batch of nodes, then free them all; the resources are reused
+// across iterations, as they would be in a long-running program.
+void BM_NewDelete(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<node *> nodes(n);
+  for (auto _ : state) {
+    for (auto &p : nodes) {
+      p = new node;
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    for (auto *p : nodes) {
+      delete p;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Resource> void BM_Resource(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  Resource resource;
+  std::vector<void *> nodes(n);
+  for (auto _ : state) {
+    for (auto &p : nodes) {
+      p = resource.allocate(sizeof(node), alignof(node));
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    for (auto *p : nodes) {
+      resource.deallocate(p, sizeof(node), alignof(node));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The arena frees everything at once instead of node by node.
+void BM_Arena(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  mem::arena_resource arena;
+  std::vector<void *> nodes(n);
+  for (auto _ : state) {
+    for (auto &p : nodes) {
+      p = arena.allocate(sizeof(node), alignof(node));
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    arena.release();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_NewDelete)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Resource, std::pmr::unsynchronized_pool_resource)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Resource, mem::pool_resource)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Resource, mem::thread_caching_resource)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_Arena)->Range(1 << 8, 1 << 16);
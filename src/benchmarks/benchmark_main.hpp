@@ -0,0 +1,58 @@
+#ifndef BENCHMARK_MAIN_HPP
+#define BENCHMARK_MAIN_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+///
+/// A replacement for BENCHMARK_MAIN() that records the compiler in the report
+/// context and, unless --benchmark_out is given, also writes the results as
+/// JSON to `default_json`, so every run can be fed to
+/// scripts/compare_benchmarks.py.
+///
+
+inline std::string benchmarkCompiler() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+  return "unknown";
+#endif
+}
+
+inline int runBenchmarks(int argc, char **argv, const char *default_json) {
+  benchmark::AddCustomContext("compiler", benchmarkCompiler());
+#ifdef NDEBUG
+  benchmark::AddCustomContext("assertions", "off");
+#else
+  benchmark::AddCustomContext("assertions", "on");
+#endif
+
+  std::vector<char *> args(argv, argv + argc);
+  const bool has_out = std::any_of(args.begin(), args.end(), [](const char *arg) {
+    return std::string_view(arg).rfind("--benchmark_out=", 0) == 0;
+  });
+  std::string out = std::string("--benchmark_out=") + default_json;
+  std::string format = "--benchmark_out_format=json";
+  if (!has_out) {
+    args.push_back(out.data());
+    args.push_back(format.data());
+  }
+  int count = static_cast<int>(args.size());
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
+
+#endif
@@ -0,0 +1,121 @@
+// Containers (containers.cpp, vector.cpp, lists.cpp, set_map_pair_tuple.cpp,
+// queue.cpp): building, traversing and searching the standard containers.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::vector<std::uint32_t> randomKeys(std::size_t n) {
+  std::mt19937 gen(42);
+  std::vector<std::uint32_t> keys(n);
+  for (auto &k : keys) {
+    k = gen();
+  }
+  return keys;
+}
+
+template <bool Reserve> void BM_VectorPushBack(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::vector<int> v;
+    if constexpr (Reserve) {
+      v.reserve(n);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      v.push_back(static_cast<int>(i));
+    }
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DequePushFront(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::deque<int> d;
+    for (std::size_t i = 0; i < n; ++i) {
+      d.push_front(static_cast<int>(i));
+    }
+    benchmark::DoNotOptimize(d.front());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same sum over contiguous and node-based storage.
+template <typename Container> void BM_Traverse(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  Container c(n, 1);
+  for (auto _ : state) {
+    long sum = std::accumulate(c.begin(), c.end(), 0L);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(int)));
+}
+
+template <typename Map> void BM_MapInsert(benchmark::State &state) {
+  const auto keys = randomKeys(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    Map m;
+    for (auto k : keys) {
+      m.emplace(k, k);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map> void BM_MapLookup(benchmark::State &state) {
+  const auto keys = randomKeys(static_cast<std::size_t>(state.range(0)));
+  Map m;
+  for (auto k : keys) {
+    m.emplace(k, k);
+  }
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto it = m.find(keys[i++ % keys.size()]);
+    benchmark::DoNotOptimize(it);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Lookup in a sorted vector instead of a tree: same O(log n), contiguous memory.
+void BM_SortedVectorLookup(benchmark::State &state) {
+  const auto keys = randomKeys(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::uint32_t> sorted = keys;
+  std::sort(sorted.begin(), sorted.end());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), keys[i++ % keys.size()]);
+    benchmark::DoNotOptimize(it);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+using ordered = std::map<std::uint32_t, std::uint32_t>;
+using unordered = std::unordered_map<std::uint32_t, std::uint32_t>;
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_VectorPushBack, false)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_VectorPushBack, true)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_DequePushFront)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Traverse, std::vector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Traverse, std::deque<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Traverse, std::list<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_MapInsert, ordered)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_MapInsert, unordered)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_MapLookup, ordered)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_MapLookup, unordered)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_SortedVectorLookup)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,99 @@
+// I/O (basic_IO_operation_*.cpp, streams_IO_operation_format_output.cpp):
+// writing and reading a file line by line with streams and stdio.
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string tempFile() {
+  return (std::filesystem::temp_directory_path() / "io_benchmark.txt").string();
+}
+
+const std::string line = "The quick brown fox jumps over the lazy dog 0123456789";
+
+// std::endl flushes the stream on every line, i.e. one write() system call
+// per line; '\n' leaves the buffering to the stream.
+template <bool Endl> void BM_OfstreamLines(benchmark::State &state) {
+  const auto lines = state.range(0);
+  for (auto _ : state) {
+    std::ofstream out(tempFile());
+    for (std::int64_t i = 0; i < lines; ++i) {
+      if constexpr (Endl) {
+        out << line << std::endl;
+      } else {
+        out << line << '\n';
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * lines *
+                          static_cast<std::int64_t>(line.size() + 1));
+  std::filesystem::remove(tempFile());
+}
+
+void BM_FwriteLines(benchmark::State &state) {
+  const auto lines = state.range(0);
+  for (auto _ : state) {
+    std::FILE *out = std::fopen(tempFile().c_str(), "w");
+    for (std::int64_t i = 0; i < lines; ++i) {
+      std::fwrite(line.data(), 1, line.size(), out);
+      std::fputc('\n', out);
+    }
+    std::fclose(out);
+  }
+  state.SetBytesProcessed(state.iterations() * lines *
+                          static_cast<std::int64_t>(line.size() + 1));
+  std::filesystem::remove(tempFile());
+}
+
+void writeFile(std::int64_t lines) {
+  std::ofstream out(tempFile());
+  for (std::int64_t i = 0; i < lines; ++i) {
+    out << line << '\n';
+  }
+}
+
+// Reads come from the page cache after the first iteration: this measures the
+// library, not the disk.
+void BM_GetlineRead(benchmark::State &state) {
+  writeFile(state.range(0));
+  const auto bytes = static_cast<std::int64_t>(std::filesystem::file_size(tempFile()));
+  for (auto _ : state) {
+    std::ifstream in(tempFile());
+    std::string s;
+    std::size_t count = 0;
+    while (std::getline(in, s)) {
+      count += s.size();
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+  std::filesystem::remove(tempFile());
+}
+
+void BM_WholeFileRead(benchmark::State &state) {
+  writeFile(state.range(0));
+  const auto bytes = static_cast<std::int64_t>(std::filesystem::file_size(tempFile()));
+  std::vector<char> buffer(static_cast<std::size_t>(bytes));
+  for (auto _ : state) {
+    std::ifstream in(tempFile(), std::ios::binary);
+    in.read(buffer.data(), bytes);
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+  std::filesystem::remove(tempFile());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_OfstreamLines, true)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_OfstreamLines, false)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_FwriteLines)->Range(1 << 8, 1 << 14);
+BENCHMARK(BM_GetlineRead)->Range(1 << 8, 1 << 16);
+BENCHMARK(BM_WholeFileRead)->Range(1 << 8, 1 << 16);
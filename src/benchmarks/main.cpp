@@ -0,0 +1,7 @@
+// One binary for the benchmarks of all subsystem examples. Pick a subsystem
+// with --benchmark_filter, e.g. --benchmark_filter='BM_Map|BM_Sort'.
+#include "benchmark_main.hpp"
+
+int main(int argc, char **argv) {
+  return runBenchmarks(argc, argv, "benchmarks.json");
+}
@@ -0,0 +1,111 @@
+// Strings (string.cpp, printing_with_format.cpp): creation,
+// copies, building and searching.
+// https://www.youtube.com/watch?v=eKODykkIZTE&t=108s
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Without DoNotOptimize the compiler may drop the unused string altogether and
+// the benchmark measures an empty loop.
+void BM_StringCreation(benchmark::State &state) {
+  for (auto _ : state) {
+    std::string empty_string;
+    benchmark::DoNotOptimize(empty_string);
+  }
+}
+
+// Short strings fit in the Small String Optimization buffer and copying them
+// does not allocate; long ones do.
+void BM_StringCopy(benchmark::State &state) {
+  const std::string x(static_cast<std::size_t>(state.range(0)), 'x');
+  for (auto _ : state) {
+    std::string copy(x);
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+template <bool Reserve> void BM_StringAppend(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::string s;
+    if constexpr (Reserve) {
+      s.reserve(n * 4);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      s += "abcd";
+    }
+    benchmark::DoNotOptimize(s.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 4);
+}
+
+// The three ways the examples turn numbers into text.
+void BM_IntToStringStream(benchmark::State &state) {
+  int i = 0;
+  for (auto _ : state) {
+    std::ostringstream out;
+    out << i++;
+    benchmark::DoNotOptimize(out.str());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_IntToString(benchmark::State &state) {
+  int i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::to_string(i++));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_IntToChars(benchmark::State &state) {
+  int i = 0;
+  char buffer[16];
+  for (auto _ : state) {
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), i++);
+    benchmark::DoNotOptimize(result.ptr);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// substr copies (and may allocate); a string_view only points into the text.
+template <typename Str> void BM_Substr(benchmark::State &state) {
+  const std::string text(4096, 'x');
+  const Str view(text);
+  std::size_t pos = 0;
+  for (auto _ : state) {
+    auto part = view.substr(pos++ % 2048, static_cast<std::size_t>(state.range(0)));
+    benchmark::DoNotOptimize(part.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_StringFind(benchmark::State &state) {
+  std::string text(static_cast<std::size_t>(state.range(0)), 'a');
+  text += "needle";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(text.find("needle"));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_StringCreation);
+BENCHMARK(BM_StringCopy)->Arg(5)->Arg(15)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_StringAppend, false)->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringAppend, true)->Range(16, 1 << 16);
+BENCHMARK(BM_IntToStringStream);
+BENCHMARK(BM_IntToString);
+BENCHMARK(BM_IntToChars);
+BENCHMARK_TEMPLATE(BM_Substr, std::string)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_Substr, std::string_view)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(BM_StringFind)->Range(64, 1 << 16);
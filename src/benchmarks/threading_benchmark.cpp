@@ -0,0 +1,66 @@
+// Threading (multithreading/): the cost of the synchronization primitives and
+// of the ways the examples start work on another thread.
+#include "multithreading/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+void BM_MutexLockUnlock(benchmark::State &state) {
+  static std::mutex mutex;
+  static long counter = 0;
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++counter;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_AtomicIncrement(benchmark::State &state) {
+  static std::atomic<long> counter{0};
+  for (auto _ : state) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Start a task and wait for its result, the unit of work in the examples.
+void BM_ThreadCreateJoin(benchmark::State &state) {
+  for (auto _ : state) {
+    int result = 0;
+    std::thread t([&result] { result = 1; });
+    t.join();
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_StdAsync(benchmark::State &state) {
+  for (auto _ : state) {
+    auto f = std::async(std::launch::async, [] { return 1; });
+    benchmark::DoNotOptimize(f.get());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ThreadPoolSubmit(benchmark::State &state) {
+  thread_pool pool(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto f = pool.submit([] { return 1; });
+    benchmark::DoNotOptimize(f.get());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_MutexLockUnlock)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_AtomicIncrement)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ThreadCreateJoin)->UseRealTime();
+BENCHMARK(BM_StdAsync)->UseRealTime();
+BENCHMARK(BM_ThreadPoolSubmit)->Arg(1)->Arg(4)->ArgName("workers")->UseRealTime();
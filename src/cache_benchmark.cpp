@@ -0,0 +1,274 @@
+// Cache behaviour, following perfomanceBenchmarking() in align.cpp:
+// - working-set sweeps (latency by pointer chasing, bandwidth by streaming)
+//   that show where L1, L2, L3 and DRAM begin
+// - stride sweeps over one large array
+// - row- vs column-major traversal of a matrix
+// - arrays of the Foo1-Foo4 layouts from align.cpp, and a packed variant with
+//   misaligned ints
+// - false sharing between threads
+//
+// Results go to cache_benchmark.json as well as the console, with the
+// compiler recorded in the context, unless --benchmark_out is given:
+//   ./cache_benchmark --benchmark_out=gcc13.json --benchmark_out_format=json
+#include "benchmarks/benchmark_main.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+#ifdef __cpp_lib_hardware_interference_size
+constexpr std::size_t cache_line = std::hardware_destructive_interference_size;
+#else
+constexpr std::size_t cache_line = 64;
+#endif
+
+// Working-set latency: every load depends on the previous one and the order
+// is a random cycle through the buffer, so neither the prefetcher nor
+// out-of-order execution can hide a miss. The time per load steps up each time
+// the buffer outgrows a cache level.
+struct alignas(cache_line) chase_node {
+  chase_node *next;
+};
+
+void BM_WorkingSetLatency(benchmark::State &state) {
+  const auto bytes = static_cast<std::size_t>(state.range(0));
+  const std::size_t count = bytes / sizeof(chase_node);
+  std::vector<chase_node> nodes(count);
+  std::vector<std::size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin() + 1, order.end(), std::mt19937_64(42));
+  for (std::size_t i = 0; i < count; ++i) {
+    nodes[order[i]].next = &nodes[order[(i + 1) % count]];
+  }
+
+  constexpr std::int64_t loads = 1 << 16;
+  chase_node *p = &nodes[0];
+  std::chrono::nanoseconds elapsed{0};
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::int64_t i = 0; i < loads; ++i) {
+      p = p->next;
+    }
+    benchmark::DoNotOptimize(p);
+    elapsed += std::chrono::steady_clock::now() - start;
+  }
+  state.counters["ns_per_load"] =
+      static_cast<double>(elapsed.count()) /
+      static_cast<double>(state.iterations() * loads);
+  state.SetLabel(std::to_string(bytes / 1024) + " KiB");
+}
+
+// Working-set bandwidth: sequential reads of the whole buffer, which the
+// prefetcher streams; bytes_per_second drops at the same sizes, but less.
+void BM_WorkingSetBandwidth(benchmark::State &state) {
+  const auto bytes = static_cast<std::size_t>(state.range(0));
+  std::vector<std::uint64_t> data(bytes / sizeof(std::uint64_t), 1);
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (std::uint64_t v : data) {
+      sum += v;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+  state.SetLabel(std::to_string(bytes / 1024) + " KiB");
+}
+
+// The stride loop from perfomanceBenchmarking(). Up to 16 ints (one cache
+// line) every line is fetched anyway, so a pass costs about the same however
+// many ints it touches; beyond that the pass time halves with every doubling.
+void BM_Stride(benchmark::State &state) {
+  constexpr std::size_t size = std::size_t{1} << 24; // 64 MiB of ints
+  const auto step = static_cast<std::size_t>(state.range(0));
+  std::vector<int> array(size);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < size; i += step) {
+      array[i]++;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(size / step));
+}
+
+// Row-major traversal walks memory sequentially; column-major jumps n ints per
+// access, so once a column's lines no longer fit in the cache every access
+// is a miss.
+template <bool RowMajor> void BM_MatrixTraversal(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<int> matrix(n * n);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < n; ++j) {
+        if constexpr (RowMajor) {
+          matrix[i * n + j] += 1;
+        } else {
+          matrix[j * n + i] += 1;
+        }
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(n * n * sizeof(int)));
+}
+
+// The layouts from align.cpp.
+struct Foo1 {
+  char c1;
+  int i1;
+};
+
+struct Foo2 {
+  char c1;
+  int i1;
+  char c2;
+  int i2;
+};
+
+struct Foo3UnPacked {
+  char c1;
+  char c2;
+  int i1;
+  int i2;
+};
+
+const int aligned_value = 8;
+
+struct Foo3 {
+  alignas(aligned_value) char c1;
+  alignas(aligned_value) char c2;
+  alignas(aligned_value) int i1;
+  alignas(aligned_value) int i2;
+};
+
+struct alignas(8) Foo4 {
+  char c1;
+  int i1;
+  char c2;
+  int i2;
+};
+
+// Foo2 without padding: i1 sits at offset 1, so most ints straddle a 4-byte
+// boundary and some a cache line.
+#pragma pack(push, 1)
+struct Foo2Packed {
+  char c1;
+  int i1;
+  char c2;
+  int i2;
+};
+#pragma pack(pop)
+
+template <typename T> std::int64_t sumInts(const T &f) {
+  if constexpr (requires { f.i2; }) {
+    return static_cast<std::int64_t>(f.i1) + f.i2 + f.c1;
+  } else {
+    return static_cast<std::int64_t>(f.i1) + f.c1;
+  }
+}
+
+// The same number of elements for every layout: a layout with more padding
+// moves more bytes for the same work. 1M elements is well past L2.
+template <typename T> void BM_StructLayout(benchmark::State &state) {
+  std::vector<T> items(1 << 20);
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    items[i].c1 = static_cast<char>(i);
+    items[i].i1 = static_cast<int>(i);
+  }
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (const T &f : items) {
+      sum += sumInts(f);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(items.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(items.size() * sizeof(T)));
+  state.SetLabel("sizeof=" + std::to_string(sizeof(T)) +
+                 " alignof=" + std::to_string(alignof(T)));
+}
+
+// Reads ints at a byte offset from a cache-line aligned buffer: 0 is aligned,
+// 1 is misaligned within a line, 62 makes every 16th int cross a line.
+void BM_UnalignedRead(benchmark::State &state) {
+  const auto offset = static_cast<std::size_t>(state.range(0));
+  constexpr std::size_t count = 1 << 16; // 256 KiB: L2, so the access itself shows
+  std::vector<std::byte> buffer(count * sizeof(int) + 2 * cache_line);
+  auto *base = buffer.data() + (cache_line - reinterpret_cast<std::uintptr_t>(
+                                                 buffer.data()) % cache_line) %
+                                   cache_line;
+  for (auto _ : state) {
+    int sum = 0;
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+      int v;
+      std::memcpy(&v, base + offset + i * sizeof(int), sizeof(int));
+      sum += v;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(count * sizeof(int)));
+}
+
+// One counter per thread. Packed, all counters share a cache line and every
+// increment takes the line away from the other threads; padded, each thread
+// keeps its own line and the threads scale.
+struct packed_counters {
+  std::atomic<std::int64_t> value[16];
+  std::atomic<std::int64_t> &operator[](int i) { return value[i]; }
+};
+
+struct padded_counters {
+  struct alignas(cache_line) slot {
+    std::atomic<std::int64_t> value;
+  };
+  slot value[16];
+  std::atomic<std::int64_t> &operator[](int i) { return value[i].value; }
+};
+
+template <typename Counters> void BM_FalseSharing(benchmark::State &state) {
+  static Counters counters{};
+  auto &mine = counters[state.thread_index()];
+  for (auto _ : state) {
+    for (int i = 0; i < 1024; ++i) {
+      mine.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+} // namespace
+
+BENCHMARK(BM_WorkingSetLatency)->RangeMultiplier(2)->Range(4 << 10, 256 << 20);
+BENCHMARK(BM_WorkingSetBandwidth)->RangeMultiplier(2)->Range(4 << 10, 256 << 20);
+BENCHMARK(BM_Stride)->RangeMultiplier(2)->Range(1, 2048)->ArgName("step");
+BENCHMARK_TEMPLATE(BM_MatrixTraversal, true)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_MatrixTraversal, false)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_StructLayout, Foo1);
+BENCHMARK_TEMPLATE(BM_StructLayout, Foo2);
+BENCHMARK_TEMPLATE(BM_StructLayout, Foo3UnPacked);
+BENCHMARK_TEMPLATE(BM_StructLayout, Foo3);
+BENCHMARK_TEMPLATE(BM_StructLayout, Foo4);
+BENCHMARK_TEMPLATE(BM_StructLayout, Foo2Packed);
+BENCHMARK(BM_UnalignedRead)->Arg(0)->Arg(1)->Arg(62)->ArgName("offset");
+BENCHMARK_TEMPLATE(BM_FalseSharing, packed_counters)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FalseSharing, padded_counters)->ThreadRange(1, 8)->UseRealTime();
+
+int main(int argc, char **argv) {
+  return runBenchmarks(argc, argv, "cache_benchmark.json");
+}
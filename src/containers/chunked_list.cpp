@@ -0,0 +1,115 @@
+#include "chunked_list.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+template <typename Container> void print(const Container &c) {
+  for (const auto &x : c) {
+    std::cout << x << " ";
+  }
+  std::cout << std::endl;
+}
+
+// The operations of lists.cpp, on an unrolled_list.
+void listOperations() {
+  std::cout << "-------- lists.cpp on an unrolled_list --------" << std::endl;
+  containers::unrolled_list<int> list_of_numbers;
+  list_of_numbers.push_back(1);
+  list_of_numbers.push_back(2);
+  list_of_numbers.push_back(2);
+  list_of_numbers.push_back(3);
+  list_of_numbers.push_back(4);
+  list_of_numbers.push_front(0);
+  print(list_of_numbers);
+
+  std::cout << "removing second element:" << std::endl;
+  auto itr = list_of_numbers.begin();
+  itr++;
+  list_of_numbers.erase(itr);
+  print(list_of_numbers);
+
+  std::cout << "delete all elements with value 2:" << std::endl;
+  list_of_numbers.remove(2);
+  print(list_of_numbers);
+
+  std::cout << "delete all even numbers:" << std::endl;
+  list_of_numbers.remove_if([](int x) { return x % 2 == 0; });
+  print(list_of_numbers);
+
+  std::cout << "front: " << list_of_numbers.front() << ", back: " << list_of_numbers.back()
+            << std::endl;
+}
+
+// Inserting in the middle and erasing while iterating, with small nodes so
+// that they split and merge.
+void insertAndErase() {
+  std::cout << "-------- insert in the middle, erase while iterating --------" << std::endl;
+  containers::unrolled_list<int, 4> list;
+  for (int i = 0; i < 10; ++i) {
+    list.push_back(i * 10);
+  }
+  auto middle = list.begin();
+  for (int i = 0; i < 5; ++i) {
+    ++middle;
+  }
+  for (int i = 1; i <= 3; ++i) {
+    middle = list.insert(middle, 50 - i);
+  }
+  print(list);
+
+  for (auto it = list.begin(); it != list.end();) {
+    it = *it % 20 == 0 ? list.erase(it) : std::next(it);
+  }
+  print(list);
+}
+
+// Inserting a copy of an element of the list itself into a full node: the
+// copy is made before the node is split and half of it moved away.
+void insertOwnElement() {
+  std::cout << "-------- push_front(back()) into a full node --------" << std::endl;
+  containers::unrolled_list<std::string, 4> list;
+  for (const char *word : {"first", "second", "third", "fourth"}) {
+    list.push_back(std::string(word) + ", long enough to live on the heap");
+  }
+  list.push_front(list.back());
+  list.insert(std::next(list.begin(), 3), list.front());
+  print(list);
+  std::cout << (list.front() == list.back() && *std::next(list.begin(), 3) == list.back()
+                    ? "copies intact"
+                    : "COPIES BROKEN")
+            << std::endl;
+}
+
+// Game entities in a colony: the pointers handed out stay valid while other
+// entities come and go, and erased slots are reused.
+void colonyOfEntities() {
+  std::cout << "-------- colony --------" << std::endl;
+  struct entity {
+    std::string name;
+    int health;
+  };
+  containers::colony<entity> entities;
+  std::vector<containers::colony<entity>::iterator> handles;
+  for (const char *name : {"orc", "elf", "dwarf", "troll", "goblin"}) {
+    handles.push_back(entities.insert({name, 100}));
+  }
+  entity *dwarf = &*handles[2];
+
+  entities.erase(handles[1]); // the elf dies
+  entities.erase(handles[3]); // and the troll
+  entities.insert({"wizard", 80}); // takes a freed slot
+  dwarf->health -= 30;             // still the same dwarf
+
+  for (const entity &e : entities) {
+    std::cout << e.name << " (" << e.health << ") ";
+  }
+  std::cout << std::endl << entities.size() << " entities" << std::endl;
+}
+
+int main() {
+  listOperations();
+  insertAndErase();
+  insertOwnElement();
+  colonyOfEntities();
+}
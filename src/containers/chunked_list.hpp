@@ -0,0 +1,654 @@
+#ifndef CHUNKED_LIST_HPP
+#define CHUNKED_LIST_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+///
+/// Linked containers that store their elements in chunks.
+///
+/// std::list allocates every element in its own node, so a traversal is one
+/// dependent pointer load (often a cache miss) per element, and every node
+/// carries two pointers and a malloc header. The containers here keep the
+/// cheap insertion and erasure of a linked list but link chunks of elements:
+///
+/// - unrolled_list<T, K> is a sequence, like std::list: a doubly linked list
+///   of cache-line-aligned nodes holding up to K elements each, in order.
+///   insert() and erase() shift at most K elements and split a full node or
+///   merge a sparse one with its neighbour, so they cost O(K) independent of
+///   size(). They invalidate iterators into the node they touch (and into
+///   its neighbour when nodes split or merge); iterators into all other nodes
+///   stay valid.
+/// - colony<T> is a bag (plf::colony style): the order of elements is not
+///   chosen by the caller. Elements live in blocks of 64 to 8192 slots, a
+///   bitmap per block marks the occupied ones, and erased slots go to a free
+///   list for reuse. insert() and erase() are O(1), and no element ever
+///   moves, so pointers and iterators stay valid until their element is
+///   erased. Traversal skips runs of erased slots a 64-bit word at a time.
+///
+
+namespace containers {
+
+namespace detail {
+
+struct chunk_link {
+  chunk_link *prev;
+  chunk_link *next;
+};
+
+} // namespace detail
+
+template <typename T>
+inline constexpr std::size_t default_chunk_capacity = std::max<std::size_t>(4, 256 / sizeof(T));
+
+template <typename T, std::size_t K = default_chunk_capacity<T>> class unrolled_list {
+  static_assert(K >= 2, "unrolled_list nodes must hold at least two elements");
+
+  // Nodes start on a cache line, so the first elements share a line with the
+  // links and the rest fill whole lines.
+  struct alignas(64) node : detail::chunk_link {
+    std::size_t count = 0;
+    alignas(T) std::byte storage[K * sizeof(T)];
+
+    T *items() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+  };
+
+  template <bool Const> class basic_iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() = default;
+    basic_iterator(const basic_iterator<false> &other) noexcept
+      requires Const
+        : m_link(other.m_link), m_index(other.m_index) {}
+    basic_iterator(const basic_iterator &) noexcept = default;
+    basic_iterator &operator=(const basic_iterator &) noexcept = default;
+
+    reference operator*() const noexcept { return asNode(m_link)->items()[m_index]; }
+    pointer operator->() const noexcept { return &**this; }
+
+    basic_iterator &operator++() noexcept {
+      if (++m_index == asNode(m_link)->count) {
+        m_link = m_link->next;
+        m_index = 0;
+      }
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      basic_iterator old = *this;
+      ++*this;
+      return old;
+    }
+    basic_iterator &operator--() noexcept {
+      if (m_index == 0) {
+        m_link = m_link->prev;
+        m_index = asNode(m_link)->count;
+      }
+      --m_index;
+      return *this;
+    }
+    basic_iterator operator--(int) noexcept {
+      basic_iterator old = *this;
+      --*this;
+      return old;
+    }
+
+    friend bool operator==(const basic_iterator &a, const basic_iterator &b) noexcept {
+      return a.m_link == b.m_link && a.m_index == b.m_index;
+    }
+
+  private:
+    friend class unrolled_list;
+    friend class basic_iterator<true>;
+
+    basic_iterator(detail::chunk_link *link, std::size_t index) noexcept
+        : m_link(link), m_index(index) {}
+
+    detail::chunk_link *m_link = nullptr;
+    std::size_t m_index = 0;
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  static constexpr size_type chunk_capacity = K;
+
+  unrolled_list() noexcept { m_sentinel.prev = m_sentinel.next = &m_sentinel; }
+
+  unrolled_list(std::initializer_list<T> values) : unrolled_list() {
+    for (const T &value : values) {
+      push_back(value);
+    }
+  }
+
+  unrolled_list(const unrolled_list &other) : unrolled_list() {
+    for (const T &value : other) {
+      push_back(value);
+    }
+  }
+
+  unrolled_list(unrolled_list &&other) noexcept : unrolled_list() { swap(other); }
+
+  unrolled_list &operator=(unrolled_list other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~unrolled_list() { clear(); }
+
+  void swap(unrolled_list &other) noexcept {
+    // The sentinels stay where they are; the nodes are relinked to them.
+    const detail::chunk_link mine = m_sentinel;
+    const detail::chunk_link theirs = other.m_sentinel;
+    const bool mine_empty = m_size == 0;
+    adopt(theirs, other.m_size == 0);
+    other.adopt(mine, mine_empty);
+    std::swap(m_size, other.m_size);
+  }
+
+  size_type size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  iterator begin() noexcept { return {m_sentinel.next, 0}; }
+  iterator end() noexcept { return {&m_sentinel, 0}; }
+  const_iterator begin() const noexcept { return {m_sentinel.next, 0}; }
+  const_iterator end() const noexcept {
+    return {const_cast<detail::chunk_link *>(&m_sentinel), 0};
+  }
+
+  reference front() noexcept { return *begin(); }
+  const_reference front() const noexcept { return *begin(); }
+  reference back() noexcept { return *--end(); }
+  const_reference back() const noexcept { return *--end(); }
+
+  template <typename... Args> reference emplace_back(Args &&...args) {
+    return *emplace(end(), std::forward<Args>(args)...);
+  }
+  template <typename... Args> reference emplace_front(Args &&...args) {
+    return *emplace(begin(), std::forward<Args>(args)...);
+  }
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+  void push_front(const T &value) { emplace_front(value); }
+  void push_front(T &&value) { emplace_front(std::move(value)); }
+  void pop_back() { erase(--end()); }
+  void pop_front() { erase(begin()); }
+
+  iterator insert(const_iterator pos, const T &value) { return emplace(pos, value); }
+  iterator insert(const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+
+  /// Inserts before pos. At the start of a node the element goes to the end
+  /// of the previous node if that has room; a full node is split in half.
+  template <typename... Args> iterator emplace(const_iterator pos, Args &&...args) {
+    // Build the value first: args may refer to an element that the split or
+    // the shift below moves.
+    T value(std::forward<Args>(args)...);
+    detail::chunk_link *link = pos.m_link;
+    std::size_t index = pos.m_index;
+    if (index == 0 && link->prev != &m_sentinel && asNode(link->prev)->count < K) {
+      link = link->prev;
+      index = asNode(link)->count;
+    } else if (link == &m_sentinel) {
+      link = newNode(&m_sentinel);
+    }
+    node *n = asNode(link);
+    if (n->count == K) {
+      node *upper = asNode(newNode(n->next));
+      relocate(n->items() + K / 2, K - K / 2, upper->items());
+      upper->count = K - K / 2;
+      n->count = K / 2;
+      if (index > K / 2) {
+        n = upper;
+        index -= K / 2;
+      }
+    }
+    T *items = n->items();
+    if (index == n->count) {
+      try {
+        std::construct_at(items + index, std::move(value));
+      } catch (...) {
+        if (n->count == 0) {
+          deleteNode(n);
+        }
+        throw;
+      }
+    } else {
+      std::construct_at(items + n->count, std::move(items[n->count - 1]));
+      std::move_backward(items + index, items + n->count - 1, items + n->count);
+      items[index] = std::move(value);
+    }
+    ++n->count;
+    ++m_size;
+    return {n, index};
+  }
+
+  /// Returns the iterator to the element after the erased one. A node that
+  /// drops below a quarter full takes in its successor if both fit.
+  iterator erase(const_iterator pos) {
+    node *n = asNode(pos.m_link);
+    std::size_t index = pos.m_index;
+    T *items = n->items();
+    std::move(items + index + 1, items + n->count, items + index);
+    std::destroy_at(items + n->count - 1);
+    --n->count;
+    --m_size;
+
+    if (n->count == 0) {
+      detail::chunk_link *next = n->next;
+      deleteNode(n);
+      return {next, 0};
+    }
+    if (n->count < K / 4 && n->next != &m_sentinel &&
+        n->count + asNode(n->next)->count <= K / 2) {
+      node *next = asNode(n->next);
+      relocate(next->items(), next->count, items + n->count);
+      n->count += next->count;
+      next->count = 0;
+      deleteNode(next);
+    }
+    if (index == n->count) {
+      return {n->next, 0};
+    }
+    return {n, index};
+  }
+
+  /// Erases every element for which pred is true, compacting each node in a
+  /// single pass. Returns the number of erased elements.
+  template <typename Pred> size_type remove_if(Pred pred) {
+    const size_type before = m_size;
+    for (detail::chunk_link *link = m_sentinel.next; link != &m_sentinel;) {
+      node *n = asNode(link);
+      link = link->next;
+      T *items = n->items();
+      T *kept = std::remove_if(items, items + n->count, pred);
+      const std::size_t remaining = static_cast<std::size_t>(kept - items);
+      std::destroy(kept, items + n->count);
+      m_size -= n->count - remaining;
+      n->count = remaining;
+      if (remaining == 0) {
+        deleteNode(n);
+      }
+    }
+    return before - m_size;
+  }
+
+  size_type remove(const T &value) {
+    return remove_if([&value](const T &x) { return x == value; });
+  }
+
+  void clear() noexcept {
+    for (detail::chunk_link *link = m_sentinel.next; link != &m_sentinel;) {
+      node *n = asNode(link);
+      link = link->next;
+      std::destroy_n(n->items(), n->count);
+      delete n;
+    }
+    m_sentinel.prev = m_sentinel.next = &m_sentinel;
+    m_size = 0;
+  }
+
+private:
+  detail::chunk_link m_sentinel;
+  size_type m_size = 0;
+
+  static node *asNode(detail::chunk_link *link) noexcept { return static_cast<node *>(link); }
+
+  // Makes the nodes between links.next and links.prev ours.
+  void adopt(const detail::chunk_link &links, bool empty) noexcept {
+    if (empty) {
+      m_sentinel.prev = m_sentinel.next = &m_sentinel;
+      return;
+    }
+    m_sentinel = links;
+    m_sentinel.prev->next = &m_sentinel;
+    m_sentinel.next->prev = &m_sentinel;
+  }
+
+  // A new empty node linked in before `before`.
+  detail::chunk_link *newNode(detail::chunk_link *before) {
+    node *n = new node;
+    n->prev = before->prev;
+    n->next = before;
+    before->prev->next = n;
+    before->prev = n;
+    return n;
+  }
+
+  void deleteNode(node *n) noexcept {
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    delete n;
+  }
+
+  static void relocate(T *from, std::size_t count, T *to) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      std::memcpy(static_cast<void *>(to), from, count * sizeof(T));
+    } else {
+      std::uninitialized_move_n(from, count, to);
+      std::destroy_n(from, count);
+    }
+  }
+};
+
+template <typename T> class colony {
+  // An erased slot holds the link of its block's free list.
+  union slot {
+    slot() noexcept {}
+    ~slot() {}
+    T value;
+    slot *next_free;
+  };
+
+  struct block {
+    explicit block(std::size_t capacity_)
+        : capacity(capacity_), bits(std::make_unique<std::uint64_t[]>(capacity_ / 64 + 1)),
+          slots(std::allocator<slot>().allocate(capacity_)) {}
+    ~block() { std::allocator<slot>().deallocate(slots, capacity); }
+
+    std::size_t capacity;
+    std::size_t count = 0;
+    // Slots [0, used) have been handed out at least once.
+    std::size_t used = 0;
+    // One bit per slot, plus a zero word so that the slot after the last can
+    // be tested.
+    std::unique_ptr<std::uint64_t[]> bits;
+    slot *slots;
+    slot *free_head = nullptr;
+    block *prev = nullptr;
+    block *next = nullptr;
+    // Membership in the list of blocks that have a free slot below `used`.
+    block *prev_with_free = nullptr;
+    block *next_with_free = nullptr;
+
+    bool occupied(std::size_t i) const noexcept { return (bits[i / 64] >> (i % 64)) & 1; }
+
+    // The first occupied slot at or after i, or capacity.
+    std::size_t firstOccupied(std::size_t i) const noexcept {
+      while (i < used) {
+        const std::uint64_t word = bits[i / 64] >> (i % 64);
+        if (word != 0) {
+          return i + static_cast<std::size_t>(std::countr_zero(word));
+        }
+        i = (i / 64 + 1) * 64;
+      }
+      return capacity;
+    }
+  };
+
+  template <bool Const> class basic_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+    using reference = std::conditional_t<Const, const T &, T &>;
+
+    basic_iterator() = default;
+    basic_iterator(const basic_iterator<false> &other) noexcept
+      requires Const
+        : m_block(other.m_block), m_index(other.m_index) {}
+    basic_iterator(const basic_iterator &) noexcept = default;
+    basic_iterator &operator=(const basic_iterator &) noexcept = default;
+
+    reference operator*() const noexcept { return m_block->slots[m_index].value; }
+    pointer operator->() const noexcept { return &**this; }
+
+    basic_iterator &operator++() noexcept {
+      // Testing the next slot first keeps the index out of the load's
+      // dependency chain, so traversing a dense block runs ahead speculatively.
+      const std::size_t next = m_index + 1;
+      if ((m_block->bits[next / 64] >> (next % 64)) & 1) {
+        m_index = next;
+      } else {
+        seek(m_block, next);
+      }
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      basic_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const basic_iterator &a, const basic_iterator &b) noexcept {
+      return a.m_block == b.m_block && a.m_index == b.m_index;
+    }
+
+  private:
+    friend class colony;
+    friend class basic_iterator<true>;
+
+    basic_iterator(block *b, std::size_t index) noexcept : m_block(b), m_index(index) {}
+
+    // The first element at or after slot i of b, or in the blocks after it.
+    static basic_iterator at(block *b, std::size_t i) noexcept {
+      basic_iterator it;
+      it.seek(b, i);
+      return it;
+    }
+
+    void seek(block *b, std::size_t i) noexcept {
+      for (; b != nullptr; b = b->next, i = 0) {
+        i = b->firstOccupied(i);
+        if (i < b->capacity) {
+          m_block = b;
+          m_index = i;
+          return;
+        }
+      }
+      m_block = nullptr;
+      m_index = 0;
+    }
+
+    block *m_block = nullptr;
+    std::size_t m_index = 0;
+  };
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  static constexpr size_type min_block_capacity = 64;
+  static constexpr size_type max_block_capacity = 8192;
+
+  colony() noexcept = default;
+
+  colony(const colony &other) : colony() {
+    for (const T &value : other) {
+      insert(value);
+    }
+  }
+
+  colony(colony &&other) noexcept { swap(other); }
+
+  colony &operator=(colony other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~colony() { clear(); }
+
+  void swap(colony &other) noexcept {
+    std::swap(m_first, other.m_first);
+    std::swap(m_last, other.m_last);
+    std::swap(m_with_free, other.m_with_free);
+    std::swap(m_size, other.m_size);
+  }
+
+  size_type size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  iterator begin() noexcept { return first(); }
+  iterator end() noexcept { return {}; }
+  const_iterator begin() const noexcept { return const_cast<colony *>(this)->first(); }
+  const_iterator end() const noexcept { return {}; }
+
+  /// Puts the element into a previously erased slot if there is one,
+  /// otherwise after the last element. Returns its iterator, which stays
+  /// valid until the element is erased.
+  template <typename... Args> iterator emplace(Args &&...args) {
+    block *b;
+    std::size_t index;
+    slot *s;
+    if (m_with_free != nullptr) {
+      b = m_with_free;
+      s = b->free_head;
+      index = static_cast<std::size_t>(s - b->slots);
+      slot *next_free = s->next_free;
+      std::construct_at(&s->value, std::forward<Args>(args)...);
+      b->free_head = next_free == s ? nullptr : next_free;
+      if (b->free_head == nullptr) {
+        unlinkWithFree(b);
+      }
+    } else {
+      if (m_last == nullptr || m_last->used == m_last->capacity) {
+        appendBlock();
+      }
+      b = m_last;
+      index = b->used;
+      s = b->slots + index;
+      std::construct_at(&s->value, std::forward<Args>(args)...);
+      ++b->used;
+    }
+    b->bits[index / 64] |= std::uint64_t{1} << (index % 64);
+    ++b->count;
+    ++m_size;
+    return {b, index};
+  }
+
+  iterator insert(const T &value) { return emplace(value); }
+  iterator insert(T &&value) { return emplace(std::move(value)); }
+
+  /// Returns the iterator to the next element. A block that becomes empty is
+  /// freed, unless it is the only one.
+  iterator erase(const_iterator pos) {
+    block *b = pos.m_block;
+    const std::size_t index = pos.m_index;
+    slot *s = b->slots + index;
+    std::destroy_at(&s->value);
+    b->bits[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+    --b->count;
+    --m_size;
+
+    if (b->count == 0 && (b->prev != nullptr || b->next != nullptr)) {
+      const iterator next = iterator::at(b->next, 0);
+      removeBlock(b);
+      return next;
+    }
+    if (b->count == 0) {
+      // The lone block starts over instead of keeping a free list.
+      if (b->free_head != nullptr) {
+        unlinkWithFree(b);
+      }
+      b->free_head = nullptr;
+      b->used = 0;
+      return end();
+    }
+    // A slot links to itself to mark the end of its block's free list.
+    s->next_free = b->free_head == nullptr ? s : b->free_head;
+    if (b->free_head == nullptr) {
+      linkWithFree(b);
+    }
+    b->free_head = s;
+    return iterator::at(b, index + 1);
+  }
+
+  template <typename Pred> size_type erase_if(Pred pred) {
+    const size_type before = m_size;
+    for (auto it = begin(); it != end();) {
+      it = pred(*it) ? erase(it) : std::next(it);
+    }
+    return before - m_size;
+  }
+
+  void clear() noexcept {
+    for (block *b = m_first; b != nullptr;) {
+      block *next = b->next;
+      for (std::size_t i = b->firstOccupied(0); i < b->capacity; i = b->firstOccupied(i + 1)) {
+        std::destroy_at(&b->slots[i].value);
+      }
+      delete b;
+      b = next;
+    }
+    m_first = m_last = m_with_free = nullptr;
+    m_size = 0;
+  }
+
+private:
+  block *m_first = nullptr;
+  block *m_last = nullptr;
+  block *m_with_free = nullptr;
+  size_type m_size = 0;
+
+  iterator first() noexcept { return iterator::at(m_first, 0); }
+
+  // Blocks grow with the colony, so small colonies stay small and large
+  // ones need few blocks.
+  void appendBlock() {
+    const std::size_t capacity =
+        std::clamp(std::bit_ceil(m_size / 2 + 1), min_block_capacity, max_block_capacity);
+    block *b = new block(capacity);
+    b->prev = m_last;
+    if (m_last != nullptr) {
+      m_last->next = b;
+    } else {
+      m_first = b;
+    }
+    m_last = b;
+  }
+
+  void removeBlock(block *b) noexcept {
+    if (b->free_head != nullptr) {
+      unlinkWithFree(b);
+    }
+    (b->prev != nullptr ? b->prev->next : m_first) = b->next;
+    (b->next != nullptr ? b->next->prev : m_last) = b->prev;
+    delete b;
+  }
+
+  void linkWithFree(block *b) noexcept {
+    b->prev_with_free = nullptr;
+    b->next_with_free = m_with_free;
+    if (m_with_free != nullptr) {
+      m_with_free->prev_with_free = b;
+    }
+    m_with_free = b;
+  }
+
+  void unlinkWithFree(block *b) noexcept {
+    (b->prev_with_free != nullptr ? b->prev_with_free->next_with_free : m_with_free) =
+        b->next_with_free;
+    if (b->next_with_free != nullptr) {
+      b->next_with_free->prev_with_free = b->prev_with_free;
+    }
+    b->prev_with_free = b->next_with_free = nullptr;
+  }
+};
+
+} // namespace containers
+
+#endif
@@ -0,0 +1,136 @@
+// std::list against unrolled_list and colony, with std::vector as the
+// baseline for traversal:
+// - Traverse: summing n ints. "fresh" lists were filled by push_back into an
+//   empty heap, so their nodes happen to be adjacent in memory; "scattered"
+//   lists were sorted after being filled with random values, so following the
+//   links jumps around the heap as it does in a long-lived program
+// - InsertMiddle: 1000 inserts at an iterator into the middle of n elements
+//   (for std::vector, at an index)
+// - EraseWhileIterating: erasing every other element of n with
+//   `it = c.erase(it)`; std::vector with erase-remove_if for comparison
+#include "chunked_list.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <random>
+#include <vector>
+
+namespace {
+
+using std_list = std::list<int>;
+using std_vector = std::vector<int>;
+using unrolled_list = containers::unrolled_list<int>;
+using colony = containers::colony<int>;
+
+// std::list whose node order no longer matches the allocation order.
+struct scattered_list : std::list<int> {};
+
+template <typename Container> Container fill(std::size_t n) {
+  Container c;
+  for (std::size_t i = 0; i < n; ++i) {
+    c.insert(c.end(), static_cast<int>(i));
+  }
+  return c;
+}
+
+template <> colony fill<colony>(std::size_t n) {
+  colony c;
+  for (std::size_t i = 0; i < n; ++i) {
+    c.insert(static_cast<int>(i));
+  }
+  return c;
+}
+
+template <> scattered_list fill<scattered_list>(std::size_t n) {
+  std::mt19937 gen(42);
+  scattered_list c;
+  for (std::size_t i = 0; i < n; ++i) {
+    c.push_back(static_cast<int>(gen() % n));
+  }
+  c.sort();
+  return c;
+}
+
+template <typename Container> void BM_Traverse(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto c = fill<Container>(n);
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (int x : c) {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+}
+
+template <typename Container> typename Container::iterator middleOf(Container &c) {
+  return std::next(c.begin(), static_cast<std::ptrdiff_t>(c.size() / 2));
+}
+
+template <typename Container> void BM_InsertMiddle(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto c = fill<Container>(n);
+  auto it = middleOf(c);
+  for (auto _ : state) {
+    for (int i = 0; i < 1000; ++i) {
+      it = c.insert(it, i);
+    }
+    benchmark::DoNotOptimize(&*it);
+    // Back to the same n elements for the next round, untimed.
+    state.PauseTiming();
+    for (int i = 0; i < 1000; ++i) {
+      it = c.erase(it);
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+template <typename Container> void BM_EraseWhileIterating(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto c = fill<Container>(n);
+    state.ResumeTiming();
+    if constexpr (std::is_same_v<Container, std_vector>) {
+      c.erase(std::remove_if(c.begin(), c.end(), [](int x) { return x % 2 == 0; }), c.end());
+    } else {
+      for (auto it = c.begin(); it != c.end();) {
+        it = *it % 2 == 0 ? c.erase(it) : std::next(it);
+      }
+    }
+    benchmark::DoNotOptimize(c.size());
+    state.PauseTiming();
+    c = Container();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n));
+}
+
+void sizes(benchmark::internal::Benchmark *b) {
+  b->ArgName("n")->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Traverse, std_list)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Traverse, scattered_list)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Traverse, std_vector)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Traverse, unrolled_list)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Traverse, colony)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(BM_InsertMiddle, std_list)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_InsertMiddle, std_vector)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_InsertMiddle, unrolled_list)->Apply(sizes);
+
+BENCHMARK_TEMPLATE(BM_EraseWhileIterating, std_list)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_EraseWhileIterating, std_vector)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_EraseWhileIterating, unrolled_list)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_EraseWhileIterating, colony)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,90 @@
+#include "flat_hash_map.hpp"
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// wordFrequencyInString() from set_map_pair_tuple.cpp, without a node
+// allocation per word and without a std::string per lookup: the words are
+// string_views into the text, and a key string is built only the first time
+// a word is seen.
+void wordFrequencyInString() {
+  std::cout << "-------- word frequency --------" << std::endl;
+  containers::string_map<int> wordFreq;
+  std::string_view str = "a a b d c a d x";
+
+  while (!str.empty()) {
+    const std::size_t end = str.find(' ');
+    std::string_view word = str.substr(0, end);
+    if (!word.empty()) {
+      wordFreq[word]++;
+    }
+    str.remove_prefix(end == std::string_view::npos ? str.size() : end + 1);
+  }
+
+  for (const auto &[word, count] : wordFreq) {
+    std::cout << "(" << word << ", " << count << ")\n";
+  }
+  std::cout << "\"a\" occurs " << wordFreq.at("a") << " times, \"z\" is "
+            << (wordFreq.contains("z") ? "" : "not ") << "present" << std::endl;
+}
+
+// The student key from hash.cpp: any key with std::hash (or a Hash argument)
+// and operator== works.
+class student {
+public:
+  int id;
+  std::string first_name;
+  std::string last_name;
+
+  bool operator==(const student &other) const {
+    return (first_name == other.first_name && last_name == other.last_name &&
+            id == other.id);
+  }
+};
+
+struct KeyHasher {
+  std::size_t operator()(const student &k) const {
+    return ((std::hash<std::string>()(k.first_name) ^
+             (std::hash<std::string>()(k.last_name) << 1)) >>
+            1) ^
+           (std::hash<int>()(k.id) << 1);
+  }
+};
+
+void customKeyType() {
+  std::cout << "-------- custom key type --------" << std::endl;
+  containers::flat_hash_map<student, std::string, KeyHasher> students = {
+      {{1, "John", "Doe"}, "example"}, {{2, "Mary", "Sue"}, "another"}};
+  students.insert_or_assign({3, "Jane", "Roe"}, "third");
+  students.erase({2, "Mary", "Sue"});
+  for (const auto &[s, note] : students) {
+    std::cout << s.id << " " << s.first_name << " " << s.last_name << ": " << note
+              << std::endl;
+  }
+}
+
+void sizeOfTheHashTable() {
+  std::cout << "-------- size of the table --------" << std::endl;
+  containers::flat_hash_map<int, int> squares;
+  for (int i = 0; i < 1000; ++i) {
+    squares[i] = i * i;
+    if (squares.size() == squares.capacity() * 7 / 8) {
+      std::cout << "size " << squares.size() << " fills " << squares.capacity()
+                << " slots to the 7/8 load limit; the next insert doubles the table"
+                << std::endl;
+    }
+  }
+  std::cout << "load factor at 1000 elements: " << squares.load_factor() << std::endl;
+
+  // No tombstones: erased slots are simply empty again.
+  erase_if(squares, [](const auto &kv) { return kv.first % 2 == 1; });
+  std::cout << "after erasing the odd keys: " << squares.size() << " elements, "
+            << squares.capacity() << " slots" << std::endl;
+}
+
+int main() {
+  wordFrequencyInString();
+  customKeyType();
+  sizeOfTheHashTable();
+}
@@ -0,0 +1,615 @@
+#ifndef FLAT_HASH_MAP_HPP
+#define FLAT_HASH_MAP_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_MAP_SSE2 1
+#endif
+
+///
+/// An open-addressing hash map in the style of Swiss tables.
+///
+/// Elements live directly in one flat array of slots, so inserting does not
+/// allocate a node per key as std::unordered_map does. The slots are split
+/// into groups of 15. Each group has a 16-byte metadata word: one byte per
+/// slot (0 = empty, otherwise 7-8 bits of the key's hash) and one overflow
+/// byte.
+///
+/// - A lookup hashes the key once, picks a group, and compares all 15
+///   metadata bytes with one SSE2 instruction. Only slots whose byte matches
+///   are compared with the key: usually exactly one on a hit, none on a miss.
+/// - When an insert finds a group full it sets one of the 8 overflow bits
+///   (chosen by the hash) and moves to the next group, probing
+///   quadratically. A lookup stops at the first group whose overflow bit for
+///   its hash is clear, so a miss usually costs one group.
+/// - Erase only clears the slot's metadata byte. There are no tombstones:
+///   stale overflow bits can lengthen later probes, so each erase from an
+///   overflowed group lowers the load limit a little, and the next growth
+///   rebuilds the table without them (the scheme of boost::unordered_flat_map).
+///
+/// With a transparent Hash and KeyEqual, as in string_map<T>, find(),
+/// contains(), erase(), try_emplace() and operator[] accept any key type the
+/// functors accept, e.g. std::string_view for std::string keys, without
+/// building a temporary key.
+///
+/// Differences from std::unordered_map: growing moves the elements, so
+/// iterators, pointers and references are invalidated by any insert that
+/// grows the table; erase(iterator) returns nothing; there is no bucket
+/// interface.
+///
+
+namespace containers {
+
+namespace detail {
+
+constexpr std::size_t group_slots = 15;
+
+struct alignas(16) hash_group {
+  std::uint8_t meta[group_slots];
+  std::uint8_t overflow;
+
+  // Bit i set if slot i has metadata `value`.
+  std::uint32_t match(std::uint8_t value) const noexcept {
+#ifdef FLAT_HASH_MAP_SSE2
+    const __m128i word = _mm_load_si128(reinterpret_cast<const __m128i *>(this));
+    const auto mask = static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(word, _mm_set1_epi8(static_cast<char>(value)))));
+    return mask & 0x7FFF;
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < group_slots; ++i) {
+      mask |= static_cast<std::uint32_t>(meta[i] == value) << i;
+    }
+    return mask;
+#endif
+  }
+
+  std::uint32_t matchEmpty() const noexcept { return match(0); }
+  std::uint32_t matchOccupied() const noexcept { return ~matchEmpty() & 0x7FFF; }
+
+  bool overflowed(std::size_t hash) const noexcept {
+    return overflow & overflowBit(hash);
+  }
+  void markOverflow(std::size_t hash) noexcept { overflow |= overflowBit(hash); }
+
+  static std::uint8_t overflowBit(std::size_t hash) noexcept {
+    return static_cast<std::uint8_t>(1u << ((hash >> 8) & 7));
+  }
+};
+
+// Every empty map points at this group, so find() needs no null check.
+inline hash_group empty_hash_group{};
+
+// Spreads the bits of std::hash, which is the identity for integers, over the
+// whole word. The low 8 bits become the metadata byte, bits 8-10 the overflow
+// bit and bits 11 and up the group index, so the three are independent.
+inline std::size_t mixHash(std::size_t hash) noexcept {
+  std::uint64_t h = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+  return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
+inline std::uint8_t metaByte(std::size_t hash) noexcept {
+  const auto byte = static_cast<std::uint8_t>(hash);
+  return byte == 0 ? 1 : byte; // 0 marks an empty slot
+}
+
+} // namespace detail
+
+/// A hash for std::string keys that also accepts std::string_view and C
+/// strings: std::hash<std::string> and std::hash<std::string_view> agree.
+struct string_hash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view s) const noexcept {
+    return std::hash<std::string_view>{}(s);
+  }
+};
+
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map {
+  // Heterogeneous lookup needs both functors to opt in, as for std::unordered_map.
+  template <typename K>
+  static constexpr bool lookup_key =
+      std::is_same_v<std::remove_cvref_t<K>, Key> ||
+      (requires { typename Hash::is_transparent; } &&
+       requires { typename KeyEqual::is_transparent; });
+
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+
+  template <bool Const> class basic_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = flat_hash_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+    basic_iterator() = default;
+    basic_iterator(const basic_iterator<false> &other) noexcept
+      requires Const
+        : m_map(other.m_map), m_group(other.m_group), m_offset(other.m_offset) {}
+    basic_iterator(const basic_iterator &) noexcept = default;
+    basic_iterator &operator=(const basic_iterator &) noexcept = default;
+
+    reference operator*() const noexcept {
+      return m_map->m_slots[m_group * detail::group_slots + m_offset];
+    }
+    pointer operator->() const noexcept { return &**this; }
+
+    basic_iterator &operator++() noexcept {
+      ++m_offset;
+      skipEmpty();
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+      basic_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const basic_iterator &a, const basic_iterator &b) noexcept {
+      return a.m_group == b.m_group && a.m_offset == b.m_offset;
+    }
+
+  private:
+    friend class flat_hash_map;
+    template <bool> friend class basic_iterator;
+    using map_pointer = std::conditional_t<Const, const flat_hash_map *, flat_hash_map *>;
+
+    basic_iterator(map_pointer map, std::size_t group, std::size_t offset) noexcept
+        : m_map(map), m_group(group), m_offset(offset) {}
+
+    // Moves to the next occupied slot at or after the current one, a group
+    // at a time.
+    void skipEmpty() noexcept {
+      const std::size_t groups = m_map->groupCount();
+      while (m_group < groups) {
+        const std::uint32_t occupied =
+            m_map->m_groups[m_group].matchOccupied() >> m_offset;
+        if (occupied != 0) {
+          m_offset += static_cast<std::size_t>(std::countr_zero(occupied));
+          return;
+        }
+        ++m_group;
+        m_offset = 0;
+      }
+      m_offset = 0;
+    }
+
+    map_pointer m_map = nullptr;
+    std::size_t m_group = 0;
+    std::size_t m_offset = 0;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  flat_hash_map() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                           std::is_nothrow_default_constructible_v<KeyEqual>) = default;
+
+  explicit flat_hash_map(size_type expected, const Hash &hash = Hash(),
+                         const KeyEqual &equal = KeyEqual())
+      : m_hash(hash), m_equal(equal) {
+    reserve(expected);
+  }
+
+  flat_hash_map(std::initializer_list<value_type> values) {
+    reserve(values.size());
+    for (const value_type &value : values) {
+      insert(value);
+    }
+  }
+
+  flat_hash_map(const flat_hash_map &other) : m_hash(other.m_hash), m_equal(other.m_equal) {
+    reserve(other.m_size);
+    for (const value_type &value : other) {
+      emplaceNew(hashOf(value.first), value);
+    }
+  }
+
+  flat_hash_map(flat_hash_map &&other) noexcept
+      : m_groups(std::exchange(other.m_groups, &detail::empty_hash_group)),
+        m_slots(std::exchange(other.m_slots, nullptr)),
+        m_group_mask(std::exchange(other.m_group_mask, 0)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_max_load(std::exchange(other.m_max_load, 0)), m_hash(std::move(other.m_hash)),
+        m_equal(std::move(other.m_equal)) {}
+
+  flat_hash_map &operator=(flat_hash_map other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~flat_hash_map() {
+    clear();
+    deallocate();
+  }
+
+  void swap(flat_hash_map &other) noexcept {
+    using std::swap;
+    swap(m_groups, other.m_groups);
+    swap(m_slots, other.m_slots);
+    swap(m_group_mask, other.m_group_mask);
+    swap(m_size, other.m_size);
+    swap(m_max_load, other.m_max_load);
+    swap(m_hash, other.m_hash);
+    swap(m_equal, other.m_equal);
+  }
+
+  iterator begin() noexcept {
+    iterator it(this, 0, 0);
+    it.skipEmpty();
+    return it;
+  }
+  const_iterator begin() const noexcept {
+    const_iterator it(this, 0, 0);
+    it.skipEmpty();
+    return it;
+  }
+  iterator end() noexcept { return {this, groupCount(), 0}; }
+  const_iterator end() const noexcept { return {this, groupCount(), 0}; }
+
+  size_type size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+  size_type capacity() const noexcept { return m_slots ? groupCount() * detail::group_slots : 0; }
+  float load_factor() const noexcept {
+    return capacity() ? static_cast<float>(m_size) / static_cast<float>(capacity()) : 0.0f;
+  }
+
+  template <typename K>
+    requires lookup_key<K>
+  iterator find(const K &key) {
+    const std::size_t index = findIndex(key, hashOf(key));
+    return index == npos ? end() : iteratorAt(index);
+  }
+  template <typename K>
+    requires lookup_key<K>
+  const_iterator find(const K &key) const {
+    const std::size_t index = findIndex(key, hashOf(key));
+    return index == npos ? end() : iteratorAt(index);
+  }
+  iterator find(const Key &key) { return find<Key>(key); }
+  const_iterator find(const Key &key) const { return find<Key>(key); }
+
+  template <typename K>
+    requires lookup_key<K>
+  bool contains(const K &key) const {
+    return findIndex(key, hashOf(key)) != npos;
+  }
+  bool contains(const Key &key) const { return contains<Key>(key); }
+
+  template <typename K>
+    requires lookup_key<K>
+  size_type count(const K &key) const {
+    return contains(key) ? 1 : 0;
+  }
+  size_type count(const Key &key) const { return count<Key>(key); }
+
+  template <typename K>
+    requires lookup_key<K>
+  T &at(const K &key) {
+    const std::size_t index = findIndex(key, hashOf(key));
+    if (index == npos) {
+      throw std::out_of_range("flat_hash_map::at: key not found");
+    }
+    return m_slots[index].second;
+  }
+  template <typename K>
+    requires lookup_key<K>
+  const T &at(const K &key) const {
+    return const_cast<flat_hash_map *>(this)->at(key);
+  }
+  T &at(const Key &key) { return at<Key>(key); }
+  const T &at(const Key &key) const { return at<Key>(key); }
+
+  /// Inserts {key, T(args...)} unless the key is present. A heterogeneous
+  /// key is converted to Key only when it is inserted.
+  template <typename K, typename... Args>
+    requires lookup_key<K> && std::is_constructible_v<Key, K &&>
+  std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+    return tryEmplace(std::forward<K>(key), std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args) {
+    return tryEmplace(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args) {
+    return tryEmplace(std::move(key), std::forward<Args>(args)...);
+  }
+
+  template <typename K>
+    requires lookup_key<K> && std::is_constructible_v<Key, K &&>
+  T &operator[](K &&key) {
+    return try_emplace(std::forward<K>(key)).first->second;
+  }
+  T &operator[](const Key &key) { return try_emplace(key).first->second; }
+  T &operator[](Key &&key) { return try_emplace(std::move(key)).first->second; }
+
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return try_emplace(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(value_type &&value) {
+    // value.first is const; the key is copied, the mapped value moved.
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key &key, M &&value) {
+    auto result = try_emplace(key, std::forward<M>(value));
+    if (!result.second) {
+      result.first->second = std::forward<M>(value);
+    }
+    return result;
+  }
+
+  template <typename... Args> std::pair<iterator, bool> emplace(Args &&...args) {
+    value_type value(std::forward<Args>(args)...);
+    return insert(std::move(value));
+  }
+
+  template <typename K>
+    requires lookup_key<K> && (!std::is_convertible_v<const K &, const_iterator>)
+  size_type erase(const K &key) {
+    const std::size_t index = findIndex(key, hashOf(key));
+    if (index == npos) {
+      return 0;
+    }
+    eraseAt(index);
+    return 1;
+  }
+  size_type erase(const Key &key) { return erase<Key>(key); }
+
+  /// Unlike std::unordered_map, returns nothing: erasing never moves other
+  /// elements, so `pos` can simply be incremented before the call.
+  void erase(const_iterator pos) noexcept {
+    eraseAt(pos.m_group * detail::group_slots + pos.m_offset);
+  }
+
+  void clear() noexcept {
+    if (m_size == 0) {
+      return;
+    }
+    for (std::size_t g = 0; g < groupCount(); ++g) {
+      for (std::uint32_t occupied = m_groups[g].matchOccupied(); occupied != 0;
+           occupied &= occupied - 1) {
+        std::destroy_at(&m_slots[g * detail::group_slots +
+                                 static_cast<std::size_t>(std::countr_zero(occupied))]);
+      }
+      m_groups[g] = {};
+    }
+    m_size = 0;
+    m_max_load = maxLoad(groupCount());
+  }
+
+  /// Makes room for `count` elements without growing again.
+  void reserve(size_type count) {
+    if (count == 0) {
+      return;
+    }
+    std::size_t groups = 1;
+    while (maxLoad(groups) < count) {
+      groups *= 2;
+    }
+    if (m_slots == nullptr || groups > groupCount()) {
+      rehash(groups);
+    }
+  }
+
+  hasher hash_function() const { return m_hash; }
+  key_equal key_eq() const { return m_equal; }
+
+private:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  // 7/8 of the slots; beyond that probe sequences get long.
+  static std::size_t maxLoad(std::size_t groups) noexcept {
+    return groups * detail::group_slots * 7 / 8;
+  }
+
+  std::size_t groupCount() const noexcept { return m_slots ? m_group_mask + 1 : 0; }
+
+  // A Hash that declares is_avalanching (hashing::hash does) already spreads
+  // its bits and is used as is.
+  template <typename K> std::size_t hashOf(const K &key) const {
+    if constexpr (requires { typename Hash::is_avalanching; }) {
+      return m_hash(key);
+    } else {
+      return detail::mixHash(m_hash(key));
+    }
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> tryEmplace(K &&key, Args &&...args) {
+    const std::size_t hash = hashOf(key);
+    const std::size_t index = findIndex(key, hash);
+    if (index != npos) {
+      return {iteratorAt(index), false};
+    }
+    return {iteratorAt(emplaceNew(hash, std::piecewise_construct,
+                                  std::forward_as_tuple(std::forward<K>(key)),
+                                  std::forward_as_tuple(std::forward<Args>(args)...))),
+            true};
+  }
+
+  iterator iteratorAt(std::size_t index) noexcept {
+    return {this, index / detail::group_slots, index % detail::group_slots};
+  }
+  const_iterator iteratorAt(std::size_t index) const noexcept {
+    return {this, index / detail::group_slots, index % detail::group_slots};
+  }
+
+  template <typename K> std::size_t findIndex(const K &key, std::size_t hash) const {
+    const std::uint8_t meta = detail::metaByte(hash);
+    std::size_t group = (hash >> 11) & m_group_mask;
+    for (std::size_t step = 1;; ++step) {
+      const detail::hash_group &g = m_groups[group];
+      for (std::uint32_t candidates = g.match(meta); candidates != 0;
+           candidates &= candidates - 1) {
+        const std::size_t index =
+            group * detail::group_slots + static_cast<std::size_t>(std::countr_zero(candidates));
+        if (m_equal(m_slots[index].first, key)) {
+          return index;
+        }
+      }
+      // Quadratic probing over a power-of-two number of groups visits each
+      // group once in group_mask + 1 steps.
+      if (!g.overflowed(hash) || step > m_group_mask) {
+        return npos;
+      }
+      group = (group + step) & m_group_mask;
+    }
+  }
+
+  // Constructs a value_type from args in the first free slot of the key's
+  // probe sequence. The key must not be present.
+  template <typename... Args> std::size_t emplaceNew(std::size_t hash, Args &&...args) {
+    if (m_size < m_max_load) {
+      return place(hash, std::forward<Args>(args)...);
+    }
+    // The arguments may refer into this map; build the element before the
+    // others move.
+    value_type value(std::forward<Args>(args)...);
+    // Grow, or rebuild at the same size when erasures have left stale
+    // overflow bits behind and the table is not really full.
+    rehash(m_slots == nullptr                             ? 1
+           : m_size >= maxLoad(groupCount()) * 3 / 4 ? 2 * groupCount()
+                                                       : groupCount());
+    return place(hash, std::move(value));
+  }
+
+  template <typename... Args> std::size_t place(std::size_t hash, Args &&...args) {
+    const std::size_t index = freeSlot(hash);
+    std::construct_at(&m_slots[index], std::forward<Args>(args)...);
+    m_groups[index / detail::group_slots].meta[index % detail::group_slots] =
+        detail::metaByte(hash);
+    ++m_size;
+    return index;
+  }
+
+  std::size_t freeSlot(std::size_t hash) noexcept {
+    std::size_t group = (hash >> 11) & m_group_mask;
+    for (std::size_t step = 1;; ++step) {
+      detail::hash_group &g = m_groups[group];
+      if (const std::uint32_t empty = g.matchEmpty(); empty != 0) {
+        return group * detail::group_slots + static_cast<std::size_t>(std::countr_zero(empty));
+      }
+      g.markOverflow(hash);
+      group = (group + step) & m_group_mask;
+    }
+  }
+
+  void eraseAt(std::size_t index) noexcept {
+    detail::hash_group &g = m_groups[index / detail::group_slots];
+    std::destroy_at(&m_slots[index]);
+    g.meta[index % detail::group_slots] = 0;
+    --m_size;
+    if (g.overflow != 0) {
+      --m_max_load;
+    }
+  }
+
+  void rehash(std::size_t groups) {
+    auto *new_groups = new detail::hash_group[groups]();
+    value_type *new_slots;
+    try {
+      new_slots = std::allocator<value_type>().allocate(groups * detail::group_slots);
+    } catch (...) {
+      delete[] new_groups;
+      throw;
+    }
+
+    detail::hash_group *old_groups = m_groups;
+    value_type *old_slots = m_slots;
+    const std::size_t old_count = groupCount();
+    m_groups = new_groups;
+    m_slots = new_slots;
+    m_group_mask = groups - 1;
+    m_max_load = maxLoad(groups);
+
+    for (std::size_t g = 0; g < old_count; ++g) {
+      for (std::uint32_t occupied = old_groups[g].matchOccupied(); occupied != 0;
+           occupied &= occupied - 1) {
+        value_type &value =
+            old_slots[g * detail::group_slots + static_cast<std::size_t>(std::countr_zero(occupied))];
+        const std::size_t hash = hashOf(value.first);
+        const std::size_t index = freeSlot(hash);
+        // The old slot is destroyed right after and never read again, so its
+        // key can be moved from despite being const (as boost and folly do).
+        std::construct_at(&m_slots[index], std::move(const_cast<Key &>(value.first)),
+                          std::move(value.second));
+        m_groups[index / detail::group_slots].meta[index % detail::group_slots] =
+            detail::metaByte(hash);
+        std::destroy_at(&value);
+      }
+    }
+    if (old_slots != nullptr) {
+      std::allocator<value_type>().deallocate(old_slots, old_count * detail::group_slots);
+      delete[] old_groups;
+    }
+  }
+
+  void deallocate() noexcept {
+    if (m_slots != nullptr) {
+      std::allocator<value_type>().deallocate(m_slots, groupCount() * detail::group_slots);
+      delete[] m_groups;
+    }
+    m_groups = &detail::empty_hash_group;
+    m_slots = nullptr;
+    m_group_mask = 0;
+    m_max_load = 0;
+  }
+
+  detail::hash_group *m_groups = &detail::empty_hash_group;
+  value_type *m_slots = nullptr;
+  std::size_t m_group_mask = 0;
+  std::size_t m_size = 0;
+  std::size_t m_max_load = 0;
+  [[no_unique_address]] Hash m_hash;
+  [[no_unique_address]] KeyEqual m_equal;
+};
+
+/// Erases every element for which pred(element) is true; returns how many.
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Pred>
+std::size_t erase_if(flat_hash_map<Key, T, Hash, KeyEqual> &map, Pred pred) {
+  std::size_t erased = 0;
+  for (auto it = map.begin(); it != map.end();) {
+    auto current = it++;
+    if (pred(*current)) {
+      map.erase(current);
+      ++erased;
+    }
+  }
+  return erased;
+}
+
+/// A map from std::string that is looked up with std::string_view or C
+/// strings without allocating.
+template <typename T>
+using string_map = flat_hash_map<std::string, T, string_hash, std::equal_to<>>;
+
+} // namespace containers
+
+#endif
@@ -0,0 +1,185 @@
+// containers::flat_hash_map against std::unordered_map, with 64-bit keys at
+// 1e3 to 1e7 keys:
+// - insert into an empty map (growing as it goes)
+// - find of keys that are present, and of keys that are not
+// - erase and re-insert
+// - string keys looked up by std::string_view, where the flat map uses
+//   heterogeneous lookup and std::unordered_map builds a std::string
+//
+// 1e8 keys need about 6 GiB for std::unordered_map; build with
+// -DFLAT_HASH_MAP_BENCHMARK_MAX_KEYS=100000000 on a machine that has it.
+#include "flat_hash_map.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef FLAT_HASH_MAP_BENCHMARK_MAX_KEYS
+#define FLAT_HASH_MAP_BENCHMARK_MAX_KEYS 10000000
+#endif
+
+namespace {
+
+using std_map = std::unordered_map<std::uint64_t, std::uint64_t>;
+using flat_map = containers::flat_hash_map<std::uint64_t, std::uint64_t>;
+
+// Present keys are even, absent keys odd.
+std::vector<std::uint64_t> presentKeys(std::size_t n) {
+  std::mt19937_64 gen(42);
+  std::vector<std::uint64_t> keys(n);
+  for (auto &k : keys) {
+    k = gen() & ~std::uint64_t{1};
+  }
+  return keys;
+}
+
+std::vector<std::uint64_t> absentKeys(std::size_t n) {
+  std::mt19937_64 gen(7);
+  std::vector<std::uint64_t> keys(n);
+  for (auto &k : keys) {
+    k = gen() | 1;
+  }
+  return keys;
+}
+
+// Lookups cycle through 64K keys drawn from the map, in random order, so a
+// large map is probed all over and not just in the part that fits the cache.
+std::vector<std::uint64_t> sampleKeys(const std::vector<std::uint64_t> &keys) {
+  std::mt19937_64 gen(1);
+  std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+  std::vector<std::uint64_t> sample(1 << 16);
+  for (auto &k : sample) {
+    k = keys[pick(gen)];
+  }
+  return sample;
+}
+
+template <typename Map> Map buildMap(const std::vector<std::uint64_t> &keys) {
+  Map map;
+  for (std::uint64_t k : keys) {
+    map.try_emplace(k, k);
+  }
+  return map;
+}
+
+template <typename Map> void BM_Insert(benchmark::State &state) {
+  const auto keys = presentKeys(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    Map map;
+    for (std::uint64_t k : keys) {
+      map.try_emplace(k, k);
+    }
+    benchmark::DoNotOptimize(map.size());
+    state.PauseTiming(); // freeing 1e7 nodes is not part of insert
+    map = Map();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map, bool Hit> void BM_Find(benchmark::State &state) {
+  const auto keys = presentKeys(static_cast<std::size_t>(state.range(0)));
+  const Map map = buildMap<Map>(keys);
+  const auto queries = Hit ? sampleKeys(keys) : absentKeys(1 << 16);
+  std::size_t i = 0;
+  std::uint64_t found = 0;
+  for (auto _ : state) {
+    const auto it = map.find(queries[i++ & 0xFFFF]);
+    found += it != map.end() ? it->second : 0;
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Erases a batch of keys and puts them back, so the map keeps its size; the
+// re-insert is not timed.
+template <typename Map> void BM_Erase(benchmark::State &state) {
+  const auto keys = presentKeys(static_cast<std::size_t>(state.range(0)));
+  Map map = buildMap<Map>(keys);
+  const auto sample = sampleKeys(keys);
+  constexpr std::size_t batch = 1024;
+  std::size_t offset = 0;
+  for (auto _ : state) {
+    std::size_t erased = 0;
+    for (std::size_t i = 0; i < batch; ++i) {
+      erased += map.erase(sample[offset + i]);
+    }
+    benchmark::DoNotOptimize(erased);
+    state.PauseTiming();
+    for (std::size_t i = 0; i < batch; ++i) {
+      map.try_emplace(sample[offset + i], sample[offset + i]);
+    }
+    offset = (offset + batch) & 0xFFFF;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch));
+}
+
+// Word-like keys of 4 to 24 characters, looked up through string_views into
+// one text buffer as a tokenizer would produce them.
+template <typename Map> void BM_StringViewFind(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::mt19937_64 gen(3);
+  std::string text;
+  std::vector<std::pair<std::size_t, std::size_t>> words;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::size_t length = 4 + gen() % 21;
+    words.emplace_back(text.size(), length);
+    for (std::size_t c = 0; c < length; ++c) {
+      text.push_back(static_cast<char>('a' + gen() % 26));
+    }
+  }
+  Map map;
+  for (auto [pos, length] : words) {
+    map.try_emplace(text.substr(pos, length), 1);
+  }
+  std::vector<std::string_view> queries;
+  for (std::size_t i = 0; i < 1 << 16; ++i) {
+    auto [pos, length] = words[gen() % n];
+    queries.emplace_back(text.data() + pos, length);
+  }
+
+  std::size_t i = 0;
+  int found = 0;
+  for (auto _ : state) {
+    const std::string_view word = queries[i++ & 0xFFFF];
+    if constexpr (std::is_same_v<Map, std::unordered_map<std::string, int>>) {
+      const auto it = map.find(std::string(word));
+      found += it != map.end() ? it->second : 0;
+    } else {
+      const auto it = map.find(word);
+      found += it != map.end() ? it->second : 0;
+    }
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations());
+}
+
+using std_string_map = std::unordered_map<std::string, int>;
+using flat_string_map = containers::string_map<int>;
+
+void keyCounts(benchmark::internal::Benchmark *b) {
+  for (std::int64_t n = 1000; n <= FLAT_HASH_MAP_BENCHMARK_MAX_KEYS; n *= 10) {
+    b->Arg(n);
+  }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Insert, std_map)->Apply(keyCounts)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Insert, flat_map)->Apply(keyCounts)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Find, std_map, true)->Apply(keyCounts);
+BENCHMARK_TEMPLATE(BM_Find, flat_map, true)->Apply(keyCounts);
+BENCHMARK_TEMPLATE(BM_Find, std_map, false)->Apply(keyCounts);
+BENCHMARK_TEMPLATE(BM_Find, flat_map, false)->Apply(keyCounts);
+BENCHMARK_TEMPLATE(BM_Erase, std_map)->Apply(keyCounts);
+BENCHMARK_TEMPLATE(BM_Erase, flat_map)->Apply(keyCounts);
+BENCHMARK_TEMPLATE(BM_StringViewFind, std_string_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_StringViewFind, flat_string_map)->Arg(1000)->Arg(1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+#include "heap.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename Q> void printQueue(Q q) {
+  while (!q.empty()) {
+    std::cout << q.top() << " ";
+    q.pop();
+  }
+  std::cout << "\n";
+}
+
+// priority_queue() from algorithms_library.cpp with a 4-ary heap: the same
+// push/top/pop interface, and std::less still means "largest on top".
+void priorityQueue() {
+  std::cout << "-------- d_ary_heap --------" << std::endl;
+  containers::d_ary_heap<int> q;
+  for (int n : {1, 8, 5, 6, 3, 4, 0, 9, 7, 2}) {
+    q.push(n);
+  }
+  printQueue(q);
+
+  const std::vector<int> values = {1, 8, 5, 6, 3, 4, 0, 9, 7, 2};
+  containers::d_ary_heap<int, 8, std::greater<>> q2(values.begin(), values.end());
+  printQueue(q2);
+
+  auto comparator = [](int left, int right) { return (left ^ 1) < (right ^ 1); };
+  containers::d_ary_heap<int, 4, decltype(comparator)> q_custom_comparator(comparator);
+  for (int n : values) {
+    q_custom_comparator.push(n);
+  }
+  printQueue(q_custom_comparator);
+}
+
+// customStructPQ(): a min-heap of cells by cost.
+void customStructHeap() {
+  std::cout << "-------- cells by cost --------" << std::endl;
+  struct cell {
+    int index;
+    float cost;
+  };
+  struct CompareCell {
+    bool operator()(const cell &a, const cell &b) const { return a.cost > b.cost; }
+  };
+
+  containers::d_ary_heap<cell, 4, CompareCell> pq;
+  for (const cell &c : {cell{1, 5.0f}, cell{2, 3.0f}, cell{3, 7.0f}, cell{4, 4.0f}}) {
+    pq.push(c);
+  }
+  while (!pq.empty()) {
+    std::cout << "Index: " << pq.top().index << ", Cost: " << pq.top().cost << std::endl;
+    pq.pop();
+  }
+}
+
+// Jobs ordered by deadline, where a deadline can move while the job waits.
+void deadlineScheduler() {
+  std::cout << "-------- indexed_heap --------" << std::endl;
+  const std::vector<std::string> jobs = {"backup", "report", "email", "deploy"};
+  containers::indexed_heap<int, std::greater<>> queue;
+  queue.push(0, 50);
+  queue.push(1, 20);
+  queue.push(2, 30);
+  queue.push(3, 40);
+
+  queue.update(0, 10); // the backup is due first now
+  queue.erase(2);      // the email was cancelled
+  std::cout << "deploy is due at " << queue.priority(3) << std::endl;
+
+  while (!queue.empty()) {
+    std::cout << jobs[queue.top().id] << " at " << queue.top().priority << std::endl;
+    queue.pop();
+  }
+}
+
+struct edge {
+  std::uint32_t to;
+  std::uint32_t weight;
+};
+
+// Shortest distances from node 0, twice: with an indexed heap that moves a
+// node up when a shorter path is found, and with a radix heap, which relies
+// on the distances taken out of the queue never decreasing.
+void shortestPaths() {
+  std::cout << "-------- Dijkstra --------" << std::endl;
+  const std::vector<std::vector<edge>> graph = {
+      {{1, 4}, {2, 1}}, {{3, 1}}, {{1, 2}, {3, 5}}, {{4, 3}}, {}};
+  constexpr std::uint64_t unreached = std::numeric_limits<std::uint64_t>::max();
+
+  std::vector<std::uint64_t> dist(graph.size(), unreached);
+  containers::indexed_heap<std::uint64_t, std::greater<>> queue;
+  dist[0] = 0;
+  queue.push(0, 0);
+  while (!queue.empty()) {
+    const auto [node, d] = queue.top();
+    queue.pop();
+    for (const edge &e : graph[node]) {
+      if (d + e.weight < dist[e.to]) {
+        dist[e.to] = d + e.weight;
+        queue.pushOrImprove(e.to, dist[e.to]);
+      }
+    }
+  }
+
+  std::vector<std::uint64_t> radix_dist(graph.size(), unreached);
+  containers::radix_heap<std::uint64_t, std::uint32_t> radix;
+  radix_dist[0] = 0;
+  radix.push(0, 0);
+  while (!radix.empty()) {
+    const auto [d, node] = radix.top();
+    radix.pop();
+    if (d != radix_dist[node]) {
+      continue; // a shorter path was found after this entry was queued
+    }
+    for (const edge &e : graph[node]) {
+      if (d + e.weight < radix_dist[e.to]) {
+        radix_dist[e.to] = d + e.weight;
+        radix.push(radix_dist[e.to], e.to);
+      }
+    }
+  }
+
+  for (std::size_t v = 0; v < graph.size(); ++v) {
+    std::cout << "node " << v << ": " << dist[v] << " (radix heap: " << radix_dist[v] << ")\n";
+  }
+}
+
+int main() {
+  priorityQueue();
+  customStructHeap();
+  deadlineScheduler();
+  shortestPaths();
+}
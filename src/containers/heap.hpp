@@ -0,0 +1,496 @@
+#ifndef HEAP_HPP
+#define HEAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// Priority queues beyond std::priority_queue.
+///
+/// std::priority_queue is a binary heap: n elements take log2(n) levels, and
+/// below the first few levels every step of a push or pop touches another
+/// cache line. A pop compares two children per level, all the way down.
+///
+/// - d_ary_heap<T, D, Compare>: the same interface with D children per node
+///   (4 or 8). The tree is log2(D) times shallower, and the D children of a
+///   node are adjacent. The storage is laid out so that every group of
+///   siblings starts on a 64-byte boundary: with D * sizeof(T) == 64 (8
+///   integers, or 4 16-byte entries), finding the best child reads exactly
+///   one cache line.
+/// - indexed_heap<Priority, Compare, D>: a d-ary heap of ids 0..n-1 that
+///   knows where each id sits. update() changes the priority of an id that
+///   is already queued in O(log n), which is what Dijkstra's algorithm and
+///   schedulers with changing deadlines need. With std::priority_queue they
+///   push a duplicate instead and skip stale entries when popping.
+/// - radix_heap<Key, T>: a min-queue for unsigned integer keys that never
+///   go below the last key taken out with top() or pop() (Dijkstra
+///   distances, event times). Keys are kept in buckets by the highest bit in
+///   which they differ from that key. Only when the lowest bucket runs empty
+///   is the next bucket scanned and spread out. Every element moves to a
+///   lower bucket at most once per bit, so a pop is amortized O(bits) with
+///   no comparisons between elements.
+///
+/// As with std::priority_queue, top() is the greatest element under
+/// Compare: std::less gives a max-heap, std::greater a min-heap.
+///
+
+namespace containers {
+
+namespace detail {
+
+constexpr std::size_t heap_alignment = 64;
+
+} // namespace detail
+
+template <typename T, std::size_t D = 4, typename Compare = std::less<T>> class d_ary_heap {
+  static_assert(D >= 2, "a heap needs at least two children per node");
+  static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                "sifting and growing move the elements, which must not throw");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using value_compare = Compare;
+  using reference = T &;
+  using const_reference = const T &;
+
+  static constexpr std::size_t arity = D;
+
+  d_ary_heap() = default;
+  explicit d_ary_heap(const Compare &comp) : m_comp(comp) {}
+
+  /// Builds a heap from [first, last) in O(n) (Floyd's method).
+  // This and the copy constructor delegate so that the destructor frees the
+  // storage and the elements built so far if a copy of a T throws.
+  template <std::input_iterator It>
+  d_ary_heap(It first, It last, const Compare &comp = Compare()) : d_ary_heap(comp) {
+    if constexpr (std::forward_iterator<It>) {
+      reserve(static_cast<size_type>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      if (m_size == m_capacity) {
+        reallocate(grownCapacity());
+      }
+      ::new (m_data + m_size) T(*first);
+      ++m_size;
+    }
+    for (size_type i = m_size / D + 1; i-- > 0;) {
+      if (i < m_size) {
+        T value = std::move(m_data[i]);
+        siftDown(i, std::move(value));
+      }
+    }
+  }
+
+  d_ary_heap(const d_ary_heap &other) : d_ary_heap(other.m_comp) {
+    reserve(other.m_size);
+    std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+    m_size = other.m_size;
+  }
+
+  d_ary_heap(d_ary_heap &&other) noexcept
+      : m_base(std::exchange(other.m_base, nullptr)), m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)), m_capacity(std::exchange(other.m_capacity, 0)),
+        m_comp(std::move(other.m_comp)) {}
+
+  d_ary_heap &operator=(d_ary_heap other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~d_ary_heap() {
+    clear();
+    deallocate(m_base, m_capacity);
+  }
+
+  void swap(d_ary_heap &other) noexcept {
+    std::swap(m_base, other.m_base);
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_comp, other.m_comp);
+  }
+
+  bool empty() const noexcept { return m_size == 0; }
+  size_type size() const noexcept { return m_size; }
+  size_type capacity() const noexcept { return m_capacity; }
+  const_reference top() const noexcept { return m_data[0]; }
+
+  void push(const T &value) { emplace(value); }
+  void push(T &&value) { emplace(std::move(value)); }
+
+  template <typename... Args> void emplace(Args &&...args) {
+    if (m_size == m_capacity) {
+      // Build the element first: args may refer into the heap.
+      T value(std::forward<Args>(args)...);
+      reallocate(grownCapacity());
+      siftUp(m_size, std::move(value));
+    } else {
+      siftUp(m_size, T(std::forward<Args>(args)...));
+    }
+    ++m_size;
+  }
+
+  void pop() {
+    --m_size;
+    if (m_size == 0) {
+      std::destroy_at(m_data);
+      return;
+    }
+    T last = std::move(m_data[m_size]);
+    std::destroy_at(m_data + m_size);
+    // Bottom-up: walk the hole at the root down to a leaf, always taking the
+    // best child, then put the former last element there and sift it up. It
+    // came from the bottom and usually stays near it, so this saves the
+    // comparison with it on every level.
+    size_type hole = 0;
+    for (size_type child = firstChild(0); child < m_size; child = firstChild(hole)) {
+      const size_type best = bestChild(child);
+      m_data[hole] = std::move(m_data[best]);
+      hole = best;
+    }
+    siftUp(hole, std::move(last), true);
+  }
+
+  void reserve(size_type count) {
+    if (count > m_capacity) {
+      reallocate(count);
+    }
+  }
+
+  void clear() noexcept {
+    std::destroy_n(m_data, m_size);
+    m_size = 0;
+  }
+
+private:
+  static constexpr size_type firstChild(size_type i) noexcept { return D * i + 1; }
+  static constexpr size_type parent(size_type i) noexcept { return (i - 1) / D; }
+
+  // The child that belongs highest among first..first + D - 1.
+  size_type bestChild(size_type first) const {
+    const size_type last = std::min(first + D, m_size);
+    size_type best = first;
+    for (size_type c = first + 1; c < last; ++c) {
+      if (m_comp(m_data[best], m_data[c])) {
+        best = c;
+      }
+    }
+    return best;
+  }
+
+  // Moves `value` into the hole at i, or above it. The hole is raw storage
+  // unless `constructed`.
+  void siftUp(size_type i, T &&value, bool constructed = false) {
+    while (i > 0) {
+      const size_type p = parent(i);
+      if (!m_comp(m_data[p], value)) {
+        break;
+      }
+      if (constructed) {
+        m_data[i] = std::move(m_data[p]);
+      } else {
+        ::new (m_data + i) T(std::move(m_data[p]));
+        constructed = true;
+      }
+      i = p;
+    }
+    if (constructed) {
+      m_data[i] = std::move(value);
+    } else {
+      ::new (m_data + i) T(std::move(value));
+    }
+  }
+
+  void siftDown(size_type hole, T &&value) {
+    for (size_type child = firstChild(hole); child < m_size; child = firstChild(hole)) {
+      const size_type best = bestChild(child);
+      if (!m_comp(value, m_data[best])) {
+        break;
+      }
+      m_data[hole] = std::move(m_data[best]);
+      hole = best;
+    }
+    m_data[hole] = std::move(value);
+  }
+
+  size_type grownCapacity() const noexcept { return m_capacity == 0 ? 64 : 2 * m_capacity; }
+
+  // Element i lives at m_base[i + D - 1], so the children of i, which start
+  // at D * i + 1, start at m_base[D * (i + 1)]: a multiple of D from an
+  // aligned base.
+  void reallocate(size_type count) {
+    T *base = static_cast<T *>(::operator new((count + D - 1) * sizeof(T),
+                                              std::align_val_t{detail::heap_alignment}));
+    T *data = base + (D - 1);
+    std::uninitialized_move_n(m_data, m_size, data);
+    std::destroy_n(m_data, m_size);
+    deallocate(m_base, m_capacity);
+    m_base = base;
+    m_data = data;
+    m_capacity = count;
+  }
+
+  static void deallocate(T *base, size_type count) noexcept {
+    if (base != nullptr) {
+      ::operator delete(base, (count + D - 1) * sizeof(T), std::align_val_t{detail::heap_alignment});
+    }
+  }
+
+  T *m_base = nullptr;
+  T *m_data = nullptr;
+  size_type m_size = 0;
+  size_type m_capacity = 0;
+  [[no_unique_address]] Compare m_comp;
+};
+
+template <typename Priority, typename Compare = std::less<Priority>, std::size_t D = 4>
+class indexed_heap {
+  static_assert(D >= 2, "a heap needs at least two children per node");
+
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+  /// What top() returns: `auto [id, priority] = heap.top();`
+  struct entry {
+    size_type id;
+    Priority priority;
+  };
+
+  indexed_heap() = default;
+  explicit indexed_heap(const Compare &comp) : m_comp(comp) {}
+
+  bool empty() const noexcept { return m_heap.empty(); }
+  size_type size() const noexcept { return m_heap.size(); }
+  const entry &top() const noexcept { return m_heap.front(); }
+
+  bool contains(size_type id) const noexcept {
+    return id < m_position.size() && m_position[id] != npos;
+  }
+
+  /// The current priority of a queued id.
+  const Priority &priority(size_type id) const { return m_heap[positionOf(id)].priority; }
+
+  /// Makes room for ids below `ids` without reallocating.
+  void reserve(size_type ids) {
+    if (ids > m_position.size()) {
+      m_position.resize(ids, npos);
+    }
+    m_heap.reserve(ids);
+  }
+
+  void push(size_type id, Priority priority) {
+    if (contains(id)) {
+      throw std::invalid_argument("indexed_heap::push: id is already queued");
+    }
+    if (id >= m_position.size()) {
+      m_position.resize(std::max(id + 1, 2 * m_position.size()), npos);
+    }
+    m_heap.push_back({id, std::move(priority)});
+    siftUp(m_heap.size() - 1);
+  }
+
+  /// Changes the priority of a queued id, in either direction.
+  void update(size_type id, Priority priority) {
+    const size_type i = positionOf(id);
+    const bool up = m_comp(m_heap[i].priority, priority);
+    m_heap[i].priority = std::move(priority);
+    if (up) {
+      siftUp(i);
+    } else {
+      siftDown(i);
+    }
+  }
+
+  /// Queues `id`, or moves it up if `priority` ranks above its current one
+  /// (the relax step of Dijkstra). Returns whether anything changed.
+  bool pushOrImprove(size_type id, Priority priority) {
+    if (!contains(id)) {
+      push(id, std::move(priority));
+      return true;
+    }
+    const size_type i = m_position[id];
+    if (!m_comp(m_heap[i].priority, priority)) {
+      return false;
+    }
+    m_heap[i].priority = std::move(priority);
+    siftUp(i);
+    return true;
+  }
+
+  void pop() { removeAt(0); }
+
+  void erase(size_type id) { removeAt(positionOf(id)); }
+
+  void clear() noexcept {
+    for (const entry &e : m_heap) {
+      m_position[e.id] = npos;
+    }
+    m_heap.clear();
+  }
+
+private:
+  size_type positionOf(size_type id) const {
+    if (!contains(id)) {
+      throw std::out_of_range("indexed_heap: id is not queued");
+    }
+    return m_position[id];
+  }
+
+  void removeAt(size_type i) {
+    m_position[m_heap[i].id] = npos;
+    const size_type last = m_heap.size() - 1;
+    if (i != last) {
+      m_heap[i] = std::move(m_heap[last]);
+      m_position[m_heap[i].id] = i;
+      m_heap.pop_back();
+      // The moved-in entry can belong above or below i.
+      if (i > 0 && m_comp(m_heap[(i - 1) / D].priority, m_heap[i].priority)) {
+        siftUp(i);
+      } else {
+        siftDown(i);
+      }
+    } else {
+      m_heap.pop_back();
+    }
+  }
+
+  void siftUp(size_type i) {
+    entry moving = std::move(m_heap[i]);
+    while (i > 0) {
+      const size_type p = (i - 1) / D;
+      if (!m_comp(m_heap[p].priority, moving.priority)) {
+        break;
+      }
+      m_heap[i] = std::move(m_heap[p]);
+      m_position[m_heap[i].id] = i;
+      i = p;
+    }
+    m_position[moving.id] = i;
+    m_heap[i] = std::move(moving);
+  }
+
+  void siftDown(size_type i) {
+    entry moving = std::move(m_heap[i]);
+    const size_type n = m_heap.size();
+    for (size_type child = D * i + 1; child < n; child = D * i + 1) {
+      size_type best = child;
+      for (size_type c = child + 1; c < std::min(child + D, n); ++c) {
+        if (m_comp(m_heap[best].priority, m_heap[c].priority)) {
+          best = c;
+        }
+      }
+      if (!m_comp(moving.priority, m_heap[best].priority)) {
+        break;
+      }
+      m_heap[i] = std::move(m_heap[best]);
+      m_position[m_heap[i].id] = i;
+      i = best;
+    }
+    m_position[moving.id] = i;
+    m_heap[i] = std::move(moving);
+  }
+
+  std::vector<entry> m_heap;
+  std::vector<size_type> m_position; // index in m_heap per id, or npos
+  [[no_unique_address]] Compare m_comp;
+};
+
+template <std::unsigned_integral Key, typename T> class radix_heap {
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = std::size_t;
+
+  bool empty() const noexcept { return m_size == 0; }
+  size_type size() const noexcept { return m_size; }
+
+  /// The element with the smallest key. From now on, pushed keys must not
+  /// be smaller than its key.
+  const value_type &top() const {
+    if (m_buckets[0].empty()) {
+      refill();
+    }
+    return m_buckets[0].back();
+  }
+
+  /// The key must not be smaller than the last key seen through top() or
+  /// popped.
+  template <typename... Args> void emplace(Key key, Args &&...args) {
+    if (key < m_last) {
+      throw std::invalid_argument("radix_heap::push: key is below the last key taken");
+    }
+    m_buckets[bucketOf(key)].emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                                          std::forward_as_tuple(std::forward<Args>(args)...));
+    ++m_size;
+  }
+
+  void push(Key key, const T &value) { emplace(key, value); }
+  void push(Key key, T &&value) { emplace(key, std::move(value)); }
+
+  void pop() {
+    if (m_buckets[0].empty()) {
+      refill();
+    }
+    m_buckets[0].pop_back();
+    --m_size;
+  }
+
+  void clear() noexcept {
+    for (auto &bucket : m_buckets) {
+      bucket.clear();
+    }
+    m_size = 0;
+    m_last = 0;
+  }
+
+private:
+  static constexpr std::size_t bits = std::numeric_limits<Key>::digits;
+
+  // Bucket 0 holds keys equal to m_last, bucket b keys whose highest bit that
+  // differs from m_last is bit b - 1.
+  std::size_t bucketOf(Key key) const noexcept {
+    return static_cast<std::size_t>(std::bit_width(static_cast<Key>(key ^ m_last)));
+  }
+
+  // Bucket 0 ran empty: take the lowest non-empty bucket, make its smallest
+  // key the new m_last, and spread the bucket over the buckets below it.
+  // This only regroups the elements, so top() may do it.
+  void refill() const {
+    std::size_t b = 1;
+    while (m_buckets[b].empty()) {
+      ++b;
+    }
+    auto &bucket = m_buckets[b];
+    m_last = std::min_element(bucket.begin(), bucket.end(), [](const auto &x, const auto &y) {
+               return x.first < y.first;
+             })->first;
+    for (auto &element : bucket) {
+      m_buckets[bucketOf(element.first)].push_back(std::move(element));
+    }
+    bucket.clear();
+  }
+
+  mutable std::array<std::vector<value_type>, bits + 1> m_buckets;
+  size_type m_size = 0;
+  mutable Key m_last = 0; // the smallest key that can still be pushed
+};
+
+} // namespace containers
+
+#endif
@@ -0,0 +1,229 @@
+// The priority queues of heap.hpp against std::priority_queue, with 16-byte
+// elements (a 64-bit key and an id) at 1e6 and 1e7 elements:
+// - push n random keys, then pop them all
+// - hold: a queue of n elements where every step pops the smallest key and
+//   pushes it back a random distance later, the event loop of a simulation.
+//   The keys never decrease, so radix_heap takes part.
+// - Dijkstra's shortest paths on a random graph with 1e6 nodes and 4e6
+//   edges: std::priority_queue and d_ary_heap with duplicate entries,
+//   indexed_heap with pushOrImprove(), and radix_heap.
+#include "heap.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct element {
+  std::uint64_t key;
+  std::uint64_t id;
+};
+
+// "Greater" key first out: these are all min-queues.
+struct later {
+  bool operator()(const element &a, const element &b) const {
+    return a.key > b.key;
+  }
+};
+
+using std_queue = std::priority_queue<element, std::vector<element>, later>;
+using binary_heap = containers::d_ary_heap<element, 2, later>;
+using four_ary_heap = containers::d_ary_heap<element, 4, later>;
+using eight_ary_heap = containers::d_ary_heap<element, 8, later>;
+using radix_queue = containers::radix_heap<std::uint64_t, std::uint64_t>;
+
+// One interface over both kinds of queue.
+template <typename Q>
+void pushElement(Q &q, std::uint64_t key, std::uint64_t id) {
+  if constexpr (std::is_same_v<Q, radix_queue>) {
+    q.push(key, id);
+  } else {
+    q.push({key, id});
+  }
+}
+
+template <typename Q> std::uint64_t topKey(const Q &q) {
+  if constexpr (std::is_same_v<Q, radix_queue>) {
+    return q.top().first;
+  } else {
+    return q.top().key;
+  }
+}
+
+template <typename Q> void BM_PushPopAll(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::mt19937_64 gen(42);
+  std::vector<std::uint64_t> keys(n);
+  for (auto &k : keys) {
+    k = gen() >> 16;
+  }
+  for (auto _ : state) {
+    Q q;
+    for (std::size_t i = 0; i < n; ++i) {
+      pushElement(q, keys[i], i);
+    }
+    std::uint64_t sum = 0;
+    while (!q.empty()) {
+      sum += topKey(q);
+      q.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Q> void BM_Hold(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::mt19937_64 gen(42);
+  Q q;
+  for (std::size_t i = 0; i < n; ++i) {
+    pushElement(q, gen() % (n * 16), i);
+  }
+  std::vector<std::uint64_t> delays(1 << 16);
+  for (auto &d : delays) {
+    d = gen() % (n * 16);
+  }
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::uint64_t key = topKey(q);
+    q.pop();
+    pushElement(q, key + delays[i & 0xFFFF], i);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A random directed graph in compressed sparse row form.
+struct graph {
+  // Node v's edges are [first_edge[v], first_edge[v + 1]).
+  std::vector<std::uint32_t> first_edge;
+  std::vector<std::uint32_t> target;
+  std::vector<std::uint32_t> weight;
+};
+
+const graph &randomGraph() {
+  static const graph g = [] {
+    constexpr std::uint32_t nodes = 1'000'000;
+    constexpr std::uint32_t degree = 4;
+    std::mt19937 gen(7);
+    graph result;
+    for (std::uint32_t v = 0; v <= nodes; ++v) {
+      result.first_edge.push_back(v * degree);
+    }
+    for (std::uint32_t e = 0; e < nodes * degree; ++e) {
+      result.target.push_back(gen() % nodes);
+      result.weight.push_back(1 + gen() % 1000);
+    }
+    return result;
+  }();
+  return g;
+}
+
+constexpr std::uint64_t unreached = std::numeric_limits<std::uint64_t>::max();
+
+// Lazy deletion: a node may be queued several times, and entries whose
+// distance is no longer the node's are skipped.
+template <typename Q> std::vector<std::uint64_t> dijkstraLazy(const graph &g) {
+  std::vector<std::uint64_t> dist(g.first_edge.size() - 1, unreached);
+  Q q;
+  dist[0] = 0;
+  pushElement(q, 0, 0);
+  while (!q.empty()) {
+    const std::uint64_t d = topKey(q);
+    std::uint64_t v;
+    if constexpr (std::is_same_v<Q, radix_queue>) {
+      v = q.top().second;
+    } else {
+      v = q.top().id;
+    }
+    q.pop();
+    if (d != dist[v]) {
+      continue;
+    }
+    for (std::uint32_t e = g.first_edge[v]; e < g.first_edge[v + 1]; ++e) {
+      const std::uint64_t nd = d + g.weight[e];
+      if (nd < dist[g.target[e]]) {
+        dist[g.target[e]] = nd;
+        pushElement(q, nd, g.target[e]);
+      }
+    }
+  }
+  return dist;
+}
+
+// Every node is queued at most once and moved up when a shorter path shows up.
+std::vector<std::uint64_t> dijkstraIndexed(const graph &g) {
+  std::vector<std::uint64_t> dist(g.first_edge.size() - 1, unreached);
+  containers::indexed_heap<std::uint64_t, std::greater<>> q;
+  q.reserve(dist.size());
+  dist[0] = 0;
+  q.push(0, 0);
+  while (!q.empty()) {
+    const auto [v, d] = q.top();
+    q.pop();
+    for (std::uint32_t e = g.first_edge[v]; e < g.first_edge[v + 1]; ++e) {
+      const std::uint64_t nd = d + g.weight[e];
+      if (nd < dist[g.target[e]]) {
+        dist[g.target[e]] = nd;
+        q.pushOrImprove(g.target[e], nd);
+      }
+    }
+  }
+  return dist;
+}
+
+struct indexed {};
+
+template <typename Q> void BM_Dijkstra(benchmark::State &state) {
+  const graph &g = randomGraph();
+  for (auto _ : state) {
+    if constexpr (std::is_same_v<Q, indexed>) {
+      benchmark::DoNotOptimize(dijkstraIndexed(g).data());
+    } else {
+      benchmark::DoNotOptimize(dijkstraLazy<Q>(g).data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(g.target.size()));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_PushPopAll, std_queue)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PushPopAll, binary_heap)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PushPopAll, four_ary_heap)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PushPopAll, eight_ary_heap)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PushPopAll, radix_queue)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Hold, std_queue)->Arg(1000000)->Arg(10000000);
+BENCHMARK_TEMPLATE(BM_Hold, binary_heap)->Arg(1000000)->Arg(10000000);
+BENCHMARK_TEMPLATE(BM_Hold, four_ary_heap)->Arg(1000000)->Arg(10000000);
+BENCHMARK_TEMPLATE(BM_Hold, eight_ary_heap)->Arg(1000000)->Arg(10000000);
+BENCHMARK_TEMPLATE(BM_Hold, radix_queue)->Arg(1000000)->Arg(10000000);
+BENCHMARK_TEMPLATE(BM_Dijkstra, std_queue)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Dijkstra, four_ary_heap)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Dijkstra, indexed)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Dijkstra, radix_queue)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
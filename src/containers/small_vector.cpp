@@ -0,0 +1,135 @@
+#include "small_vector.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Every heap allocation of the program goes through these, as in
+// track_memory_allocations.cpp.
+static std::size_t s_allocations = 0;
+
+void *operator new(std::size_t size) {
+  ++s_allocations;
+  if (void *p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+static bool s_all_ok = true;
+
+// Runs f and compares the number of heap allocations it made with `expected`.
+template <typename F>
+void expectAllocations(const std::string &what, std::size_t expected, F &&f) {
+  const std::size_t before = s_allocations;
+  f();
+  const std::size_t made = s_allocations - before;
+  const bool ok = made == expected;
+  s_all_ok = s_all_ok && ok;
+  std::cout << what << ": " << made << " allocations" << (ok ? "" : "  <-- expected ")
+            << (ok ? "" : std::to_string(expected)) << std::endl;
+}
+
+// vectorPushBack() from vector.cpp: copy 10 ints into a second vector, with
+// the reserve() its comment asks for.
+void vectorPushBack() {
+  std::cout << "-------- vectorPushBack() --------" << std::endl;
+  expectAllocations("std::vector", 2, [] {
+    std::vector<int> src(10, 0);
+    std::vector<int> dst;
+    dst.reserve(src.size());
+    for (auto i : src) {
+      dst.push_back(i);
+    }
+  });
+  expectAllocations("small_vector<int, 16>", 0, [] {
+    containers::small_vector<int, 16> src(10, 0);
+    containers::small_vector<int, 16> dst;
+    for (auto i : src) {
+      dst.push_back(i);
+    }
+  });
+  expectAllocations("static_vector<int, 16>", 0, [] {
+    containers::static_vector<int, 16> src(10, 0);
+    containers::static_vector<int, 16> dst(src.begin(), src.end());
+  });
+}
+
+// Up to N elements the vectors never touch the heap; element N + 1 moves a
+// small_vector to the heap and is an error for a static_vector.
+void inlineCapacity() {
+  std::cout << "-------- inline capacity --------" << std::endl;
+  for (std::size_t n : {0, 1, 8, 16}) {
+    const std::string what = "small_vector<int, 16>, " + std::to_string(n) + " push_backs";
+    expectAllocations(what, 0, [n] {
+      containers::small_vector<int, 16> v;
+      for (std::size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<int>(i));
+      }
+    });
+  }
+  expectAllocations("small_vector<int, 16>, 17 push_backs", 1, [] {
+    containers::small_vector<int, 16> v;
+    for (int i = 0; i < 17; ++i) {
+      v.push_back(i);
+    }
+  });
+
+  // Short strings fit in std::string's own inline buffer, so a vector of
+  // names can live entirely on the stack.
+  expectAllocations("small_vector<std::string, 4>, emplace/insert/erase", 0, [] {
+    containers::small_vector<std::string, 4> names;
+    names.emplace_back("ali");
+    names.emplace_back("baba");
+    names.insert(names.begin(), "behnam");
+    names.erase(names.begin() + 1);
+    auto copy = names;
+    auto moved = std::move(copy);
+  });
+
+  containers::static_vector<int, 16> full;
+  expectAllocations("static_vector<int, 16>, 16 push_backs", 0, [&full] {
+    for (int i = 0; i < 16; ++i) {
+      full.push_back(i);
+    }
+  });
+  try {
+    full.push_back(16);
+  } catch (const std::length_error &e) {
+    std::cout << "17th push_back: " << e.what() << std::endl;
+  }
+}
+
+// The growth policy decides how often the heap block is replaced once the
+// vector has left its inline buffer, and how much of it stays unused.
+template <typename Growth> void growth(const char *name) {
+  containers::small_vector<int, 16, Growth> v;
+  const std::size_t before = s_allocations;
+  for (int i = 0; i < 1000; ++i) {
+    v.push_back(i);
+  }
+  std::cout << name << ": " << s_allocations - before << " allocations, capacity "
+            << v.capacity() << " for " << v.size() << " elements" << std::endl;
+}
+
+void growthPolicies() {
+  std::cout << "-------- growth policy, 1000 push_backs --------" << std::endl;
+  growth<containers::growth::doubling>("doubling");
+  growth<containers::growth::one_and_a_half>("one_and_a_half");
+  growth<containers::growth::exact>("exact");
+}
+
+int main() {
+  vectorPushBack();
+  inlineCapacity();
+  growthPolicies();
+  std::cout << (s_all_ok ? "all allocation counts as expected" : "UNEXPECTED ALLOCATIONS")
+            << std::endl;
+  return s_all_ok ? 0 : 1;
+}
@@ -0,0 +1,581 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+///
+/// Vectors that keep their first N elements inside the object.
+///
+/// A std::vector allocates on the first push_back, however few elements it
+/// will ever hold, and every element access goes through a pointer to a
+/// separate heap block. Most vectors in real programs are small (the
+/// arguments of a call, the children of a tree node, the edges of a graph
+/// vertex), so:
+///
+/// - small_vector<T, N, Growth> stores up to N elements in an inline buffer
+///   and moves to the heap only when it outgrows it. Growth decides how the
+///   heap capacity grows from there (growth::doubling by default).
+/// - static_vector<T, N> never allocates: its capacity is fixed at N, and
+///   growing past it throws std::length_error.
+///
+/// Both have the interface of std::vector (contiguous storage, T* iterators,
+/// emplace_back, insert, erase, resize, ...). Unlike std::vector, moving a
+/// vector whose elements are inline moves the elements one by one, and the
+/// object is N * sizeof(T) bytes larger. Anything that only needs the
+/// elements can take a std::span<T>, so functions need not be templates on N.
+///
+
+namespace containers {
+
+/// Growth policies for small_vector: next(capacity, required) returns the new
+/// heap capacity, at least `required`.
+namespace growth {
+
+/// Fewest reallocations: n push_backs move each element about once.
+struct doubling {
+  static std::size_t next(std::size_t capacity, std::size_t required) noexcept {
+    return std::max(required, 2 * capacity);
+  }
+};
+
+/// Less unused capacity (a third on average instead of half), and a freed
+/// block can eventually be reused: with factor 1.5 the earlier blocks add up
+/// to more than the next request, with factor 2 they never do.
+struct one_and_a_half {
+  static std::size_t next(std::size_t capacity, std::size_t required) noexcept {
+    return std::max(required, capacity + capacity / 2);
+  }
+};
+
+/// No unused capacity, but every push_back past the capacity reallocates, so
+/// only for vectors that are filled once after a reserve().
+struct exact {
+  static std::size_t next(std::size_t, std::size_t required) noexcept {
+    return required;
+  }
+};
+
+} // namespace growth
+
+namespace detail {
+
+// Everything that does not depend on N. Derived provides
+//   static constexpr const char *class_name;
+//   static constexpr bool can_grow;
+//   static size_type max_size();
+//   T *inlineData() noexcept;
+//   static size_type nextCapacity(size_type capacity, size_type required);
+//                                                            (if can_grow)
+template <typename Derived, typename T> class inline_vector_base {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  size_type size() const noexcept { return m_size; }
+  size_type capacity() const noexcept { return m_capacity; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  T *data() noexcept { return m_data; }
+  const T *data() const noexcept { return m_data; }
+
+  iterator begin() noexcept { return m_data; }
+  iterator end() noexcept { return m_data + m_size; }
+  const_iterator begin() const noexcept { return m_data; }
+  const_iterator end() const noexcept { return m_data + m_size; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  reference operator[](size_type i) noexcept { return m_data[i]; }
+  const_reference operator[](size_type i) const noexcept { return m_data[i]; }
+  reference front() noexcept { return m_data[0]; }
+  const_reference front() const noexcept { return m_data[0]; }
+  reference back() noexcept { return m_data[m_size - 1]; }
+  const_reference back() const noexcept { return m_data[m_size - 1]; }
+
+  reference at(size_type i) {
+    checkIndex(i);
+    return m_data[i];
+  }
+  const_reference at(size_type i) const {
+    checkIndex(i);
+    return m_data[i];
+  }
+
+  template <typename... Args> reference emplace_back(Args &&...args) {
+    if (m_size == m_capacity) {
+      return growAndEmplaceBack(std::forward<Args>(args)...);
+    }
+    T *p = std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+    ++m_size;
+    return *p;
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  void pop_back() noexcept {
+    --m_size;
+    std::destroy_at(m_data + m_size);
+  }
+
+  void clear() noexcept {
+    std::destroy_n(m_data, m_size);
+    m_size = 0;
+  }
+
+  void reserve(size_type count) {
+    if (count > m_capacity) {
+      reallocate(checkedCapacity(count, "reserve"));
+    }
+  }
+
+  void resize(size_type count) {
+    if (count <= m_size) {
+      truncate(count);
+      return;
+    }
+    reserve(count);
+    std::uninitialized_value_construct(m_data + m_size, m_data + count);
+    m_size = count;
+  }
+
+  void resize(size_type count, const T &value) {
+    if (count <= m_size) {
+      truncate(count);
+      return;
+    }
+    if (count > m_capacity) {
+      // value may be one of our elements; copy it before reallocating.
+      T copy(value);
+      reserve(count);
+      std::uninitialized_fill(m_data + m_size, m_data + count, copy);
+    } else {
+      std::uninitialized_fill(m_data + m_size, m_data + count, value);
+    }
+    m_size = count;
+  }
+
+  void assign(size_type count, const T &value) {
+    T copy(value);
+    clear();
+    resize(count, copy);
+  }
+
+  template <std::input_iterator It> void assign(It first, It last) {
+    clear();
+    append(first, last);
+  }
+
+  void assign(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+
+  /// Inserts by appending and rotating the new elements into place.
+  template <typename... Args> iterator emplace(const_iterator pos, Args &&...args) {
+    const size_type index = static_cast<size_type>(pos - begin());
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(begin() + index, end() - 1, end());
+    return begin() + index;
+  }
+
+  iterator insert(const_iterator pos, const T &value) { return emplace(pos, value); }
+  iterator insert(const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+
+  template <std::input_iterator It> iterator insert(const_iterator pos, It first, It last) {
+    const size_type index = static_cast<size_type>(pos - begin());
+    const size_type old_size = m_size;
+    append(first, last);
+    std::rotate(begin() + index, begin() + old_size, end());
+    return begin() + index;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> values) {
+    return insert(pos, values.begin(), values.end());
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    iterator out = begin() + (first - cbegin());
+    if (first != last) {
+      iterator tail = std::move(begin() + (last - cbegin()), end(), out);
+      truncate(static_cast<size_type>(tail - begin()));
+    }
+    return out;
+  }
+
+  /// The elements are on the heap (always false for static_vector).
+  bool isOnHeap() const noexcept { return m_data != derived().inlineData(); }
+
+  friend bool operator==(const inline_vector_base &a, const inline_vector_base &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+
+  friend auto operator<=>(const inline_vector_base &a, const inline_vector_base &b) {
+    return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+  }
+
+protected:
+  // The derived constructor points m_data at its inline buffer.
+  inline_vector_base() noexcept = default;
+  inline_vector_base(const inline_vector_base &) = delete;
+  inline_vector_base &operator=(const inline_vector_base &) = delete;
+  ~inline_vector_base() = default;
+
+  T *m_data = nullptr;
+  size_type m_size = 0;
+  size_type m_capacity = 0;
+
+  Derived &derived() noexcept { return static_cast<Derived &>(*this); }
+  const Derived &derived() const noexcept { return static_cast<const Derived &>(*this); }
+
+  template <typename It> void append(It first, It last) {
+    if constexpr (std::forward_iterator<It>) {
+      const auto count = static_cast<size_type>(std::distance(first, last));
+      reserve(m_size + count);
+      std::uninitialized_copy(first, last, m_data + m_size);
+      m_size += count;
+    } else {
+      for (; first != last; ++first) {
+        emplace_back(*first);
+      }
+    }
+  }
+
+  void truncate(size_type count) noexcept {
+    std::destroy(m_data + count, m_data + m_size);
+    m_size = count;
+  }
+
+  void releaseHeap() noexcept {
+    if (isOnHeap()) {
+      std::allocator<T>().deallocate(m_data, m_capacity);
+    }
+  }
+
+  // Moves the elements into `buffer` (copies them if the move constructor may
+  // throw, like std::vector) and frees the old heap block.
+  void relocateTo(T *buffer, size_type capacity) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (m_size != 0) {
+        std::memcpy(static_cast<void *>(buffer), m_data, m_size * sizeof(T));
+      }
+    } else if constexpr (std::is_nothrow_move_constructible_v<T> ||
+                         !std::is_copy_constructible_v<T>) {
+      std::uninitialized_move_n(m_data, m_size, buffer);
+    } else {
+      std::uninitialized_copy_n(m_data, m_size, buffer);
+    }
+    std::destroy_n(m_data, m_size);
+    releaseHeap();
+    m_data = buffer;
+    m_capacity = capacity;
+  }
+
+  void reallocate(size_type capacity) {
+    T *buffer = std::allocator<T>().allocate(capacity);
+    try {
+      relocateTo(buffer, capacity);
+    } catch (...) {
+      std::allocator<T>().deallocate(buffer, capacity);
+      throw;
+    }
+  }
+
+  [[noreturn]] static void tooLong(const char *function, const char *reason) {
+    throw std::length_error(std::string(Derived::class_name) + "::" + function + ": " +
+                            reason);
+  }
+
+  size_type checkedCapacity(size_type required, const char *function) const {
+    if constexpr (Derived::can_grow) {
+      if (required > Derived::max_size()) {
+        tooLong(function, "too many elements");
+      }
+      return required;
+    } else {
+      tooLong(function, "capacity exceeded");
+    }
+  }
+
+  // The cold path of emplace_back(): the new element is built in the new
+  // buffer first, because args may refer to an element we are about to move.
+  template <typename... Args> reference growAndEmplaceBack(Args &&...args) {
+    if constexpr (Derived::can_grow) {
+      const size_type capacity = checkedCapacity(
+          derived().nextCapacity(m_capacity, m_size + 1), "emplace_back");
+      T *buffer = std::allocator<T>().allocate(capacity);
+      T *p = nullptr;
+      try {
+        p = std::construct_at(buffer + m_size, std::forward<Args>(args)...);
+        relocateTo(buffer, capacity);
+      } catch (...) {
+        if (p != nullptr) {
+          std::destroy_at(p);
+        }
+        std::allocator<T>().deallocate(buffer, capacity);
+        throw;
+      }
+      ++m_size;
+      return *p;
+    } else {
+      tooLong("emplace_back", "capacity exceeded");
+    }
+  }
+
+private:
+  void checkIndex(size_type i) const {
+    if (i >= m_size) {
+      throw std::out_of_range(std::string(Derived::class_name) + "::at: index out of range");
+    }
+  }
+};
+
+} // namespace detail
+
+template <typename T, std::size_t N, typename Growth = growth::doubling>
+class small_vector : public detail::inline_vector_base<small_vector<T, N, Growth>, T> {
+  static_assert(N > 0, "small_vector needs an inline capacity; use std::vector");
+
+  using base = detail::inline_vector_base<small_vector, T>;
+  friend base;
+
+public:
+  using typename base::size_type;
+
+  static constexpr size_type inline_capacity = N;
+
+  small_vector() noexcept { useInline(); }
+
+  explicit small_vector(size_type count) : small_vector() { this->resize(count); }
+
+  small_vector(size_type count, const T &value) : small_vector() {
+    this->resize(count, value);
+  }
+
+  template <std::input_iterator It> small_vector(It first, It last) : small_vector() {
+    this->append(first, last);
+  }
+
+  small_vector(std::initializer_list<T> values) : small_vector() {
+    this->append(values.begin(), values.end());
+  }
+
+  small_vector(const small_vector &other) : small_vector() {
+    this->append(other.begin(), other.end());
+  }
+
+  /// Takes other's heap block if it has one, otherwise moves the elements.
+  small_vector(small_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      : small_vector() {
+    takeFrom(other);
+  }
+
+  small_vector &operator=(const small_vector &other) {
+    if (this != &other) {
+      this->assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  small_vector &operator=(small_vector &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      this->clear();
+      this->releaseHeap();
+      useInline();
+      takeFrom(other);
+    }
+    return *this;
+  }
+
+  small_vector &operator=(std::initializer_list<T> values) {
+    this->assign(values);
+    return *this;
+  }
+
+  ~small_vector() {
+    this->clear();
+    this->releaseHeap();
+  }
+
+  static constexpr size_type max_size() noexcept {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  /// Moves the elements back into the inline buffer if they fit, or into a
+  /// heap block of exactly size() elements.
+  void shrink_to_fit() {
+    if (!this->isOnHeap() || this->m_size == this->m_capacity) {
+      return;
+    }
+    if (this->m_size <= N) {
+      this->relocateTo(inlineData(), N);
+    } else {
+      this->reallocate(this->m_size);
+    }
+  }
+
+  void swap(small_vector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    small_vector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  friend void swap(small_vector &a, small_vector &b) noexcept(noexcept(a.swap(b))) {
+    a.swap(b);
+  }
+
+private:
+  static constexpr const char *class_name = "small_vector";
+  static constexpr bool can_grow = true;
+
+  alignas(T) std::byte m_inline[N * sizeof(T)];
+
+  T *inlineData() noexcept { return std::launder(reinterpret_cast<T *>(m_inline)); }
+  const T *inlineData() const noexcept {
+    return std::launder(reinterpret_cast<const T *>(m_inline));
+  }
+
+  static size_type nextCapacity(size_type capacity, size_type required) noexcept {
+    return Growth::next(capacity, required);
+  }
+
+  void useInline() noexcept {
+    this->m_data = inlineData();
+    this->m_size = 0;
+    this->m_capacity = N;
+  }
+
+  // Expects *this to be empty and inline; leaves other empty and inline.
+  void takeFrom(small_vector &other) {
+    if (other.isOnHeap()) {
+      this->m_data = other.m_data;
+      this->m_size = other.m_size;
+      this->m_capacity = other.m_capacity;
+      other.useInline();
+      return;
+    }
+    std::uninitialized_move_n(other.m_data, other.m_size, this->m_data);
+    this->m_size = other.m_size;
+    other.clear();
+  }
+};
+
+template <typename T, std::size_t N>
+class static_vector : public detail::inline_vector_base<static_vector<T, N>, T> {
+  static_assert(N > 0, "static_vector needs a capacity");
+
+  using base = detail::inline_vector_base<static_vector, T>;
+  friend base;
+
+public:
+  using typename base::size_type;
+
+  static_vector() noexcept {
+    this->m_data = inlineData();
+    this->m_capacity = N;
+  }
+
+  explicit static_vector(size_type count) : static_vector() { this->resize(count); }
+
+  static_vector(size_type count, const T &value) : static_vector() {
+    this->resize(count, value);
+  }
+
+  template <std::input_iterator It> static_vector(It first, It last) : static_vector() {
+    this->append(first, last);
+  }
+
+  static_vector(std::initializer_list<T> values) : static_vector() {
+    this->append(values.begin(), values.end());
+  }
+
+  static_vector(const static_vector &other) : static_vector() {
+    this->append(other.begin(), other.end());
+  }
+
+  static_vector(static_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      : static_vector() {
+    std::uninitialized_move_n(other.m_data, other.m_size, this->m_data);
+    this->m_size = other.m_size;
+    other.clear();
+  }
+
+  static_vector &operator=(const static_vector &other) {
+    if (this != &other) {
+      this->assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  static_vector &operator=(static_vector &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      this->clear();
+      std::uninitialized_move_n(other.m_data, other.m_size, this->m_data);
+      this->m_size = other.m_size;
+      other.clear();
+    }
+    return *this;
+  }
+
+  static_vector &operator=(std::initializer_list<T> values) {
+    this->assign(values);
+    return *this;
+  }
+
+  ~static_vector() { this->clear(); }
+
+  static constexpr size_type max_size() noexcept { return N; }
+
+  bool full() const noexcept { return this->m_size == N; }
+
+  void swap(static_vector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    static_vector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  friend void swap(static_vector &a, static_vector &b) noexcept(noexcept(a.swap(b))) {
+    a.swap(b);
+  }
+
+private:
+  static constexpr const char *class_name = "static_vector";
+  static constexpr bool can_grow = false;
+
+  alignas(T) std::byte m_inline[N * sizeof(T)];
+
+  T *inlineData() noexcept { return std::launder(reinterpret_cast<T *>(m_inline)); }
+  const T *inlineData() const noexcept {
+    return std::launder(reinterpret_cast<const T *>(m_inline));
+  }
+};
+
+} // namespace containers
+
+#endif
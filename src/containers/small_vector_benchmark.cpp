@@ -0,0 +1,129 @@
+// std::vector against small_vector<T, 16> and static_vector<T, 16> for the
+// sizes most vectors have, 0 to 16 elements:
+// - BuildAndSum: a local vector gets n push_backs and is summed, the pattern
+//   of vectorPushBack() in vector.cpp (std::vector with and without reserve)
+// - AdjacencyBuild/AdjacencyScan: a graph of 100k vertices with 0-8 edges each,
+//   as a vector of per-vertex vectors; building it, and summing every
+//   neighbour list
+// - Growth: 1000 push_backs into small_vector<int, 16, Growth>, i.e. mostly
+//   on the heap, for each growth policy
+#include "small_vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using std_vector = std::vector<int>;
+using small_vector = containers::small_vector<int, 16>;
+using static_vector = containers::static_vector<int, 16>;
+
+struct std_vector_reserved : std::vector<int> {
+  std_vector_reserved() { reserve(16); }
+};
+
+template <typename Vector> void BM_BuildAndSum(benchmark::State &state) {
+  const auto n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    Vector v;
+    for (int i = 0; i < n; ++i) {
+      v.push_back(i);
+    }
+    benchmark::DoNotOptimize(v.data());
+    int sum = 0;
+    for (int x : v) {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+constexpr std::size_t vertices = 100'000;
+
+std::vector<int> degrees() {
+  std::mt19937 gen(42);
+  std::vector<int> d(vertices);
+  for (auto &x : d) {
+    x = static_cast<int>(gen() % 9);
+  }
+  return d;
+}
+
+template <typename Vector> std::vector<Vector> buildGraph(const std::vector<int> &degree) {
+  std::vector<Vector> graph(vertices);
+  for (std::size_t v = 0; v < vertices; ++v) {
+    for (int e = 0; e < degree[v]; ++e) {
+      graph[v].push_back(static_cast<int>((v * 31 + static_cast<std::size_t>(e) * 7919) % vertices));
+    }
+  }
+  return graph;
+}
+
+template <typename Vector> void BM_AdjacencyBuild(benchmark::State &state) {
+  const auto degree = degrees();
+  for (auto _ : state) {
+    auto graph = buildGraph<Vector>(degree);
+    benchmark::DoNotOptimize(graph.data());
+  }
+  state.SetItemsProcessed(state.iterations() * vertices);
+}
+
+template <typename Vector> void BM_AdjacencyScan(benchmark::State &state) {
+  const auto graph = buildGraph<Vector>(degrees());
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (const auto &neighbours : graph) {
+      for (int w : neighbours) {
+        sum += w;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * vertices);
+}
+
+template <typename Growth> void BM_Growth(benchmark::State &state) {
+  for (auto _ : state) {
+    containers::small_vector<int, 16, Growth> v;
+    for (int i = 0; i < 1000; ++i) {
+      v.push_back(i);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+void smallSizes(benchmark::internal::Benchmark *b) {
+  b->ArgName("n");
+  for (int n : {0, 1, 2, 4, 8, 16}) {
+    b->Arg(n);
+  }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_BuildAndSum, std_vector)->Apply(smallSizes);
+BENCHMARK_TEMPLATE(BM_BuildAndSum, std_vector_reserved)->Apply(smallSizes);
+BENCHMARK_TEMPLATE(BM_BuildAndSum, small_vector)->Apply(smallSizes);
+BENCHMARK_TEMPLATE(BM_BuildAndSum, static_vector)->Apply(smallSizes);
+
+BENCHMARK_TEMPLATE(BM_AdjacencyBuild, std_vector)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AdjacencyBuild, containers::small_vector<int, 8>)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AdjacencyBuild, containers::static_vector<int, 8>)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AdjacencyScan, std_vector)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AdjacencyScan, containers::small_vector<int, 8>)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AdjacencyScan, containers::static_vector<int, 8>)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_Growth, containers::growth::doubling);
+BENCHMARK_TEMPLATE(BM_Growth, containers::growth::one_and_a_half);
+BENCHMARK_TEMPLATE(BM_Growth, containers::growth::exact);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+#include "soa_vector.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// The struct from track_memory_allocations.cpp, as std::vector<S> stores it.
+struct S {
+  double a;
+  int b;
+  float c;
+};
+
+// The same record as a structure of arrays. Naming the field indices keeps
+// the accesses readable.
+enum field { a, b, c };
+using s_vector = containers::soa_vector<double, int, float>;
+
+static_assert(std::random_access_iterator<s_vector::iterator>);
+static_assert(std::random_access_iterator<s_vector::const_iterator>);
+
+void aosStyleAccess() {
+  std::cout << "-------- AoS-style access --------" << std::endl;
+  s_vector v;
+  for (int i = 0; i < 5; ++i) {
+    v.emplace_back(i * 1.5, i, 0.0f);
+  }
+  v.push_back({10.0, 10, 0.0f});
+
+  // A proxy reference per element; get<I>() is a reference into column I.
+  v[0].get<c>() = 42.0f;
+
+  // Structured bindings refer into the columns, so writes go through.
+  for (auto [x, y, z] : v) {
+    z = static_cast<float>(x * y);
+  }
+
+  // Conversion to std::tuple copies an element out.
+  std::tuple<double, int, float> last = v.back();
+  std::cout << "last element: a=" << std::get<a>(last) << " b=" << std::get<b>(last)
+            << " c=" << std::get<c>(last) << std::endl;
+
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    std::cout << "v[" << i << "] = {" << v[i].get<a>() << ", " << v[i].get<b>()
+              << ", " << v[i].get<c>() << "}" << std::endl;
+  }
+}
+
+void columnAccess() {
+  std::cout << "-------- column access --------" << std::endl;
+  constexpr std::size_t n = 1000;
+  s_vector v(n);
+  std::vector<S> aos(n);
+
+  auto as = v.column<a>();
+  auto bs = v.column<b>();
+  std::iota(bs.begin(), bs.end(), 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    as[i] = 0.5 * static_cast<double>(i);
+    aos[i] = {as[i], bs[i], 0.0f};
+  }
+
+  // A reduction and a transform over single fields: each loop streams one or
+  // two dense arrays and vectorizes.
+  double sum = std::accumulate(as.begin(), as.end(), 0.0);
+  auto cs = v.column<c>();
+  for (std::size_t i = 0; i < n; ++i) {
+    cs[i] = static_cast<float>(as[i] * bs[i]);
+  }
+  std::cout << "sum of a: " << sum << ", c[999]: " << cs[n - 1] << std::endl;
+
+  std::cout << "std::vector<S>: " << sizeof(S) << " bytes per element, a loop over a reads "
+            << n * sizeof(S) << " bytes" << std::endl;
+  std::cout << "soa_vector:      a loop over a reads " << as.size_bytes()
+            << " bytes, column a starts at " << as.data() << " (64-byte aligned: "
+            << std::boolalpha
+            << (reinterpret_cast<std::uintptr_t>(as.data()) % s_vector::column_alignment == 0)
+            << ")" << std::endl;
+}
+
+void nonTrivialFields() {
+  std::cout << "-------- non-trivial fields --------" << std::endl;
+  containers::soa_vector<std::string, int> names;
+  names.emplace_back("alpha", 1);
+  names.emplace_back(std::string(40, 'x'), 2);
+  for (int i = 0; i < 100; ++i) {
+    names.emplace_back(names[0].get<0>(), i); // may grow while reading an element
+  }
+  auto copy = names;
+  names.clear();
+  std::cout << "copy has " << copy.size() << " elements, copy[1] = " << copy[1].get<0>()
+            << ", original has " << names.size() << std::endl;
+}
+
+int main() {
+  aosStyleAccess();
+  columnAccess();
+  nonTrivialFields();
+}
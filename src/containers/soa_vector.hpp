@@ -0,0 +1,422 @@
+#ifndef SOA_VECTOR_HPP
+#define SOA_VECTOR_HPP
+
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+///
+/// A vector of records stored as a structure of arrays.
+///
+/// soa_vector<double, int, float> holds what std::vector<S> would hold for
+/// `struct S { double a; int b; float c; }`, but keeps every field in its own
+/// array:
+///
+///   AoS  a b c . a b c . a b c . ...   (S is 16 bytes, 0-3 of them padding)
+///   SoA  a a a a a ...  |  b b b b b ...  |  c c c c c ...
+///
+/// A loop over one field then reads only that field's bytes, without padding,
+/// and consecutive elements sit in consecutive lanes, so the compiler can
+/// vectorize it. Every column starts on a 64-byte boundary (a cache line, and
+/// a full AVX-512 register), and column<I>() tells the compiler so.
+///
+/// - column<I>() returns the I-th field of all elements as a std::span, for
+///   vectorizable loops.
+/// - operator[] and the iterators return a proxy reference for AoS-style
+///   access: v[i].get<1>(), `auto [a, b, c] = v[i];` (a, b and c refer into
+///   the columns), or conversion to std::tuple<Ts...>.
+///
+/// The proxies keep the vector and an index, so unlike std::vector references
+/// they stay valid when the vector grows. The iterators are random access in
+/// the C++20 sense (std::random_access_iterator) but, like those of
+/// std::vector<bool>, only input iterators to the pre-C++20 algorithms.
+///
+
+namespace containers {
+
+template <typename... Ts> class soa_vector;
+
+namespace detail {
+
+template <bool Const, typename... Ts> class soa_reference {
+public:
+  using value_type = std::tuple<Ts...>;
+
+  soa_reference(const std::tuple<Ts *...> *columns, std::size_t index) noexcept
+      : m_columns(columns), m_index(index) {}
+
+  // A non-const reference converts to a const one.
+  soa_reference(const soa_reference<false, Ts...> &other) noexcept
+    requires Const
+      : m_columns(other.m_columns), m_index(other.m_index) {}
+
+  soa_reference(const soa_reference &) noexcept = default;
+
+  template <std::size_t I>
+  std::conditional_t<Const, const std::tuple_element_t<I, value_type> &,
+                     std::tuple_element_t<I, value_type> &>
+  get() const noexcept {
+    return std::get<I>(*m_columns)[m_index];
+  }
+
+  operator value_type() const {
+    return [this]<std::size_t... Is>(std::index_sequence<Is...>) {
+      return value_type(get<Is>()...);
+    }(std::index_sequence_for<Ts...>{});
+  }
+
+  // Assignment writes through to the elements, as for any proxy reference.
+  const soa_reference &operator=(const value_type &value) const
+    requires(!Const)
+  {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      ((get<Is>() = std::get<Is>(value)), ...);
+    }(std::index_sequence_for<Ts...>{});
+    return *this;
+  }
+
+  const soa_reference &operator=(value_type &&value) const
+    requires(!Const)
+  {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      ((get<Is>() = std::get<Is>(std::move(value))), ...);
+    }(std::index_sequence_for<Ts...>{});
+    return *this;
+  }
+
+  const soa_reference &operator=(const soa_reference &other) const
+    requires(!Const)
+  {
+    return *this = static_cast<value_type>(other);
+  }
+
+  friend void swap(const soa_reference &a, const soa_reference &b)
+    requires(!Const)
+  {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      using std::swap;
+      (swap(a.template get<Is>(), b.template get<Is>()), ...);
+    }(std::index_sequence_for<Ts...>{});
+  }
+
+private:
+  friend class soa_reference<true, Ts...>;
+
+  const std::tuple<Ts *...> *m_columns;
+  std::size_t m_index;
+};
+
+template <bool Const, typename... Ts> class soa_iterator {
+public:
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::input_iterator_tag;
+  using value_type = std::tuple<Ts...>;
+  using difference_type = std::ptrdiff_t;
+  using reference = soa_reference<Const, Ts...>;
+
+  soa_iterator() = default;
+  soa_iterator(const std::tuple<Ts *...> *columns, difference_type index) noexcept
+      : m_columns(columns), m_index(index) {}
+  soa_iterator(const soa_iterator<false, Ts...> &other) noexcept
+    requires Const
+      : m_columns(other.m_columns), m_index(other.m_index) {}
+  soa_iterator(const soa_iterator &) noexcept = default;
+  soa_iterator &operator=(const soa_iterator &) noexcept = default;
+
+  reference operator*() const noexcept {
+    return {m_columns, static_cast<std::size_t>(m_index)};
+  }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  soa_iterator &operator++() noexcept {
+    ++m_index;
+    return *this;
+  }
+  soa_iterator operator++(int) noexcept { return {m_columns, m_index++}; }
+  soa_iterator &operator--() noexcept {
+    --m_index;
+    return *this;
+  }
+  soa_iterator operator--(int) noexcept { return {m_columns, m_index--}; }
+  soa_iterator &operator+=(difference_type n) noexcept {
+    m_index += n;
+    return *this;
+  }
+  soa_iterator &operator-=(difference_type n) noexcept {
+    m_index -= n;
+    return *this;
+  }
+
+  friend soa_iterator operator+(soa_iterator it, difference_type n) noexcept {
+    return it += n;
+  }
+  friend soa_iterator operator+(difference_type n, soa_iterator it) noexcept {
+    return it += n;
+  }
+  friend soa_iterator operator-(soa_iterator it, difference_type n) noexcept {
+    return it -= n;
+  }
+  friend difference_type operator-(const soa_iterator &a, const soa_iterator &b) noexcept {
+    return a.m_index - b.m_index;
+  }
+  friend bool operator==(const soa_iterator &a, const soa_iterator &b) noexcept {
+    return a.m_index == b.m_index;
+  }
+  friend auto operator<=>(const soa_iterator &a, const soa_iterator &b) noexcept {
+    return a.m_index <=> b.m_index;
+  }
+
+private:
+  friend class soa_iterator<true, Ts...>;
+
+  const std::tuple<Ts *...> *m_columns = nullptr;
+  difference_type m_index = 0;
+};
+
+} // namespace detail
+
+template <typename... Ts> class soa_vector {
+  static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one field");
+  static_assert((std::is_nothrow_move_constructible_v<Ts> && ...),
+                "growing moves the fields, which must not throw");
+
+public:
+  using value_type = std::tuple<Ts...>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = detail::soa_reference<false, Ts...>;
+  using const_reference = detail::soa_reference<true, Ts...>;
+  using iterator = detail::soa_iterator<false, Ts...>;
+  using const_iterator = detail::soa_iterator<true, Ts...>;
+  template <std::size_t I> using field_type = std::tuple_element_t<I, value_type>;
+
+  static constexpr std::size_t column_alignment = 64;
+
+  soa_vector() noexcept = default;
+
+  explicit soa_vector(size_type count) { resize(count); }
+
+  soa_vector(const soa_vector &other) : soa_vector() {
+    reserve(other.m_size);
+    if constexpr ((std::is_trivially_copyable_v<Ts> && ...)) {
+      forEachColumn([&](auto column) {
+        constexpr std::size_t I = decltype(column)::value;
+        if (other.m_size != 0) {
+          std::memcpy(std::get<I>(m_columns), std::get<I>(other.m_columns),
+                      other.m_size * sizeof(field_type<I>));
+        }
+      });
+      m_size = other.m_size;
+    } else {
+      for (size_type i = 0; i < other.m_size; ++i) {
+        constructAt(i, static_cast<value_type>(other[i]));
+        ++m_size;
+      }
+    }
+  }
+
+  soa_vector(soa_vector &&other) noexcept
+      : m_columns(std::exchange(other.m_columns, {})),
+        m_size(std::exchange(other.m_size, 0)),
+        m_capacity(std::exchange(other.m_capacity, 0)) {}
+
+  soa_vector &operator=(soa_vector other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~soa_vector() {
+    clear();
+    deallocate(m_columns, m_capacity);
+  }
+
+  void swap(soa_vector &other) noexcept {
+    std::swap(m_columns, other.m_columns);
+    std::swap(m_size, other.m_size);
+    std::swap(m_capacity, other.m_capacity);
+  }
+
+  size_type size() const noexcept { return m_size; }
+  size_type capacity() const noexcept { return m_capacity; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  /// The I-th field of every element, contiguous and 64-byte aligned.
+  template <std::size_t I> std::span<field_type<I>> column() noexcept {
+    return {alignedColumn<I>(), m_size};
+  }
+  template <std::size_t I> std::span<const field_type<I>> column() const noexcept {
+    return {alignedColumn<I>(), m_size};
+  }
+
+  reference operator[](size_type i) noexcept { return {&m_columns, i}; }
+  const_reference operator[](size_type i) const noexcept { return {&m_columns, i}; }
+  reference back() noexcept { return (*this)[m_size - 1]; }
+  const_reference back() const noexcept { return (*this)[m_size - 1]; }
+
+  iterator begin() noexcept { return {&m_columns, 0}; }
+  iterator end() noexcept { return {&m_columns, static_cast<difference_type>(m_size)}; }
+  const_iterator begin() const noexcept { return {&m_columns, 0}; }
+  const_iterator end() const noexcept {
+    return {&m_columns, static_cast<difference_type>(m_size)};
+  }
+
+  void reserve(size_type count) {
+    if (count <= m_capacity) {
+      return;
+    }
+    std::tuple<Ts *...> columns = allocate(count);
+    forEachColumn([&](auto column) {
+      constexpr std::size_t I = decltype(column)::value;
+      std::uninitialized_move_n(std::get<I>(m_columns), m_size, std::get<I>(columns));
+      std::destroy_n(std::get<I>(m_columns), m_size);
+    });
+    deallocate(m_columns, m_capacity);
+    m_columns = columns;
+    m_capacity = count;
+  }
+
+  /// Appends one element built field by field: emplace_back(a, b, c)
+  /// constructs field I from argument I.
+  template <typename... Args>
+    requires(sizeof...(Args) == sizeof...(Ts))
+  reference emplace_back(Args &&...args) {
+    if (m_size == m_capacity) {
+      // The arguments may refer into this vector; take a copy before growing.
+      value_type value(std::forward<Args>(args)...);
+      reserve(grownCapacity());
+      constructAt(m_size, std::move(value));
+    } else {
+      constructAt(m_size, std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    return (*this)[m_size++];
+  }
+
+  void push_back(const value_type &value) {
+    std::apply([this](const Ts &...fields) { emplace_back(fields...); }, value);
+  }
+
+  void push_back(value_type &&value) {
+    std::apply([this](Ts &...fields) { emplace_back(std::move(fields)...); }, value);
+  }
+
+  void pop_back() noexcept {
+    --m_size;
+    forEachColumn([&](auto column) {
+      std::destroy_at(std::get<decltype(column)::value>(m_columns) + m_size);
+    });
+  }
+
+  /// New elements are value-initialized, field by field.
+  void resize(size_type count) {
+    if (count < m_size) {
+      forEachColumn([&](auto column) {
+        std::destroy(std::get<decltype(column)::value>(m_columns) + count,
+                     std::get<decltype(column)::value>(m_columns) + m_size);
+      });
+      m_size = count;
+      return;
+    }
+    reserve(count);
+    while (m_size < count) {
+      constructAt(m_size, std::tuple<>{});
+      ++m_size;
+    }
+  }
+
+  void clear() noexcept { resize(0); }
+
+private:
+  template <typename F> static void forEachColumn(F &&f) {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+      (f(std::integral_constant<std::size_t, Is>{}), ...);
+    }(std::index_sequence_for<Ts...>{});
+  }
+
+  template <std::size_t I> field_type<I> *alignedColumn() const noexcept {
+    // std::assume_aligned must not be given the null pointer of an empty vector.
+    return m_capacity == 0
+               ? nullptr
+               : std::assume_aligned<column_alignment>(std::get<I>(m_columns));
+  }
+
+  size_type grownCapacity() const noexcept {
+    return m_capacity == 0 ? 16 : 2 * m_capacity;
+  }
+
+  static std::tuple<Ts *...> allocate(size_type count) {
+    std::tuple<Ts *...> columns{};
+    try {
+      forEachColumn([&](auto column) {
+        constexpr std::size_t I = decltype(column)::value;
+        std::get<I>(columns) = static_cast<field_type<I> *>(::operator new(
+            count * sizeof(field_type<I>), std::align_val_t{column_alignment}));
+      });
+    } catch (...) {
+      deallocate(columns, count);
+      throw;
+    }
+    return columns;
+  }
+
+  static void deallocate(const std::tuple<Ts *...> &columns, size_type count) noexcept {
+    forEachColumn([&](auto column) {
+      constexpr std::size_t I = decltype(column)::value;
+      if (std::get<I>(columns) != nullptr) {
+        ::operator delete(std::get<I>(columns), count * sizeof(field_type<I>),
+                          std::align_val_t{column_alignment});
+      }
+    });
+  }
+
+  // Constructs field I of element `index` from std::get<I>(args), or
+  // value-initializes it if args has no I-th entry. If a field throws, the
+  // fields already built are destroyed again.
+  template <typename Tuple> void constructAt(size_type index, Tuple &&args) {
+    std::size_t built = 0;
+    try {
+      forEachColumn([&](auto column) {
+        constexpr std::size_t I = decltype(column)::value;
+        if constexpr (I < std::tuple_size_v<std::remove_cvref_t<Tuple>>) {
+          std::construct_at(std::get<I>(m_columns) + index,
+                            std::get<I>(std::forward<Tuple>(args)));
+        } else {
+          std::construct_at(std::get<I>(m_columns) + index);
+        }
+        ++built;
+      });
+    } catch (...) {
+      forEachColumn([&](auto column) {
+        if (decltype(column)::value < built) {
+          std::destroy_at(std::get<decltype(column)::value>(m_columns) + index);
+        }
+      });
+      throw;
+    }
+  }
+
+  std::tuple<Ts *...> m_columns{};
+  size_type m_size = 0;
+  size_type m_capacity = 0;
+};
+
+} // namespace containers
+
+// Structured bindings for the proxy reference: `auto [a, b, c] = v[i];`.
+template <bool Const, typename... Ts>
+struct std::tuple_size<containers::detail::soa_reference<Const, Ts...>>
+    : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template <std::size_t I, bool Const, typename... Ts>
+struct std::tuple_element<I, containers::detail::soa_reference<Const, Ts...>> {
+  using field = std::tuple_element_t<I, std::tuple<Ts...>>;
+  using type = std::conditional_t<Const, const field &, field &>;
+};
+
+#endif
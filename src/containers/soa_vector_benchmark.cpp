@@ -0,0 +1,197 @@
+// Field-wise loops over std::vector<S> (array of structs) against
+// soa_vector<double, int, float> (structure of arrays), for the S from
+// track_memory_allocations.cpp:
+// - reductions over one field, and over two
+// - a transform writing one field from two others
+// - a loop that touches every field of every element, where AoS loses its
+//   disadvantage
+// - appending elements one by one
+#include "soa_vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct S {
+  double a;
+  int b;
+  float c;
+};
+
+enum field { a, b, c };
+using s_vector = containers::soa_vector<double, int, float>;
+
+struct aos {
+  explicit aos(std::size_t n) : items(n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      items[i] = {0.5 * static_cast<double>(i), static_cast<int>(i % 1000), 1.0f};
+    }
+  }
+  std::vector<S> items;
+};
+
+struct soa {
+  explicit soa(std::size_t n) : items(n) {
+    auto as = items.column<a>();
+    auto bs = items.column<b>();
+    auto cs = items.column<c>();
+    for (std::size_t i = 0; i < n; ++i) {
+      as[i] = 0.5 * static_cast<double>(i);
+      bs[i] = static_cast<int>(i % 1000);
+      cs[i] = 1.0f;
+    }
+  }
+  s_vector items;
+};
+
+void setCounters(benchmark::State &state, std::size_t bytes_per_element) {
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(bytes_per_element));
+}
+
+// sum of a: AoS reads all 16 bytes of S per element, SoA only the 8 of a.
+void BM_SumAoS(benchmark::State &state) {
+  aos data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = 0;
+    for (const S &s : data.items) {
+      sum += s.a;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setCounters(state, sizeof(S));
+}
+
+void BM_SumSoA(benchmark::State &state) {
+  soa data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = 0;
+    for (double v : data.items.column<a>()) {
+      sum += v;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setCounters(state, sizeof(double));
+}
+
+// sum of b: an int column is a quarter of S, and integer sums vectorize
+// without -ffast-math.
+void BM_SumIntAoS(benchmark::State &state) {
+  aos data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (const S &s : data.items) {
+      sum += s.b;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setCounters(state, sizeof(S));
+}
+
+void BM_SumIntSoA(benchmark::State &state) {
+  soa data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::int64_t sum = 0;
+    for (int v : data.items.column<b>()) {
+      sum += v;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setCounters(state, sizeof(int));
+}
+
+// c = a * b for every element.
+void BM_TransformAoS(benchmark::State &state) {
+  aos data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (S &s : data.items) {
+      s.c = static_cast<float>(s.a * s.b);
+    }
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, 2 * sizeof(S));
+}
+
+void BM_TransformSoA(benchmark::State &state) {
+  soa data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto as = data.items.column<a>();
+    auto bs = data.items.column<b>();
+    auto cs = data.items.column<c>();
+    for (std::size_t i = 0; i < cs.size(); ++i) {
+      cs[i] = static_cast<float>(as[i] * bs[i]);
+    }
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, sizeof(double) + sizeof(int) + 2 * sizeof(float));
+}
+
+// All three fields of every element, through the proxy reference on the SoA
+// side: AoS reads each cache line once and SoA reads three streams.
+void BM_WholeRecordAoS(benchmark::State &state) {
+  aos data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = 0;
+    for (const S &s : data.items) {
+      sum += s.a + s.b + s.c;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setCounters(state, sizeof(S));
+}
+
+void BM_WholeRecordSoA(benchmark::State &state) {
+  soa data(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    double sum = 0;
+    for (auto [x, y, z] : data.items) {
+      sum += x + y + z;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setCounters(state, sizeof(double) + sizeof(int) + sizeof(float));
+}
+
+void BM_PushBackAoS(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::vector<S> v;
+    for (std::size_t i = 0; i < n; ++i) {
+      v.push_back({static_cast<double>(i), static_cast<int>(i), 0.0f});
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PushBackSoA(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    s_vector v;
+    for (std::size_t i = 0; i < n; ++i) {
+      v.emplace_back(static_cast<double>(i), static_cast<int>(i), 0.0f);
+    }
+    benchmark::DoNotOptimize(v.column<a>().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+// 4K elements fit in L1/L2, 4M elements (64 MiB of S) come from DRAM.
+BENCHMARK(BM_SumAoS)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_SumSoA)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_SumIntAoS)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_SumIntSoA)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_TransformAoS)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_TransformSoA)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_WholeRecordAoS)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_WholeRecordSoA)->RangeMultiplier(32)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_PushBackAoS)->Arg(1 << 16);
+BENCHMARK(BM_PushBackSoA)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
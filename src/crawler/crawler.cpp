@@ -0,0 +1,129 @@
+#include "crawler/crawler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <thread>
+
+// Usage: crawler [root] [name_pattern] [threads]
+//
+// Finds the entries under `root` whose name matches `name_pattern` (by
+// default ".*\.ulg", the PX4 logs of regex_mathch_search.cpp) three ways and
+// prints the time of each:
+// - std::filesystem::recursive_directory_iterator and std::regex_match, the
+//   loop of findFileWithRegexPattern() made recursive
+// - crawler::crawl() on a thread pool, also summing the sizes of the matches
+// - crawler::crawl_stream, read on the main thread
+// Without a root, a tree of 20000 files is generated in the temp directory.
+
+namespace {
+
+template <typename F> double seconds(F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char *name, std::uint64_t matches, double s) {
+  std::printf("%-36s %8.3f s %8llu matches\n", name, s, static_cast<unsigned long long>(matches));
+}
+
+// 20 directories of 10 subdirectories of 100 files, one file in ten a log.
+void generateTree(const std::filesystem::path &root) {
+  for (int a = 0; a < 20; ++a) {
+    for (int b = 0; b < 10; ++b) {
+      const std::filesystem::path dir =
+          root / ("flight_" + std::to_string(a)) / ("session_" + std::to_string(b));
+      std::filesystem::create_directories(dir);
+      for (int f = 0; f < 100; ++f) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%05d-2023-02-23_16-13-%02d.%s", a * 1000 + b * 100 + f,
+                      f % 60, f % 10 == 0 ? "ulg" : "csv");
+        std::ofstream(dir / name) << name;
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string root;
+  if (argc > 1) {
+    root = argv[1];
+  } else {
+    root = (std::filesystem::temp_directory_path() / "crawler_sample").string();
+    if (!std::filesystem::exists(root)) {
+      std::cout << "generating " << root << std::endl;
+      generateTree(root);
+    }
+  }
+  const std::string pattern = argc > 2 ? argv[2] : ".*\\.ulg";
+  const std::size_t threads =
+      argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+  std::cout << root << ": \"" << pattern << "\", " << threads << " threads" << std::endl;
+
+  std::uint64_t baseline = 0;
+  const double baseline_seconds = seconds([&] {
+    const std::regex regex(pattern);
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(
+             root, std::filesystem::directory_options::skip_permission_denied)) {
+      if (!entry.is_directory() && std::regex_match(entry.path().filename().string(), regex)) {
+        ++baseline;
+      }
+    }
+  });
+  report("recursive_directory_iterator + regex", baseline, baseline_seconds);
+
+  thread_pool pool(threads);
+  crawler::options opts;
+  opts.name_pattern = pattern;
+  std::atomic<std::uint64_t> bytes{0};
+  crawler::crawl_stats stats;
+  const double crawl_seconds = seconds([&] {
+    stats = crawler::crawl(
+        root, pool,
+        [&](const crawler::entry &e) {
+          if (e.type() == crawler::entry_type::regular) {
+            bytes.fetch_add(e.metadata().size, std::memory_order_relaxed);
+          }
+        },
+        opts);
+  });
+  report("crawler::crawl + statx of matches", stats.reported, crawl_seconds);
+  std::cout << "  " << stats.directories << " directories, " << stats.entries << " entries, "
+            << stats.errors << " unreadable, " << bytes.load() << " bytes in the matches"
+            << std::endl;
+
+  std::uint64_t streamed = 0;
+  std::string example;
+  const double stream_seconds = seconds([&] {
+    crawler::crawl_stream stream(root, pool, opts);
+    crawler::found item;
+    while (stream.next(item)) {
+      if (streamed++ == 0) {
+        example = item.path;
+      }
+    }
+  });
+  report("crawler::crawl_stream", streamed, stream_seconds);
+  if (!example.empty()) {
+    std::cout << "  e.g. " << example << std::endl;
+  }
+
+  // Stops at the first match, like findFileWithRegexPattern().
+  if (const auto any = crawler::findAny(root, pool, pattern)) {
+    std::cout << "findAny: " << *any << std::endl;
+  }
+
+  const bool same = baseline == stats.reported && stats.reported == streamed;
+  std::cout << "match counts " << (same ? "agree" : "DIFFER") << std::endl;
+  return same ? 0 : 1;
+}
@@ -0,0 +1,626 @@
+#ifndef CRAWLER_HPP
+#define CRAWLER_HPP
+
+#include "multithreading/mpmc_queue.hpp"
+#include "multithreading/thread_pool.hpp"
+#include "strings/regex.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <filesystem>
+#endif
+
+///
+/// A parallel recursive directory walk, the engine for directoryIterator() in
+/// filesystem.cpp and findFileWithRegexPattern() in regex_mathch_search.cpp.
+///
+/// - Every directory is a task on a work-stealing thread_pool. A worker reads
+///   one directory and posts a task for each subdirectory, which idle workers
+///   steal, so wide and deep parts of a tree spread over all workers.
+/// - On Linux a directory is read with getdents64, 32 KiB of entries per
+///   system call into a buffer on the worker's stack, and the entry type comes
+///   from d_type. Names are handed out as string_views into that buffer: no
+///   std::filesystem::path and no allocation per entry, and a path is only
+///   built for entries that are reported.
+/// - Metadata costs a statx per entry, so it is only fetched on request:
+///   entry::metadata() calls statx on first use, relative to the open
+///   directory. Entries whose d_type is unknown (some network filesystems) get
+///   a statx for their type alone.
+/// - Results stream out through a callback, called on the workers, or through
+///   crawl_stream, a bounded mpmc::queue that the calling thread reads while
+///   the crawl is still running.
+/// - Names can be filtered by a strings::regex. A regex is not thread-safe, so
+///   each directory task borrows a copy from a small free list.
+///
+/// Symbolic links are reported but never followed, as by
+/// recursive_directory_iterator by default. Directories below the root that
+/// cannot be read are skipped and counted in crawl_stats::errors.
+///
+
+namespace crawler {
+
+enum class entry_type : std::uint8_t { unknown, regular, directory, symlink, other };
+
+struct file_metadata {
+  std::uint64_t size = 0;
+  std::uint64_t inode = 0;
+  std::int64_t mtime_ns = 0; // since the Unix epoch
+  std::uint32_t mode = 0;    // st_mode: type and permission bits
+};
+
+struct options {
+  /// Only entries whose name matches (strings::regex::match, not the path) are
+  /// reported. Empty reports every entry. Directories are descended whether
+  /// their name matches or not.
+  std::string name_pattern;
+  /// Report directories too, not only the other entries.
+  bool report_directories = false;
+  /// Entries of the root have depth 0. Directories at max_depth are reported
+  /// but not read.
+  std::size_t max_depth = std::numeric_limits<std::size_t>::max();
+  /// crawl_stream only: fill found::metadata. A callback calls
+  /// entry::metadata() instead.
+  bool with_metadata = false;
+};
+
+struct crawl_stats {
+  std::uint64_t directories = 0; // read
+  std::uint64_t entries = 0;     // seen, without "." and ".."
+  std::uint64_t reported = 0;
+  std::uint64_t errors = 0; // directories or metadata that could not be read
+};
+
+namespace detail {
+
+inline entry_type typeOfMode(std::uint32_t mode) noexcept {
+#if defined(__linux__)
+  switch (mode & S_IFMT) {
+  case S_IFREG:
+    return entry_type::regular;
+  case S_IFDIR:
+    return entry_type::directory;
+  case S_IFLNK:
+    return entry_type::symlink;
+  default:
+    return entry_type::other;
+  }
+#else
+  (void)mode;
+  return entry_type::unknown;
+#endif
+}
+
+#if defined(__linux__)
+
+inline entry_type typeOfDirent(unsigned char d_type) noexcept {
+  switch (d_type) {
+  case DT_REG:
+    return entry_type::regular;
+  case DT_DIR:
+    return entry_type::directory;
+  case DT_LNK:
+    return entry_type::symlink;
+  case DT_UNKNOWN:
+    return entry_type::unknown;
+  default:
+    return entry_type::other;
+  }
+}
+
+/// An open directory, read in batches of entries.
+class directory {
+public:
+  explicit directory(const std::string &path)
+      : m_fd(::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) {}
+
+  directory(const directory &) = delete;
+  directory &operator=(const directory &) = delete;
+
+  ~directory() {
+    if (m_fd >= 0) {
+      ::close(m_fd);
+    }
+  }
+
+  bool isOpen() const noexcept { return m_fd >= 0; }
+
+  /// Calls f(name, type) for every entry but "." and "..". Returns false if a
+  /// read failed, or as soon as f returns false.
+  template <typename F> bool forEach(F &&f) const {
+    alignas(8) char buffer[32 * 1024];
+    for (;;) {
+      const long bytes = ::syscall(SYS_getdents64, m_fd, buffer, sizeof(buffer));
+      if (bytes <= 0) {
+        return bytes == 0;
+      }
+      for (long pos = 0; pos < bytes;) {
+        // Records are 8-byte aligned and laid out as glibc's dirent64.
+        const auto *record = reinterpret_cast<const struct dirent64 *>(buffer + pos);
+        const char *name = record->d_name;
+        pos += record->d_reclen;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+          continue;
+        }
+        entry_type type = typeOfDirent(record->d_type);
+        if (type == entry_type::unknown) {
+          struct statx stx {};
+          if (::statx(m_fd, name, AT_SYMLINK_NOFOLLOW, STATX_TYPE, &stx) == 0) {
+            type = typeOfMode(stx.stx_mode);
+          }
+        }
+        if (!f(std::string_view(name), type)) {
+          return true;
+        }
+      }
+    }
+  }
+
+  /// statx relative to this directory: the kernel does not walk the path
+  /// from the root again.
+  bool metadata(const char *name, file_metadata &out) const noexcept {
+    struct statx stx {};
+    if (::statx(m_fd, name, AT_SYMLINK_NOFOLLOW,
+                STATX_TYPE | STATX_MODE | STATX_INO | STATX_SIZE | STATX_MTIME, &stx) != 0) {
+      return false;
+    }
+    out.size = stx.stx_size;
+    out.inode = stx.stx_ino;
+    out.mtime_ns = static_cast<std::int64_t>(stx.stx_mtime.tv_sec) * 1'000'000'000 +
+                   stx.stx_mtime.tv_nsec;
+    out.mode = stx.stx_mode;
+    return true;
+  }
+
+private:
+  int m_fd;
+};
+
+#else
+
+inline entry_type typeOfStatus(const std::filesystem::file_status &status) noexcept {
+  switch (status.type()) {
+  case std::filesystem::file_type::regular:
+    return entry_type::regular;
+  case std::filesystem::file_type::directory:
+    return entry_type::directory;
+  case std::filesystem::file_type::symlink:
+    return entry_type::symlink;
+  case std::filesystem::file_type::none:
+  case std::filesystem::file_type::unknown:
+    return entry_type::unknown;
+  default:
+    return entry_type::other;
+  }
+}
+
+/// Portable fallback on std::filesystem::directory_iterator.
+class directory {
+public:
+  explicit directory(const std::string &path) : m_path(path) {
+    std::error_code error;
+    m_iterator = std::filesystem::directory_iterator(m_path, error);
+    m_open = !error;
+  }
+
+  bool isOpen() const noexcept { return m_open; }
+
+  template <typename F> bool forEach(F &&f) const {
+    std::error_code error;
+    for (auto it = m_iterator; it != std::filesystem::directory_iterator(); it.increment(error)) {
+      if (error) {
+        return false;
+      }
+      const std::string name = it->path().filename().string();
+      if (!f(std::string_view(name), typeOfStatus(it->symlink_status(error)))) {
+        return true;
+      }
+    }
+    return !error;
+  }
+
+  bool metadata(const char *name, file_metadata &out) const noexcept {
+    std::error_code error;
+    const std::filesystem::path path = m_path / name;
+    const auto status = std::filesystem::symlink_status(path, error);
+    if (error) {
+      return false;
+    }
+    out.size = status.type() == std::filesystem::file_type::regular
+                   ? std::filesystem::file_size(path, error)
+                   : 0;
+    const auto time = std::filesystem::last_write_time(path, error);
+    out.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::file_clock::to_sys(time).time_since_epoch())
+                       .count();
+    out.mode = static_cast<std::uint32_t>(status.permissions());
+    return !error;
+  }
+
+private:
+  std::filesystem::path m_path;
+  std::filesystem::directory_iterator m_iterator;
+  bool m_open = false;
+};
+
+#endif
+
+/// Copies of one strings::regex, handed to one directory task at a time.
+class regex_pool {
+public:
+  explicit regex_pool(const std::string &pattern) {
+    if (!pattern.empty()) {
+      m_prototype.emplace(pattern);
+    }
+  }
+
+  bool empty() const noexcept { return !m_prototype.has_value(); }
+
+  std::unique_ptr<strings::regex> borrow() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_free.empty()) {
+        std::unique_ptr<strings::regex> regex = std::move(m_free.back());
+        m_free.pop_back();
+        return regex;
+      }
+    }
+    return std::make_unique<strings::regex>(*m_prototype);
+  }
+
+  void giveBack(std::unique_ptr<strings::regex> regex) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(std::move(regex));
+  }
+
+private:
+  std::optional<strings::regex> m_prototype;
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<strings::regex>> m_free;
+};
+
+template <typename Sink> class crawl_job;
+
+} // namespace detail
+
+/// One directory entry, valid during the callback it is passed to.
+class entry {
+public:
+  /// The path of the directory holding the entry, starting with the root as
+  /// given to crawl().
+  std::string_view directory() const noexcept { return m_directory; }
+  std::string_view name() const noexcept { return m_name; }
+  std::string path() const {
+    std::string path;
+    path.reserve(m_directory.size() + 1 + m_name.size());
+    path.append(m_directory);
+    if (!m_directory.empty() && m_directory.back() != '/') {
+      path.push_back('/');
+    }
+    path.append(m_name);
+    return path;
+  }
+  entry_type type() const noexcept { return m_type; }
+  std::size_t depth() const noexcept { return m_depth; }
+
+  /// Fetched on the first call; throws std::system_error if the entry cannot
+  /// be stat'ed any more.
+  const file_metadata &metadata() const {
+    if (!m_metadata) {
+      file_metadata data;
+      if (!m_dir->metadata(m_name.data(), data)) {
+        throw std::system_error(errno, std::generic_category(),
+                                "crawler::entry::metadata: cannot stat " + path());
+      }
+      m_metadata = data;
+    }
+    return *m_metadata;
+  }
+
+private:
+  template <typename Sink> friend class detail::crawl_job;
+
+  entry(const detail::directory &dir, std::string_view directory, std::string_view name,
+        entry_type type, std::size_t depth)
+      : m_dir(&dir), m_directory(directory), m_name(name), m_type(type), m_depth(depth) {}
+
+  const detail::directory *m_dir;
+  std::string_view m_directory;
+  std::string_view m_name; // '\0'-terminated
+  entry_type m_type;
+  std::size_t m_depth;
+  mutable std::optional<file_metadata> m_metadata;
+};
+
+namespace detail {
+
+/// The state shared by the directory tasks of one crawl. Sink::visit(entry)
+/// returns false to stop the crawl; Sink::finish() is called once, after the
+/// last task.
+template <typename Sink> class crawl_job {
+public:
+  crawl_job(thread_pool &pool, const options &opts, Sink &sink)
+      : m_pool(pool), m_options(opts), m_sink(sink), m_filters(opts.name_pattern) {}
+
+  void start(std::string root) { post(std::move(root), 0); }
+
+  /// Set by the last task as its very last action: then the job may go.
+  bool done() const noexcept { return m_done.load(std::memory_order_acquire); }
+
+  void stop() noexcept { m_stop.store(true, std::memory_order_relaxed); }
+
+  std::exception_ptr error() const {
+    std::lock_guard<std::mutex> lock(m_error_mutex);
+    return m_error;
+  }
+
+  crawl_stats stats() const noexcept {
+    return {m_directories.load(), m_entries.load(), m_reported.load(), m_errors.load()};
+  }
+
+  void countError() noexcept { m_errors.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+  thread_pool &m_pool;
+  const options &m_options;
+  Sink &m_sink;
+  regex_pool m_filters;
+
+  std::atomic<std::size_t> m_pending{0};
+  std::atomic<bool> m_stop{false};
+  std::atomic<bool> m_done{false};
+  mutable std::mutex m_error_mutex;
+  std::exception_ptr m_error;
+
+  std::atomic<std::uint64_t> m_directories{0};
+  std::atomic<std::uint64_t> m_entries{0};
+  std::atomic<std::uint64_t> m_reported{0};
+  std::atomic<std::uint64_t> m_errors{0};
+
+  void post(std::string path, std::size_t depth) {
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_pool.post([this, path = std::move(path), depth] {
+      try {
+        read(path, depth);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+        if (!m_error) {
+          m_error = std::current_exception();
+        }
+        m_stop.store(true, std::memory_order_relaxed);
+      }
+      if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_sink.finish();
+        m_done.store(true, std::memory_order_release);
+      }
+    });
+  }
+
+  // Reads the directory at `path`, whose entries have depth `depth`.
+  void read(const std::string &path, std::size_t depth) {
+    if (m_stop.load(std::memory_order_relaxed)) {
+      return;
+    }
+    const directory dir(path);
+    if (!dir.isOpen()) {
+      if (depth == 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "crawler::crawl: cannot open " + path);
+      }
+      countError();
+      return;
+    }
+    std::unique_ptr<strings::regex> filter;
+    if (!m_filters.empty()) {
+      filter = m_filters.borrow();
+    }
+    std::uint64_t entries = 0;
+    std::uint64_t reported = 0;
+    const bool complete = dir.forEach([&](std::string_view name, entry_type type) {
+      ++entries;
+      const bool is_directory = type == entry_type::directory;
+      if ((!is_directory || m_options.report_directories) && (!filter || filter->match(name))) {
+        ++reported;
+        entry e(dir, path, name, type, depth);
+        if (!m_sink.visit(e)) {
+          m_stop.store(true, std::memory_order_relaxed);
+          return false;
+        }
+      }
+      if (is_directory && depth < m_options.max_depth) {
+        std::string child;
+        child.reserve(path.size() + 1 + name.size());
+        child.append(path);
+        if (child.back() != '/') {
+          child.push_back('/');
+        }
+        child.append(name);
+        post(std::move(child), depth + 1);
+      }
+      return !m_stop.load(std::memory_order_relaxed);
+    });
+    if (filter) {
+      m_filters.giveBack(std::move(filter));
+    }
+    if (!complete) {
+      countError();
+    }
+    m_directories.fetch_add(1, std::memory_order_relaxed);
+    m_entries.fetch_add(entries, std::memory_order_relaxed);
+    m_reported.fetch_add(reported, std::memory_order_relaxed);
+  }
+};
+
+template <typename F> struct callback_sink {
+  F &f;
+
+  bool visit(const entry &e) {
+    if constexpr (std::is_same_v<std::invoke_result_t<F &, const entry &>, bool>) {
+      return f(e);
+    } else {
+      f(e);
+      return true;
+    }
+  }
+  void finish() noexcept {}
+};
+
+} // namespace detail
+
+/// Walks the tree under `root` on the workers of `pool` and calls f(entry) for
+/// every reported entry, concurrently from several threads and in no
+/// particular order. f may return false to stop the crawl; entries already
+/// being read may still be reported. The calling thread runs crawl tasks
+/// until the walk is done, so crawl() may be called from a pool task. The
+/// first exception thrown by f is rethrown here, as is a failure to open the
+/// root.
+template <typename F>
+crawl_stats crawl(std::string root, thread_pool &pool, F &&f, const options &opts = {}) {
+  detail::callback_sink<std::remove_reference_t<F>> sink{f};
+  detail::crawl_job<decltype(sink)> job(pool, opts, sink);
+  job.start(std::move(root));
+  while (!job.done()) {
+    if (!pool.run_pending_task()) {
+      std::this_thread::yield();
+    }
+  }
+  if (const std::exception_ptr error = job.error()) {
+    std::rethrow_exception(error);
+  }
+  return job.stats();
+}
+
+/// The path of some entry under `root` whose name matches `name_pattern`: the
+/// first one found, which is not always the same from run to run.
+inline std::optional<std::string> findAny(std::string root, thread_pool &pool,
+                                          std::string name_pattern) {
+  std::optional<std::string> found;
+  std::mutex mutex;
+  options opts;
+  opts.name_pattern = std::move(name_pattern);
+  crawl(
+      std::move(root), pool,
+      [&](const entry &e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!found) {
+          found = e.path();
+        }
+        return false;
+      },
+      opts);
+  return found;
+}
+
+/// An entry that outlives the crawl, as crawl_stream delivers it.
+struct found {
+  std::string path;
+  entry_type type = entry_type::unknown;
+  file_metadata metadata; // only with options::with_metadata
+};
+
+/// The results of a crawl as a channel: the crawl runs on the pool while the
+/// thread that owns the stream takes entries out with next(). The queue is
+/// bounded, so a slow reader holds the workers back instead of buffering the
+/// whole tree. Read the stream from outside the pool: a worker blocked in
+/// next() cannot run the crawl tasks that would fill it.
+class crawl_stream {
+public:
+  crawl_stream(std::string root, thread_pool &pool, options opts = {},
+               std::size_t capacity = 4096)
+      : m_options(std::move(opts)), m_queue(capacity), m_sink{this},
+        m_job(pool, m_options, m_sink) {
+    m_job.start(std::move(root));
+  }
+
+  crawl_stream(const crawl_stream &) = delete;
+  crawl_stream &operator=(const crawl_stream &) = delete;
+
+  /// Stops the crawl and waits for its tasks.
+  ~crawl_stream() {
+    m_job.stop();
+    found item;
+    while (!m_ended) {
+      m_queue.pop(item);
+      m_ended = m_sink.isEnd(item);
+    }
+    while (!m_job.done()) {
+      std::this_thread::yield();
+    }
+  }
+
+  /// Blocks until the next entry arrives. Returns false at the end of the
+  /// crawl, or rethrows what stopped it.
+  bool next(found &out) {
+    if (m_ended) {
+      return false;
+    }
+    m_queue.pop(out);
+    if (m_sink.isEnd(out)) {
+      m_ended = true;
+      while (!m_job.done()) {
+        std::this_thread::yield();
+      }
+      if (const std::exception_ptr error = m_job.error()) {
+        std::rethrow_exception(error);
+      }
+      return false;
+    }
+    return true;
+  }
+
+  /// Final once next() has returned false.
+  crawl_stats stats() const noexcept { return m_job.stats(); }
+
+private:
+  struct sink {
+    crawl_stream *stream;
+
+    bool visit(const entry &e) {
+      found item{e.path(), e.type(), {}};
+      if (stream->m_options.with_metadata) {
+        try {
+          item.metadata = e.metadata();
+        } catch (const std::system_error &) {
+          stream->m_job.countError(); // removed since it was listed
+          return true;
+        }
+      }
+      stream->m_queue.push(std::move(item));
+      return true;
+    }
+    // Real entries always have a path.
+    void finish() { stream->m_queue.push(found{}); }
+    static bool isEnd(const found &item) noexcept { return item.path.empty(); }
+  };
+
+  options m_options;
+  mpmc::queue<found> m_queue;
+  sink m_sink;
+  detail::crawl_job<sink> m_job;
+  bool m_ended = false;
+};
+
+} // namespace crawler
+
+#endif
@@ -0,0 +1,195 @@
+// Walking a synthetic tree of 1M files, in entries/s:
+// - std::filesystem::recursive_directory_iterator, counting the files, and
+//   with std::regex_match on each name: findFileWithRegexPattern()'s loop
+//   made recursive and run to the end
+// - crawler::crawl() counting, filtering the same names by strings::regex,
+//   and summing file sizes (std::filesystem::file_size against
+//   entry::metadata(), a statx per file)
+// - crawler::crawl_stream, the matches read on the benchmark thread
+// The crawler runs on 1, 2, 4 and 8 pool threads.
+//
+// The tree is 10 x 10 x 10 directories of 1000 files each, one name in ten
+// a ".ulg" log. It is generated once, which takes a minute, into the
+// subdirectory crawler_benchmark_tree of $CRAWLER_BENCHMARK_ROOT or else of
+// the temp directory, and kept for later runs: remove it by hand. Nothing
+// outside that subdirectory is written or deleted. Every run but the first
+// reads it from the page cache; a cold run needs
+// `echo 3 > /proc/sys/vm/drop_caches` as root.
+#include "crawler/crawler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <string>
+
+namespace {
+
+constexpr int fanout = 10;
+constexpr int files_per_directory = 1000;
+// Directories and files, and the ".complete" marker.
+constexpr std::int64_t tree_entries =
+    fanout + fanout * fanout + fanout * fanout * fanout * (1 + files_per_directory) + 1;
+constexpr const char *log_pattern = ".*\\.ulg";
+
+const std::string &treeRoot() {
+  static const std::string root = [] {
+    const char *env = std::getenv("CRAWLER_BENCHMARK_ROOT");
+    const std::filesystem::path parent =
+        env != nullptr ? std::filesystem::path(env) : std::filesystem::temp_directory_path();
+    // Always a directory of our own, never $CRAWLER_BENCHMARK_ROOT itself:
+    // an incomplete tree is deleted before it is generated again.
+    const std::filesystem::path root = parent / "crawler_benchmark_tree";
+    // Written last, so that an interrupted generation starts over.
+    const std::filesystem::path complete = root / ".complete";
+    if (!std::filesystem::exists(complete)) {
+      std::filesystem::remove_all(root);
+      for (int a = 0; a < fanout; ++a) {
+        for (int b = 0; b < fanout; ++b) {
+          for (int c = 0; c < fanout; ++c) {
+            const std::filesystem::path dir = root / ("a" + std::to_string(a)) /
+                                              ("b" + std::to_string(b)) / ("c" + std::to_string(c));
+            std::filesystem::create_directories(dir);
+            for (int f = 0; f < files_per_directory; ++f) {
+              char name[64];
+              std::snprintf(name, sizeof(name), "%d%d%d%03d-2023-02-23_16-13-23.%s", a, b, c, f,
+                            f % 10 == 0 ? "ulg" : "csv");
+              std::ofstream(dir / name) << name;
+            }
+          }
+        }
+      }
+      std::ofstream(complete) << "";
+    }
+    return root.string();
+  }();
+  return root;
+}
+
+void perEntry(benchmark::State &state) {
+  state.SetItemsProcessed(state.iterations() * tree_entries);
+}
+
+void BM_RecursiveDirectoryIterator(benchmark::State &state) {
+  const std::string &root = treeRoot();
+  for (auto _ : state) {
+    std::uint64_t files = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+      files += !entry.is_directory();
+    }
+    benchmark::DoNotOptimize(files);
+  }
+  perEntry(state);
+}
+
+void BM_RecursiveDirectoryIteratorRegex(benchmark::State &state) {
+  const std::string &root = treeRoot();
+  const std::regex regex(log_pattern);
+  for (auto _ : state) {
+    std::uint64_t matches = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+      matches += !entry.is_directory() && std::regex_match(entry.path().filename().string(), regex);
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  perEntry(state);
+}
+
+void BM_RecursiveDirectoryIteratorSize(benchmark::State &state) {
+  const std::string &root = treeRoot();
+  for (auto _ : state) {
+    std::uint64_t bytes = 0;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+      if (entry.is_regular_file()) {
+        bytes += entry.file_size();
+      }
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+  perEntry(state);
+}
+
+template <typename F> void crawlBenchmark(benchmark::State &state, const crawler::options &opts,
+                                          F &&visit) {
+  const std::string &root = treeRoot();
+  thread_pool pool(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(crawler::crawl(root, pool, visit, opts).reported);
+  }
+  perEntry(state);
+}
+
+void BM_Crawl(benchmark::State &state) {
+  std::atomic<std::uint64_t> files{0};
+  crawlBenchmark(state, {}, [&](const crawler::entry &) {
+    files.fetch_add(1, std::memory_order_relaxed);
+  });
+}
+
+void BM_CrawlRegex(benchmark::State &state) {
+  crawler::options opts;
+  opts.name_pattern = log_pattern;
+  std::atomic<std::uint64_t> matches{0};
+  crawlBenchmark(state, opts, [&](const crawler::entry &) {
+    matches.fetch_add(1, std::memory_order_relaxed);
+  });
+}
+
+void BM_CrawlSize(benchmark::State &state) {
+  std::atomic<std::uint64_t> bytes{0};
+  crawlBenchmark(state, {}, [&](const crawler::entry &e) {
+    if (e.type() == crawler::entry_type::regular) {
+      bytes.fetch_add(e.metadata().size, std::memory_order_relaxed);
+    }
+  });
+}
+
+void BM_CrawlStream(benchmark::State &state) {
+  const std::string &root = treeRoot();
+  thread_pool pool(static_cast<std::size_t>(state.range(0)));
+  crawler::options opts;
+  opts.name_pattern = log_pattern;
+  for (auto _ : state) {
+    crawler::crawl_stream stream(root, pool, opts);
+    crawler::found item;
+    std::uint64_t matches = 0;
+    while (stream.next(item)) {
+      ++matches;
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  perEntry(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_RecursiveDirectoryIterator)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RecursiveDirectoryIteratorRegex)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RecursiveDirectoryIteratorSize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Crawl)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_CrawlRegex)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_CrawlSize)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_CrawlStream)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -39,6 +39,9 @@ void filesystemExample() {
   // fs::path("a/./b/..").lexically_normal() == "a/"
 }
 
+// A single-threaded walk that builds a path per entry. For large trees see
+// crawler::crawl() in crawler/crawler.hpp: parallel, getdents64-based, and
+// statx only for the entries whose metadata is asked for.
 void directoryIterator() {
 
   std::filesystem::create_directories(std::filesystem::temp_directory_path() /
@@ -1,3 +1,5 @@
+#include "hashing.hpp"
+
 #include <iostream>
 #include <set>
 #include <string>
@@ -28,15 +30,19 @@ public:
 class CourseHashFunction {
 public:
   std::size_t operator()(const Course &k) const {
-    // We use predfined hash functions of string and bool and define our hash
-    // function as XOR of the hash values.
-    return (std::hash<std::string>()(k.m_name)) ^
-           (std::hash<bool>()(k.m_isAdvanced));
+    // Combine the hashes of the fields with hashCombine, which mixes each one
+    // in. A plain XOR of std::hash<std::string> and std::hash<bool> would map
+    // {"x", true} and {"y", false} to each other whenever the string hashes
+    // differ only in the lowest bit.
+    return hashing::hashCombine(hashing::hashValue(k.m_name),
+                                hashing::hashValue(k.m_isAdvanced));
   }
 };
 
 // Example 2
 
+// strings/interner.hpp stores each distinct name once and makes the two name
+// fields 4-byte symbols.
 class student {
 public:
   int id;
@@ -53,16 +59,9 @@ namespace std {
 
 template <> struct hash<student> {
   std::size_t operator()(const student &k) const {
-
-    // Compute individual hash values for first,
-    // second and third and combine them using XOR
-    // and bit shifting:
-
-    return ((std::hash<string>()(k.first_name) ^
-             (std::hash<string>()(k.last_name) << 1)) >>
-            1) ^
-           (std::hash<int>()(k.id) << 1);
-    ;
+    // student is an aggregate (public fields, no constructors), so
+    // hashing::hashValue can walk its fields by itself and combine them.
+    return hashing::hashValue(k);
   }
 };
 
@@ -73,20 +72,50 @@ template <> struct hash<student> {
 
 struct KeyHasher {
   std::size_t operator()(const student &k) const {
-
-    return ((std::hash<std::string>()(k.first_name) ^
-             (std::hash<std::string>()(k.last_name) << 1)) >>
-            1) ^
-           (std::hash<int>()(k.id) << 1);
+    std::size_t seed = hashing::hashValue(k.id);
+    seed = hashing::hashCombine(seed, hashing::hashValue(k.first_name));
+    seed = hashing::hashCombine(seed, hashing::hashValue(k.last_name));
+    return seed;
   }
 };
 
+// Or skip writing a hasher: hashing::hash<T> handles aggregates, strings,
+// pairs, tuples and containers.
+using StudentHasher = hashing::hash<student>;
+
 void unordered_mapCustomClasstype() {
   std::unordered_map<student, std::string> student_umap = {
       {{1, "John", "Doe"}, "example"}, {{2, "Mary", "Sue"}, "another"}};
 
   std::unordered_map<student, std::string, KeyHasher> m6 = {
       {{1, "John", "Doe"}, "example"}, {{2, "Mary", "Sue"}, "another"}};
+
+  std::unordered_map<student, std::string, StudentHasher> m7 = {
+      {{1, "John", "Doe"}, "example"}, {{2, "Mary", "Sue"}, "another"}};
+
+  std::unordered_map<Course, int, CourseHashFunction> course_umap = {
+      {{"Algorithms", true}, 1}, {{"Algorithms", false}, 2}};
+  std::cout << "courses: " << course_umap.size() << ", students: " << m7.size()
+            << std::endl;
+}
+
+// The combiner the examples above used to have, h1 ^ (h2 << 1), on keys with
+// two small int fields: std::hash<int> is the identity, so the result is
+// x ^ (2 * y) and thousands of distinct keys share a hash value.
+void xorCombinerCollisions() {
+  std::set<std::size_t> xor_hashes;
+  std::set<std::size_t> combined_hashes;
+  int keys = 0;
+  for (int x = 0; x < 100; ++x) {
+    for (int y = 0; y < 100; ++y) {
+      xor_hashes.insert(std::hash<int>()(x) ^ (std::hash<int>()(y) << 1));
+      combined_hashes.insert(hashing::hashValue(std::pair{x, y}));
+      ++keys;
+    }
+  }
+  std::cout << keys << " keys {x, y}: " << xor_hashes.size()
+            << " distinct hashes with h(x) ^ (h(y) << 1), " << combined_hashes.size()
+            << " with hashCombine" << std::endl;
 }
 
 void sizeOfTheHashTable() {
@@ -119,5 +148,6 @@ void sizeOfTheHashTable() {
 
 int main() {
   unordered_mapCustomClasstype();
+  xorCombinerCollisions();
   sizeOfTheHashTable();
 }
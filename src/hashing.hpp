@@ -0,0 +1,294 @@
+#ifndef HASHING_HPP
+#define HASHING_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+///
+/// Hash functions for hash-table keys.
+///
+/// - hashBytes(): a wyhash-style byte hasher. It reads 8 or 16 bytes per step
+///   and folds them in with 64x64->128-bit multiplies. Every input bit
+///   affects every output bit, and it runs at several GB/s for long inputs.
+///   Short strings (<= 16 bytes) take two multiplies.
+/// - mix(): a 64-bit finalizer (xor-shift-multiply), so that keys that differ
+///   in a few low bits (ids, counters, pointers) get unrelated hashes.
+/// - hashCombine(seed, value): mixes every combined value. The XOR-and-shift
+///   combiners (`h1 ^ (h2 << 1)`) cancel out equal or related fields: {1, 2}
+///   and {3, 3} collide, and so do all {x, x}.
+/// - hashing::hash<T>: a functor for std::unordered_map and
+///   containers::flat_hash_map. It handles arithmetic types, strings (char
+///   pointers are hashed as C strings), pairs, tuples and ranges. It also
+///   handles aggregates: a plain struct of hashable fields, such as
+///   `struct student { int id; std::string first_name, last_name; }`, is
+///   hashed field by field without writing a hash function for it. Other
+///   types fall back to std::hash mixed with mix().
+///
+/// The hashes are for hash tables, not for security: they are not
+/// cryptographic and, with the default seed, not resistant to keys crafted
+/// to collide.
+///
+
+namespace hashing {
+
+namespace detail {
+
+// The 128-bit product of a and b, folded into a (low) and b (high).
+inline void multiply128(std::uint64_t &a, std::uint64_t &b) noexcept {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<std::uint64_t>(r);
+  b = static_cast<std::uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  a = _umul128(a, b, &b);
+#else
+  const std::uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+  const std::uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+  const std::uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+  const std::uint64_t hi_hi = (a >> 32) * (b >> 32);
+  const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  a = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  b = hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+inline std::uint64_t multiplyMix(std::uint64_t a, std::uint64_t b) noexcept {
+  multiply128(a, b);
+  return a ^ b;
+}
+
+inline std::uint64_t read8(const unsigned char *p) noexcept {
+  std::uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline std::uint64_t read4(const unsigned char *p) noexcept {
+  std::uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+// 1 to 3 bytes: the first, middle and last byte, which covers all of them.
+inline std::uint64_t read1to3(const unsigned char *p, std::size_t n) noexcept {
+  return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[n >> 1]} << 8) | p[n - 1];
+}
+
+constexpr std::uint64_t secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                     0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+} // namespace detail
+
+constexpr std::uint64_t default_seed = 0x9E3779B97F4A7C15ull;
+
+/// Hashes `size` bytes at `data` (the wyhash construction).
+inline std::uint64_t hashBytes(const void *data, std::size_t size,
+                               std::uint64_t seed = default_seed) noexcept {
+  using detail::multiplyMix;
+  using detail::read8;
+  using detail::secret;
+  const auto *p = static_cast<const unsigned char *>(data);
+  seed ^= multiplyMix(seed ^ secret[0], secret[1]);
+  std::uint64_t a;
+  std::uint64_t b;
+  if (size <= 16) {
+    if (size >= 4) {
+      // Two overlapping 4-byte reads from each end cover 4..16 bytes.
+      const std::size_t middle = (size >> 3) << 2;
+      a = (detail::read4(p) << 32) | detail::read4(p + middle);
+      b = (detail::read4(p + size - 4) << 32) | detail::read4(p + size - 4 - middle);
+    } else if (size > 0) {
+      a = detail::read1to3(p, size);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    std::size_t i = size;
+    if (i > 48) {
+      // Three independent lanes keep three multipliers busy.
+      std::uint64_t lane1 = seed;
+      std::uint64_t lane2 = seed;
+      do {
+        seed = multiplyMix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+        lane1 = multiplyMix(read8(p + 16) ^ secret[2], read8(p + 24) ^ lane1);
+        lane2 = multiplyMix(read8(p + 32) ^ secret[3], read8(p + 40) ^ lane2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while (i > 16) {
+      seed = multiplyMix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    // The last 16 bytes, overlapping what was already consumed.
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+  a ^= secret[1];
+  b ^= seed;
+  detail::multiply128(a, b);
+  return multiplyMix(a ^ secret[0] ^ size, b ^ secret[1]);
+}
+
+inline std::uint64_t hashString(std::string_view s, std::uint64_t seed = default_seed) noexcept {
+  return hashBytes(s.data(), s.size(), seed);
+}
+
+/// Full-avalanche 64-bit finalizer: each input bit flips each output bit with
+/// probability close to 1/2.
+constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+  x ^= x >> 32;
+  x *= 0xD6E8FEB86659FD93ull;
+  x ^= x >> 32;
+  x *= 0xD6E8FEB86659FD93ull;
+  x ^= x >> 32;
+  return x;
+}
+
+/// Folds `value` into `seed`. The order matters: combining {a, b} and {b, a}
+/// gives different results.
+constexpr std::size_t hashCombine(std::size_t seed, std::size_t value) noexcept {
+  return static_cast<std::size_t>(mix(seed + 0x9E3779B97F4A7C15ull + value));
+}
+
+namespace detail {
+
+// Converts to any field type, to count the fields of an aggregate by trying
+// T{field, field, ...} with more and more fields.
+struct any_field {
+  template <typename T> operator T() const;
+};
+
+template <typename T, typename... Fields> consteval std::size_t fieldCount() {
+  if constexpr (requires { T{Fields{}..., any_field{}}; }) {
+    return fieldCount<T, Fields..., any_field>();
+  } else {
+    return sizeof...(Fields);
+  }
+}
+
+constexpr std::size_t max_reflected_fields = 8;
+
+// The fields of an aggregate as a tuple of references, through structured
+// bindings.
+template <typename T> auto tieFields(const T &v) {
+  constexpr std::size_t n = fieldCount<T>();
+  if constexpr (n == 1) {
+    const auto &[f1] = v;
+    return std::tie(f1);
+  } else if constexpr (n == 2) {
+    const auto &[f1, f2] = v;
+    return std::tie(f1, f2);
+  } else if constexpr (n == 3) {
+    const auto &[f1, f2, f3] = v;
+    return std::tie(f1, f2, f3);
+  } else if constexpr (n == 4) {
+    const auto &[f1, f2, f3, f4] = v;
+    return std::tie(f1, f2, f3, f4);
+  } else if constexpr (n == 5) {
+    const auto &[f1, f2, f3, f4, f5] = v;
+    return std::tie(f1, f2, f3, f4, f5);
+  } else if constexpr (n == 6) {
+    const auto &[f1, f2, f3, f4, f5, f6] = v;
+    return std::tie(f1, f2, f3, f4, f5, f6);
+  } else if constexpr (n == 7) {
+    const auto &[f1, f2, f3, f4, f5, f6, f7] = v;
+    return std::tie(f1, f2, f3, f4, f5, f6, f7);
+  } else {
+    static_assert(n == 8, "aggregates with more than 8 fields need a hash function");
+    const auto &[f1, f2, f3, f4, f5, f6, f7, f8] = v;
+    return std::tie(f1, f2, f3, f4, f5, f6, f7, f8);
+  }
+}
+
+template <typename T>
+concept string_like = std::is_convertible_v<const T &, std::string_view>;
+
+template <typename T>
+concept tuple_like = requires { std::tuple_size<T>::value; } && !std::ranges::range<T>;
+
+// Aggregates whose fields can be counted: no base classes, no C arrays
+// (brace elision would count their elements as fields).
+template <typename T>
+concept reflectable = std::is_aggregate_v<T> && !std::is_array_v<T> &&
+                      !std::ranges::range<T> && !tuple_like<T> && std::is_class_v<T> &&
+                      fieldCount<T>() > 0 && fieldCount<T>() <= max_reflected_fields;
+
+} // namespace detail
+
+template <typename T = void> struct hash;
+
+/// Hashes any supported value; hashing::hash<> is the transparent version.
+template <typename T> std::size_t hashValue(const T &value) noexcept {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (detail::string_like<U>) {
+    return static_cast<std::size_t>(hashString(std::string_view(value)));
+  } else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+    return static_cast<std::size_t>(mix(static_cast<std::uint64_t>(value)));
+  } else if constexpr (std::is_pointer_v<U>) {
+    return static_cast<std::size_t>(mix(reinterpret_cast<std::uintptr_t>(value)));
+  } else if constexpr (std::is_floating_point_v<U>) {
+    // +0.0 and -0.0 compare equal and must hash equal.
+    const U v = value == U{} ? U{} : value;
+    return static_cast<std::size_t>(hashBytes(&v, sizeof(v)));
+  } else if constexpr (detail::tuple_like<U>) {
+    return std::apply(
+        [](const auto &...fields) {
+          std::size_t seed = 0;
+          ((seed = hashCombine(seed, hashValue(fields))), ...);
+          return seed;
+        },
+        value);
+  } else if constexpr (std::ranges::range<U>) {
+    std::size_t seed = 0;
+    std::size_t count = 0;
+    for (const auto &element : value) {
+      seed = hashCombine(seed, hashValue(element));
+      ++count;
+    }
+    return hashCombine(seed, count);
+  } else if constexpr (detail::reflectable<U>) {
+    return hashValue(detail::tieFields(value));
+  } else {
+    return static_cast<std::size_t>(mix(std::hash<U>{}(value)));
+  }
+}
+
+/// Drop-in Hash argument for unordered containers. is_avalanching tells
+/// containers that the result needs no further mixing.
+///
+/// operator() is deliberately not noexcept: libstdc++'s std::unordered_map
+/// stores the hash in each node only for hashers that may throw, and
+/// without it every node visited in a bucket is hashed again.
+template <typename T> struct hash {
+  using is_avalanching = void;
+  std::size_t operator()(const T &value) const { return hashValue(value); }
+};
+
+template <> struct hash<void> {
+  using is_transparent = void;
+  using is_avalanching = void;
+  template <typename T> std::size_t operator()(const T &value) const {
+    return hashValue(value);
+  }
+};
+
+} // namespace hashing
+
+#endif
@@ -0,0 +1,148 @@
+// hashing.hpp against std::hash and the XOR-and-shift combiners that hash.cpp
+// used to have:
+// - throughput of the byte hasher against std::hash<std::string_view>
+//   (murmur-based in libstdc++) from 8 bytes to 4 KiB
+// - std::unordered_map lookups with composite keys, hashed with
+//   h1 ^ (h2 << 1) and with hashing::hash. The counters report the share of
+//   keys whose full hash collides with another key's (`collisions`) and the
+//   mean number of keys per occupied bucket (`chain`).
+#include "hashing.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+template <typename Hasher> void BM_HashString(benchmark::State &state) {
+  const auto length = static_cast<std::size_t>(state.range(0));
+  std::mt19937_64 gen(42);
+  std::vector<std::string> inputs(64);
+  for (auto &s : inputs) {
+    for (std::size_t i = 0; i < length; ++i) {
+      s.push_back(static_cast<char>('a' + gen() % 26));
+    }
+  }
+  Hasher hasher;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hasher(std::string_view(inputs[i++ & 63])));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+using std_string_hash = std::hash<std::string_view>;
+using wy_string_hash = hashing::hash<std::string_view>;
+
+// Grid coordinates, the textbook victim of XOR combining: with the identity
+// std::hash<int>, x ^ (y << 1) has only a few hundred distinct values for a
+// 256 x 256 grid.
+struct point {
+  int x;
+  int y;
+  bool operator==(const point &) const = default;
+};
+
+struct xor_point_hash {
+  std::size_t operator()(const point &p) const {
+    return std::hash<int>()(p.x) ^ (std::hash<int>()(p.y) << 1);
+  }
+};
+
+// Students with ids and names drawn from small pools, hashed with the
+// combiner from the old std::hash<student>.
+struct student {
+  int id;
+  std::string first_name;
+  std::string last_name;
+  bool operator==(const student &) const = default;
+};
+
+struct xor_student_hash {
+  std::size_t operator()(const student &k) const {
+    return ((std::hash<std::string>()(k.first_name) ^
+             (std::hash<std::string>()(k.last_name) << 1)) >>
+            1) ^
+           (std::hash<int>()(k.id) << 1);
+  }
+};
+
+std::vector<point> gridKeys(std::size_t n) {
+  std::vector<point> keys;
+  const int side = 1 << (std::bit_width(n - 1) / 2 + std::bit_width(n - 1) % 2);
+  for (int x = 0; x < side && keys.size() < n; ++x) {
+    for (int y = 0; y < side && keys.size() < n; ++y) {
+      keys.push_back({x, y});
+    }
+  }
+  return keys;
+}
+
+std::vector<student> studentKeys(std::size_t n) {
+  const char *first[] = {"John", "Mary", "Ali", "Mei", "Olga", "Raj", "Ana", "Tom"};
+  const char *last[] = {"Doe", "Sue", "Khan", "Wang", "Ivanova", "Patel", "Silva", "Lee"};
+  std::vector<student> keys;
+  for (std::size_t i = 0; i < n; ++i) {
+    keys.push_back({static_cast<int>(i / 64), first[i % 8], last[(i / 8) % 8]});
+  }
+  return keys;
+}
+
+template <typename Key, typename Hasher>
+void lookup(benchmark::State &state, const std::vector<Key> &keys) {
+  std::unordered_map<Key, int, Hasher> map;
+  std::unordered_set<std::size_t> hashes;
+  for (const Key &k : keys) {
+    map.emplace(k, 1);
+    hashes.insert(Hasher()(k));
+  }
+  std::size_t occupied = 0;
+  for (std::size_t b = 0; b < map.bucket_count(); ++b) {
+    occupied += map.bucket_size(b) != 0;
+  }
+
+  std::mt19937_64 gen(1);
+  std::vector<const Key *> queries(1 << 12);
+  for (auto &q : queries) {
+    q = &keys[gen() % keys.size()];
+  }
+  std::size_t i = 0;
+  int found = 0;
+  for (auto _ : state) {
+    found += map.find(*queries[i++ & 4095])->second;
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations());
+  state.counters["collisions"] =
+      1.0 - static_cast<double>(hashes.size()) / static_cast<double>(keys.size());
+  state.counters["chain"] =
+      static_cast<double>(keys.size()) / static_cast<double>(occupied);
+}
+
+template <typename Hasher> void BM_PointLookup(benchmark::State &state) {
+  lookup<point, Hasher>(state, gridKeys(static_cast<std::size_t>(state.range(0))));
+}
+
+template <typename Hasher> void BM_StudentLookup(benchmark::State &state) {
+  lookup<student, Hasher>(state, studentKeys(static_cast<std::size_t>(state.range(0))));
+}
+
+using wy_point_hash = hashing::hash<point>;
+using wy_student_hash = hashing::hash<student>;
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_HashString, std_string_hash)->RangeMultiplier(4)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_HashString, wy_string_hash)->RangeMultiplier(4)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_PointLookup, xor_point_hash)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PointLookup, wy_point_hash)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StudentLookup, xor_student_hash)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StudentLookup, wy_student_hash)->Arg(1 << 12)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
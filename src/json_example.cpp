@@ -4,6 +4,8 @@
 #include <string>
 using json = nlohmann::json;
 
+// Every object repeats the same keys; strings/interner.hpp turns repeated
+// strings into 4-byte symbols.
 void jsonTypes() {
   /**/
   json j = {{"name", "John"},
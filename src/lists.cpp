@@ -13,6 +13,9 @@ list allows cheap insertions, but slow access (because the list has to be
 traversed to reach any item)
 */
 
+// For lists of many small elements, containers/chunked_list.hpp links chunks
+// of elements instead (unrolled_list, colony); see docs/containers.md.
+
 void print(std::list<int> &list) {
   std::cout << "Iterating through the list" << std::endl;
   for (auto i : list)
@@ -3,6 +3,8 @@
 #include <unordered_map>
 #include <mutex>
 
+// Many items share a name; strings/interner.hpp (in the main tree) keeps one
+// copy of each and compares names as integers.
 struct Item {
     int id;
     std::string name;
@@ -0,0 +1,501 @@
+#ifndef ASYNC_LOGGER_HPP
+#define ASYNC_LOGGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+///
+/// An asynchronous logger: the calling thread never formats, never locks and
+/// never touches the file.
+///
+/// log() copies the raw arguments (plus a pointer to the format string and to
+/// a type-specific decoder) into a lock-free single-producer/single-consumer
+/// ring buffer owned by the calling thread. One background thread drains the
+/// rings of all threads, turns the records into text and hands the batches to
+/// the kernel with a single writev() per round.
+///
+/// Format strings use "{}" placeholders and must outlive the logger (string
+/// literals do). Arguments may be arithmetic types, bool, char, const char*,
+/// std::string and std::string_view; strings are copied, so they may die
+/// right after log() returns.
+///
+
+namespace async_log {
+
+namespace detail {
+
+/// Ring buffer of variable-sized records with one writer and one reader.
+/// Records never wrap: if one does not fit before the end, the writer fills the
+/// tail with a padding record and starts again at offset 0.
+class spsc_ring {
+public:
+  explicit spsc_ring(std::size_t capacity)
+      : m_capacity(roundUpPow2(capacity)), m_mask(m_capacity - 1),
+        m_data(new std::byte[m_capacity]) {}
+
+  /// The largest record that always fits once the ring is drained: a record
+  /// that does not fit before the end also needs the padding in front of it.
+  std::size_t maxRecord() const { return m_capacity / 2; }
+
+  /// Producer: returns room for `size` bytes (a multiple of 8, at most
+  /// maxRecord()) or nullptr if the ring is full.
+  std::byte *reserve(std::size_t size) {
+    const std::size_t write = m_write.load(std::memory_order_relaxed);
+    const std::size_t offset = write & m_mask;
+    const std::size_t contiguous = m_capacity - offset;
+    const std::size_t needed = size <= contiguous ? size : contiguous + size;
+    if (write + needed - m_cached_read > m_capacity) {
+      m_cached_read = m_read.load(std::memory_order_acquire);
+      if (write + needed - m_cached_read > m_capacity) {
+        return nullptr;
+      }
+    }
+    if (size > contiguous) {
+      writeHeader(m_data.get() + offset, contiguous, padding);
+      m_write.store(write + contiguous, std::memory_order_release);
+      return m_data.get();
+    }
+    return m_data.get() + offset;
+  }
+
+  /// Producer: publishes the record written into the last reserve().
+  void commit(std::size_t size) {
+    m_write.store(m_write.load(std::memory_order_relaxed) + size,
+                  std::memory_order_release);
+  }
+
+  /// Consumer: calls f(record, size) for every published record and frees
+  /// them. Returns the number of records consumed.
+  template <typename F> std::size_t drain(F &&f) {
+    std::size_t read = m_read.load(std::memory_order_relaxed);
+    const std::size_t write = m_write.load(std::memory_order_acquire);
+    std::size_t count = 0;
+    while (read != write) {
+      const std::byte *p = m_data.get() + (read & m_mask);
+      std::uint32_t size, kind;
+      std::memcpy(&size, p, sizeof(size));
+      std::memcpy(&kind, p + sizeof(size), sizeof(kind));
+      if (kind != padding) {
+        f(p, size);
+        ++count;
+      }
+      read += size;
+    }
+    m_read.store(read, std::memory_order_release);
+    return count;
+  }
+
+  bool empty() const {
+    return m_read.load(std::memory_order_acquire) ==
+           m_write.load(std::memory_order_acquire);
+  }
+
+  static constexpr std::uint32_t padding = 0;
+  static constexpr std::uint32_t record = 1;
+
+  static void writeHeader(std::byte *p, std::size_t size, std::uint32_t kind) {
+    const auto s = static_cast<std::uint32_t>(size);
+    std::memcpy(p, &s, sizeof(s));
+    std::memcpy(p + sizeof(s), &kind, sizeof(kind));
+  }
+
+private:
+  static std::size_t roundUpPow2(std::size_t n) {
+    std::size_t p = 64;
+    while (p < n) {
+      p <<= 1;
+    }
+    return p;
+  }
+
+  const std::size_t m_capacity;
+  const std::size_t m_mask;
+  const std::unique_ptr<std::byte[]> m_data;
+
+  alignas(64) std::atomic<std::size_t> m_write{0};
+  std::size_t m_cached_read = 0; // producer's last view of m_read
+  alignas(64) std::atomic<std::size_t> m_read{0};
+};
+
+// How each argument type is stored in the ring and read back.
+template <typename T> struct codec {
+  static_assert(std::is_arithmetic_v<T>,
+                "async_log supports arithmetic and string arguments");
+  using stored = T;
+  static std::size_t size(const T &) { return sizeof(T); }
+  static std::byte *write(std::byte *p, const T &v) {
+    std::memcpy(p, &v, sizeof(T));
+    return p + sizeof(T);
+  }
+  static const std::byte *read(const std::byte *p, T &v) {
+    std::memcpy(&v, p, sizeof(T));
+    return p + sizeof(T);
+  }
+};
+
+struct string_codec {
+  using stored = std::string_view;
+  static std::size_t size(std::string_view s) {
+    return sizeof(std::uint32_t) + s.size();
+  }
+  static std::byte *write(std::byte *p, std::string_view s) {
+    const auto n = static_cast<std::uint32_t>(s.size());
+    std::memcpy(p, &n, sizeof(n));
+    std::memcpy(p + sizeof(n), s.data(), n);
+    return p + sizeof(n) + n;
+  }
+  static const std::byte *read(const std::byte *p, std::string_view &s) {
+    std::uint32_t n;
+    std::memcpy(&n, p, sizeof(n));
+    s = std::string_view(reinterpret_cast<const char *>(p + sizeof(n)), n);
+    return p + sizeof(n) + n;
+  }
+};
+
+template <> struct codec<std::string> : string_codec {};
+template <> struct codec<std::string_view> : string_codec {};
+template <> struct codec<const char *> : string_codec {};
+template <> struct codec<char *> : string_codec {};
+
+template <typename T>
+using codec_for = codec<std::conditional_t<
+    std::is_array_v<std::remove_reference_t<T>>, const char *,
+    std::remove_cv_t<std::remove_reference_t<T>>>>;
+
+inline void appendValue(std::string &out, std::string_view v) { out += v; }
+inline void appendValue(std::string &out, bool v) {
+  out += v ? "true" : "false";
+}
+inline void appendValue(std::string &out, char v) { out += v; }
+template <typename T>
+std::enable_if_t<std::is_arithmetic_v<T>> appendValue(std::string &out, T v) {
+  char buf[64];
+  auto result = std::to_chars(buf, buf + sizeof(buf), v);
+  out.append(buf, result.ptr);
+}
+
+// Copies the format string up to the next "{}" and skips the placeholder.
+inline void appendLiteral(std::string &out, std::string_view &fmt) {
+  const std::size_t pos = fmt.find("{}");
+  if (pos == std::string_view::npos) {
+    out += fmt;
+    fmt = {};
+  } else {
+    out.append(fmt.data(), pos);
+    fmt.remove_prefix(pos + 2);
+  }
+}
+
+// Fixed part of every record, followed by the encoded arguments.
+struct record_header {
+  std::uint32_t size;
+  std::uint32_t kind;
+  void (*format)(const char *fmt, const std::byte *args, std::string &out);
+  const char *fmt;
+  std::int64_t timestamp_ns; // system_clock
+  std::uint64_t thread;
+};
+
+template <typename... Args>
+void formatRecord(const char *fmt, const std::byte *p, std::string &out) {
+  std::tuple<typename codec_for<Args>::stored...> values;
+  std::apply(
+      [&p](auto &...v) { ((p = codec_for<Args>::read(p, v)), ...); }, values);
+
+  std::string_view rest(fmt);
+  std::apply(
+      [&](const auto &...v) {
+        ((appendLiteral(out, rest), appendValue(out, v)), ...);
+      },
+      values);
+  out += rest;
+}
+
+inline void appendTimestamp(std::string &out, std::int64_t ns) {
+  // seconds.microseconds since the epoch; cheap and unambiguous.
+  char buf[32];
+  auto r = std::to_chars(buf, buf + sizeof(buf), ns / 1'000'000'000);
+  *r.ptr++ = '.';
+  const auto micros = static_cast<int>((ns / 1000) % 1'000'000);
+  for (int div = 100'000; div > 0; div /= 10) {
+    *r.ptr++ = static_cast<char>('0' + (micros / div) % 10);
+  }
+  out.append(buf, r.ptr);
+}
+
+} // namespace detail
+
+class logger {
+public:
+  /// ring_bytes is the per-thread buffer size; a thread whose buffer is full
+  /// waits for the flusher rather than losing messages. A single record larger
+  /// than half the buffer could never fit and is dropped (see dropped()).
+  explicit logger(const std::string &path, std::size_t ring_bytes = 1 << 20)
+      : m_id(nextId()), m_ring_bytes(ring_bytes) {
+#if defined(_WIN32)
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+#else
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+#endif
+      throw std::runtime_error("async_log::logger: cannot open " + path);
+    }
+    m_flusher = std::thread([this] { flusherLoop(); });
+  }
+
+  logger(const logger &) = delete;
+  logger &operator=(const logger &) = delete;
+
+  /// Writes everything that was logged before the call, then closes the file.
+  ~logger() {
+    {
+      std::lock_guard<std::mutex> lock(m_wake_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_one();
+    m_flusher.join();
+#if defined(_WIN32)
+    std::fclose(m_file);
+#else
+    ::close(m_fd);
+#endif
+  }
+
+  template <std::size_t N, typename... Args>
+  void log(const char (&fmt)[N], const Args &...args) {
+    using detail::codec_for;
+    const std::size_t payload =
+        sizeof(detail::record_header) + (codec_for<Args>::size(args) + ... + 0);
+    const std::size_t size = (payload + 7) & ~std::size_t{7};
+
+    detail::spsc_ring &ring = threadRing();
+    if (size > ring.maxRecord()) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    std::byte *p;
+    while (!(p = ring.reserve(size))) {
+      m_wake.notify_one();
+      std::this_thread::yield();
+    }
+
+    detail::record_header header{
+        static_cast<std::uint32_t>(size), detail::spsc_ring::record,
+        &detail::formatRecord<Args...>, fmt,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count(),
+        threadNumber()};
+    std::memcpy(p, &header, sizeof(header));
+    std::byte *args_begin = p + sizeof(header);
+    ((args_begin = codec_for<Args>::write(args_begin, args)), ...);
+    ring.commit(size);
+  }
+
+  /// Records dropped because they were larger than half of ring_bytes.
+  std::uint64_t dropped() const {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+  /// Blocks until everything logged before the call is in the kernel.
+  void flush() {
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    const std::uint64_t target = ++m_flush_requested;
+    m_wake.notify_one();
+    m_flushed.wait(lock, [&] { return m_flush_done >= target; });
+  }
+
+private:
+  struct producer {
+    std::shared_ptr<detail::spsc_ring> ring;
+  };
+
+  static std::uint64_t nextId() {
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+  }
+
+  static std::uint64_t threadNumber() {
+    static std::atomic<std::uint64_t> counter{0};
+    thread_local const std::uint64_t number = ++counter;
+    return number;
+  }
+
+  // The calling thread's ring for this logger, created and registered on the
+  // first log() call. Only that first call takes a lock.
+  detail::spsc_ring &threadRing() {
+    thread_local std::vector<std::pair<std::uint64_t,
+                                       std::shared_ptr<detail::spsc_ring>>>
+        rings;
+    for (auto &[id, ring] : rings) {
+      if (id == m_id) {
+        return *ring;
+      }
+    }
+    auto ring = std::make_shared<detail::spsc_ring>(m_ring_bytes);
+    {
+      std::lock_guard<std::mutex> lock(m_producers_mutex);
+      m_producers.push_back(ring);
+    }
+    rings.emplace_back(m_id, ring);
+    return *ring;
+  }
+
+  // One round: drain every ring into its own text chunk, then write all
+  // chunks with a single gather write. Returns false if there was nothing.
+  bool flushOnce() {
+    {
+      std::lock_guard<std::mutex> lock(m_producers_mutex);
+      m_snapshot = m_producers;
+    }
+    std::size_t used = 0;
+    for (auto &ring : m_snapshot) {
+      if (used == m_chunks.size()) {
+        m_chunks.emplace_back();
+      }
+      std::string &out = m_chunks[used];
+      out.clear();
+      ring->drain([&out](const std::byte *p, std::size_t) {
+        detail::record_header h;
+        std::memcpy(&h, p, sizeof(h));
+        detail::appendTimestamp(out, h.timestamp_ns);
+        out += " [";
+        detail::appendValue(out, h.thread);
+        out += "] ";
+        h.format(h.fmt, p + sizeof(h), out);
+        out += '\n';
+      });
+      if (!out.empty()) {
+        ++used;
+      }
+    }
+    writeChunks(used);
+
+    // Forget rings whose thread has exited and which are now empty.
+    {
+      std::lock_guard<std::mutex> lock(m_producers_mutex);
+      m_producers.erase(
+          std::remove_if(m_producers.begin(), m_producers.end(),
+                         [](const std::shared_ptr<detail::spsc_ring> &r) {
+                           // us + the snapshot: the owning thread is gone
+                           return r.use_count() == 2 && r->empty();
+                         }),
+          m_producers.end());
+    }
+    m_snapshot.clear();
+    return used > 0;
+  }
+
+  void writeChunks(std::size_t count) {
+#if defined(_WIN32)
+    for (std::size_t i = 0; i < count; ++i) {
+      std::fwrite(m_chunks[i].data(), 1, m_chunks[i].size(), m_file);
+    }
+    std::fflush(m_file);
+#else
+    std::vector<iovec> iov;
+    iov.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      iov.push_back({m_chunks[i].data(), m_chunks[i].size()});
+    }
+    std::size_t first = 0;
+    while (first < iov.size()) {
+      const int n = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+      ssize_t written = ::writev(m_fd, iov.data() + first, n);
+      if (written < 0) {
+        return; // nowhere to report it; drop the batch
+      }
+      // Skip fully written buffers, trim a partially written one.
+      while (first < iov.size() &&
+             static_cast<std::size_t>(written) >= iov[first].iov_len) {
+        written -= static_cast<ssize_t>(iov[first].iov_len);
+        ++first;
+      }
+      if (first < iov.size()) {
+        iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + written;
+        iov[first].iov_len -= static_cast<std::size_t>(written);
+      }
+    }
+#endif
+  }
+
+  void flusherLoop() {
+    for (;;) {
+      std::uint64_t requested;
+      bool stop;
+      {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        requested = m_flush_requested;
+        stop = m_stop;
+      }
+      while (flushOnce()) {
+      }
+      {
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        m_flush_done = requested;
+        m_flushed.notify_all();
+        if (stop) {
+          return;
+        }
+        // Idle: poll again in a millisecond unless woken earlier.
+        m_wake.wait_for(lock, std::chrono::milliseconds(1), [&] {
+          return m_stop || m_flush_requested != requested;
+        });
+      }
+    }
+  }
+
+  const std::uint64_t m_id;
+  const std::size_t m_ring_bytes;
+  std::atomic<std::uint64_t> m_dropped{0};
+#if defined(_WIN32)
+  std::FILE *m_file = nullptr;
+#else
+  int m_fd = -1;
+#endif
+
+  std::mutex m_producers_mutex;
+  std::vector<std::shared_ptr<detail::spsc_ring>> m_producers;
+
+  // Flusher-only state, reused between rounds to avoid reallocating.
+  std::vector<std::shared_ptr<detail::spsc_ring>> m_snapshot;
+  std::vector<std::string> m_chunks;
+
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_flushed;
+  bool m_stop = false;
+  std::uint64_t m_flush_requested = 0;
+  std::uint64_t m_flush_done = 0;
+
+  std::thread m_flusher;
+};
+
+} // namespace async_log
+
+#endif
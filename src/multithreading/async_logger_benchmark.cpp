@@ -0,0 +1,105 @@
+// Per-call latency percentiles of the mutex-guarded LogFile from mutex.cpp
+// against async_log::logger, with 1 to 32 threads logging at once.
+#include "async_logger.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// mutexWithStreamProtection::LogFile from mutex.cpp.
+class LogFile {
+  std::mutex mutex;
+
+public:
+  std::ofstream fileObj;
+  LogFile(std::string logFile) { fileObj.open(logFile, std::ofstream::out); }
+
+  void sharedPrinter(std::string s, int id) {
+    std::lock_guard<std::mutex> guard(mutex);
+    fileObj << "Message from function" << id << ": " << s << std::endl;
+  }
+};
+
+struct mutex_log_file {
+  explicit mutex_log_file(const std::string &path) : file(path) {}
+  void log(int id, int i) { file.sharedPrinter(std::to_string(i), id); }
+  void flush() {}
+  LogFile file;
+};
+
+struct async_log_file {
+  explicit async_log_file(const std::string &path) : logger(path) {}
+  void log(int id, int i) { logger.log("Message from function{}: {}", id, i); }
+  void flush() { logger.flush(); }
+  async_log::logger logger;
+};
+
+std::string logPath() {
+  return (std::filesystem::temp_directory_path() / "async_logger_benchmark.log")
+      .string();
+}
+
+constexpr int messages_per_thread = 20'000;
+
+template <typename Log> void BM_LogLatency(benchmark::State &state) {
+  const int threads = static_cast<int>(state.range(0));
+  std::vector<std::vector<std::int64_t>> latencies(threads);
+
+  for (auto _ : state) {
+    Log log(logPath());
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+      pool.emplace_back([&log, &samples = latencies[t], t] {
+        samples.reserve(samples.size() + messages_per_thread);
+        for (int i = 0; i < messages_per_thread; ++i) {
+          const auto start = std::chrono::steady_clock::now();
+          log.log(t, i);
+          const auto end = std::chrono::steady_clock::now();
+          samples.push_back(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                  .count());
+        }
+      });
+    }
+    for (auto &p : pool) {
+      p.join();
+    }
+    log.flush(); // the file is complete before the next iteration
+  }
+
+  std::vector<std::int64_t> all;
+  for (auto &samples : latencies) {
+    all.insert(all.end(), samples.begin(), samples.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto percentile = [&all](double p) {
+    return static_cast<double>(
+        all[std::min(all.size() - 1, static_cast<std::size_t>(p * all.size()))]);
+  };
+  state.counters["p50_ns"] = percentile(0.50);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.counters["p999_ns"] = percentile(0.999);
+  state.counters["max_ns"] = static_cast<double>(all.back());
+  state.SetItemsProcessed(state.iterations() * threads * messages_per_thread);
+  std::filesystem::remove(logPath());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_LogLatency, mutex_log_file)
+    ->RangeMultiplier(2)->Range(1, 32)->ArgName("threads")
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LogLatency, async_log_file)
+    ->RangeMultiplier(2)->Range(1, 32)->ArgName("threads")
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
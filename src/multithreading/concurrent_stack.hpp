@@ -0,0 +1,165 @@
+#ifndef CONCURRENT_STACK_HPP
+#define CONCURRENT_STACK_HPP
+
+#include "hazard_pointer.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <utility>
+
+///
+/// Lock-free stacks.
+///
+/// treiber_stack is R. K. Treiber's stack: a singly linked list whose head is
+/// swung with compare_exchange. Popped nodes are reclaimed through hazard
+/// pointers, so pop() never touches freed memory and is immune to ABA.
+///
+/// elimination_stack puts an elimination array in front of it (Hendler, Shavit,
+/// Yerushalmi 2004). Under contention a failed compare_exchange on the head
+/// means many threads are hammering the same cache line; instead of retrying
+/// there, the thread visits a random exchanger slot. A push parked in a slot
+/// and a pop that finds it cancel each other out without touching the stack:
+/// the pair is linearized at the moment the pop takes the node.
+///
+
+namespace lockfree {
+
+template <typename T, bool Elimination = false> class stack {
+public:
+  stack() = default;
+  stack(const stack &) = delete;
+  stack &operator=(const stack &) = delete;
+
+  /// Not thread-safe: no other thread may still use the stack.
+  ~stack() {
+    node *n = m_head.load(std::memory_order_relaxed);
+    while (n) {
+      delete std::exchange(n, n->next);
+    }
+  }
+
+  void push(T value) {
+    node *n = new node{std::move(value), m_head.load(std::memory_order_relaxed)};
+    for (;;) {
+      if (m_head.compare_exchange_weak(n->next, n, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+        return;
+      }
+      if constexpr (Elimination) {
+        if (tryEliminatePush(n)) {
+          return;
+        }
+      }
+    }
+  }
+
+  std::optional<T> pop() {
+    std::atomic<void *> &hazard = hazard_pointer_domain::global().hazard();
+    for (;;) {
+      node *old = m_head.load(std::memory_order_acquire);
+      node *seen;
+      do { // publish, then make sure it is still the head
+        seen = old;
+        hazard.store(old);
+        old = m_head.load();
+      } while (old != seen);
+
+      if (!old) {
+        hazard.store(nullptr, std::memory_order_release);
+        return std::nullopt;
+      }
+      if (m_head.compare_exchange_strong(old, old->next)) {
+        hazard.store(nullptr, std::memory_order_release);
+        std::optional<T> value(std::move(old->value));
+        hazard_pointer_domain::global().retire(old);
+        return value;
+      }
+      hazard.store(nullptr, std::memory_order_release);
+
+      if constexpr (Elimination) {
+        if (node *n = tryEliminatePop()) {
+          std::optional<T> value(std::move(n->value));
+          delete n; // never was in the stack, nobody else can see it
+          return value;
+        }
+      }
+    }
+  }
+
+  /// Only meaningful when no other thread is modifying the stack.
+  bool empty() const { return m_head.load() == nullptr; }
+
+private:
+  struct node {
+    T value;
+    node *next;
+  };
+
+  alignas(64) std::atomic<node *> m_head{nullptr};
+
+  // Elimination array. A slot is empty (0), holds a waiting push (node
+  // pointer) or has been taken by a pop (taken) until the pusher sees it.
+  static constexpr std::uintptr_t taken = 1;
+  static constexpr std::size_t exchanger_count = Elimination ? 16 : 1;
+  static constexpr int exchange_spins = 256;
+
+  struct alignas(64) exchanger {
+    std::atomic<std::uintptr_t> state{0};
+  };
+  exchanger m_exchangers[exchanger_count];
+
+  static std::size_t randomSlot() {
+    thread_local std::uint32_t x = static_cast<std::uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1);
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x % exchanger_count;
+  }
+
+  bool tryEliminatePush(node *n) {
+    exchanger &slot = m_exchangers[randomSlot()];
+    std::uintptr_t expected = 0;
+    const auto offer = reinterpret_cast<std::uintptr_t>(n);
+    if (!slot.state.compare_exchange_strong(expected, offer)) {
+      return false;
+    }
+    for (int i = 0; i < exchange_spins; ++i) {
+      if (slot.state.load(std::memory_order_acquire) == taken) {
+        slot.state.store(0, std::memory_order_release);
+        return true;
+      }
+    }
+    expected = offer;
+    if (slot.state.compare_exchange_strong(expected, 0)) {
+      return false; // withdrawn, nobody came
+    }
+    // A pop took it between the last check and the withdrawal.
+    slot.state.store(0, std::memory_order_release);
+    return true;
+  }
+
+  node *tryEliminatePop() {
+    exchanger &slot = m_exchangers[randomSlot()];
+    std::uintptr_t offer = slot.state.load(std::memory_order_acquire);
+    if (offer == 0 || offer == taken) {
+      return nullptr;
+    }
+    if (!slot.state.compare_exchange_strong(offer, taken,
+                                            std::memory_order_acq_rel)) {
+      return nullptr;
+    }
+    return reinterpret_cast<node *>(offer);
+  }
+};
+
+template <typename T> using treiber_stack = stack<T, false>;
+template <typename T> using elimination_stack = stack<T, true>;
+
+} // namespace lockfree
+
+#endif
@@ -0,0 +1,94 @@
+// Push/pop pairs under contention: the correctly locked threadSafe::stack
+// from thread_safe.cpp against the lock-free stacks in concurrent_stack.hpp.
+#include "concurrent_stack.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// threadSafe::stack from thread_safe.cpp.
+template <typename T> class locked_stack {
+public:
+  std::optional<T> pop() {
+    std::scoped_lock lock(mx);
+    if (data.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> tmp(std::move(data.back()));
+    data.pop_back();
+    return tmp;
+  }
+
+  void push(T element) {
+    std::scoped_lock lock(mx);
+    data.push_back(std::move(element));
+  }
+
+private:
+  std::mutex mx;
+  std::vector<T> data;
+};
+
+template <typename Stack> Stack &sharedStack() {
+  static Stack s;
+  return s;
+}
+
+// Every thread alternates push and pop on one shared stack.
+template <typename Stack> void BM_PushPop(benchmark::State &state) {
+  Stack &s = sharedStack<Stack>();
+  int i = 0;
+  for (auto _ : state) {
+    s.push(i++);
+    benchmark::DoNotOptimize(s.pop());
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Half of the threads only push, the other half only pop: the pattern where
+// elimination can pair operations off.
+template <typename Stack> void BM_ProducersConsumers(benchmark::State &state) {
+  Stack &s = sharedStack<Stack>();
+  const bool producer = state.thread_index() % 2 == 0;
+  int i = 0;
+  for (auto _ : state) {
+    if (producer) {
+      s.push(i++);
+    } else {
+      benchmark::DoNotOptimize(s.pop());
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+const int max_threads =
+    static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_PushPop, locked_stack<int>)
+    ->ThreadRange(1, max_threads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PushPop, lockfree::treiber_stack<int>)
+    ->ThreadRange(1, max_threads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PushPop, lockfree::elimination_stack<int>)
+    ->ThreadRange(1, max_threads)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_ProducersConsumers, locked_stack<int>)
+    ->ThreadRange(2, max_threads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProducersConsumers, lockfree::treiber_stack<int>)
+    ->ThreadRange(2, max_threads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProducersConsumers, lockfree::elimination_stack<int>)
+    ->ThreadRange(2, max_threads)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,3 +1,5 @@
+#include "mpmc_queue.hpp"
+
 #include <condition_variable>
 #include <functional>
 #include <iostream>
@@ -67,12 +69,36 @@ void function_2() {
 }
 } // namespace condition_variable_deque
 
+namespace mpmc_ring_buffer {
+// Same hand-off as above, but through a lock-free bounded ring buffer: no
+// mutex, and the consumer parks on the slot's sequence number (a futex on
+// Linux) instead of on a condition variable.
+mpmc::queue<int> q(16);
+
+void function_1() {
+  int count = 10;
+  while (count > 0) {
+    q.push(count);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    count--;
+  }
+}
+
+void function_2() {
+  int data = 0;
+  while (data != 1) {
+    q.pop(data);
+    std::cout << "t2 got a value from t1: " << data << std::endl;
+  }
+}
+} // namespace mpmc_ring_buffer
+
 std::condition_variable cond;
 std::mutex mu;
 
 bool main_thread_is_ready = false;
 bool data_has_been_processed = false;
-int worker_func() {
+void worker_func() {
   std::unique_lock<std::mutex> worker_lock(mu);
   cond.wait(worker_lock, [] { return main_thread_is_ready; });
   std::cout << "Worker thread is processing data" << std::endl;
@@ -105,6 +131,16 @@ int main() {
       t1.join();
       t2.join();
     }
+
+    std::cout << "Queueing and Dequeueing with a lock-free MPMC ring buffer"
+              << std::endl;
+    {
+      std::thread t1(mpmc_ring_buffer::function_1);
+      std::thread t2(mpmc_ring_buffer::function_2);
+
+      t1.join();
+      t2.join();
+    }
   }
 
   { // worker example
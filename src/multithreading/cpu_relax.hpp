@@ -0,0 +1,19 @@
+#ifndef CPU_RELAX_HPP
+#define CPU_RELAX_HPP
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/// Tells the CPU we are in a spin-wait loop: on x86 `pause` saves power and
+/// avoids the memory-order mis-speculation penalty when the loop exits, and
+/// gives the sibling hyper-thread the core.
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef HAZARD_POINTER_HPP
+#define HAZARD_POINTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+///
+/// Hazard pointers: safe memory reclamation for lock-free data structures.
+///
+/// A thread that is about to dereference a shared node first publishes the
+/// node's address in its hazard pointer. A node that has been unlinked is not
+/// deleted right away but "retired"; every few hundred retirements the thread
+/// scans all published hazard pointers and frees only the retired nodes that
+/// nobody is looking at. This also rules out the ABA problem: a node cannot be
+/// freed and reallocated while another thread still holds its address.
+///
+
+namespace lockfree {
+
+class hazard_pointer_domain {
+public:
+  static constexpr std::size_t max_hazard_pointers = 128;
+
+  static hazard_pointer_domain &global() {
+    static hazard_pointer_domain domain;
+    return domain;
+  }
+
+  /// All threads using the domain have exited; nothing can be protected.
+  ~hazard_pointer_domain() {
+    for (const retired &r : m_orphans) {
+      r.deleter(r.pointer);
+    }
+  }
+
+  /// The calling thread's hazard pointer, claimed on first use and released
+  /// when the thread exits.
+  std::atomic<void *> &hazard() {
+    thread_local owner slot(*this);
+    return slot.record->pointer;
+  }
+
+  template <typename T> void retire(T *p) {
+    thread_local retire_list list(*this);
+    list.items.push_back({p, [](void *q) { delete static_cast<T *>(q); }});
+    if (list.items.size() >= 2 * max_hazard_pointers) {
+      scan(list.items);
+    }
+  }
+
+private:
+  hazard_pointer_domain() = default;
+
+  struct alignas(64) record {
+    std::atomic<bool> active{false};
+    std::atomic<void *> pointer{nullptr};
+  };
+
+  struct retired {
+    void *pointer;
+    void (*deleter)(void *);
+  };
+
+  struct owner {
+    explicit owner(hazard_pointer_domain &d) : record(d.claim()) {}
+    ~owner() {
+      record->pointer.store(nullptr);
+      record->active.store(false);
+    }
+    hazard_pointer_domain::record *record;
+  };
+
+  struct retire_list {
+    explicit retire_list(hazard_pointer_domain &d) : domain(d) {}
+    ~retire_list() {
+      domain.scan(items);
+      std::lock_guard<std::mutex> lock(domain.m_orphans_mutex);
+      domain.m_orphans.insert(domain.m_orphans.end(), items.begin(),
+                              items.end());
+    }
+    hazard_pointer_domain &domain;
+    std::vector<retired> items;
+  };
+
+  record m_records[max_hazard_pointers];
+  std::mutex m_orphans_mutex;
+  std::vector<retired> m_orphans; // left behind by exited threads
+
+  record *claim() {
+    for (record &r : m_records) {
+      bool expected = false;
+      if (!r.active.load(std::memory_order_relaxed) &&
+          r.active.compare_exchange_strong(expected, true)) {
+        return &r;
+      }
+    }
+    throw std::runtime_error("hazard_pointer_domain: too many threads");
+  }
+
+  void scan(std::vector<retired> &items) {
+    {
+      std::unique_lock<std::mutex> lock(m_orphans_mutex, std::try_to_lock);
+      if (lock.owns_lock() && !m_orphans.empty()) {
+        items.insert(items.end(), m_orphans.begin(), m_orphans.end());
+        m_orphans.clear();
+      }
+    }
+
+    std::vector<void *> protected_pointers;
+    protected_pointers.reserve(max_hazard_pointers);
+    for (const record &r : m_records) {
+      if (void *p = r.pointer.load()) {
+        protected_pointers.push_back(p);
+      }
+    }
+    std::sort(protected_pointers.begin(), protected_pointers.end());
+
+    auto still_protected = std::partition(
+        items.begin(), items.end(), [&](const retired &r) {
+          return std::binary_search(protected_pointers.begin(),
+                                    protected_pointers.end(), r.pointer);
+        });
+    for (auto it = still_protected; it != items.end(); ++it) {
+      it->deleter(it->pointer);
+    }
+    items.erase(still_protected, items.end());
+  }
+};
+
+} // namespace lockfree
+
+#endif
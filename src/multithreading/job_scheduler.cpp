@@ -0,0 +1,111 @@
+#include "job_scheduler.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The job struct of queue.cpp.
+struct job {
+
+  int id = 0;
+  void execute() { std::cout << "exec job id=" << id << std::endl; };
+};
+
+std::mutex cout_mutex;
+
+void say(const std::string &line) {
+  std::lock_guard<std::mutex> lock(cout_mutex);
+  std::cout << line << std::endl;
+}
+
+int main() {
+  { // queue.cpp pushes jobs 1-3 at the back and job 4 at the front of a
+    // std::deque; here job 4 gets a higher priority and job 5 waits for 2.
+    std::cout << "-------- queue.cpp jobs --------" << std::endl;
+    std::vector<job> queued = {{1}, {2}, {3}, {4}, {5}};
+    jobs::graph g;
+    for (auto &j : queued) {
+      const jobs::priority level =
+          j.id == 4 ? jobs::priority::high : jobs::priority::normal;
+      g.add([&j] { j.execute(); }, level);
+    }
+    g.precede(1, 4); // job 2 before job 5
+    jobs::scheduler one_thread(1);
+    one_thread.run(g);
+  }
+
+  jobs::scheduler scheduler;
+  std::cout << "scheduler has " << scheduler.size() << " workers" << std::endl;
+
+  { // a build: three compiles, then link, then test and package in parallel
+    std::cout << "-------- build graph --------" << std::endl;
+    jobs::graph g;
+    const jobs::job_id link = g.add([] { say("link app"); });
+    for (const char *file : {"main.cpp", "parser.cpp", "codegen.cpp"}) {
+      const jobs::job_id compile =
+          g.add([file] { say(std::string("compile ") + file); });
+      g.precede(compile, link);
+    }
+    const jobs::job_id test =
+        g.add([] { say("run tests"); }, jobs::priority::high);
+    const jobs::job_id package =
+        g.add([] { say("package"); }, jobs::priority::low);
+    g.precede(link, test);
+    g.precede(link, package);
+    scheduler.run(g);
+  }
+
+  { // a failing job cancels the jobs that depend on it
+    std::cout << "-------- failing job --------" << std::endl;
+    jobs::graph g;
+    const jobs::job_id fetch =
+        g.add([]() { throw std::runtime_error("fetch failed"); });
+    const jobs::job_id unpack = g.add([] { say("unpack (not printed)"); });
+    g.precede(fetch, unpack);
+    try {
+      scheduler.run(g);
+    } catch (const std::exception &e) {
+      std::cout << "caught: " << e.what() << std::endl;
+    }
+  }
+
+  { // cycles are rejected instead of waiting forever
+    jobs::graph g;
+    const jobs::job_id a = g.add([] {});
+    const jobs::job_id b = g.add([] {});
+    g.precede(a, b);
+    g.precede(b, a);
+    try {
+      scheduler.run(g);
+    } catch (const std::invalid_argument &e) {
+      std::cout << "caught: " << e.what() << std::endl;
+    }
+  }
+
+  { // one root, a million tiny jobs, one sink: the cost of scheduling
+    std::cout << "-------- fan-out/fan-in of 1M jobs --------" << std::endl;
+    constexpr std::size_t n = 1'000'000;
+    std::vector<std::uint64_t> out(n);
+    jobs::graph g;
+    g.reserve(n + 2);
+    const jobs::job_id root = g.add([] {});
+    const jobs::job_id sink = g.add([] {});
+    for (std::size_t i = 0; i < n; ++i) {
+      const jobs::job_id leaf = g.add([&out, i] { out[i] = i * i; });
+      g.precede(root, leaf);
+      g.precede(leaf, sink);
+    }
+    for (int round = 0; round < 3; ++round) {
+      const auto start = std::chrono::steady_clock::now();
+      scheduler.run(g);
+      const auto end = std::chrono::steady_clock::now();
+      const std::chrono::duration<double, std::nano> elapsed = end - start;
+      std::cout << "run " << round << ": " << elapsed.count() / n
+                << " ns per job" << std::endl;
+    }
+  }
+}
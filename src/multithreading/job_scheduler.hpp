@@ -0,0 +1,546 @@
+#ifndef JOB_SCHEDULER_HPP
+#define JOB_SCHEDULER_HPP
+
+#include "cpu_relax.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// A job system for dependency graphs.
+///
+/// A jobs::graph is a DAG: every job is a callable with a priority, and
+/// precede(a, b) makes b wait for a. A jobs::scheduler runs a whole graph and
+/// returns when every job has finished:
+///
+/// - every job carries a counter of unfinished predecessors; the worker that
+///   finishes a job decrements the counters of its successors and makes the
+///   ones that reach zero ready. A job with a single predecessor needs no
+///   atomic at all: only that predecessor can release it.
+/// - every worker owns one lock-free Chase–Lev deque per priority. The owner
+///   pushes and pops at the bottom without a compare-exchange in the common
+///   case; idle workers steal from the top. A worker takes its own ready
+///   jobs in priority order and only then steals, again highest priority
+///   first, so priorities are strict per worker and approximate across the
+///   pool.
+/// - when a finished job releases a successor, the worker runs it directly
+///   instead of pushing and popping it, unless a more urgent job is ready.
+/// - the thread that calls run() is worker 0; the others spin while a graph is
+///   running and sleep on a condition variable between runs.
+///
+/// A graph can be run any number of times; run() resets the counters.
+///
+
+namespace jobs {
+
+enum class priority : std::uint8_t { high, normal, low };
+
+constexpr std::size_t priority_levels = 3;
+
+using job_id = std::uint32_t;
+
+///
+/// Lock-free work-stealing deque for trivially copyable values (Chase and
+/// Lev, with the memory orderings of Lê et al., "Correct and Efficient
+/// Work-Stealing for Weak Memory Models", 2013).
+///
+/// push() and pop() may only be called by the thread that owns the deque,
+/// steal() by any thread. The ring grows when full; old rings are kept until
+/// the deque is destroyed because a thief may still be reading them.
+///
+template <typename T> class work_stealing_deque {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                    std::atomic<T>::is_always_lock_free,
+                "work_stealing_deque needs a lock-free trivially copyable T");
+
+  struct ring {
+    explicit ring(std::size_t capacity)
+        : mask(capacity - 1),
+          slots(std::make_unique<std::atomic<T>[]>(capacity)) {}
+
+    std::size_t capacity() const { return mask + 1; }
+    T get(std::int64_t i) const {
+      return slots[static_cast<std::size_t>(i) & mask].load(
+          std::memory_order_relaxed);
+    }
+    void put(std::int64_t i, T value) {
+      slots[static_cast<std::size_t>(i) & mask].store(
+          value, std::memory_order_relaxed);
+    }
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+public:
+  explicit work_stealing_deque(std::size_t capacity = 256) {
+    m_rings.push_back(std::make_unique<ring>(
+        std::bit_ceil(std::max<std::size_t>(2, capacity))));
+    m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(const work_stealing_deque &) = delete;
+  work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+  /// Owner only.
+  void push(T value) {
+    const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const std::int64_t t = m_top.load(std::memory_order_acquire);
+    ring *r = m_ring.load(std::memory_order_relaxed);
+    if (b - t >= static_cast<std::int64_t>(r->capacity())) {
+      r = grow(r, t, b);
+    }
+    r->put(b, value);
+    m_bottom.store(b + 1, std::memory_order_release);
+  }
+
+  /// Owner only: takes the most recently pushed value.
+  bool pop(T &out) {
+    std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+    // top only grows, so a stale top that already reaches bottom proves the
+    // deque is empty without the seq_cst store below.
+    if (m_top.load(std::memory_order_relaxed) >= b) {
+      return false;
+    }
+    --b;
+    ring *r = m_ring.load(std::memory_order_relaxed);
+    // Lê et al. use a relaxed store and a seq_cst fence; a seq_cst store is
+    // a single xchg on x86, about half the cost of mov + mfence.
+    m_bottom.store(b, std::memory_order_seq_cst);
+    std::int64_t t = m_top.load(std::memory_order_seq_cst);
+    if (t > b) {
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    out = r->get(b);
+    if (t == b) {
+      // The last value: race the thieves for it.
+      const bool won = m_top.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /// Any thread: takes the oldest value. Also fails when another thief won
+  /// the race for it.
+  bool steal(T &out) {
+    std::int64_t t = m_top.load(std::memory_order_seq_cst);
+    if (t >= m_bottom.load(std::memory_order_seq_cst)) {
+      return false;
+    }
+    const T value = m_ring.load(std::memory_order_acquire)->get(t);
+    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+      return false;
+    }
+    out = value;
+    return true;
+  }
+
+  /// Exact for the owner, a snapshot for everybody else.
+  bool empty() const {
+    return m_top.load(std::memory_order_relaxed) >=
+           m_bottom.load(std::memory_order_relaxed);
+  }
+
+private:
+  alignas(64) std::atomic<std::int64_t> m_top{0};
+  alignas(64) std::atomic<std::int64_t> m_bottom{0};
+  std::atomic<ring *> m_ring{nullptr};
+  std::vector<std::unique_ptr<ring>> m_rings;
+
+  ring *grow(ring *old, std::int64_t top, std::int64_t bottom) {
+    auto bigger = std::make_unique<ring>(old->capacity() * 2);
+    for (std::int64_t i = top; i < bottom; ++i) {
+      bigger->put(i, old->get(i));
+    }
+    ring *r = bigger.get();
+    m_rings.push_back(std::move(bigger));
+    m_ring.store(r, std::memory_order_release);
+    return r;
+  }
+};
+
+class scheduler;
+
+/// Jobs and their dependencies. Building a graph is single-threaded.
+class graph {
+public:
+  /// Adds a job that runs fn(). Returns its id, the next integer from 0.
+  template <typename F>
+  job_id add(F &&fn, priority level = priority::normal) {
+    if (m_jobs.size() >= std::numeric_limits<job_id>::max()) {
+      throw std::length_error("graph::add: too many jobs");
+    }
+    m_jobs.push_back(
+        node{thread_pool::task(std::forward<F>(fn)), {}, 0, level});
+    m_checked = false;
+    return static_cast<job_id>(m_jobs.size() - 1);
+  }
+
+  /// `after` starts only when `before` has finished.
+  void precede(job_id before, job_id after) {
+    if (before >= m_jobs.size() || after >= m_jobs.size()) {
+      throw std::out_of_range("graph::precede: unknown job");
+    }
+    if (before == after) {
+      throw std::invalid_argument(
+          "graph::precede: a job cannot wait for itself");
+    }
+    m_jobs[before].successors.push_back(after);
+    ++m_jobs[after].dependencies;
+    m_checked = false;
+  }
+
+  void reserve(std::size_t jobs) { m_jobs.reserve(jobs); }
+  std::size_t size() const { return m_jobs.size(); }
+  bool empty() const { return m_jobs.empty(); }
+
+  void clear() {
+    m_jobs.clear();
+    m_roots.clear();
+    m_remaining.reset();
+    m_first_successor.clear();
+    m_successors.clear();
+    m_checked = false;
+  }
+
+private:
+  friend class scheduler;
+
+  struct node {
+    thread_pool::task fn;
+    std::vector<job_id> successors;
+    std::uint32_t dependencies;
+    priority level;
+  };
+
+  std::vector<node> m_jobs;
+  // Set by prepare(), valid until the next add() or precede().
+  std::vector<job_id> m_roots;
+  std::unique_ptr<std::atomic<std::uint32_t>[]> m_remaining;
+  // The successor lists in one array (compressed sparse rows): those of job i
+  // are m_successors[m_first_successor[i], m_first_successor[i + 1]).
+  std::vector<std::size_t> m_first_successor;
+  std::vector<job_id> m_successors;
+  bool m_checked = false;
+
+  /// Resets the dependency counters for a run. The first run after a change
+  /// also collects the roots and rejects cycles (Kahn's algorithm), which
+  /// would otherwise leave run() waiting forever.
+  void prepare() {
+    const std::size_t n = m_jobs.size();
+    if (!m_checked) {
+      m_roots.clear();
+      std::vector<std::uint32_t> indegree(n);
+      std::vector<job_id> order;
+      order.reserve(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        indegree[i] = m_jobs[i].dependencies;
+        if (indegree[i] == 0) {
+          m_roots.push_back(static_cast<job_id>(i));
+          order.push_back(static_cast<job_id>(i));
+        }
+      }
+      for (std::size_t k = 0; k < order.size(); ++k) {
+        for (job_id s : m_jobs[order[k]].successors) {
+          if (--indegree[s] == 0) {
+            order.push_back(s);
+          }
+        }
+      }
+      if (order.size() != n) {
+        throw std::invalid_argument("scheduler::run: the graph has a cycle");
+      }
+      m_remaining = std::make_unique<std::atomic<std::uint32_t>[]>(n);
+      m_first_successor.assign(n + 1, 0);
+      m_successors.clear();
+      for (std::size_t i = 0; i < n; ++i) {
+        const auto &successors = m_jobs[i].successors;
+        m_successors.insert(m_successors.end(), successors.begin(),
+                            successors.end());
+        m_first_successor[i + 1] = m_successors.size();
+      }
+      m_checked = true;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      m_remaining[i].store(m_jobs[i].dependencies, std::memory_order_relaxed);
+    }
+  }
+};
+
+/// Runs graphs on a fixed set of worker threads.
+class scheduler {
+public:
+  /// thread_count includes the thread that calls run(), so
+  /// thread_count - 1 threads are started.
+  explicit scheduler(
+      std::size_t thread_count = std::max(1u,
+                                          std::thread::hardware_concurrency()))
+      : m_workers(std::max<std::size_t>(1, thread_count)) {
+    m_threads.reserve(m_workers.size() - 1);
+    for (std::size_t i = 1; i < m_workers.size(); ++i) {
+      m_threads.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  scheduler(const scheduler &) = delete;
+  scheduler &operator=(const scheduler &) = delete;
+
+  ~scheduler() {
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  /// Number of workers, including the caller of run().
+  std::size_t size() const { return m_workers.size(); }
+
+  /// Runs every job of g once, respecting the dependencies, and returns when
+  /// all have finished. If a job throws, the jobs that have not started yet
+  /// are skipped and the first exception is rethrown here. Concurrent calls
+  /// run one after the other; run() must not be called from inside a job.
+  void run(graph &g) {
+    std::lock_guard<std::mutex> run_lock(m_run_mutex);
+    g.prepare();
+    if (g.empty()) {
+      return;
+    }
+    m_graph = &g;
+    m_error = nullptr;
+    m_cancelled.store(false, std::memory_order_relaxed);
+    for (auto &w : m_workers) {
+      w.completed.store(0, std::memory_order_relaxed);
+    }
+    // Pushed in reverse so that one worker on its own starts the roots in
+    // the order they were added.
+    worker &self = m_workers[0];
+    for (auto it = g.m_roots.rbegin(); it != g.m_roots.rend(); ++it) {
+      self.ready[level(*it)].push(*it);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_mutex);
+      m_running.store(true, std::memory_order_release);
+      ++m_generation;
+    }
+    m_wake.notify_all();
+
+    const std::size_t total = g.size();
+    int idle_rounds = 0;
+    job_id id;
+    for (;;) {
+      if (findJob(0, id)) {
+        execute(0, id);
+        idle_rounds = 0;
+      } else if (completed() == total) {
+        break;
+      } else {
+        backOff(idle_rounds);
+      }
+    }
+
+    // Once m_running is false no worker joins any more; wait for the ones
+    // still looking for work, so none of them touches g after we return.
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_mutex);
+      m_running.store(false, std::memory_order_release);
+    }
+    while (m_busy.load(std::memory_order_acquire) > 0) {
+      std::this_thread::yield();
+    }
+    m_graph = nullptr;
+    if (m_error) {
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+  }
+
+private:
+  struct worker {
+    work_stealing_deque<job_id> ready[priority_levels];
+    // Written only by the owner; the caller of run() sums them.
+    alignas(64) std::atomic<std::size_t> completed{0};
+  };
+
+  static constexpr int spin_rounds = 64;
+
+  std::vector<worker> m_workers;
+  std::vector<std::thread> m_threads;
+  graph *m_graph = nullptr;
+
+  std::mutex m_run_mutex;
+  std::mutex m_error_mutex;
+  std::exception_ptr m_error;
+  std::atomic<bool> m_cancelled{false};
+
+  // Workers sleep on m_wake between runs and count themselves in m_busy
+  // while they take part in one.
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake;
+  std::atomic<bool> m_running{false};
+  std::atomic<std::size_t> m_busy{0};
+  std::size_t m_generation = 0;
+  bool m_stop = false;
+
+  std::size_t level(job_id id) const {
+    return static_cast<std::size_t>(m_graph->m_jobs[id].level);
+  }
+
+  std::size_t completed() const {
+    std::size_t sum = 0;
+    for (const auto &w : m_workers) {
+      sum += w.completed.load(std::memory_order_acquire);
+    }
+    return sum;
+  }
+
+  static void backOff(int &idle_rounds) {
+    if (++idle_rounds < spin_rounds) {
+      cpuRelax();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  bool findJob(std::size_t index, job_id &out) {
+    worker &self = m_workers[index];
+    for (auto &ready : self.ready) {
+      if (ready.pop(out)) {
+        return true;
+      }
+    }
+    const std::size_t n = m_workers.size();
+    for (std::size_t p = 0; p < priority_levels; ++p) {
+      for (std::size_t k = 1; k < n; ++k) {
+        if (m_workers[(index + k) % n].ready[p].steal(out)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool moreUrgentReady(const worker &self, std::size_t p) const {
+    for (std::size_t q = 0; q < p; ++q) {
+      if (!self.ready[q].empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Runs job id and then, as long as it released one, the most urgent of its
+  // ready successors.
+  void execute(std::size_t index, job_id id) {
+    worker &self = m_workers[index];
+    auto &jobs = m_graph->m_jobs;
+    for (;;) {
+      auto &job = jobs[id];
+      if (!m_cancelled.load(std::memory_order_relaxed)) {
+        try {
+          job.fn();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(m_error_mutex);
+          if (!m_error) {
+            m_error = std::current_exception();
+          }
+          m_cancelled.store(true, std::memory_order_relaxed);
+        }
+      }
+
+      // Walk the successors backwards and push all but the first most urgent
+      // one, so that ready siblings are popped in the order they were added.
+      bool has_next = false;
+      job_id next = 0;
+      const job_id *successors = m_graph->m_successors.data();
+      const job_id *first = successors + m_graph->m_first_successor[id];
+      for (const job_id *it = successors + m_graph->m_first_successor[id + 1];
+           it != first;) {
+        const job_id s = *--it;
+        if (jobs[s].dependencies > 1 &&
+            m_graph->m_remaining[s].fetch_sub(1, std::memory_order_acq_rel) !=
+                1) {
+          continue;
+        }
+        if (!has_next) {
+          next = s;
+          has_next = true;
+        } else if (jobs[s].level <= jobs[next].level) {
+          self.ready[level(next)].push(next);
+          next = s;
+        } else {
+          self.ready[level(s)].push(s);
+        }
+      }
+      // Only this thread writes its counter, so no read-modify-write.
+      self.completed.store(self.completed.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_release);
+
+      if (!has_next) {
+        return;
+      }
+      if (moreUrgentReady(self, level(next))) {
+        self.ready[level(next)].push(next);
+        return;
+      }
+      id = next;
+    }
+  }
+
+  void workerLoop(std::size_t index) {
+    std::size_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [&] {
+          return m_stop || (m_running.load(std::memory_order_relaxed) &&
+                            m_generation != seen);
+        });
+        if (m_stop) {
+          return;
+        }
+        seen = m_generation;
+        m_busy.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      int idle_rounds = 0;
+      job_id id;
+      for (;;) {
+        if (findJob(index, id)) {
+          execute(index, id);
+          idle_rounds = 0;
+        } else if (!m_running.load(std::memory_order_acquire)) {
+          break;
+        } else {
+          backOff(idle_rounds);
+        }
+      }
+      m_busy.fetch_sub(1, std::memory_order_release);
+    }
+  }
+};
+
+} // namespace jobs
+
+#endif
@@ -0,0 +1,180 @@
+// Scheduling overhead of job_scheduler.hpp for graphs of tiny jobs. "per_job"
+// is the wall time of a run divided by the number of jobs:
+// - FanOutFanIn: one root, n independent jobs, one sink that waits for all
+// - Chain: n jobs, each waiting for the previous one
+// - Wavefront: a sqrt(n) x sqrt(n) grid, every cell waiting for its left and
+//   upper neighbour (2n edges)
+// - Priorities: the fan-out/fan-in graph with the jobs spread over the three
+//   priorities
+// Baselines: calling the same jobs in a loop, and thread_pool::post() for n
+// independent tasks (thread_pool_benchmark.cpp).
+//
+// The graphs are built once; only run() is timed.
+#include "job_scheduler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// A few nanoseconds of work, so that scheduling cost dominates.
+inline void tinyTask(std::uint64_t i) {
+  std::uint64_t x = i;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  benchmark::DoNotOptimize(x);
+}
+
+jobs::scheduler &scheduler() {
+  static jobs::scheduler instance;
+  return instance;
+}
+
+thread_pool &pool() {
+  static thread_pool instance;
+  return instance;
+}
+
+void setCounters(benchmark::State &state, std::size_t jobs) {
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(jobs));
+  state.counters["per_job"] = benchmark::Counter(
+      static_cast<double>(jobs),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+  state.counters["threads"] = static_cast<double>(scheduler().size());
+}
+
+void runGraph(benchmark::State &state, jobs::graph &g) {
+  for (auto _ : state) {
+    scheduler().run(g);
+  }
+  setCounters(state, g.size());
+}
+
+jobs::graph fanOutFanIn(std::size_t n, bool mixed_priorities) {
+  jobs::graph g;
+  g.reserve(n + 2);
+  const jobs::job_id root = g.add([] {});
+  const jobs::job_id sink = g.add([] {});
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto level = mixed_priorities ? static_cast<jobs::priority>(i % 3)
+                                        : jobs::priority::normal;
+    const jobs::job_id leaf = g.add([i] { tinyTask(i); }, level);
+    g.precede(root, leaf);
+    g.precede(leaf, sink);
+  }
+  return g;
+}
+
+} // namespace
+
+static void BM_SequentialCalls(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<thread_pool::task> tasks;
+  tasks.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    tasks.emplace_back([i] { tinyTask(i); });
+  }
+  for (auto _ : state) {
+    for (auto &t : tasks) {
+      t();
+    }
+  }
+  setCounters(state, n);
+}
+
+static void BM_ThreadPoolPost(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::atomic<std::size_t> done{0};
+    for (std::size_t i = 0; i < n; ++i) {
+      pool().post([i, &done] {
+        tinyTask(i);
+        done.fetch_add(1, std::memory_order_release);
+      });
+    }
+    while (done.load(std::memory_order_acquire) < n) {
+      if (!pool().run_pending_task()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  setCounters(state, n);
+}
+
+static void BM_FanOutFanIn(benchmark::State &state) {
+  jobs::graph g = fanOutFanIn(static_cast<std::size_t>(state.range(0)), false);
+  runGraph(state, g);
+}
+
+static void BM_Priorities(benchmark::State &state) {
+  jobs::graph g = fanOutFanIn(static_cast<std::size_t>(state.range(0)), true);
+  runGraph(state, g);
+}
+
+static void BM_Chain(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  jobs::graph g;
+  g.reserve(n);
+  jobs::job_id previous = g.add([] { tinyTask(0); });
+  for (std::size_t i = 1; i < n; ++i) {
+    const jobs::job_id id = g.add([i] { tinyTask(i); });
+    g.precede(previous, id);
+    previous = id;
+  }
+  runGraph(state, g);
+}
+
+static void BM_Wavefront(benchmark::State &state) {
+  const auto side = static_cast<std::size_t>(
+      std::sqrt(static_cast<double>(state.range(0))));
+  jobs::graph g;
+  g.reserve(side * side);
+  for (std::size_t row = 0; row < side; ++row) {
+    for (std::size_t col = 0; col < side; ++col) {
+      const jobs::job_id id = g.add([row, col] { tinyTask(row ^ col); });
+      if (col > 0) {
+        g.precede(id - 1, id);
+      }
+      if (row > 0) {
+        g.precede(static_cast<jobs::job_id>(id - side), id);
+      }
+    }
+  }
+  runGraph(state, g);
+}
+
+#define JOB_COUNTS Arg(10'000)->Arg(1'000'000)
+
+BENCHMARK(BM_SequentialCalls)
+    ->JOB_COUNTS
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ThreadPoolPost)
+    ->JOB_COUNTS
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_FanOutFanIn)
+    ->JOB_COUNTS
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_Priorities)
+    ->JOB_COUNTS
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_Chain)
+    ->JOB_COUNTS
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_Wavefront)
+    ->JOB_COUNTS
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
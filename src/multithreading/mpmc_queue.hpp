@@ -0,0 +1,233 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include "cpu_relax.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+///
+/// A bounded multi-producer multi-consumer queue without locks.
+///
+/// The ring buffer is a power-of-two array of slots. Every slot carries a
+/// sequence number ("turn") telling whose turn it is: for lap `t` over the
+/// ring, turn == 2t means "empty, producer t may write" and turn == 2t + 1
+/// means "full, consumer t may read". push() and pop() take a ticket with a
+/// single fetch_add on the head/tail counter and then only touch their own
+/// slot, so producers and consumers never contend on one lock. Slots and
+/// counters are cache-line aligned to avoid false sharing.
+///
+/// WaitPolicy decides what push()/pop() do while their slot is not ready:
+/// spin_wait burns CPU (lowest latency, needs a free core per thread),
+/// blocking_wait spins briefly and then parks through std::atomic::wait
+/// (a futex on Linux).
+///
+
+namespace mpmc {
+
+constexpr std::size_t cache_line_size = 64;
+
+struct spin_wait {
+  static void wait(const std::atomic<std::size_t> &turn, std::size_t expected,
+                   std::atomic<std::uint32_t> &) {
+    for (int i = 0; turn.load(std::memory_order_acquire) != expected; ++i) {
+      if (i < 128) {
+        cpuRelax();
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+  static void notify(std::atomic<std::size_t> &, std::atomic<std::uint32_t> &) {}
+};
+
+struct blocking_wait {
+  static void wait(const std::atomic<std::size_t> &turn, std::size_t expected,
+                   std::atomic<std::uint32_t> &waiters) {
+    for (int i = 0; i < 128; ++i) {
+      if (turn.load(std::memory_order_acquire) == expected) {
+        return;
+      }
+      cpuRelax();
+    }
+    waiters.fetch_add(1);
+    std::size_t current;
+    while ((current = turn.load()) != expected) {
+      turn.wait(current, std::memory_order_acquire);
+    }
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // notify_all() is not free even when nobody sleeps, so only call it when a
+  // waiter announced itself. The fence orders our turn store before the
+  // waiters load, pairing with the fetch_add in wait(). Several laps may be
+  // waiting on the same slot, so wake all of them.
+  static void notify(std::atomic<std::size_t> &turn,
+                     std::atomic<std::uint32_t> &waiters) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+      turn.notify_all();
+    }
+  }
+};
+
+template <typename T, typename WaitPolicy = blocking_wait> class queue {
+  static_assert(std::is_nothrow_destructible_v<T>, "T must not throw in ~T()");
+
+public:
+  explicit queue(std::size_t capacity)
+      : m_capacity(roundUpPow2(capacity)), m_mask(m_capacity - 1),
+        m_shift(log2(m_capacity)), m_slots(new slot[m_capacity]) {
+    if (capacity == 0) {
+      throw std::invalid_argument("mpmc::queue capacity must be positive");
+    }
+  }
+
+  queue(const queue &) = delete;
+  queue &operator=(const queue &) = delete;
+
+  ~queue() {
+    for (std::size_t i = 0; i < m_capacity; ++i) {
+      if (m_slots[i].turn.load(std::memory_order_relaxed) & 1) {
+        m_slots[i].value()->~T();
+      }
+    }
+  }
+
+  std::size_t capacity() const { return m_capacity; }
+
+  /// Approximate: only exact when no other thread is pushing or popping.
+  std::ptrdiff_t size() const {
+    return static_cast<std::ptrdiff_t>(m_head.load(std::memory_order_relaxed) -
+                                       m_tail.load(std::memory_order_relaxed));
+  }
+
+  bool empty() const { return size() <= 0; }
+
+  /// Blocks (according to WaitPolicy) while the queue is full.
+  template <typename... Args> void emplace(Args &&...args) {
+    const std::size_t head = m_head.fetch_add(1, std::memory_order_relaxed);
+    slot &s = m_slots[head & m_mask];
+    WaitPolicy::wait(s.turn, turn(head) * 2, s.waiters);
+    s.construct(std::forward<Args>(args)...);
+    s.turn.store(turn(head) * 2 + 1, std::memory_order_release);
+    WaitPolicy::notify(s.turn, s.waiters);
+  }
+
+  void push(const T &v) { emplace(v); }
+  void push(T &&v) { emplace(std::move(v)); }
+
+  /// Returns false instead of waiting when the queue is full.
+  template <typename... Args> bool try_emplace(Args &&...args) {
+    std::size_t head = m_head.load(std::memory_order_acquire);
+    for (;;) {
+      slot &s = m_slots[head & m_mask];
+      if (s.turn.load(std::memory_order_acquire) == turn(head) * 2) {
+        if (m_head.compare_exchange_strong(head, head + 1)) {
+          s.construct(std::forward<Args>(args)...);
+          s.turn.store(turn(head) * 2 + 1, std::memory_order_release);
+          WaitPolicy::notify(s.turn, s.waiters);
+          return true;
+        }
+      } else {
+        const std::size_t previous = head;
+        head = m_head.load(std::memory_order_acquire);
+        if (head == previous) {
+          return false;
+        }
+      }
+    }
+  }
+
+  bool try_push(const T &v) { return try_emplace(v); }
+  bool try_push(T &&v) { return try_emplace(std::move(v)); }
+
+  /// Blocks (according to WaitPolicy) while the queue is empty.
+  void pop(T &v) {
+    const std::size_t tail = m_tail.fetch_add(1, std::memory_order_relaxed);
+    slot &s = m_slots[tail & m_mask];
+    WaitPolicy::wait(s.turn, turn(tail) * 2 + 1, s.waiters);
+    v = s.take();
+    s.turn.store(turn(tail) * 2 + 2, std::memory_order_release);
+    WaitPolicy::notify(s.turn, s.waiters);
+  }
+
+  /// Returns false instead of waiting when the queue is empty.
+  bool try_pop(T &v) {
+    std::size_t tail = m_tail.load(std::memory_order_acquire);
+    for (;;) {
+      slot &s = m_slots[tail & m_mask];
+      if (s.turn.load(std::memory_order_acquire) == turn(tail) * 2 + 1) {
+        if (m_tail.compare_exchange_strong(tail, tail + 1)) {
+          v = s.take();
+          s.turn.store(turn(tail) * 2 + 2, std::memory_order_release);
+          WaitPolicy::notify(s.turn, s.waiters);
+          return true;
+        }
+      } else {
+        const std::size_t previous = tail;
+        tail = m_tail.load(std::memory_order_acquire);
+        if (tail == previous) {
+          return false;
+        }
+      }
+    }
+  }
+
+private:
+  struct alignas(cache_line_size) slot {
+    std::atomic<std::size_t> turn{0};
+    std::atomic<std::uint32_t> waiters{0};
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *value() { return std::launder(reinterpret_cast<T *>(storage)); }
+
+    template <typename... Args> void construct(Args &&...args) {
+      ::new (static_cast<void *>(storage)) T(std::forward<Args>(args)...);
+    }
+
+    T take() {
+      T v = std::move(*value());
+      value()->~T();
+      return v;
+    }
+  };
+
+  static std::size_t roundUpPow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) {
+      p <<= 1;
+    }
+    return p;
+  }
+
+  static unsigned log2(std::size_t n) {
+    unsigned s = 0;
+    while ((std::size_t{1} << s) < n) {
+      ++s;
+    }
+    return s;
+  }
+
+  std::size_t turn(std::size_t ticket) const { return ticket >> m_shift; }
+
+  const std::size_t m_capacity;
+  const std::size_t m_mask;
+  const unsigned m_shift;
+  const std::unique_ptr<slot[]> m_slots;
+
+  // Producers and consumers hammer different counters; keep them apart.
+  alignas(cache_line_size) std::atomic<std::size_t> m_head{0};
+  alignas(cache_line_size) std::atomic<std::size_t> m_tail{0};
+};
+
+} // namespace mpmc
+
+#endif
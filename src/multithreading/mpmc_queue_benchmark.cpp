@@ -0,0 +1,128 @@
+// Throughput and latency of the lock-free ring buffer in mpmc_queue.hpp
+// against the mutex + std::deque + condition_variable hand-off from
+// condition_variable.cpp, for 1..N producers and consumers.
+#include "mpmc_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// condition_variable_deque from condition_variable.cpp, without the sleeps.
+class condvar_queue {
+public:
+  explicit condvar_queue(std::size_t) {}
+
+  void push(int v) {
+    std::unique_lock<std::mutex> locker(mu);
+    q.push_front(v);
+    locker.unlock();
+    cond.notify_one();
+  }
+
+  void pop(int &v) {
+    std::unique_lock<std::mutex> locker(mu);
+    cond.wait(locker, [this]() { return !q.empty(); });
+    v = q.back();
+    q.pop_back();
+  }
+
+private:
+  std::deque<int> q;
+  std::mutex mu;
+  std::condition_variable cond;
+};
+
+constexpr std::size_t queue_capacity = 1024;
+constexpr int items = 1 << 20;
+
+// range(0) producers and range(1) consumers move `items` ints through Queue.
+template <typename Queue> void BM_Throughput(benchmark::State &state) {
+  const int producers = static_cast<int>(state.range(0));
+  const int consumers = static_cast<int>(state.range(1));
+  const int per_producer = items / producers;
+  const int total = per_producer * producers;
+
+  for (auto _ : state) {
+    Queue q(queue_capacity);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&q, per_producer] {
+        for (int i = 0; i < per_producer; ++i) {
+          q.push(i);
+        }
+      });
+    }
+    for (int c = 0; c < consumers; ++c) {
+      // The first consumer also takes the remainder.
+      const int share = total / consumers + (c == 0 ? total % consumers : 0);
+      threads.emplace_back([&q, share] {
+        int v = 0;
+        long long sum = 0;
+        for (int i = 0; i < share; ++i) {
+          q.pop(v);
+          sum += v;
+        }
+        benchmark::DoNotOptimize(sum);
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * total);
+}
+
+// Round trip of one message between two threads over a pair of queues.
+template <typename Queue> void BM_PingPong(benchmark::State &state) {
+  constexpr int round_trips = 10'000;
+  for (auto _ : state) {
+    Queue ping(queue_capacity), pong(queue_capacity);
+    std::thread echo([&] {
+      int v = 0;
+      for (int i = 0; i < round_trips; ++i) {
+        ping.pop(v);
+        pong.push(v);
+      }
+    });
+    int v = 0;
+    for (int i = 0; i < round_trips; ++i) {
+      ping.push(i);
+      pong.pop(v);
+    }
+    echo.join();
+  }
+  state.SetItemsProcessed(state.iterations() * round_trips);
+}
+
+void producerConsumerArgs(benchmark::internal::Benchmark *b) {
+  const int n = static_cast<int>(
+      std::max(2u, std::thread::hardware_concurrency()));
+  for (int p = 1; p <= n; p *= 2) {
+    b->Args({p, p});
+  }
+  b->Args({1, n})->Args({n, 1});
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Throughput, condvar_queue)
+    ->Apply(producerConsumerArgs)->ArgNames({"producers", "consumers"})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Throughput, mpmc::queue<int, mpmc::blocking_wait>)
+    ->Apply(producerConsumerArgs)->ArgNames({"producers", "consumers"})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Throughput, mpmc::queue<int, mpmc::spin_wait>)
+    ->Apply(producerConsumerArgs)->ArgNames({"producers", "consumers"})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_PingPong, condvar_queue)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, mpmc::queue<int, mpmc::blocking_wait>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, mpmc::queue<int, mpmc::spin_wait>)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,3 +1,5 @@
+#include "async_logger.hpp"
+
 #include <fstream>
 #include <iostream>
 #include <mutex>
@@ -117,6 +119,26 @@ void function2Log(LogFile &log) {
 
 } // namespace mutexWithStreamProtection
 
+namespace asyncLogging {
+// LogFile above serializes every thread on the mutex *and* on the file write
+// (std::endl flushes each line). async_log::logger takes no lock on the
+// caller's side: log() copies the arguments into a per-thread ring buffer and
+// a background thread formats them and writes whole batches with writev().
+
+void function1Log(async_log::logger &log) {
+  for (int i = 0; i > -100; i--) {
+    log.log("Message from function{}: {}", 1, i);
+  }
+}
+
+void function2Log(async_log::logger &log) {
+  for (int i = 0; i < 100; i++) {
+    log.log("Message from function{}: {}", 2, i);
+  }
+}
+
+} // namespace asyncLogging
+
 class walletMutex {
 public:
   int money;
@@ -176,4 +198,13 @@ int main() {
     t1.join();
     t2.join();
   }
+
+  {
+    async_log::logger log("AsyncLog.txt");
+    std::thread t1(asyncLogging::function1Log, std::ref(log));
+    std::thread t2(asyncLogging::function2Log, std::ref(log));
+    t1.join();
+    t2.join();
+    log.flush();
+  }
 }
@@ -4,4 +4,102 @@ https://www.geeksforgeeks.org/semaphores-in-process-synchronization/
 https://www.youtube.com/watch?v=8wcuLCvMmF8
 
 */
-int main() {}
+#include "semaphore.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// At most 3 of the 8 "queries" run at the same time.
+void limitConcurrentAccess() {
+  futex_sync::counting_semaphore<3> connections(3);
+  std::atomic<int> running{0}, peak{0};
+
+  std::vector<std::thread> pool;
+  for (int i = 0; i < 8; ++i) {
+    pool.emplace_back([&] {
+      connections.acquire();
+      int now = ++running;
+      int seen = peak.load();
+      while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      --running;
+      connections.release();
+    });
+  }
+  for (auto &t : pool) {
+    t.join();
+  }
+  std::cout << "counting_semaphore<3>: at most " << peak
+            << " queries ran at once" << std::endl;
+}
+
+// One-shot signal from a producer to a consumer.
+void oneShotSignal() {
+  futex_sync::binary_semaphore ready(0);
+  int data = 0;
+
+  std::thread consumer([&] {
+    ready.acquire();
+    std::cout << "binary_semaphore: consumer got " << data << std::endl;
+  });
+  data = 42;
+  ready.release();
+  consumer.join();
+}
+
+// Workers finish their setup; main waits for all of them once.
+void waitForStartup() {
+  constexpr int workers = 4;
+  futex_sync::latch started(workers);
+
+  std::vector<std::thread> pool;
+  for (int i = 0; i < workers; ++i) {
+    pool.emplace_back([&started, i] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10 * i));
+      started.count_down();
+    });
+  }
+  started.wait();
+  std::cout << "latch: all " << workers << " workers started" << std::endl;
+  for (auto &t : pool) {
+    t.join();
+  }
+}
+
+// Every thread finishes step k before any thread starts step k + 1.
+void stepInLockstep() {
+  constexpr int threads = 4, steps = 3;
+  futex_sync::barrier sync_point(threads);
+  std::atomic<int> finished_step[steps] = {};
+  std::atomic<bool> in_order{true};
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; ++t) {
+    pool.emplace_back([&] {
+      for (int step = 0; step < steps; ++step) {
+        if (step > 0 && finished_step[step - 1] != threads) {
+          in_order = false;
+        }
+        ++finished_step[step];
+        sync_point.arrive_and_wait();
+      }
+    });
+  }
+  for (auto &t : pool) {
+    t.join();
+  }
+  std::cout << "barrier: " << threads << " threads ran " << steps
+            << " steps in lockstep: " << std::boolalpha << in_order.load()
+            << std::endl;
+}
+
+int main() {
+  limitConcurrentAccess();
+  oneShotSignal();
+  waitForStartup();
+  stepInLockstep();
+}
@@ -0,0 +1,229 @@
+#ifndef SEMAPHORE_HPP
+#define SEMAPHORE_HPP
+
+#include "cpu_relax.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+///
+/// Spin-then-park synchronization primitives: counting/binary semaphore, latch
+/// and barrier.
+///
+/// Each one keeps its whole state in a 32-bit atomic. The fast path is a single
+/// atomic operation with no system call. A thread that has to wait first spins
+/// for a short while (the other side is often only nanoseconds away) and only
+/// then parks in the kernel on that very word: FUTEX_WAIT on Linux,
+/// std::atomic::wait elsewhere. The waking side only makes a system call when
+/// a sleeper has registered itself, so uncontended hand-offs never enter the
+/// kernel, unlike std::mutex + std::condition_variable.
+///
+
+namespace futex_sync {
+
+namespace detail {
+
+// Spinning only pays off when the thread we wait for can run at the same
+// time; on a single CPU it just delays the context switch.
+inline int spinCount() {
+  static const int spins = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+  return spins;
+}
+
+inline void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected) {
+#if defined(__linux__)
+  // Returns at once if word != expected; spurious wake-ups are possible, so
+  // callers always re-check in a loop.
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word),
+          FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+  word.wait(expected, std::memory_order_acquire);
+#endif
+}
+
+inline void futexWake(std::atomic<std::uint32_t> &word, int count) {
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word),
+          FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+  if (count == 1) {
+    word.notify_one();
+  } else {
+    word.notify_all();
+  }
+#endif
+}
+
+template <typename Predicate> bool spinUntil(Predicate ready) {
+  for (int i = 0, n = spinCount(); i < n; ++i) {
+    if (ready()) {
+      return true;
+    }
+    cpuRelax();
+  }
+  return ready();
+}
+
+} // namespace detail
+
+/// Same interface as std::counting_semaphore.
+template <std::ptrdiff_t LeastMaxValue = INT_MAX> class counting_semaphore {
+  static_assert(LeastMaxValue > 0 && LeastMaxValue <= UINT32_MAX);
+
+public:
+  explicit counting_semaphore(std::ptrdiff_t desired)
+      : m_count(static_cast<std::uint32_t>(desired)) {}
+
+  counting_semaphore(const counting_semaphore &) = delete;
+  counting_semaphore &operator=(const counting_semaphore &) = delete;
+
+  static constexpr std::ptrdiff_t max() noexcept { return LeastMaxValue; }
+
+  void release(std::ptrdiff_t update = 1) {
+    if constexpr (LeastMaxValue == 1) {
+      m_count.store(1, std::memory_order_release);
+    } else {
+      m_count.fetch_add(static_cast<std::uint32_t>(update),
+                        std::memory_order_release);
+    }
+    // Pairs with the fence in acquire(): either we see the sleeper, or the
+    // sleeper sees the new count and does not go to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed) > 0) {
+      detail::futexWake(m_count, static_cast<int>(update));
+    }
+  }
+
+  bool try_acquire() noexcept {
+    std::uint32_t count = m_count.load(std::memory_order_relaxed);
+    while (count > 0) {
+      if (m_count.compare_exchange_weak(count, count - 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void acquire() {
+    if (detail::spinUntil([this] { return try_acquire(); })) {
+      return;
+    }
+    m_waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!try_acquire()) {
+      detail::futexWait(m_count, 0);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<std::uint32_t> m_count;
+  std::atomic<std::uint32_t> m_waiters{0};
+};
+
+using binary_semaphore = counting_semaphore<1>;
+
+/// Same interface as std::latch: a single-use countdown.
+class latch {
+public:
+  explicit latch(std::ptrdiff_t expected)
+      : m_count(static_cast<std::uint32_t>(expected)) {}
+
+  latch(const latch &) = delete;
+  latch &operator=(const latch &) = delete;
+
+  void count_down(std::ptrdiff_t update = 1) {
+    const auto n = static_cast<std::uint32_t>(update);
+    if (m_count.fetch_sub(n, std::memory_order_acq_rel) == n) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_waiters.load(std::memory_order_relaxed) > 0) {
+        detail::futexWake(m_count, INT_MAX);
+      }
+    }
+  }
+
+  bool try_wait() const noexcept {
+    return m_count.load(std::memory_order_acquire) == 0;
+  }
+
+  void wait() {
+    if (detail::spinUntil([this] { return try_wait(); })) {
+      return;
+    }
+    m_waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint32_t count;
+    while ((count = m_count.load(std::memory_order_acquire)) != 0) {
+      detail::futexWait(m_count, count);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void arrive_and_wait(std::ptrdiff_t update = 1) {
+    count_down(update);
+    wait();
+  }
+
+private:
+  std::atomic<std::uint32_t> m_count;
+  std::atomic<std::uint32_t> m_waiters{0};
+};
+
+/// A reusable barrier for a fixed number of threads (std::barrier without a
+/// completion function). Threads park on the phase number, which the last
+/// thread to arrive bumps.
+class barrier {
+public:
+  explicit barrier(std::ptrdiff_t expected)
+      : m_expected(static_cast<std::uint32_t>(expected)) {}
+
+  barrier(const barrier &) = delete;
+  barrier &operator=(const barrier &) = delete;
+
+  void arrive_and_wait() {
+    const std::uint32_t phase = m_phase.load(std::memory_order_acquire);
+    if (m_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_expected) {
+      m_arrived.store(0, std::memory_order_relaxed);
+      m_phase.fetch_add(1, std::memory_order_release);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (m_waiters.load(std::memory_order_relaxed) > 0) {
+        detail::futexWake(m_phase, INT_MAX);
+      }
+      return;
+    }
+
+    auto phase_done = [&] {
+      return m_phase.load(std::memory_order_acquire) != phase;
+    };
+    if (detail::spinUntil(phase_done)) {
+      return;
+    }
+    m_waiters.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!phase_done()) {
+      detail::futexWait(m_phase, phase);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+private:
+  const std::uint32_t m_expected;
+  std::atomic<std::uint32_t> m_arrived{0};
+  std::atomic<std::uint32_t> m_phase{0};
+  std::atomic<std::uint32_t> m_waiters{0};
+};
+
+} // namespace futex_sync
+
+#endif
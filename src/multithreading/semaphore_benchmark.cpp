@@ -0,0 +1,113 @@
+// Wake-up latency and context switches of a two-thread ping-pong: the
+// std::mutex + std::condition_variable hand-off from condition_variable.cpp
+// against the spin-then-futex primitives in semaphore.hpp.
+#include "semaphore.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <barrier>
+#include <condition_variable>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+// The flag + condition_variable hand-off from condition_variable.cpp.
+class condvar_signal {
+public:
+  explicit condvar_signal(int) {}
+
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      ready = true;
+    }
+    cond.notify_one();
+  }
+
+  void acquire() {
+    std::unique_lock<std::mutex> lock(mu);
+    cond.wait(lock, [this] { return ready; });
+    ready = false;
+  }
+
+private:
+  std::mutex mu;
+  std::condition_variable cond;
+  bool ready = false;
+};
+
+long contextSwitches() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+// Each round trip is two wake-ups: main -> echo -> main.
+template <typename Signal> void BM_PingPong(benchmark::State &state) {
+  constexpr int round_trips = 10'000;
+  long switches = 0;
+  for (auto _ : state) {
+    Signal ping(0), pong(0);
+    const long before = contextSwitches();
+    std::thread echo([&] {
+      for (int i = 0; i < round_trips; ++i) {
+        ping.acquire();
+        pong.release();
+      }
+    });
+    for (int i = 0; i < round_trips; ++i) {
+      ping.release();
+      pong.acquire();
+    }
+    echo.join();
+    switches += contextSwitches() - before;
+  }
+  state.SetItemsProcessed(state.iterations() * round_trips);
+  state.counters["ctx_switches_per_round_trip"] = benchmark::Counter(
+      static_cast<double>(switches) / (state.iterations() * round_trips));
+}
+
+template <typename Barrier> void BM_BarrierPhase(benchmark::State &state) {
+  constexpr int phases = 10'000;
+  const int threads = static_cast<int>(state.range(0));
+  long switches = 0;
+  for (auto _ : state) {
+    Barrier sync_point(threads);
+    const long before = contextSwitches();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+      pool.emplace_back([&] {
+        for (int i = 0; i < phases; ++i) {
+          sync_point.arrive_and_wait();
+        }
+      });
+    }
+    for (int i = 0; i < phases; ++i) {
+      sync_point.arrive_and_wait();
+    }
+    for (auto &t : pool) {
+      t.join();
+    }
+    switches += contextSwitches() - before;
+  }
+  state.SetItemsProcessed(state.iterations() * phases);
+  state.counters["ctx_switches_per_phase"] = benchmark::Counter(
+      static_cast<double>(switches) / (state.iterations() * phases));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_PingPong, condvar_signal)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, std::binary_semaphore)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, futex_sync::binary_semaphore)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, futex_sync::counting_semaphore<>)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_BarrierPhase, std::barrier<>)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BarrierPhase, futex_sync::barrier)->Arg(2)->Arg(4)->UseRealTime();
+
+BENCHMARK_MAIN();
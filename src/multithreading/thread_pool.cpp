@@ -1 +1,64 @@
-int main() {}
\ No newline at end of file
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+std::uint64_t fibonacci(int n) {
+  std::uint64_t a = 0, b = 1;
+  for (int i = 0; i < n; ++i) {
+    a = std::exchange(b, a + b);
+  }
+  return a;
+}
+
+int main() {
+  thread_pool pool;
+  std::cout << "pool has " << pool.size() << " workers" << std::endl;
+
+  { // submit() returns a future
+    std::vector<std::future<std::uint64_t>> results;
+    for (int n = 10; n < 20; ++n) {
+      results.push_back(pool.submit(fibonacci, n));
+    }
+    for (auto &r : results) {
+      std::cout << r.get() << " ";
+    }
+    std::cout << std::endl;
+  }
+
+  { // exceptions travel through the future
+    auto failing = pool.submit([]() -> int {
+      throw std::runtime_error("task failed");
+    });
+    try {
+      failing.get();
+    } catch (const std::exception &e) {
+      std::cout << "caught: " << e.what() << std::endl;
+    }
+  }
+
+  { // parallel_for over a large range, one chunk per task
+    std::vector<double> v(10'000'000);
+    auto start = std::chrono::steady_clock::now();
+    pool.parallel_for(std::size_t{0}, v.size(),
+                      [&v](std::size_t i) { v[i] = 0.5 * i; });
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "parallel_for filled " << v.size() << " elements in "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms, sum = " << std::accumulate(v.begin(), v.end(), 0.0)
+              << std::endl;
+  }
+
+  { // tasks can spawn tasks; they land on the spawning worker's own deque
+    auto outer = pool.submit([&pool] {
+      std::atomic<int> sum{0};
+      pool.parallel_for(0, 100, [&sum](int i) { sum += i; });
+      return sum.load();
+    });
+    std::cout << "nested parallel_for: " << outer.get() << std::endl;
+  }
+}
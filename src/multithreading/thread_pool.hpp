@@ -0,0 +1,274 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// A fixed-size work-stealing thread pool.
+///
+/// Every worker owns a deque. A worker pushes and pops its own tasks at the
+/// back (LIFO, the task is still hot in cache) and, when it runs dry, steals
+/// from the front of the other workers' deques (FIFO, the oldest task). Tasks
+/// submitted from outside the pool are spread round-robin over the deques.
+/// Idle workers spin for a short while and then park on a condition variable,
+/// so an idle pool costs no CPU.
+///
+
+class thread_pool {
+public:
+  /// Move-only type-erased callable. std::function requires a copyable target
+  /// and std::packaged_task is move-only, so we need our own.
+  class task {
+    struct concept_t {
+      virtual ~concept_t() = default;
+      virtual void run() = 0;
+    };
+
+    template <typename F> struct model_t final : concept_t {
+      template <typename G> explicit model_t(G &&g) : fn(std::forward<G>(g)) {}
+      void run() override { fn(); }
+      F fn;
+    };
+
+    std::unique_ptr<concept_t> m_impl;
+
+  public:
+    task() = default;
+
+    template <typename F, typename = std::enable_if_t<
+                              !std::is_same_v<std::decay_t<F>, task>>>
+    task(F &&f)
+        : m_impl(std::make_unique<model_t<std::decay_t<F>>>(
+              std::forward<F>(f))) {}
+
+    void operator()() { m_impl->run(); }
+
+    explicit operator bool() const { return m_impl != nullptr; }
+  };
+
+  explicit thread_pool(
+      std::size_t thread_count = std::max(1u,
+                                          std::thread::hardware_concurrency()))
+      : m_queues(std::max<std::size_t>(1, thread_count)) {
+    m_workers.reserve(m_queues.size());
+    for (std::size_t i = 0; i < m_queues.size(); ++i) {
+      m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  /// Runs every task that is still queued, then joins the workers.
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_mutex);
+      m_stop.store(true);
+    }
+    m_wake.notify_all();
+    for (auto &worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  std::size_t size() const { return m_workers.size(); }
+
+  /// Fire-and-forget. The task must not throw: there is nobody to report to.
+  template <typename F> void post(F &&f) { enqueue(task(std::forward<F>(f))); }
+
+  /// Queues f(args...) and returns a future for its result. Exceptions thrown
+  /// by the task are delivered through the future.
+  template <typename F, typename... Args>
+  auto submit(F &&f, Args &&...args)
+      -> std::future<std::invoke_result_t<std::decay_t<F>,
+                                          std::decay_t<Args>...>> {
+    using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+    std::packaged_task<R()> job(
+        [f = std::forward<F>(f),
+         ... args = std::forward<Args>(args)]() mutable -> R {
+          return std::invoke(std::move(f), std::move(args)...);
+        });
+    std::future<R> result = job.get_future();
+    enqueue(task(std::move(job)));
+    return result;
+  }
+
+  /// Calls body(i) for every i in [first, last). The range is cut into chunks
+  /// of `grain` indices (by default about four chunks per worker). The calling
+  /// thread helps running queued tasks until all chunks are done, so it is
+  /// safe to call parallel_for from inside a pool task. The first exception
+  /// thrown by body is rethrown here.
+  template <typename Index, typename F>
+  void parallel_for(Index first, Index last, F &&body, Index grain = 0) {
+    static_assert(std::is_integral_v<Index>, "parallel_for needs an integer");
+    if (!(first < last)) {
+      return;
+    }
+    const std::size_t count = static_cast<std::size_t>(last - first);
+    std::size_t step = static_cast<std::size_t>(grain);
+    if (step == 0) {
+      step = std::max<std::size_t>(1, count / (size() * 4));
+    }
+    const std::size_t chunks = (count + step - 1) / step;
+
+    std::atomic<std::size_t> remaining{chunks};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto run_chunk = [&](std::size_t chunk) {
+      const Index begin = first + static_cast<Index>(chunk * step);
+      const Index end =
+          first + static_cast<Index>(std::min(count, (chunk + 1) * step));
+      try {
+        for (Index i = begin; i < end; ++i) {
+          body(i);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      remaining.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+      enqueue(task([&run_chunk, chunk] { run_chunk(chunk); }));
+    }
+    run_chunk(0);
+
+    while (remaining.load(std::memory_order_acquire) > 0) {
+      if (!run_pending_task()) {
+        std::this_thread::yield();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /// Runs one queued task on the calling thread, if there is one. Threads that
+  /// wait for pool work should call this instead of blocking.
+  bool run_pending_task() {
+    task t;
+    const bool own = tl_pool == this;
+    if (!tryPop(own ? tl_index : 0, own, t)) {
+      return false;
+    }
+    t();
+    return true;
+  }
+
+private:
+  // One deque per worker, padded so that two workers' locks never share a
+  // cache line.
+  struct alignas(64) worker_queue {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  static constexpr int spin_rounds = 64;
+
+  static inline thread_local const thread_pool *tl_pool = nullptr;
+  static inline thread_local std::size_t tl_index = 0;
+
+  std::vector<worker_queue> m_queues;
+  std::vector<std::thread> m_workers;
+
+  // Number of tasks pushed but not yet taken. It is incremented before the
+  // push, so a worker that sees zero may safely park.
+  std::atomic<std::size_t> m_pending{0};
+  std::atomic<std::size_t> m_sleeping{0};
+  std::atomic<std::size_t> m_next{0};
+  std::atomic<bool> m_stop{false};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake;
+
+  void enqueue(task t) {
+    const std::size_t index =
+        tl_pool == this
+            ? tl_index
+            : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    m_pending.fetch_add(1);
+    {
+      std::lock_guard<std::mutex> lock(m_queues[index].mutex);
+      m_queues[index].tasks.push_back(std::move(t));
+    }
+    // Pairs with the m_sleeping increment in workerLoop(): either the worker
+    // sees our m_pending increment, or we see it is about to sleep and take
+    // the sleep mutex so the notification cannot be lost.
+    if (m_sleeping.load() > 0) {
+      { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+      m_wake.notify_one();
+    }
+  }
+
+  bool tryPop(std::size_t index, bool own, task &out) {
+    const std::size_t n = m_queues.size();
+    if (own) {
+      worker_queue &q = m_queues[index];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (!q.tasks.empty()) {
+        out = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        m_pending.fetch_sub(1);
+        return true;
+      }
+    }
+    for (std::size_t k = own ? 1 : 0; k < n; ++k) {
+      worker_queue &victim = m_queues[(index + k) % n];
+      std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+      if (lock.owns_lock() && !victim.tasks.empty()) {
+        out = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        m_pending.fetch_sub(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void workerLoop(std::size_t index) {
+    tl_pool = this;
+    tl_index = index;
+    task t;
+    int idle_rounds = 0;
+    for (;;) {
+      if (tryPop(index, true, t)) {
+        t();
+        t = task();
+        idle_rounds = 0;
+        continue;
+      }
+      if (m_pending.load() > 0 || ++idle_rounds < spin_rounds) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      idle_rounds = 0;
+      m_sleeping.fetch_add(1);
+      std::unique_lock<std::mutex> lock(m_sleep_mutex);
+      m_wake.wait(lock, [this] { return m_pending.load() > 0 || m_stop.load(); });
+      m_sleeping.fetch_sub(1);
+      if (m_stop.load() && m_pending.load() == 0) {
+        return;
+      }
+    }
+  }
+};
+
+#endif
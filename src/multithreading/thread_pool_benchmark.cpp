@@ -0,0 +1,125 @@
+// Compares the work-stealing pool in thread_pool.hpp against starting one
+// std::thread per task (creating_and_terminating_threads.cpp) and against
+// std::async (asynchronous_programming.cpp) for many tiny tasks.
+#include "thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// A few nanoseconds of work, so that scheduling cost dominates.
+inline void tinyTask(std::uint64_t i) {
+  std::uint64_t x = i;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  benchmark::DoNotOptimize(x);
+}
+
+// Neither threads nor std::async futures can be kept alive by the million, so
+// both baselines run in waves of this many concurrent tasks.
+constexpr std::size_t wave = 256;
+
+thread_pool &pool() {
+  static thread_pool instance;
+  return instance;
+}
+
+} // namespace
+
+static void BM_ThreadPerTask(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::thread> threads;
+  threads.reserve(wave);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; i += wave) {
+      for (std::size_t j = i; j < std::min(n, i + wave); ++j) {
+        threads.emplace_back(tinyTask, j);
+      }
+      for (auto &t : threads) {
+        t.join();
+      }
+      threads.clear();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_StdAsync(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::future<void>> futures;
+  futures.reserve(wave);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; i += wave) {
+      for (std::size_t j = i; j < std::min(n, i + wave); ++j) {
+        futures.push_back(std::async(std::launch::async, tinyTask, j));
+      }
+      for (auto &f : futures) {
+        f.get();
+      }
+      futures.clear();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_ThreadPoolSubmit(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<std::future<void>> futures;
+  futures.reserve(4096);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; i += 4096) {
+      for (std::size_t j = i; j < std::min(n, i + 4096); ++j) {
+        futures.push_back(pool().submit(tinyTask, j));
+      }
+      for (auto &f : futures) {
+        f.get();
+      }
+      futures.clear();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_ThreadPoolPost(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    std::atomic<std::size_t> done{0};
+    for (std::size_t i = 0; i < n; ++i) {
+      pool().post([i, &done] {
+        tinyTask(i);
+        done.fetch_add(1, std::memory_order_release);
+      });
+    }
+    while (done.load(std::memory_order_acquire) < n) {
+      if (!pool().run_pending_task()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_ThreadPoolParallelFor(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    pool().parallel_for(std::size_t{0}, n, tinyTask);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+#define TASK_COUNTS Arg(1'000)->Arg(100'000)->Arg(10'000'000)
+
+BENCHMARK(BM_ThreadPerTask)->TASK_COUNTS->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_StdAsync)->TASK_COUNTS->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ThreadPoolSubmit)->TASK_COUNTS->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ThreadPoolPost)->TASK_COUNTS->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ThreadPoolParallelFor)->TASK_COUNTS->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,5 +1,8 @@
+#include "concurrent_stack.hpp"
+
 #include <iostream>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -20,21 +23,79 @@ public:
 } // namespace notThreadSafe
 
 namespace threadSafe {
+// Every member takes the lock, and "look at the top" and "remove it" are one
+// step: there is no top(), because the element could be gone by the time the
+// caller acts on it. An empty stack gives std::nullopt instead of UB, and the
+// element is moved out only after pop_back() can no longer throw.
 template <typename T> class stack {
 private:
   std::mutex mx;
   std::vector<T> data;
 
 public:
-  T pop() {
-    T tmp = data.back();
+  std::optional<T> pop() {
+    std::scoped_lock lock(mx);
+    if (data.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> tmp(std::move(data.back()));
     data.pop_back();
     return tmp;
   }
 
-  void push(T element) { data.push_back(element); }
+  void push(T element) {
+    std::scoped_lock lock(mx);
+    data.push_back(std::move(element));
+  }
 };
 
 } // namespace threadSafe
 
-int main() {}
+// Push 0..n-1 from several threads, pop from several threads, and check that
+// every element came out exactly once.
+template <typename Stack> bool pushPopFromManyThreads(const char *name) {
+  constexpr int threads = 4;
+  constexpr int per_thread = 10000;
+  Stack s;
+  std::vector<int> seen(threads * per_thread, 0);
+  std::mutex seen_mutex;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&s, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        s.push(t * per_thread + i);
+      }
+    });
+    workers.emplace_back([&] {
+      std::vector<int> mine;
+      while (static_cast<int>(mine.size()) < per_thread) {
+        if (std::optional<int> v = s.pop()) {
+          mine.push_back(*v);
+        }
+      }
+      std::scoped_lock lock(seen_mutex);
+      for (int v : mine) {
+        ++seen[v];
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  bool ok = true;
+  for (int count : seen) {
+    ok = ok && count == 1;
+  }
+  std::cout << name << ": " << (ok ? "every element popped once" : "BROKEN")
+            << std::endl;
+  return ok;
+}
+
+int main() {
+  pushPopFromManyThreads<threadSafe::stack<int>>("mutex + std::vector");
+  pushPopFromManyThreads<lockfree::treiber_stack<int>>("Treiber stack");
+  pushPopFromManyThreads<lockfree::elimination_stack<int>>(
+      "Treiber stack + elimination array");
+}
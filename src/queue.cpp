@@ -3,6 +3,8 @@
 #include <vector>
 
 // Algorithm for sliding window maximum (LeetCode 239)
+// sliding_window/sliding_window.hpp generalizes it to streams, min/max/sum/
+// mean/variance and time-based windows
 std::vector<int> maxSlidingWindow(std::vector<int> &nums, int k) {
   std::deque<int> dq; // Stores indices, front has max for current window
   std::vector<int> result;
@@ -28,6 +30,8 @@ std::vector<int> maxSlidingWindow(std::vector<int> &nums, int k) {
   return result;
 }
 
+// A scheduler for jobs with priorities and dependencies, built around this
+// struct: multithreading/job_scheduler.cpp
 struct job {
 
   int id = 0;
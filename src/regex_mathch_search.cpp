@@ -6,7 +6,11 @@
 #include <regex>
 
 // regex can be verified at https://regex101.com/
+// std::regex backtracks and is slow on every call; for hot paths see
+// strings::regex in strings/regex.hpp (docs/regex.md).
 
+// One directory, one thread. crawler::findAny() in crawler/crawler.hpp
+// searches a whole tree in parallel with a strings::regex.
 std::optional<std::string>
 findFileWithRegexPattern(const std::string &searchPath,
                          const std::regex &regex) {
@@ -32,12 +36,15 @@ void mapFindingUsingRegex(std::regex regex, std::map<T, T> map) {
   return;
 }
 
+// Takes the regex and the vector by reference and searches each item once:
+// copying either, or searching twice, costs more than the search itself. For
+// many strings, strings::regex (strings/regex.hpp) compiles the pattern to a
+// DFA and is one to two orders of magnitude faster than std::regex.
 template <typename T>
-std::vector<T>::iterator vectorFindingRegex(std::regex regex,
-                                            std::vector<T> vec) {
-  return std::find_if(vec.begin(), vec.end(), [regex](T item) {
-    std::cout << regex_search(item, regex);
-    return regex_search(item, regex);
+typename std::vector<T>::iterator vectorFindingRegex(const std::regex &regex,
+                                                     std::vector<T> &vec) {
+  return std::find_if(vec.begin(), vec.end(), [&regex](const T &item) {
+    return std::regex_search(item, regex);
   });
 }
 
@@ -0,0 +1,101 @@
+#include "searching/searching.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// binary_search() and lower_upper_equal_bound() from algorithms_library.cpp:
+// the indexes answer with the same positions as std::lower_bound.
+void smallInputs() {
+  std::cout << "-------- small inputs --------" << std::endl;
+  std::vector<int> vec1 = {12, 3, 4, 7, 7, 0};
+  std::sort(vec1.begin(), vec1.end());
+  const searching::eytzinger_index<int> eytzinger(vec1);
+  const searching::btree_index<int> btree(vec1);
+
+  int number_to_be_inserted = 7;
+  std::cout << "First location that " << number_to_be_inserted << " can be inserted: "
+            << std::lower_bound(vec1.begin(), vec1.end(), number_to_be_inserted) - vec1.begin()
+            << " (eytzinger " << eytzinger.lowerBound(number_to_be_inserted) << ", btree "
+            << btree.lowerBound(number_to_be_inserted) << ")" << std::endl;
+  // upper_bound(x) is lower_bound of the next value for integers.
+  std::cout << "Last location that " << number_to_be_inserted << " can be inserted: "
+            << btree.lowerBound(number_to_be_inserted + 1) << std::endl;
+
+  std::cout << std::boolalpha << "contains 9: " << eytzinger.contains(9)
+            << ", contains 12: " << btree.contains(12) << std::endl;
+}
+
+template <typename F> double nanosecondsPerQuery(std::size_t queries, F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+             .count() /
+         static_cast<double>(queries);
+}
+
+// One million random queries against 1e3 to 1e8 sorted 32-bit keys.
+void largeInputs() {
+  std::cout << "-------- lower bound (ns per query) --------" << std::endl;
+  std::cout << "keys         std::lower_bound  branchless  eytzinger  btree  btree batched"
+            << std::endl;
+  std::mt19937 gen(42);
+  std::vector<std::uint32_t> queries(1'000'000);
+  for (auto &q : queries) {
+    q = static_cast<std::uint32_t>(gen());
+  }
+  std::vector<std::size_t> expected(queries.size());
+  std::vector<std::size_t> ranks(queries.size());
+
+  for (std::size_t n = 1000; n <= 100'000'000; n *= 10) {
+    std::vector<std::uint32_t> keys(n);
+    for (auto &k : keys) {
+      k = static_cast<std::uint32_t>(gen());
+    }
+    std::sort(keys.begin(), keys.end());
+    const searching::eytzinger_index<std::uint32_t> eytzinger(keys);
+    const searching::btree_index<std::uint32_t> btree(keys);
+
+    const double std_ns = nanosecondsPerQuery(queries.size(), [&] {
+      for (std::size_t i = 0; i < queries.size(); ++i) {
+        expected[i] = static_cast<std::size_t>(
+            std::lower_bound(keys.begin(), keys.end(), queries[i]) - keys.begin());
+      }
+    });
+    bool ok = true;
+    const auto check = [&] { ok = ok && ranks == expected; };
+    const double branchless_ns = nanosecondsPerQuery(queries.size(), [&] {
+      for (std::size_t i = 0; i < queries.size(); ++i) {
+        ranks[i] = static_cast<std::size_t>(
+            searching::branchlessLowerBound(keys.begin(), keys.end(), queries[i]) - keys.begin());
+      }
+    });
+    check();
+    const double eytzinger_ns = nanosecondsPerQuery(queries.size(), [&] {
+      for (std::size_t i = 0; i < queries.size(); ++i) {
+        ranks[i] = eytzinger.lowerBound(queries[i]);
+      }
+    });
+    check();
+    const double btree_ns = nanosecondsPerQuery(queries.size(), [&] {
+      for (std::size_t i = 0; i < queries.size(); ++i) {
+        ranks[i] = btree.lowerBound(queries[i]);
+      }
+    });
+    check();
+    const double batched_ns =
+        nanosecondsPerQuery(queries.size(), [&] { btree.lowerBound(queries, ranks); });
+    check();
+    std::printf("%-12zu %16.1f %11.1f %10.1f %6.1f %14.1f %s\n", n, std_ns, branchless_ns,
+                eytzinger_ns, btree_ns, batched_ns, ok ? "" : "MISMATCH");
+  }
+}
+
+int main() {
+  smallInputs();
+  largeInputs();
+}
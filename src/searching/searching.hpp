@@ -0,0 +1,404 @@
+#ifndef SEARCHING_HPP
+#define SEARCHING_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+///
+/// Searching large sorted arrays faster than std::lower_bound.
+///
+/// Binary search over a sorted array reads one element per step, and each
+/// step's position depends on the comparison before it. On an array larger
+/// than the cache almost every step is a cache miss, the first few steps
+/// always jump across the whole array, and the branch on the comparison is
+/// mispredicted half of the time.
+///
+/// - branchlessLowerBound(): std::lower_bound on the same sorted array, with
+///   the comparison turned into a conditional move and both possible next
+///   positions prefetched. The number of steps no longer depends on the data,
+///   so the loop never mispredicts and the misses of one step overlap with
+///   the next.
+/// - eytzinger_index<T, Compare>: the keys in the order of a breadth-first
+///   walk of the binary search tree (node k has children 2k and 2k + 1), as
+///   in a binary heap. The first levels of every search share a few cache
+///   lines that stay cached, and the 16 descendants four levels below a node
+///   sit in one cache line, so the search prefetches four levels ahead.
+/// - btree_index<T, Compare>: a static B+ tree (S+ tree). Each node holds
+///   one cache line of keys (16 32-bit integers), and a search reads one
+///   node per level, log17(n) levels instead of log2(n). The keys of a node
+///   are compared all at once (SSE2/AVX2 for 32-bit integers). The leaves
+///   are the sorted keys themselves.
+///
+/// Both indexes are built once from a sorted range and cannot be modified.
+/// lowerBound() returns what std::lower_bound - begin would on that range:
+/// the position of the first key not less than the one searched for, or
+/// size() if there is none. The batched overloads search many keys
+/// interleaved, so that the cache misses of different searches overlap.
+///
+
+namespace searching {
+
+using size_type = std::size_t;
+
+namespace detail {
+
+constexpr std::size_t cache_line = 64;
+
+inline void prefetch(const void *p) noexcept {
+#if defined(__GNUC__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+template <typename T> struct cache_aligned_allocator {
+  using value_type = T;
+
+  cache_aligned_allocator() = default;
+  template <typename U> cache_aligned_allocator(const cache_aligned_allocator<U> &) noexcept {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{cache_line}));
+  }
+  void deallocate(T *p, std::size_t n) noexcept {
+    ::operator delete(p, n * sizeof(T), std::align_val_t{cache_line});
+  }
+
+  template <typename U> bool operator==(const cache_aligned_allocator<U> &) const noexcept {
+    return true;
+  }
+};
+
+template <typename T> using aligned_vector = std::vector<T, cache_aligned_allocator<T>>;
+
+template <typename It, typename Compare>
+size_type checkedSize(It first, It last, const Compare &comp, const char *who) {
+  if (!std::is_sorted(first, last, comp)) {
+    throw std::invalid_argument(std::string(who) + ": the keys are not sorted");
+  }
+  return static_cast<size_type>(std::distance(first, last));
+}
+
+// Number of searches a batched lowerBound() runs side by side.
+constexpr size_type batch_size = 16;
+
+} // namespace detail
+
+/// std::lower_bound without branches on the comparison.
+template <std::random_access_iterator It, typename T, typename Compare = std::less<>>
+It branchlessLowerBound(It first, It last, const T &key, Compare comp = Compare()) {
+  auto length = std::distance(first, last);
+  if (length == 0) {
+    return first;
+  }
+  while (length > 1) {
+    const auto half = length / 2;
+    length -= half;
+    // The next step reads the middle of one of the two halves. There is no
+    // next step once length is 1, and first[-1] may be outside the range.
+    if (length > 1) {
+      detail::prefetch(std::addressof(first[length / 2 - 1]));
+      detail::prefetch(std::addressof(first[half + length / 2 - 1]));
+    }
+    // A multiplication, not `? half : 0`, which GCC turns back into a branch.
+    first += half * static_cast<decltype(half)>(comp(first[half - 1], key));
+  }
+  return first + static_cast<decltype(length)>(comp(*first, key));
+}
+
+template <typename T, typename Compare = std::less<T>> class eytzinger_index {
+public:
+  eytzinger_index() = default;
+
+  /// Builds the index from a sorted range; throws std::invalid_argument if
+  /// the range is not sorted under comp.
+  template <std::random_access_iterator It>
+  eytzinger_index(It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+    m_size = detail::checkedSize(first, last, m_comp, "eytzinger_index");
+    if (m_size == 0) {
+      return;
+    }
+    m_height = std::bit_width(m_size);
+    // Slot 0 is unused: with the root at 1, the children of k are 2k and 2k + 1.
+    m_data.reserve(m_size + 1);
+    m_data.push_back(first[0]);
+    for (size_type k = 1; k <= m_size; ++k) {
+      m_data.push_back(first[rankOf(k)]);
+    }
+  }
+
+  template <std::ranges::random_access_range R>
+  explicit eytzinger_index(const R &keys, const Compare &comp = Compare())
+      : eytzinger_index(std::ranges::begin(keys), std::ranges::end(keys), comp) {}
+
+  size_type size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  size_type lowerBound(const T &key) const noexcept { return rankOrEnd(slotOf(key)); }
+
+  bool contains(const T &key) const noexcept {
+    const size_type k = slotOf(key);
+    return k != 0 && !m_comp(key, m_data[k]);
+  }
+
+  /// ranks[i] = lowerBound(keys[i]); throws std::invalid_argument if the
+  /// spans differ in size.
+  void lowerBound(std::span<const T> keys, std::span<size_type> ranks) const {
+    if (keys.size() != ranks.size()) {
+      throw std::invalid_argument("eytzinger_index::lowerBound: keys and ranks differ in size");
+    }
+    for (size_type base = 0; base < keys.size(); base += detail::batch_size) {
+      const size_type count = std::min(detail::batch_size, keys.size() - base);
+      size_type k[detail::batch_size];
+      std::fill_n(k, count, size_type{1});
+      for (size_type level = 0; level < m_height; ++level) {
+        for (size_type j = 0; j < count; ++j) {
+          if (k[j] <= m_size) {
+            prefetchDescendants(k[j]);
+            k[j] = 2 * k[j] + (m_comp(m_data[k[j]], keys[base + j]) ? 1 : 0);
+          }
+        }
+      }
+      for (size_type j = 0; j < count; ++j) {
+        ranks[base + j] = rankOrEnd(k[j] >> (std::countr_one(k[j]) + 1));
+      }
+    }
+  }
+
+private:
+  // Keys per cache line: the descendants of k this many levels down,
+  // k * stride .. k * stride + stride - 1, start a cache line.
+  static constexpr size_type prefetch_stride = std::max<size_type>(1, detail::cache_line / sizeof(T));
+
+  void prefetchDescendants(size_type k) const noexcept {
+    if constexpr (prefetch_stride >= 4) {
+      // Only an address: the line may be past the end of the array.
+      detail::prefetch(reinterpret_cast<const char *>(m_data.data()) + k * prefetch_stride * sizeof(T));
+    }
+  }
+
+  // The search goes right at every key less than `key` and left otherwise.
+  // The answer is the last node where it went left: strip the trailing right
+  // turns (ones) and that left turn. 0 if it never went left.
+  size_type slotOf(const T &key) const noexcept {
+    size_type k = 1;
+    while (k <= m_size) {
+      prefetchDescendants(k);
+      k = 2 * k + (m_comp(m_data[k], key) ? 1 : 0);
+    }
+    return k >> (std::countr_one(k) + 1);
+  }
+
+  size_type rankOrEnd(size_type k) const noexcept { return k == 0 ? m_size : rankOf(k); }
+
+  // Position of slot k in sorted order. In a perfect tree of m_height levels
+  // that is (2k + 1) * 2^h - 2^m_height - 1, with h the levels below k. The
+  // last level is filled from the left, and its missing nodes would have
+  // taken every other position from some point on.
+  size_type rankOf(size_type k) const noexcept {
+    const size_type below = m_height - static_cast<size_type>(std::bit_width(k));
+    const size_type perfect = ((2 * k + 1) << below) - (size_type{1} << m_height) - 1;
+    const size_type last_level = m_size - (size_type{1} << (m_height - 1)) + 1;
+    const size_type leaves_before = (perfect + 1) / 2;
+    return perfect - (leaves_before > last_level ? leaves_before - last_level : 0);
+  }
+
+  detail::aligned_vector<T> m_data;
+  size_type m_size = 0;
+  size_type m_height = 0;
+  [[no_unique_address]] Compare m_comp;
+};
+
+template <typename T, typename Compare = std::less<T>> class btree_index {
+public:
+  /// Keys per node: one cache line.
+  static constexpr size_type node_keys = std::max<size_type>(2, detail::cache_line / sizeof(T));
+
+  btree_index() = default;
+
+  /// Builds the index from a sorted range; throws std::invalid_argument if
+  /// the range is not sorted under comp.
+  template <std::random_access_iterator It>
+  btree_index(It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+    m_size = detail::checkedSize(first, last, m_comp, "btree_index");
+    if (m_size == 0) {
+      return;
+    }
+    // Layer 0 is the leaves; each layer above has one node per node_keys + 1
+    // nodes of the one below. Node j's children are j * (node_keys + 1) + i.
+    std::vector<size_type> nodes = {(m_size + node_keys - 1) / node_keys};
+    while (nodes.back() > 1) {
+      nodes.push_back((nodes.back() + node_keys) / (node_keys + 1));
+    }
+    size_type total = 0;
+    for (size_type count : nodes) {
+      m_offset.push_back(total);
+      total += count * node_keys;
+    }
+
+    // Missing keys are copies of the largest key. lowerBound() answers keys
+    // greater than that without searching, so a copy is never less than the
+    // key searched for and never chosen over a real one.
+    const T &largest = first[static_cast<std::ptrdiff_t>(m_size - 1)];
+    m_data.reserve(total);
+    m_data.insert(m_data.end(), first, last);
+    m_data.resize(nodes[0] * node_keys, largest);
+    // Key i of node j separates child i from child i + 1: it is the first
+    // key of child i + 1, which is the first key of that child's leftmost
+    // leaf.
+    size_type leaves_per_child = 1;
+    for (size_type layer = 1; layer < nodes.size(); ++layer) {
+      for (size_type j = 0; j < nodes[layer]; ++j) {
+        for (size_type i = 0; i < node_keys; ++i) {
+          const size_type leaf = (j * (node_keys + 1) + i + 1) * leaves_per_child;
+          const size_type key = leaf * node_keys;
+          m_data.push_back(key < m_size ? m_data[key] : largest);
+        }
+      }
+      leaves_per_child *= node_keys + 1;
+    }
+  }
+
+  template <std::ranges::random_access_range R>
+  explicit btree_index(const R &keys, const Compare &comp = Compare())
+      : btree_index(std::ranges::begin(keys), std::ranges::end(keys), comp) {}
+
+  size_type size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  /// The keys in sorted order: the leaves of the tree.
+  std::span<const T> keys() const noexcept { return {m_data.data(), m_size}; }
+  const T &operator[](size_type rank) const noexcept { return m_data[rank]; }
+
+  size_type lowerBound(const T &key) const noexcept {
+    if (m_size == 0 || m_comp(m_data[m_size - 1], key)) {
+      return m_size;
+    }
+    size_type j = 0;
+    for (size_type layer = m_offset.size() - 1; layer > 0; --layer) {
+      j = j * (node_keys + 1) + countLess(nodeAt(layer, j), key);
+    }
+    return j * node_keys + countLess(nodeAt(0, j), key);
+  }
+
+  bool contains(const T &key) const noexcept {
+    const size_type rank = lowerBound(key);
+    return rank != m_size && !m_comp(key, m_data[rank]);
+  }
+
+  /// ranks[i] = lowerBound(keys[i]); throws std::invalid_argument if the
+  /// spans differ in size.
+  void lowerBound(std::span<const T> keys, std::span<size_type> ranks) const {
+    if (keys.size() != ranks.size()) {
+      throw std::invalid_argument("btree_index::lowerBound: keys and ranks differ in size");
+    }
+    if (m_size == 0) {
+      std::fill(ranks.begin(), ranks.end(), size_type{0});
+      return;
+    }
+    const T &largest = m_data[m_size - 1];
+    for (size_type base = 0; base < keys.size(); base += detail::batch_size) {
+      const size_type count = std::min(detail::batch_size, keys.size() - base);
+      // Keys past the largest one would walk off the right edge of the
+      // tree: they search for the largest key instead and get m_size.
+      const T *probe[detail::batch_size];
+      for (size_type q = 0; q < count; ++q) {
+        probe[q] = m_comp(largest, keys[base + q]) ? &largest : &keys[base + q];
+      }
+      size_type j[detail::batch_size] = {};
+      for (size_type layer = m_offset.size() - 1; layer > 0; --layer) {
+        for (size_type q = 0; q < count; ++q) {
+          j[q] = j[q] * (node_keys + 1) + countLess(nodeAt(layer, j[q]), *probe[q]);
+        }
+      }
+      for (size_type q = 0; q < count; ++q) {
+        ranks[base + q] = probe[q] == &largest ? m_size
+                                               : j[q] * node_keys + countLess(nodeAt(0, j[q]), *probe[q]);
+      }
+    }
+  }
+
+private:
+  const T *nodeAt(size_type layer, size_type j) const noexcept {
+    return m_data.data() + m_offset[layer] + j * node_keys;
+  }
+
+  // The number of keys in the node less than key. The keys of a node are
+  // sorted, so this is also the position of the first one that is not.
+  size_type countLess(const T *node, const T &key) const noexcept {
+    constexpr bool simd = (std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::uint32_t>) &&
+                          (std::is_same_v<Compare, std::less<T>> ||
+                           std::is_same_v<Compare, std::less<>>);
+    if constexpr (simd) {
+      return countLess32(node, key);
+    } else {
+      size_type count = 0;
+      for (size_type i = 0; i < node_keys; ++i) {
+        count += m_comp(node[i], key) ? 1 : 0;
+      }
+      return count;
+    }
+  }
+
+#if defined(__AVX2__)
+  static size_type countLess32(const T *node, T key) noexcept {
+    // Unsigned keys compare as signed after flipping the top bit.
+    const __m256i flip = _mm256_set1_epi32(std::is_signed_v<T> ? 0 : INT32_MIN);
+    const __m256i x = _mm256_xor_si256(_mm256_set1_epi32(static_cast<std::int32_t>(key)), flip);
+    const auto *p = reinterpret_cast<const __m256i *>(node);
+    const __m256i lo = _mm256_cmpgt_epi32(x, _mm256_xor_si256(_mm256_load_si256(p), flip));
+    const __m256i hi = _mm256_cmpgt_epi32(x, _mm256_xor_si256(_mm256_load_si256(p + 1), flip));
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(lo))) |
+                      static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hi))) << 8;
+    return static_cast<size_type>(std::popcount(mask));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  static size_type countLess32(const T *node, T key) noexcept {
+    const __m128i flip = _mm_set1_epi32(std::is_signed_v<T> ? 0 : INT32_MIN);
+    const __m128i x = _mm_xor_si128(_mm_set1_epi32(static_cast<std::int32_t>(key)), flip);
+    const auto *p = reinterpret_cast<const __m128i *>(node);
+    std::uint32_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+      const __m128i less = _mm_cmpgt_epi32(x, _mm_xor_si128(_mm_load_si128(p + i), flip));
+      mask |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(less))) << (4 * i);
+    }
+    return static_cast<size_type>(std::popcount(mask));
+  }
+#else
+  static size_type countLess32(const T *node, T key) noexcept {
+    size_type count = 0;
+    for (size_type i = 0; i < node_keys; ++i) {
+      count += node[i] < key ? 1 : 0;
+    }
+    return count;
+  }
+#endif
+
+  detail::aligned_vector<T> m_data; // leaves (the sorted keys, padded) first, then the layers above
+  std::vector<size_type> m_offset;  // where each layer starts in m_data
+  size_type m_size = 0;
+  [[no_unique_address]] Compare m_comp;
+};
+
+} // namespace searching
+
+#endif // SEARCHING_HPP
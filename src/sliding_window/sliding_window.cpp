@@ -0,0 +1,72 @@
+#include "sliding_window/sliding_window.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+template <typename T> void print(const std::vector<T> &v) {
+  for (const auto &x : v) {
+    std::cout << x << " ";
+  }
+  std::cout << "\n";
+}
+
+// The example of maxSlidingWindow() in queue.cpp, streaming and in batch.
+void maxOfEveryWindow() {
+  std::cout << "-------- max of every window of 3 --------" << std::endl;
+  const std::vector<int> nums = {1, 3, -1, -3, 5, 3, 6, 7};
+  const std::size_t k = 3;
+
+  sliding_window::count_window<int, sliding_window::stats::max> window(k);
+  std::vector<int> streamed;
+  for (int x : nums) {
+    window.push(x);
+    if (window.full()) {
+      streamed.push_back(window.max());
+    }
+  }
+  print(streamed);
+
+  std::vector<int> batch(nums.size() - k + 1);
+  sliding_window::slidingMax(nums, k, batch);
+  print(batch);
+}
+
+// All statistics over the last four values.
+void countWindowStatistics() {
+  std::cout << "-------- last 4 values --------" << std::endl;
+  sliding_window::count_window<double> window(4);
+  for (double x : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+    window.push(x);
+    std::cout << "push " << x << ": min " << window.min() << ", max " << window.max()
+              << ", mean " << window.mean() << ", variance " << window.variance() << std::endl;
+  }
+}
+
+// Latency samples that arrive at irregular times, summarized over the last
+// second.
+void timeWindowStatistics() {
+  std::cout << "-------- last second --------" << std::endl;
+  using namespace std::chrono_literals;
+  using clock = std::chrono::steady_clock;
+  sliding_window::time_window<int, clock::time_point> latencies(1s);
+  const clock::time_point start = clock::now();
+
+  const std::pair<std::chrono::milliseconds, int> samples[] = {
+      {0ms, 12}, {300ms, 48}, {700ms, 15}, {1200ms, 9}, {1250ms, 31}, {2600ms, 20}};
+  for (const auto &[at, latency_ms] : samples) {
+    latencies.push(start + at, latency_ms);
+    std::cout << "at " << at.count() << " ms: " << latencies.size() << " samples, max "
+              << latencies.max() << " ms, mean " << latencies.mean() << " ms" << std::endl;
+  }
+  latencies.advance(start + 5s);
+  std::cout << "at 5000 ms: " << latencies.size() << " samples" << std::endl;
+}
+
+int main() {
+  maxOfEveryWindow();
+  countWindowStatistics();
+  timeWindowStatistics();
+}
@@ -0,0 +1,591 @@
+#ifndef SLIDING_WINDOW_HPP
+#define SLIDING_WINDOW_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// Statistics over a sliding window of a stream, the general form of
+/// maxSlidingWindow() in queue.cpp.
+///
+/// - count_window<T, S> keeps the last `length` values; time_window<T, Time,
+///   S> keeps the values pushed less than `length` ago. Values are pushed one
+///   at a time and the statistics of the current window can be read after
+///   every push, so the stream never has to be in memory.
+/// - S chooses the statistics to maintain: stats::min, stats::max, stats::sum
+///   (sum and mean) and stats::variance (variance, and sum and mean), or
+///   stats::all. Statistics that are not chosen cost nothing.
+/// - min and max of a time window use the monotonic queue of
+///   maxSlidingWindow(): candidates in decreasing (for max) order, each with
+///   the time at which it leaves the window. Every value enters and leaves
+///   the queue once, so a push is amortized O(1) whatever the window length.
+///   The queues are ring buffers (ring_buffer), one array indexed modulo a
+///   power of two, instead of std::deque's chain of blocks.
+/// - A count window knows where its windows start, so min and max use the
+///   blocks of the batch mode below instead: O(1) per value with no
+///   data-dependent branches, where the queue mispredicts on most pushes.
+/// - sum is kept exactly for integers (in 64 bits), and mean is sum / size.
+///   variance is updated with Welford's method, which adds and removes a
+///   value without the cancellation of a sum of squares.
+/// - slidingMin(), slidingMax() and slidingSum() are the batch mode: all
+///   windows of an array at once (van Herk / Gil-Werman). The input is cut
+///   into blocks of `length`; a window that starts in one block ends in the
+///   next, so its result combines a suffix of the first block with a prefix
+///   of the second. That is three operations per element whatever the
+///   window length, with no branches, and the combining step is a loop over
+///   independent elements that the compiler turns into SIMD instructions.
+///
+
+namespace sliding_window {
+
+/// A double-ended queue in one array whose capacity is a power of two, for
+/// small trivially copyable elements. Grows by doubling when full.
+template <typename T> class ring_buffer {
+public:
+  using size_type = std::size_t;
+
+  ring_buffer() = default;
+  explicit ring_buffer(size_type capacity) { reserve(capacity); }
+
+  bool empty() const noexcept { return m_size == 0; }
+  size_type size() const noexcept { return m_size; }
+  size_type capacity() const noexcept { return m_data.size(); }
+
+  const T &front() const noexcept { return m_data[m_head]; }
+  const T &back() const noexcept { return m_data[(m_head + m_size - 1) & m_mask]; }
+  const T &operator[](size_type i) const noexcept { return m_data[(m_head + i) & m_mask]; }
+
+  void push_back(const T &value) {
+    if (m_size == m_data.size()) {
+      reserve(m_size + 1);
+    }
+    m_data[(m_head + m_size) & m_mask] = value;
+    ++m_size;
+  }
+
+  void pop_front() noexcept {
+    m_head = (m_head + 1) & m_mask;
+    --m_size;
+  }
+
+  void pop_back() noexcept { --m_size; }
+
+  void clear() noexcept {
+    m_head = 0;
+    m_size = 0;
+  }
+
+  void reserve(size_type count) {
+    if (count <= m_data.size()) {
+      return;
+    }
+    std::vector<T> data(std::bit_ceil(count));
+    for (size_type i = 0; i < m_size; ++i) {
+      data[i] = (*this)[i];
+    }
+    m_data = std::move(data);
+    m_mask = m_data.size() - 1;
+    m_head = 0;
+  }
+
+private:
+  std::vector<T> m_data;
+  size_type m_mask = 0;
+  size_type m_head = 0;
+  size_type m_size = 0;
+};
+
+enum class stats : unsigned {
+  min = 1,
+  max = 2,
+  sum = 4,
+  variance = 8 | 4,
+  all = 15,
+};
+
+constexpr stats operator|(stats a, stats b) noexcept {
+  return static_cast<stats>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+
+/// True if the set `s` includes `wanted`.
+constexpr bool includes(stats s, stats wanted) noexcept {
+  return (static_cast<unsigned>(s) & static_cast<unsigned>(wanted)) ==
+         static_cast<unsigned>(wanted);
+}
+
+/// The type sums of T are kept in: 64-bit integers for integers, at least
+/// double for floating point.
+template <typename T>
+using sum_type =
+    std::conditional_t<std::is_floating_point_v<T>, std::common_type_t<T, double>,
+                       std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+namespace detail {
+
+struct max_op {
+  static constexpr stats statistic = stats::max;
+  template <typename T> T operator()(T a, T b) const noexcept { return a < b ? b : a; }
+};
+
+struct min_op {
+  static constexpr stats statistic = stats::min;
+  template <typename T> T operator()(T a, T b) const noexcept { return b < a ? b : a; }
+};
+
+struct plus_op {
+  template <typename T> T operator()(T a, T b) const noexcept { return a + b; }
+};
+
+// The candidates for the maximum (or, with min_op, minimum) of a window:
+// values that no later value beats, oldest first. An equal later value
+// replaces an earlier one, as in maxSlidingWindow().
+template <typename T, typename Key, typename Op> class monotonic_queue {
+public:
+  void push(Key key, T value) {
+    while (!m_entries.empty() && Op()(m_entries.back().value, value) == value) {
+      m_entries.pop_back();
+    }
+    m_entries.push_back({key, value});
+  }
+
+  void expireThrough(Key last_expired) {
+    while (!m_entries.empty() && !(last_expired < m_entries.front().key)) {
+      m_entries.pop_front();
+    }
+  }
+
+  T best() const noexcept { return m_entries.front().value; }
+  void clear() noexcept { m_entries.clear(); }
+
+private:
+  struct entry {
+    Key key;
+    T value;
+  };
+  ring_buffer<entry> m_entries;
+};
+
+struct no_queue {
+  template <typename... Args> void push(Args &&...) noexcept {}
+  template <typename... Args> void expireThrough(Args &&...) noexcept {}
+  void clear() noexcept {}
+};
+
+// The maximum (or, with min_op, minimum) of the last `length` values of a
+// stream cut into blocks of `length`, as in slidingMax(): the window ending
+// at offset j of the current block is offsets j + 1.. of the previous block
+// and 0..j of this one. This keeps the suffix maxima of the previous block
+// and the running maximum of the current one, and recomputes the suffixes
+// once per block: O(1) per value, without the unpredictable loop of a
+// monotonic queue.
+template <typename T, typename Op> class block_extremum {
+public:
+  explicit block_extremum(std::size_t length) : m_suffix(length) {}
+
+  void push(T value, std::size_t offset) noexcept {
+    m_prefix = offset == 0 ? value : Op()(m_prefix, value);
+  }
+
+  // Called with the values of the block that has just been completed.
+  void closeBlock(const T *block) noexcept {
+    const std::size_t length = m_suffix.size();
+    m_suffix[length - 1] = block[length - 1];
+    for (std::size_t j = length - 1; j-- > 0;) {
+      m_suffix[j] = Op()(block[j], m_suffix[j + 1]);
+    }
+  }
+
+  // offset: where the next value goes in the current block.
+  T value(std::size_t offset, bool has_previous) const noexcept {
+    if (offset == 0) {
+      return m_suffix[0];
+    }
+    return has_previous ? Op()(m_suffix[offset], m_prefix) : m_prefix;
+  }
+
+private:
+  std::vector<T> m_suffix;
+  T m_prefix{};
+};
+
+struct no_extremum {
+  explicit no_extremum(std::size_t) noexcept {}
+  template <typename... Args> void push(Args &&...) noexcept {}
+  template <typename... Args> void closeBlock(Args &&...) noexcept {}
+};
+
+// Sum, mean and variance of the values in a window. The caller passes the
+// number of values in the window after each change.
+template <typename T, stats S> class moments {
+public:
+  void add(T value, std::size_t count) noexcept {
+    if constexpr (includes(S, stats::sum)) {
+      m_sum += static_cast<sum_type<T>>(value);
+    }
+    if constexpr (includes(S, stats::variance)) {
+      const double x = static_cast<double>(value);
+      const double delta = x - m_mean;
+      m_mean += delta / static_cast<double>(count);
+      m_m2 += delta * (x - m_mean);
+    }
+  }
+
+  void remove(T value, std::size_t count) noexcept {
+    if constexpr (includes(S, stats::sum)) {
+      m_sum -= static_cast<sum_type<T>>(value);
+    }
+    if constexpr (includes(S, stats::variance)) {
+      if (count == 0) {
+        m_mean = 0.0;
+        m_m2 = 0.0;
+        return;
+      }
+      const double x = static_cast<double>(value);
+      const double delta = x - m_mean;
+      m_mean -= delta / static_cast<double>(count);
+      m_m2 -= delta * (x - m_mean);
+    }
+  }
+
+  void clear() noexcept { *this = moments(); }
+
+  sum_type<T> sum() const noexcept { return m_sum; }
+
+  double mean(std::size_t count) const noexcept {
+    return count == 0 ? 0.0 : static_cast<double>(m_sum) / static_cast<double>(count);
+  }
+
+  double variance(std::size_t count) const noexcept {
+    return count == 0 ? 0.0 : std::max(0.0, m_m2 / static_cast<double>(count));
+  }
+
+private:
+  sum_type<T> m_sum{};
+  double m_mean = 0.0; // Welford's running mean, for m_m2
+  double m_m2 = 0.0;   // sum of squared distances from the mean
+};
+
+} // namespace detail
+
+/// The last `length` values pushed. min() and max() need a non-empty
+/// window; the others are 0 for an empty one.
+template <typename T, stats S = stats::all> class count_window {
+public:
+  static_assert(std::is_arithmetic_v<T>, "count_window holds numbers");
+
+  /// Throws std::invalid_argument if length is 0.
+  explicit count_window(std::size_t length)
+      : m_current(length), m_previous(length), m_max(length), m_min(length), m_length(length) {
+    if (length == 0) {
+      throw std::invalid_argument("count_window: the window length must be positive");
+    }
+  }
+
+  void push(T value) {
+    if (m_next >= m_length) {
+      m_moments.remove(m_previous[m_offset], m_length - 1);
+    }
+    m_current[m_offset] = value;
+    m_max.push(value, m_offset);
+    m_min.push(value, m_offset);
+    ++m_next;
+    m_moments.add(value, size());
+    if (++m_offset == m_length) {
+      m_max.closeBlock(m_current.data());
+      m_min.closeBlock(m_current.data());
+      m_current.swap(m_previous);
+      m_offset = 0;
+    }
+  }
+
+  template <std::ranges::input_range R> void push(const R &values) {
+    for (const auto &value : values) {
+      push(value);
+    }
+  }
+
+  void clear() noexcept {
+    m_moments.clear();
+    m_next = 0;
+    m_offset = 0;
+  }
+
+  std::size_t length() const noexcept { return m_length; }
+  std::size_t size() const noexcept {
+    return static_cast<std::size_t>(std::min<std::uint64_t>(m_next, m_length));
+  }
+  bool empty() const noexcept { return m_next == 0; }
+  bool full() const noexcept { return m_next >= m_length; }
+
+  T max() const noexcept
+    requires(includes(S, stats::max))
+  {
+    return m_max.value(m_offset, m_next > m_offset);
+  }
+  T min() const noexcept
+    requires(includes(S, stats::min))
+  {
+    return m_min.value(m_offset, m_next > m_offset);
+  }
+  sum_type<T> sum() const noexcept
+    requires(includes(S, stats::sum))
+  {
+    return m_moments.sum();
+  }
+  double mean() const noexcept
+    requires(includes(S, stats::sum))
+  {
+    return m_moments.mean(size());
+  }
+  /// Population variance: the mean squared distance from the mean.
+  double variance() const noexcept
+    requires(includes(S, stats::variance))
+  {
+    return m_moments.variance(size());
+  }
+
+private:
+  template <typename Op>
+  using extremum = std::conditional_t<includes(S, Op::statistic), detail::block_extremum<T, Op>,
+                                      detail::no_extremum>;
+
+  std::vector<T> m_current;  // the block being filled
+  std::vector<T> m_previous; // the last complete block
+  extremum<detail::max_op> m_max;
+  extremum<detail::min_op> m_min;
+  detail::moments<T, S> m_moments;
+  std::size_t m_length;
+  std::size_t m_offset = 0;  // position of the next value in m_current
+  std::uint64_t m_next = 0;  // position of the next value in the stream
+};
+
+namespace detail {
+
+// The values of a time window with their times, and the chosen statistics.
+template <typename T, typename Time, stats S> class time_state {
+public:
+  std::size_t size() const noexcept { return m_samples.size(); }
+
+  void add(Time time, T value) {
+    m_samples.push_back({time, value});
+    m_max.push(time, value);
+    m_min.push(time, value);
+    m_moments.add(value, m_samples.size());
+  }
+
+  // Removes the values whose time is not after last_expired.
+  void expireThrough(Time last_expired) {
+    while (!m_samples.empty() && !(last_expired < m_samples.front().time)) {
+      m_moments.remove(m_samples.front().value, m_samples.size() - 1);
+      m_samples.pop_front();
+    }
+    m_max.expireThrough(last_expired);
+    m_min.expireThrough(last_expired);
+  }
+
+  void clear() noexcept {
+    m_samples.clear();
+    m_max.clear();
+    m_min.clear();
+    m_moments.clear();
+  }
+
+  T max() const noexcept { return m_max.best(); }
+  T min() const noexcept { return m_min.best(); }
+  const moments<T, S> &totals() const noexcept { return m_moments; }
+
+private:
+  struct sample {
+    Time time;
+    T value;
+  };
+  ring_buffer<sample> m_samples;
+  std::conditional_t<includes(S, stats::max), monotonic_queue<T, Time, max_op>, no_queue> m_max;
+  std::conditional_t<includes(S, stats::min), monotonic_queue<T, Time, min_op>, no_queue> m_min;
+  moments<T, S> m_moments;
+};
+
+} // namespace detail
+
+/// The values pushed at a time t with now - length < t <= now, where now is
+/// the latest time passed to push() or advance(). Time is an arithmetic type
+/// or a std::chrono::time_point. min() and max() need a non-empty window;
+/// the others are 0 for an empty one.
+template <typename T, typename Time = std::int64_t, stats S = stats::all> class time_window {
+public:
+  static_assert(std::is_arithmetic_v<T>, "time_window holds numbers");
+  using duration = decltype(std::declval<Time>() - std::declval<Time>());
+
+  /// Throws std::invalid_argument if length is not positive.
+  explicit time_window(duration length) : m_length(length) {
+    if (!(duration{} < length)) {
+      throw std::invalid_argument("time_window: the window length must be positive");
+    }
+  }
+
+  /// Throws std::invalid_argument if time is before the latest time seen.
+  void push(Time time, T value) {
+    advance(time);
+    m_state.add(time, value);
+  }
+
+  /// Moves the window to end at now, dropping the values that fall out of
+  /// it. Throws std::invalid_argument if now is before the latest time seen.
+  void advance(Time now) {
+    if (m_started && now < m_now) {
+      throw std::invalid_argument("time_window::advance: time went backwards");
+    }
+    m_now = now;
+    m_started = true;
+    // An unsigned now - length wraps around while now < length; nothing can
+    // have expired yet then.
+    if constexpr (std::is_unsigned_v<Time>) {
+      if (std::cmp_less(now, m_length)) {
+        return;
+      }
+    }
+    m_state.expireThrough(now - m_length);
+  }
+
+  void clear() noexcept {
+    m_state.clear();
+    m_started = false;
+  }
+
+  duration length() const noexcept { return m_length; }
+  std::size_t size() const noexcept { return m_state.size(); }
+  bool empty() const noexcept { return m_state.size() == 0; }
+
+  T max() const noexcept
+    requires(includes(S, stats::max))
+  {
+    return m_state.max();
+  }
+  T min() const noexcept
+    requires(includes(S, stats::min))
+  {
+    return m_state.min();
+  }
+  sum_type<T> sum() const noexcept
+    requires(includes(S, stats::sum))
+  {
+    return m_state.totals().sum();
+  }
+  double mean() const noexcept
+    requires(includes(S, stats::sum))
+  {
+    return m_state.totals().mean(size());
+  }
+  /// Population variance: the mean squared distance from the mean.
+  double variance() const noexcept
+    requires(includes(S, stats::variance))
+  {
+    return m_state.totals().variance(size());
+  }
+
+private:
+  detail::time_state<T, Time, S> m_state;
+  duration m_length;
+  Time m_now{};
+  bool m_started = false;
+};
+
+namespace detail {
+
+// out[i] = op(a[i], b[i]) in fixed chunks of 16, which GCC and Clang
+// vectorize at -O2 (the pointers do not alias).
+template <typename T, typename Op>
+void combine(const T *__restrict a, const T *__restrict b, T *__restrict out, std::size_t n,
+             Op op) {
+  constexpr std::size_t chunk = 16;
+  std::size_t i = 0;
+  for (; i + chunk <= n; i += chunk) {
+    for (std::size_t j = 0; j < chunk; ++j) {
+      out[i + j] = op(a[i + j], b[i + j]);
+    }
+  }
+  for (; i < n; ++i) {
+    out[i] = op(a[i], b[i]);
+  }
+}
+
+// out[i] = op over in[i, i + length), for every window, with op associative.
+template <typename Acc, typename T, typename Op>
+std::size_t slidingFold(const T *in, std::size_t n, std::size_t length, Acc *out,
+                        std::size_t out_size, Op op, const char *who) {
+  if (length == 0) {
+    throw std::invalid_argument(std::string(who) + ": the window length must be positive");
+  }
+  if (n < length) {
+    return 0;
+  }
+  const std::size_t windows = n - length + 1;
+  if (out_size < windows) {
+    throw std::invalid_argument(std::string(who) + ": the output holds fewer than n - length + 1 values");
+  }
+  const auto suffix = std::make_unique_for_overwrite<Acc[]>(length);
+  const auto prefix = std::make_unique_for_overwrite<Acc[]>(length);
+  // Windows starting in the block [start, start + length) end in the next.
+  for (std::size_t start = 0; start < windows; start += length) {
+    const T *block = in + start;
+    suffix[length - 1] = static_cast<Acc>(block[length - 1]);
+    for (std::size_t j = length - 1; j-- > 0;) {
+      suffix[j] = op(static_cast<Acc>(block[j]), suffix[j + 1]);
+    }
+    out[start] = suffix[0];
+    const std::size_t count = std::min(length, windows - start);
+    if (count > 1) {
+      const T *next = block + length;
+      prefix[0] = static_cast<Acc>(next[0]);
+      for (std::size_t j = 1; j + 1 < count; ++j) {
+        prefix[j] = op(prefix[j - 1], static_cast<Acc>(next[j]));
+      }
+      combine(suffix.get() + 1, prefix.get(), out + start + 1, count - 1, op);
+    }
+  }
+  return windows;
+}
+
+} // namespace detail
+
+/// out[i] = the largest of values[i, i + length), for i in [0, n - length].
+/// Returns the number of windows, n - length + 1, or 0 if n < length.
+/// Throws std::invalid_argument if length is 0 or out is too small.
+template <std::ranges::contiguous_range R, std::ranges::contiguous_range O>
+std::size_t slidingMax(const R &values, std::size_t length, O &&out) {
+  return detail::slidingFold(std::ranges::data(values), std::ranges::size(values), length,
+                             std::ranges::data(out), std::ranges::size(out), detail::max_op(),
+                             "slidingMax");
+}
+
+/// As slidingMax(), with the smallest value of each window.
+template <std::ranges::contiguous_range R, std::ranges::contiguous_range O>
+std::size_t slidingMin(const R &values, std::size_t length, O &&out) {
+  return detail::slidingFold(std::ranges::data(values), std::ranges::size(values), length,
+                             std::ranges::data(out), std::ranges::size(out), detail::min_op(),
+                             "slidingMin");
+}
+
+/// As slidingMax(), with the sum of each window. out holds sum_type of the
+/// values (or any type they convert to). Every sum is a suffix of one block
+/// plus a prefix of the next, not a running total, so floating-point
+/// errors do not build up along the stream.
+template <std::ranges::contiguous_range R, std::ranges::contiguous_range O>
+std::size_t slidingSum(const R &values, std::size_t length, O &&out) {
+  return detail::slidingFold(std::ranges::data(values), std::ranges::size(values), length,
+                             std::ranges::data(out), std::ranges::size(out), detail::plus_op(),
+                             "slidingSum");
+}
+
+} // namespace sliding_window
+
+#endif // SLIDING_WINDOW_HPP
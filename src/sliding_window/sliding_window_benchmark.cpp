@@ -0,0 +1,142 @@
+// maxSlidingWindow() from queue.cpp against sliding_window.hpp, on a stream of
+// 1e8 random 32-bit integers and windows of 16 and 4096 values:
+// - maxSlidingWindow(): a std::deque of indices into the whole vector
+// - count_window<int, stats::max>: one push and one max() per value
+// - count_window<int, stats::all>: max, min, mean and variance of every window
+// - time_window<int, std::int64_t, stats::max>: value i at time i, so the
+//   windows are the same; the monotonic queue of maxSlidingWindow() in a
+//   ring buffer
+// - slidingMax() and slidingSum(): the batch mode, all windows of the vector
+//
+// The stream and the results take about 1.2 GB; build with
+// -DSLIDING_WINDOW_BENCHMARK_ELEMENTS=10000000 for a smaller one.
+#include "sliding_window/sliding_window.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+#ifndef SLIDING_WINDOW_BENCHMARK_ELEMENTS
+#define SLIDING_WINDOW_BENCHMARK_ELEMENTS 100000000
+#endif
+
+namespace {
+
+// As in queue.cpp.
+std::vector<int> maxSlidingWindow(std::vector<int> &nums, int k) {
+  std::deque<int> dq;
+  std::vector<int> result;
+
+  for (int i = 0; i < static_cast<int>(nums.size()); i++) {
+    if (!dq.empty() && dq.front() == i - k) {
+      dq.pop_front();
+    }
+    while (!dq.empty() && nums[dq.back()] <= nums[i]) {
+      dq.pop_back();
+    }
+    dq.push_back(i);
+    if (i >= k - 1) {
+      result.push_back(nums[dq.front()]);
+    }
+  }
+  return result;
+}
+
+std::vector<int> &stream() {
+  static std::vector<int> values = [] {
+    std::mt19937 gen(42);
+    std::vector<int> v(SLIDING_WINDOW_BENCHMARK_ELEMENTS);
+    for (auto &x : v) {
+      x = static_cast<int>(gen());
+    }
+    return v;
+  }();
+  return values;
+}
+
+void BM_MaxSlidingWindowDeque(benchmark::State &state) {
+  auto &values = stream();
+  for (auto _ : state) {
+    auto result = maxSlidingWindow(values, static_cast<int>(state.range(0)));
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+void BM_CountWindowMax(benchmark::State &state) {
+  const auto &values = stream();
+  for (auto _ : state) {
+    sliding_window::count_window<int, sliding_window::stats::max> window(
+        static_cast<std::size_t>(state.range(0)));
+    std::int64_t checksum = 0;
+    for (int x : values) {
+      window.push(x);
+      checksum += window.max();
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+void BM_CountWindowAll(benchmark::State &state) {
+  const auto &values = stream();
+  for (auto _ : state) {
+    sliding_window::count_window<int> window(static_cast<std::size_t>(state.range(0)));
+    double checksum = 0;
+    for (int x : values) {
+      window.push(x);
+      checksum += window.max() - window.min() + window.mean() + window.variance();
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+void BM_TimeWindowMax(benchmark::State &state) {
+  const auto &values = stream();
+  for (auto _ : state) {
+    sliding_window::time_window<int, std::int64_t, sliding_window::stats::max> window(
+        state.range(0));
+    std::int64_t checksum = 0;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      window.push(static_cast<std::int64_t>(i), values[i]);
+      checksum += window.max();
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+void BM_SlidingMax(benchmark::State &state) {
+  const auto &values = stream();
+  std::vector<int> result(values.size());
+  for (auto _ : state) {
+    sliding_window::slidingMax(values, static_cast<std::size_t>(state.range(0)), result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+void BM_SlidingSum(benchmark::State &state) {
+  const auto &values = stream();
+  std::vector<std::int64_t> result(values.size());
+  for (auto _ : state) {
+    sliding_window::slidingSum(values, static_cast<std::size_t>(state.range(0)), result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_MaxSlidingWindowDeque)->Arg(16)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountWindowMax)->Arg(16)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountWindowAll)->Arg(16)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TimeWindowMax)->Arg(16)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SlidingMax)->Arg(16)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SlidingSum)->Arg(16)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
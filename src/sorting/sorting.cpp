@@ -0,0 +1,103 @@
+#include "sorting/sorting.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+template <typename T> void print(const std::vector<T> &v) {
+  for (const auto &x : v) {
+    std::cout << x << " ";
+  }
+  std::cout << "\n";
+}
+
+// The vectors from sort() in algorithms_library.cpp, through the new sorts.
+void smallInputs() {
+  std::cout << "-------- small inputs --------" << std::endl;
+  std::vector<int> vec1 = {0, 1, 3, 6, 9, 8, 7};
+  sorting::pdqSort(vec1);
+  print(vec1);
+
+  std::vector<int> number_set1 = {10, 20, 50, 30, 40};
+  sorting::pdqSort(number_set1, std::greater<>());
+  print(number_set1);
+
+  // Negative numbers and floats sort by value, not by bit pattern.
+  std::vector<double> readings = {2.5, -1.0, 0.0, -273.15, 1e-9, 100.0};
+  sorting::radixSort(readings);
+  print(readings);
+
+  std::vector<std::string_view> words = {"pear", "apple", "fig", "app", "banana", "applesauce"};
+  sorting::radixSort(words);
+  print(words);
+
+  // "b", "ab", "aab" ... with up to 5000 a's: a shared prefix as long as the
+  // longest string, one radix level per byte of it.
+  std::vector<std::string> prefixed;
+  for (std::size_t k = 5000; k-- > 0;) {
+    prefixed.push_back(std::string(k, 'a') + "b");
+  }
+  sorting::radixSort(prefixed);
+  std::cout << "5000 strings with a long shared prefix: "
+            << (std::is_sorted(prefixed.begin(), prefixed.end()) ? "sorted" : "NOT SORTED")
+            << std::endl;
+}
+
+template <typename F> double milliseconds(F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Ten million 64-bit integers in four orders, sorted by std::sort and by the
+// three sorts of sorting.hpp.
+void largeInputs() {
+  std::cout << "-------- 1e7 integers (ms) --------" << std::endl;
+  thread_pool pool;
+  std::cout << "order     std::sort   pdqSort  radixSort  parallelSort(" << pool.size()
+            << " threads)" << std::endl;
+
+  std::mt19937_64 gen(42);
+  std::vector<std::uint64_t> random(10'000'000);
+  for (auto &x : random) {
+    x = gen();
+  }
+  std::vector<std::uint64_t> sorted = random;
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::uint64_t> reverse(sorted.rbegin(), sorted.rend());
+  std::vector<std::uint64_t> few_unique = random;
+  for (auto &x : few_unique) {
+    x %= 16;
+  }
+
+  const std::pair<const char *, const std::vector<std::uint64_t> *> inputs[] = {
+      {"random", &random}, {"sorted", &sorted}, {"reverse", &reverse}, {"few", &few_unique}};
+  for (const auto &[name, input] : inputs) {
+    std::vector<std::uint64_t> expected = *input;
+    std::vector<std::uint64_t> v = *input;
+    const double std_ms = milliseconds([&] { std::sort(expected.begin(), expected.end()); });
+    const double pdq_ms = milliseconds([&] { sorting::pdqSort(v); });
+    bool ok = v == expected;
+    v = *input;
+    const double radix_ms = milliseconds([&] { sorting::radixSort(v); });
+    ok = ok && v == expected;
+    v = *input;
+    const double parallel_ms = milliseconds([&] { sorting::parallelSort(v, pool); });
+    ok = ok && v == expected;
+    std::printf("%-8s %10.1f %9.1f %10.1f %13.1f %s\n", name, std_ms, pdq_ms, radix_ms,
+                parallel_ms, ok ? "" : "MISMATCH");
+  }
+}
+
+int main() {
+  smallInputs();
+  largeInputs();
+}
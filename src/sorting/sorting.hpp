@@ -0,0 +1,582 @@
+#ifndef SORTING_HPP
+#define SORTING_HPP
+
+#include "multithreading/thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// Sorting beyond std::sort, for large arrays.
+///
+/// - pdqSort(): pattern-defeating quicksort (Orson Peters), in place and not
+///   stable. It is introsort with three additions: it detects runs that are
+///   already sorted, it puts elements equal to the pivot into a partition of
+///   their own so that inputs with few distinct values sort in linear time,
+///   and it shuffles a few elements when it sees a bad partition. That makes
+///   sorted, reverse-sorted and few-unique inputs cheap and adversarial
+///   inputs no worse than O(n log n).
+/// - radixSort(): sorts without comparisons. Integers, floats and doubles use
+///   LSD radix sort: one pass per byte of the key into a buffer the size of
+///   the input, skipping bytes that are the same in every key. Strings (any
+///   range of things that convert to std::string_view) use in-place MSD radix
+///   sort (American flag sort) by byte, switching to pdqSort for small
+///   buckets.
+/// - parallelSort(): sample sort on a thread_pool. A sample of the input picks
+///   splitters that cut it into buckets of similar size. The workers count
+///   and move the elements into their buckets, block by block, and then sort
+///   the buckets independently with pdqSort. Elements equal to a splitter go
+///   to a bucket of their own that needs no sorting, so inputs with few
+///   distinct values do not end up in one huge bucket.
+///
+
+namespace sorting {
+
+namespace detail {
+
+constexpr std::ptrdiff_t insertion_sort_threshold = 24;
+constexpr std::ptrdiff_t ninther_threshold = 128;
+constexpr std::size_t partial_insertion_limit = 8;
+
+template <typename It, typename Comp> void insertionSort(It first, It last, Comp &comp) {
+  if (first == last) {
+    return;
+  }
+  for (It cur = first + 1; cur != last; ++cur) {
+    It sift = cur;
+    It sift_1 = cur - 1;
+    if (comp(*sift, *sift_1)) {
+      auto tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (sift != first && comp(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+// Like insertionSort, but *(first - 1) must exist and be no greater than any
+// element of the range, so the inner loop needs no bounds check.
+template <typename It, typename Comp> void unguardedInsertionSort(It first, It last, Comp &comp) {
+  if (first == last) {
+    return;
+  }
+  for (It cur = first + 1; cur != last; ++cur) {
+    It sift = cur;
+    It sift_1 = cur - 1;
+    if (comp(*sift, *sift_1)) {
+      auto tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (comp(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+// Insertion sort that gives up once it has moved more than a few elements.
+// Returns whether the range is sorted.
+template <typename It, typename Comp> bool partialInsertionSort(It first, It last, Comp &comp) {
+  if (first == last) {
+    return true;
+  }
+  std::size_t moved = 0;
+  for (It cur = first + 1; cur != last; ++cur) {
+    It sift = cur;
+    It sift_1 = cur - 1;
+    if (comp(*sift, *sift_1)) {
+      auto tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (sift != first && comp(tmp, *--sift_1));
+      *sift = std::move(tmp);
+      moved += static_cast<std::size_t>(cur - sift);
+    }
+    if (moved > partial_insertion_limit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename It, typename Comp> void sort2(It a, It b, Comp &comp) {
+  if (comp(*b, *a)) {
+    std::iter_swap(a, b);
+  }
+}
+
+template <typename It, typename Comp> void sort3(It a, It b, It c, Comp &comp) {
+  sort2(a, b, comp);
+  sort2(b, c, comp);
+  sort2(a, b, comp);
+}
+
+// The pivot stays at *first during partitioning. Small trivially copyable
+// values are copied into a register instead of re-read through the iterator.
+template <typename It> decltype(auto) pivotValue(It first) {
+  using T = std::iter_value_t<It>;
+  if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= 16) {
+    return T(*first);
+  } else {
+    return (*first);
+  }
+}
+
+// Partitions [first, last) around the pivot *first: smaller elements to the
+// left, the rest to the right. Returns the pivot's final position and whether
+// the range was already partitioned (no swaps were needed).
+template <typename It, typename Comp>
+std::pair<It, bool> partitionRight(It first, It last, Comp &comp) {
+  const auto &pivot = pivotValue(first);
+  It begin = first;
+  It end = last;
+  // The median-of-3 put an element >= pivot at the end, so this stops.
+  while (comp(*++begin, pivot)) {
+  }
+  if (begin - 1 == first) {
+    while (begin < end && !comp(*--end, pivot)) {
+    }
+  } else {
+    // *(first + 1) < pivot stops this one.
+    while (!comp(*--end, pivot)) {
+    }
+  }
+  const bool already_partitioned = begin >= end;
+  while (begin < end) {
+    std::iter_swap(begin, end);
+    while (comp(*++begin, pivot)) {
+    }
+    while (!comp(*--end, pivot)) {
+    }
+  }
+  const It pivot_pos = begin - 1;
+  std::iter_swap(first, pivot_pos);
+  return {pivot_pos, already_partitioned};
+}
+
+// Partitions with the elements equal to the pivot on the left. Used when the
+// pivot equals the element before the range, which is no greater than any
+// element in it: then the left part holds only copies of the pivot and is done.
+template <typename It, typename Comp> It partitionLeft(It first, It last, Comp &comp) {
+  const auto &pivot = pivotValue(first);
+  It begin = first;
+  It end = last;
+  while (comp(pivot, *--end)) {
+  }
+  if (end + 1 == last) {
+    while (begin < end && !comp(pivot, *++begin)) {
+    }
+  } else {
+    while (!comp(pivot, *++begin)) {
+    }
+  }
+  while (begin < end) {
+    std::iter_swap(begin, end);
+    while (comp(pivot, *--end)) {
+    }
+    while (!comp(pivot, *++begin)) {
+    }
+  }
+  std::iter_swap(first, end);
+  return end;
+}
+
+template <typename It, typename Comp>
+void pdqLoop(It begin, It end, Comp &comp, int bad_allowed, bool leftmost) {
+  using diff_t = std::iter_difference_t<It>;
+  for (;;) {
+    const diff_t size = end - begin;
+    if (size < insertion_sort_threshold) {
+      if (leftmost) {
+        insertionSort(begin, end, comp);
+      } else {
+        unguardedInsertionSort(begin, end, comp);
+      }
+      return;
+    }
+
+    // Median of 3, or for large ranges the median of 3 medians of 3 (Tukey's
+    // ninther). The pivot ends up at *begin.
+    const diff_t half = size / 2;
+    if (size > ninther_threshold) {
+      sort3(begin, begin + half, end - 1, comp);
+      sort3(begin + 1, begin + (half - 1), end - 2, comp);
+      sort3(begin + 2, begin + (half + 1), end - 3, comp);
+      sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+      std::iter_swap(begin, begin + half);
+    } else {
+      sort3(begin + half, begin, end - 1, comp);
+    }
+
+    // *(begin - 1) is the pivot of an earlier partition and no greater than
+    // anything here. If it equals the new pivot, the range has many copies of
+    // that value: put them all on the left and skip them.
+    if (!leftmost && !comp(*(begin - 1), *begin)) {
+      begin = partitionLeft(begin, end, comp) + 1;
+      continue;
+    }
+
+    const auto [pivot_pos, already_partitioned] = partitionRight(begin, end, comp);
+    const diff_t left_size = pivot_pos - begin;
+    const diff_t right_size = end - (pivot_pos + 1);
+
+    if (left_size < size / 8 || right_size < size / 8) {
+      // A bad split. After too many, fall back to heapsort for O(n log n).
+      if (--bad_allowed == 0) {
+        std::make_heap(begin, end, comp);
+        std::sort_heap(begin, end, comp);
+        return;
+      }
+      // Otherwise move some elements around to break the pattern that caused
+      // it, so the next pivots are chosen from different values.
+      if (left_size >= insertion_sort_threshold) {
+        std::iter_swap(begin, begin + left_size / 4);
+        std::iter_swap(pivot_pos - 1, pivot_pos - left_size / 4);
+        if (left_size > ninther_threshold) {
+          std::iter_swap(begin + 1, begin + (left_size / 4 + 1));
+          std::iter_swap(begin + 2, begin + (left_size / 4 + 2));
+          std::iter_swap(pivot_pos - 2, pivot_pos - (left_size / 4 + 1));
+          std::iter_swap(pivot_pos - 3, pivot_pos - (left_size / 4 + 2));
+        }
+      }
+      if (right_size >= insertion_sort_threshold) {
+        std::iter_swap(pivot_pos + 1, pivot_pos + (1 + right_size / 4));
+        std::iter_swap(end - 1, end - right_size / 4);
+        if (right_size > ninther_threshold) {
+          std::iter_swap(pivot_pos + 2, pivot_pos + (2 + right_size / 4));
+          std::iter_swap(pivot_pos + 3, pivot_pos + (3 + right_size / 4));
+          std::iter_swap(end - 2, end - (1 + right_size / 4));
+          std::iter_swap(end - 3, end - (2 + right_size / 4));
+        }
+      }
+    } else if (already_partitioned && partialInsertionSort(begin, pivot_pos, comp) &&
+               partialInsertionSort(pivot_pos + 1, end, comp)) {
+      // Nothing moved and both halves were (nearly) sorted: the input is
+      // probably sorted already.
+      return;
+    }
+
+    pdqLoop(begin, pivot_pos, comp, bad_allowed, leftmost);
+    begin = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+template <typename T>
+concept radix_number = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                       std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename T>
+concept string_key = std::is_convertible_v<const T &, std::string_view>;
+
+// An unsigned integer that orders the same way as the value: the sign bit of
+// signed integers is flipped, and negative floats have all bits flipped so
+// that larger magnitudes sort first. -0.0 sorts before +0.0, and NaNs go to
+// the ends (by sign bit).
+template <radix_number T> auto radixKey(T value) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    using U = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    constexpr U sign = U{1} << (sizeof(U) * 8 - 1);
+    const U bits = std::bit_cast<U>(value);
+    return static_cast<U>((bits & sign) != 0 ? ~bits : bits | sign);
+  } else {
+    using U = std::make_unsigned_t<T>;
+    if constexpr (std::is_signed_v<T>) {
+      return static_cast<U>(static_cast<U>(value) ^ (U{1} << (sizeof(U) * 8 - 1)));
+    } else {
+      return static_cast<U>(value);
+    }
+  }
+}
+
+// Below this size a comparison sort beats the fixed cost of the radix passes
+// (eight histograms and up to eight passes for 64-bit keys).
+constexpr std::size_t radix_sort_cutoff = 1024;
+
+template <typename T> void lsdRadixSort(T *data, std::size_t size) {
+  using key_t = decltype(radixKey(T{}));
+  constexpr std::size_t passes = sizeof(key_t);
+  if (size < radix_sort_cutoff) {
+    std::less<> comp;
+    pdqLoop(data, data + size, comp, static_cast<int>(std::bit_width(size)), true);
+    return;
+  }
+
+  // All histograms in one read of the input.
+  std::vector<std::array<std::size_t, 256>> counts(passes);
+  for (std::size_t i = 0; i < size; ++i) {
+    const key_t key = radixKey(data[i]);
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+      ++counts[pass][(key >> (pass * 8)) & 0xFF];
+    }
+  }
+
+  const auto buffer = std::make_unique_for_overwrite<T[]>(size);
+  T *from = data;
+  T *to = buffer.get();
+  for (std::size_t pass = 0; pass < passes; ++pass) {
+    const std::size_t shift = pass * 8;
+    // Every key has the same byte here: the pass would not move anything.
+    if (counts[pass][(radixKey(from[0]) >> shift) & 0xFF] == size) {
+      continue;
+    }
+    // A local copy: the compiler can tell that the stores into `to` do not
+    // change it, and keeps the offsets out of the store-to-load dependency
+    // chain.
+    std::array<std::size_t, 256> next;
+    std::size_t offset = 0;
+    for (std::size_t b = 0; b < 256; ++b) {
+      next[b] = offset;
+      offset += counts[pass][b];
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      const T value = from[i];
+      to[next[(radixKey(value) >> shift) & 0xFF]++] = value;
+    }
+    std::swap(from, to);
+  }
+  if (from != data) {
+    std::copy(from, from + size, data);
+  }
+}
+
+// Compares the parts of two strings from `depth` on; the first `depth` bytes
+// are known to be equal.
+struct suffix_less {
+  std::size_t depth;
+  template <typename A, typename B> bool operator()(const A &a, const B &b) const {
+    return std::string_view(a).substr(depth) < std::string_view(b).substr(depth);
+  }
+};
+
+constexpr std::size_t msd_radix_cutoff = 64;
+
+// Bucket 0 holds strings that end before `depth`, bucket c + 1 those whose
+// byte at `depth` is c.
+template <typename T> std::size_t msdBucket(const T &value, std::size_t depth) {
+  const std::string_view s(value);
+  return depth < s.size() ? static_cast<unsigned char>(s[depth]) + std::size_t{1} : 0;
+}
+
+// Not recursive: the ranges still to sort wait on a heap-allocated work list,
+// and the bucket tables are allocated once and reused. Recursing once per byte
+// would put three 257-entry tables on the call stack per level, and strings
+// that share a long prefix but differ in length (as "ab", "aab", "aaab" ...)
+// need one level per byte of it.
+template <typename It> void msdRadixSort(It first, It last, std::size_t depth) {
+  constexpr std::size_t buckets = 257;
+  struct range {
+    It first;
+    It last;
+    std::size_t depth;
+  };
+  struct tables {
+    std::array<std::size_t, buckets> count;
+    std::array<std::size_t, buckets> next;
+    std::array<std::size_t, buckets> end;
+  };
+  std::unique_ptr<tables> t;
+  std::vector<range> pending{{first, last, depth}};
+  while (!pending.empty()) {
+    auto [begin, end, d] = pending.back();
+    pending.pop_back();
+    for (;;) {
+      const auto size = static_cast<std::size_t>(end - begin);
+      if (size < msd_radix_cutoff) {
+        suffix_less comp{d};
+        pdqLoop(begin, end, comp, static_cast<int>(std::bit_width(size)), true);
+        break;
+      }
+      if (!t) {
+        t = std::make_unique<tables>();
+      }
+      auto &count = t->count;
+      count.fill(0);
+      for (It it = begin; it != end; ++it) {
+        ++count[msdBucket(*it, d)];
+      }
+      // A common prefix: every string has the same byte here. Move on to the
+      // next byte of the same range.
+      if (count[msdBucket(*begin, d)] == size) {
+        if (msdBucket(*begin, d) == 0) {
+          break; // all equal
+        }
+        ++d;
+        continue;
+      }
+
+      // American flag sort: swap every element straight into its bucket.
+      auto &next = t->next;
+      auto &bucket_end = t->end;
+      std::size_t offset = 0;
+      for (std::size_t b = 0; b < buckets; ++b) {
+        next[b] = offset;
+        offset += count[b];
+        bucket_end[b] = offset;
+      }
+      for (std::size_t b = 0; b < buckets; ++b) {
+        while (next[b] < bucket_end[b]) {
+          const std::size_t target = msdBucket(begin[next[b]], d);
+          if (target == b) {
+            ++next[b];
+          } else {
+            std::iter_swap(begin + next[b], begin + next[target]++);
+          }
+        }
+      }
+
+      // Bucket 0 is already sorted: its strings are equal.
+      for (std::size_t b = 1; b < buckets; ++b) {
+        if (count[b] > 1) {
+          pending.push_back({begin + (bucket_end[b] - count[b]), begin + bucket_end[b], d + 1});
+        }
+      }
+      break;
+    }
+  }
+}
+
+// Below this size parallelSort() sorts on the calling thread.
+constexpr std::size_t parallel_sort_cutoff = std::size_t{1} << 16;
+constexpr std::size_t oversampling = 16;
+
+} // namespace detail
+
+/// Sorts [first, last) in place with pattern-defeating quicksort. Not stable.
+template <std::random_access_iterator It, typename Comp = std::less<>>
+void pdqSort(It first, It last, Comp comp = {}) {
+  const auto size = static_cast<std::size_t>(last - first);
+  if (size < 2) {
+    return;
+  }
+  detail::pdqLoop(first, last, comp, static_cast<int>(std::bit_width(size)), true);
+}
+
+template <std::ranges::random_access_range R, typename Comp = std::less<>>
+void pdqSort(R &&range, Comp comp = {}) {
+  pdqSort(std::ranges::begin(range), std::ranges::end(range), std::move(comp));
+}
+
+/// Sorts integers, floats or doubles in ascending order with LSD radix sort.
+/// Needs a temporary buffer as large as the input.
+template <std::ranges::contiguous_range R>
+  requires detail::radix_number<std::ranges::range_value_t<R>>
+void radixSort(R &&range) {
+  detail::lsdRadixSort(std::ranges::data(range), std::ranges::size(range));
+}
+
+/// Sorts strings (std::string, std::string_view, const char * ...) in
+/// byte-wise ascending order with in-place MSD radix sort.
+template <std::ranges::random_access_range R>
+  requires detail::string_key<std::ranges::range_value_t<R>>
+void radixSort(R &&range) {
+  detail::msdRadixSort(std::ranges::begin(range), std::ranges::end(range), 0);
+}
+
+/// Sorts [first, last) with a parallel sample sort on `pool`. Not stable.
+/// The elements must be default constructible: they are moved through a
+/// buffer of the same size as the input. `comp` is called from several
+/// threads at once.
+template <std::random_access_iterator It, typename Comp = std::less<>>
+void parallelSort(It first, It last, thread_pool &pool, Comp comp = {}) {
+  using T = std::iter_value_t<It>;
+  const auto size = static_cast<std::size_t>(last - first);
+  if (pool.size() < 2 || size < detail::parallel_sort_cutoff) {
+    pdqSort(first, last, comp);
+    return;
+  }
+
+  // About 4 ranges per worker. Each range between two splitters is a bucket,
+  // and so is each splitter itself (the elements equal to it).
+  const std::size_t ranges = std::min<std::size_t>(std::bit_ceil(pool.size() * 4), 1024);
+  std::vector<T> splitters;
+  {
+    std::vector<T> sample;
+    sample.reserve(ranges * detail::oversampling);
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (std::size_t i = 0; i < ranges * detail::oversampling; ++i) {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      sample.push_back(first[static_cast<std::size_t>((state >> 33) % size)]);
+    }
+    pdqSort(sample.begin(), sample.end(), comp);
+    for (std::size_t i = 1; i < ranges; ++i) {
+      splitters.push_back(sample[i * detail::oversampling]);
+    }
+    splitters.erase(std::unique(splitters.begin(), splitters.end(),
+                                [&](const T &a, const T &b) { return !comp(a, b); }),
+                    splitters.end());
+  }
+  const std::size_t buckets = 2 * splitters.size() + 1;
+  auto bucketOf = [&](const T &value) -> std::uint16_t {
+    const auto j = static_cast<std::size_t>(
+        std::upper_bound(splitters.begin(), splitters.end(), value, comp) - splitters.begin());
+    // value >= splitters[j - 1] and not less, so equal.
+    return static_cast<std::uint16_t>(j > 0 && !comp(splitters[j - 1], value) ? 2 * j - 1 : 2 * j);
+  };
+
+  // Classify block by block, counting per block, so that the scatter below
+  // can write without synchronization.
+  const std::size_t blocks = pool.size() * 4;
+  const std::size_t block_size = (size + blocks - 1) / blocks;
+  std::vector<std::uint16_t> bucket_of(size);
+  std::vector<std::size_t> counts(blocks * buckets);
+  pool.parallel_for(std::size_t{0}, blocks, [&](std::size_t block) {
+    std::size_t *count = &counts[block * buckets];
+    const std::size_t end = std::min(size, (block + 1) * block_size);
+    for (std::size_t i = block * block_size; i < end; ++i) {
+      bucket_of[i] = bucketOf(first[i]);
+      ++count[bucket_of[i]];
+    }
+  }, std::size_t{1});
+
+  // Bucket by bucket, then block by block within a bucket: the position
+  // where each block writes its first element of each bucket.
+  std::vector<std::size_t> bucket_begin(buckets + 1);
+  std::size_t offset = 0;
+  for (std::size_t b = 0; b < buckets; ++b) {
+    bucket_begin[b] = offset;
+    for (std::size_t block = 0; block < blocks; ++block) {
+      offset += std::exchange(counts[block * buckets + b], offset);
+    }
+  }
+  bucket_begin[buckets] = size;
+
+  const auto buffer = std::make_unique_for_overwrite<T[]>(size);
+  pool.parallel_for(std::size_t{0}, blocks, [&](std::size_t block) {
+    std::size_t *next = &counts[block * buckets];
+    const std::size_t end = std::min(size, (block + 1) * block_size);
+    for (std::size_t i = block * block_size; i < end; ++i) {
+      buffer[next[bucket_of[i]]++] = std::move(first[i]);
+    }
+  }, std::size_t{1});
+
+  // Odd buckets hold copies of one splitter and are sorted already.
+  pool.parallel_for(std::size_t{0}, buckets, [&](std::size_t b) {
+    T *begin = buffer.get() + bucket_begin[b];
+    T *end = buffer.get() + bucket_begin[b + 1];
+    if (b % 2 == 0) {
+      pdqSort(begin, end, comp);
+    }
+    std::move(begin, end, first + bucket_begin[b]);
+  }, std::size_t{1});
+}
+
+template <std::ranges::random_access_range R, typename Comp = std::less<>>
+void parallelSort(R &&range, thread_pool &pool, Comp comp = {}) {
+  parallelSort(std::ranges::begin(range), std::ranges::end(range), pool, std::move(comp));
+}
+
+} // namespace sorting
+
+#endif
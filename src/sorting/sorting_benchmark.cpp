@@ -0,0 +1,151 @@
+// sorting.hpp against std::sort on 64-bit integers, 1e3 to 1e7 elements, for
+// four input orders: random, sorted, reverse-sorted and few unique values
+// (16 distinct keys):
+// - std::sort, and std::sort(std::execution::par_unseq) where the standard
+//   library has parallel algorithms (libstdc++ needs TBB for them to run in
+//   parallel)
+// - sorting::pdqSort, sorting::radixSort and sorting::parallelSort
+// - for doubles and strings, std::sort against radixSort at 1e6 elements
+//
+// 1e9 integers need about 24 GiB (input, working copy and radix buffer);
+// build with -DSORTING_BENCHMARK_MAX_ELEMENTS=1000000000 on a machine that has
+// it.
+#include "sorting/sorting.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_parallel_algorithm)
+#include <execution>
+#endif
+
+#ifndef SORTING_BENCHMARK_MAX_ELEMENTS
+#define SORTING_BENCHMARK_MAX_ELEMENTS 10000000
+#endif
+
+namespace {
+
+enum input_order { random_order, sorted_order, reverse_order, few_unique };
+
+std::vector<std::uint64_t> makeInput(std::size_t n, input_order order) {
+  std::mt19937_64 gen(42);
+  std::vector<std::uint64_t> v(n);
+  for (auto &x : v) {
+    x = order == few_unique ? gen() % 16 : gen();
+  }
+  if (order == sorted_order) {
+    std::sort(v.begin(), v.end());
+  } else if (order == reverse_order) {
+    std::sort(v.rbegin(), v.rend());
+  }
+  return v;
+}
+
+thread_pool &pool() {
+  static thread_pool instance;
+  return instance;
+}
+
+struct std_sort {
+  template <typename V> void operator()(V &v) const { std::sort(v.begin(), v.end()); }
+};
+
+#if defined(__cpp_lib_parallel_algorithm)
+struct std_sort_par_unseq {
+  template <typename V> void operator()(V &v) const {
+    std::sort(std::execution::par_unseq, v.begin(), v.end());
+  }
+};
+#endif
+
+struct pdq_sort {
+  template <typename V> void operator()(V &v) const { sorting::pdqSort(v); }
+};
+
+struct radix_sort {
+  template <typename V> void operator()(V &v) const { sorting::radixSort(v); }
+};
+
+struct parallel_sort {
+  template <typename V> void operator()(V &v) const { sorting::parallelSort(v, pool()); }
+};
+
+// Sorts a fresh copy of the input each iteration; the copy is not timed.
+template <typename Sort, typename V> void sortCopies(benchmark::State &state, const V &input) {
+  V data;
+  for (auto _ : state) {
+    state.PauseTiming();
+    data = input;
+    state.ResumeTiming();
+    Sort()(data);
+    benchmark::DoNotOptimize(data.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+
+template <typename Sort> void BM_Sort(benchmark::State &state) {
+  const auto input = makeInput(static_cast<std::size_t>(state.range(0)),
+                               static_cast<input_order>(state.range(1)));
+  sortCopies<Sort>(state, input);
+}
+
+template <typename Sort> void BM_SortDoubles(benchmark::State &state) {
+  std::mt19937_64 gen(42);
+  std::normal_distribution<double> normal(0.0, 1e6);
+  std::vector<double> input(static_cast<std::size_t>(state.range(0)));
+  for (auto &x : input) {
+    x = normal(gen);
+  }
+  sortCopies<Sort>(state, input);
+}
+
+// Words of 4 to 16 lowercase letters.
+template <typename Sort> void BM_SortStrings(benchmark::State &state) {
+  std::mt19937_64 gen(42);
+  std::vector<std::string> input(static_cast<std::size_t>(state.range(0)));
+  for (auto &s : input) {
+    const std::size_t length = 4 + gen() % 13;
+    for (std::size_t i = 0; i < length; ++i) {
+      s.push_back(static_cast<char>('a' + gen() % 26));
+    }
+  }
+  sortCopies<Sort>(state, input);
+}
+
+void sizesAndOrders(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"n", "order"});
+  for (std::int64_t n = 1000; n <= SORTING_BENCHMARK_MAX_ELEMENTS; n *= 10) {
+    for (int order : {random_order, sorted_order, reverse_order, few_unique}) {
+      b->Args({n, order});
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Sort, std_sort)->Apply(sizesAndOrders)->Unit(benchmark::kMicrosecond);
+#if defined(__cpp_lib_parallel_algorithm)
+BENCHMARK_TEMPLATE(BM_Sort, std_sort_par_unseq)
+    ->Apply(sizesAndOrders)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+#endif
+BENCHMARK_TEMPLATE(BM_Sort, pdq_sort)->Apply(sizesAndOrders)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Sort, radix_sort)->Apply(sizesAndOrders)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Sort, parallel_sort)
+    ->Apply(sizesAndOrders)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SortDoubles, std_sort)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortDoubles, radix_sort)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortStrings, std_sort)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortStrings, pdq_sort)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortStrings, radix_sort)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -239,6 +239,8 @@ void formatingStream() {
   std::cout << std::cout.flags() << std::endl; // 3.1
 }
 
+// strings/numbers.hpp parses a buffer of numbers without a stream:
+// parseNumbers().
 void stringstreamExample() {
   std::stringstream ss;
   std::string name = "behnam";
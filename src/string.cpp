@@ -79,6 +79,7 @@ void stringDataTypes() {
   std::string name5 = "Behnam"s + "Asadi"s;
 }
 
+// strings/strings.hpp splits into string_views instead, without copies.
 void spitingByDelimiter() {
   std::vector<std::string> spilitedString;
   std::string s = "scott>=tiger>=mushroom";
@@ -98,6 +99,8 @@ void spitingByDelimiter() {
 }
 
 // string to number and number to string
+// strings/numbers.hpp converts without locales or allocations, and prints 10.3
+// as "10.3".
 void stringNumberConversion() {
   std::string strNumber = std::to_string(10.3);
   float f = std::atof(strNumber.c_str());  // 10.3
@@ -279,6 +282,7 @@ void shortStringOptimization() {
 }
 
 /// Try to find in the word the sentence - case insensitive
+/// (strings::findCaseInsensitive() in strings/strings.hpp is the SIMD version)
 bool findStringCaseInsensitive(const std::string &sentence,
                                const std::string &word) {
   auto it = std::search(sentence.begin(), sentence.end(), word.begin(),
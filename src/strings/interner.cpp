@@ -0,0 +1,78 @@
+#include "strings/interner.hpp"
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// hash.cpp's student with interned names: 12 bytes instead of 72, and ==
+// compares three integers.
+struct student {
+  int id;
+  strings::symbol first_name;
+  strings::symbol last_name;
+
+  bool operator==(const student &) const = default;
+};
+
+void internedStudents() {
+  std::cout << "-------- interned student names --------" << std::endl;
+  strings::string_interner names;
+  const std::vector<student> students = {
+      {1, names.intern("Behnam"), names.intern("Asadi")},
+      {2, names.intern("Mary"), names.intern("Smith")},
+      {3, names.intern("Behnam"), names.intern("Smith")},
+  };
+  for (const student &s : students) {
+    std::cout << s.id << ": " << names.view(s.first_name) << " " << names.view(s.last_name)
+              << " (symbols " << static_cast<std::uint32_t>(s.first_name) << ", "
+              << static_cast<std::uint32_t>(s.last_name) << ")" << std::endl;
+  }
+  std::cout << "sizeof(student): " << sizeof(student) << ", distinct names: " << names.size()
+            << std::endl;
+  std::cout << std::boolalpha << "students[0].first_name == students[2].first_name: "
+            << (students[0].first_name == students[2].first_name) << std::endl;
+  // find() does not add the name.
+  std::cout << "find(\"John\"): " << (names.find("John") ? "found" : "not interned") << std::endl;
+  // The text is null-terminated for C APIs.
+  std::cout << "c_str: " << names.c_str(students[1].last_name) << std::endl;
+}
+
+// The keys of json_example.cpp's objects, interned by several threads at
+// once: every thread gets the same symbol for the same key.
+void concurrentJsonKeys() {
+  std::cout << "-------- concurrent interning of JSON keys --------" << std::endl;
+  const std::vector<std::string_view> keys = {"name", "age", "isStudent", "courses", "address",
+                                              "city", "zip"};
+  strings::concurrent_string_interner interner;
+  std::vector<std::vector<strings::symbol>> symbols(4);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < symbols.size(); ++t) {
+    threads.emplace_back([&, t] {
+      for (int object = 0; object < 1000; ++object) {
+        for (std::size_t k = 0; k < keys.size(); ++k) {
+          // Each thread walks the keys in its own order.
+          symbols[t].push_back(interner.intern(keys[(k + t) % keys.size()]));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::cout << "interned " << symbols.size() * symbols[0].size() << " keys, "
+            << interner.size() << " distinct:";
+  for (const std::string_view key : keys) {
+    std::cout << " " << key << "=" << static_cast<std::uint32_t>(*interner.find(key));
+  }
+  std::cout << std::endl;
+  const strings::interner_memory memory = interner.memory();
+  std::cout << "text: " << memory.strings << " bytes, index: " << memory.index
+            << " bytes, directory: " << memory.directory << " bytes" << std::endl;
+}
+
+int main() {
+  internedStudents();
+  concurrentJsonKeys();
+}
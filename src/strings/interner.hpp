@@ -0,0 +1,417 @@
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include "allocators.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "hashing.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+///
+/// String interning: each distinct string is stored once and named by a
+/// 32-bit symbol.
+///
+/// The data examples repeat a few short strings across many objects: the
+/// first and last names of hash.cpp's students, the item names of the REST
+/// service, the keys of every JSON object. Interned, each of those fields
+/// is a 4-byte symbol instead of a 32-byte std::string (plus a heap block
+/// when the text is longer than 15 chars), and comparing two of them
+/// compares two integers.
+///
+/// - string_interner: intern(text) returns the symbol of `text`, adding it
+///   on first sight. view(symbol) returns the text. The text is copied into
+///   an arena (mem::arena_resource), null-terminated, and never moves, so
+///   the string_views stay valid for the interner's lifetime. The index is a
+///   containers::flat_hash_map of bare symbols, 8 bytes a slot, that finds
+///   their text through the symbol -> text directory. Not thread-safe.
+/// - concurrent_string_interner: the same, for any number of threads. The
+///   strings are spread over 64 shards by hash. Each shard's index is an
+///   insert-only open-addressing table of atomic (hash, id) slots, so
+///   lookups of known strings take no lock at all; only adding a string
+///   locks its shard. The low 6 bits of a symbol name its shard. view()
+///   takes no lock either.
+///
+/// Symbols are dense per interner (per shard for the concurrent one), so a
+/// symbol can index a std::vector of per-string data directly. Symbols from
+/// different interners must not be mixed.
+///
+
+namespace strings {
+
+/// The name of an interned string. Compare with ==, hash with std::hash or
+/// hashing::hash.
+enum class symbol : std::uint32_t {};
+
+/// What an interner holds, in bytes.
+struct interner_memory {
+  std::size_t strings = 0;   // the text, with a '\0' after each string
+  std::size_t index = 0;     // the hash table from text to symbol
+  std::size_t directory = 0; // the table from symbol to text
+  std::size_t total() const { return strings + index + directory; }
+};
+
+namespace detail {
+
+// Symbol -> text. Segment k holds 64 << k views and is never moved or
+// freed before the directory, so a thread may read an entry while another
+// appends: only the append needs a lock.
+class symbol_directory {
+public:
+  symbol_directory() = default;
+  symbol_directory(const symbol_directory &) = delete;
+  symbol_directory &operator=(const symbol_directory &) = delete;
+
+  std::size_t size() const noexcept { return m_size; }
+
+  std::string_view operator[](std::size_t index) const noexcept {
+    const std::size_t position = index + first_segment;
+    const int segment = std::bit_width(position) - 1 - first_segment_bits;
+    return m_segments[static_cast<std::size_t>(segment)]
+                     [position - (first_segment << segment)];
+  }
+
+  void push_back(std::string_view text) {
+    const std::size_t position = m_size + first_segment;
+    const int segment = std::bit_width(position) - 1 - first_segment_bits;
+    auto &entries = m_segments[static_cast<std::size_t>(segment)];
+    if (!entries) {
+      entries = std::make_unique<std::string_view[]>(first_segment << segment);
+    }
+    entries[position - (first_segment << segment)] = text;
+    ++m_size;
+  }
+
+  std::size_t bytes() const noexcept {
+    std::size_t total = sizeof(m_segments);
+    for (std::size_t k = 0; k < m_segments.size() && m_segments[k]; ++k) {
+      total += (first_segment << k) * sizeof(std::string_view);
+    }
+    return total;
+  }
+
+private:
+  static constexpr int first_segment_bits = 6;
+  static constexpr std::size_t first_segment = std::size_t{1} << first_segment_bits;
+  // 64 * (2^27 - 1) entries: more than 2^32.
+  std::array<std::unique_ptr<std::string_view[]>, 27> m_segments;
+  std::size_t m_size = 0;
+};
+
+// The arena that holds the text and the directory that finds it.
+class string_store {
+public:
+  std::string_view operator[](std::size_t index) const noexcept { return m_directory[index]; }
+  std::size_t size() const noexcept { return m_directory.size(); }
+
+  // Copies `text`, with a '\0' after it, and gives it the next index.
+  void push_back(std::string_view text) {
+    auto *copy = static_cast<char *>(m_arena.allocate(text.size() + 1, 1));
+    std::memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    m_directory.push_back(std::string_view(copy, text.size()));
+  }
+
+  std::size_t textBytes() const noexcept { return m_arena.bytes_allocated(); }
+  std::size_t directoryBytes() const noexcept { return m_directory.bytes(); }
+
+private:
+  mem::arena_resource m_arena{16 * 1024};
+  symbol_directory m_directory;
+};
+
+// string_interner's index holds only symbols, 8 bytes a slot with the
+// (empty) mapped value, and finds their text in the store. Lookups pass the
+// text with its hash, computed once.
+struct lookup_key {
+  std::string_view text;
+  std::uint64_t hash;
+};
+
+// A lookup_key that becomes the symbol `next` if it is inserted, so that
+// intern() hashes the text once and probes the index once.
+struct insert_key : lookup_key {
+  symbol next;
+  explicit operator symbol() const noexcept { return next; }
+};
+
+struct no_value {};
+
+struct symbol_hash {
+  using is_transparent = void;
+  using is_avalanching = void;
+  const string_store *strings;
+
+  // Only when the index grows: inserts pass their hash in the key.
+  std::size_t operator()(symbol s) const noexcept {
+    return static_cast<std::size_t>(hashing::hashString((*strings)[static_cast<std::size_t>(s)]));
+  }
+  std::size_t operator()(const lookup_key &key) const noexcept {
+    return static_cast<std::size_t>(key.hash);
+  }
+};
+
+struct symbol_equal {
+  using is_transparent = void;
+  const string_store *strings;
+
+  bool operator()(symbol a, symbol b) const noexcept { return a == b; }
+  bool operator()(symbol s, const lookup_key &key) const noexcept {
+    return (*strings)[static_cast<std::size_t>(s)] == key.text;
+  }
+};
+
+} // namespace detail
+
+class string_interner {
+public:
+  /// `expected_strings` distinct strings fit without growing the index.
+  explicit string_interner(std::size_t expected_strings = 0)
+      : m_index(expected_strings, detail::symbol_hash{&m_strings},
+                detail::symbol_equal{&m_strings}) {}
+
+  string_interner(const string_interner &) = delete;
+  string_interner &operator=(const string_interner &) = delete;
+
+  /// The symbol of `text`, added if it is new. Throws std::length_error when
+  /// all 2^32 symbols are taken.
+  symbol intern(std::string_view text) {
+    const detail::lookup_key key{text, hashing::hashString(text)};
+    if (m_strings.size() > std::numeric_limits<std::uint32_t>::max()) {
+      if (const auto it = m_index.find(key); it != m_index.end()) {
+        return it->first;
+      }
+      throw std::length_error("strings::string_interner::intern: out of symbols");
+    }
+    const auto [it, inserted] =
+        m_index.try_emplace(detail::insert_key{key, static_cast<symbol>(m_strings.size())});
+    if (inserted) {
+      // The new slot names a string the store does not hold yet; nothing
+      // reads it before the store has it.
+      try {
+        m_strings.push_back(text);
+      } catch (...) {
+        m_index.erase(it);
+        throw;
+      }
+    }
+    return it->first;
+  }
+
+  /// The symbol of `text` if it has been interned.
+  std::optional<symbol> find(std::string_view text) const {
+    const auto it = m_index.find(detail::lookup_key{text, hashing::hashString(text)});
+    if (it == m_index.end()) {
+      return std::nullopt;
+    }
+    return it->first;
+  }
+
+  /// The text of `s`: valid, and null-terminated, while the interner lives.
+  std::string_view view(symbol s) const noexcept {
+    return m_strings[static_cast<std::size_t>(s)];
+  }
+  const char *c_str(symbol s) const noexcept { return view(s).data(); }
+
+  /// The number of distinct strings.
+  std::size_t size() const noexcept { return m_strings.size(); }
+
+  interner_memory memory() const {
+    return {m_strings.textBytes(),
+            m_index.capacity() * sizeof(index_map::value_type) +
+                m_index.capacity() / 15 * 16, // a 16-byte metadata word per 15 slots
+            m_strings.directoryBytes()};
+  }
+
+private:
+  using index_map = containers::flat_hash_map<symbol, detail::no_value, detail::symbol_hash,
+                                              detail::symbol_equal>;
+
+  detail::string_store m_strings;
+  index_map m_index;
+};
+
+class concurrent_string_interner {
+public:
+  static constexpr int shard_bits = 6;
+  static constexpr std::size_t shard_count = std::size_t{1} << shard_bits;
+
+  /// `expected_strings` distinct strings fit without growing the index.
+  explicit concurrent_string_interner(std::size_t expected_strings = 0) {
+    std::size_t capacity = min_capacity;
+    while (capacity < 2 * expected_strings / shard_count) {
+      capacity *= 2;
+    }
+    for (shard &s : m_shards) {
+      s.tables.push_back(std::make_unique<slot_table>(capacity));
+      s.table.store(s.tables.back().get(), std::memory_order_release);
+    }
+  }
+
+  concurrent_string_interner(const concurrent_string_interner &) = delete;
+  concurrent_string_interner &operator=(const concurrent_string_interner &) = delete;
+
+  /// The symbol of `text`, added if it is new. Throws std::length_error when
+  /// the shard of `text` has no symbols left (2^26 strings per shard).
+  symbol intern(std::string_view text) {
+    const std::uint64_t hash = hashing::hashString(text);
+    const std::size_t index = shardOf(hash);
+    shard &s = m_shards[index];
+    if (const auto id = findIn(s, *s.table.load(std::memory_order_acquire), text, hash)) {
+      return symbolOf(*id, index);
+    }
+    std::lock_guard lock(s.mutex);
+    // Another thread may have added it since; this thread is now the only
+    // writer of the shard.
+    slot_table *table = s.tables.back().get();
+    if (const auto id = findIn(s, *table, text, hash)) {
+      return symbolOf(*id, index);
+    }
+    const std::size_t id = s.strings.size();
+    if (id >= max_per_shard) {
+      throw std::length_error("strings::concurrent_string_interner::intern: out of symbols");
+    }
+    // At most half full, so that probe sequences stay short.
+    if (2 * (id + 1) > table->mask + 1) {
+      table = grow(s);
+    }
+    // The text is stored before the slot is published, so a reader that
+    // sees the slot sees the text.
+    s.strings.push_back(text);
+    place(*table, hash, id);
+    return symbolOf(id, index);
+  }
+
+  /// The symbol of `text` if it has been interned. A string that another
+  /// thread is adding at the same moment may not be found yet.
+  std::optional<symbol> find(std::string_view text) const {
+    const std::uint64_t hash = hashing::hashString(text);
+    const std::size_t index = shardOf(hash);
+    const shard &s = m_shards[index];
+    if (const auto id = findIn(s, *s.table.load(std::memory_order_acquire), text, hash)) {
+      return symbolOf(*id, index);
+    }
+    return std::nullopt;
+  }
+
+  /// The text of `s`. A thread holding a symbol got it after its text was
+  /// stored, and stored text never moves.
+  std::string_view view(symbol s) const noexcept {
+    const auto id = static_cast<std::uint32_t>(s);
+    return m_shards[id & (shard_count - 1)].strings[id >> shard_bits];
+  }
+  const char *c_str(symbol s) const noexcept { return view(s).data(); }
+
+  std::size_t size() const {
+    std::size_t total = 0;
+    for (const shard &s : m_shards) {
+      std::lock_guard lock(s.mutex);
+      total += s.strings.size();
+    }
+    return total;
+  }
+
+  interner_memory memory() const {
+    interner_memory total;
+    for (const shard &s : m_shards) {
+      std::lock_guard lock(s.mutex);
+      total.strings += s.strings.textBytes();
+      total.directory += s.strings.directoryBytes();
+      for (const auto &table : s.tables) {
+        total.index += (table->mask + 1) * sizeof(std::uint64_t);
+      }
+    }
+    return total;
+  }
+
+private:
+  static constexpr std::size_t min_capacity = 64;
+  static constexpr std::size_t max_per_shard = std::size_t{1} << (32 - shard_bits);
+
+  // A slot is 0 when empty, else the top 32 bits of the string's hash above
+  // its id + 1. Slots only ever go from empty to full.
+  struct slot_table {
+    explicit slot_table(std::size_t capacity)
+        : mask(capacity - 1), slots(std::make_unique<std::atomic<std::uint64_t>[]>(capacity)) {}
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+  };
+
+  // Aligned to cache lines, so that neighbouring shards share none.
+  struct alignas(64) shard {
+    mutable std::mutex mutex;
+    std::atomic<const slot_table *> table{nullptr};
+    // The current table last. Readers may still be probing the older ones,
+    // so they live as long as the interner: together at most as big as the
+    // current one.
+    std::vector<std::unique_ptr<slot_table>> tables;
+    detail::string_store strings;
+  };
+
+  // The top bits: the tables use the low ones.
+  static std::size_t shardOf(std::uint64_t hash) noexcept {
+    return static_cast<std::size_t>(hash >> (64 - shard_bits));
+  }
+
+  static symbol symbolOf(std::size_t id, std::size_t shard) noexcept {
+    return static_cast<symbol>((static_cast<std::uint32_t>(id) << shard_bits) |
+                               static_cast<std::uint32_t>(shard));
+  }
+
+  static std::optional<std::size_t> findIn(const shard &s, const slot_table &table,
+                                           std::string_view text, std::uint64_t hash) noexcept {
+    const auto tag = static_cast<std::uint32_t>(hash >> 32);
+    // Linear probing: the table is at most half full, so an empty slot
+    // always ends the search.
+    for (std::size_t i = hash & table.mask;; i = (i + 1) & table.mask) {
+      const std::uint64_t slot = table.slots[i].load(std::memory_order_acquire);
+      if (slot == 0) {
+        return std::nullopt;
+      }
+      if (static_cast<std::uint32_t>(slot >> 32) == tag) {
+        const std::size_t id = static_cast<std::uint32_t>(slot) - 1;
+        if (s.strings[id] == text) {
+          return id;
+        }
+      }
+    }
+  }
+
+  static void place(slot_table &table, std::uint64_t hash, std::size_t id) noexcept {
+    std::size_t i = hash & table.mask;
+    while (table.slots[i].load(std::memory_order_relaxed) != 0) {
+      i = (i + 1) & table.mask;
+    }
+    table.slots[i].store((hash >> 32 << 32) | (id + 1), std::memory_order_release);
+  }
+
+  // A table twice the size with every string of the shard, published for
+  // the readers once it is complete.
+  static slot_table *grow(shard &s) {
+    auto bigger = std::make_unique<slot_table>(2 * (s.tables.back()->mask + 1));
+    for (std::size_t id = 0; id < s.strings.size(); ++id) {
+      place(*bigger, hashing::hashString(s.strings[id]), id);
+    }
+    s.tables.push_back(std::move(bigger));
+    s.table.store(s.tables.back().get(), std::memory_order_release);
+    return s.tables.back().get();
+  }
+
+  std::array<shard, shard_count> m_shards;
+};
+
+} // namespace strings
+
+#endif
@@ -0,0 +1,247 @@
+// Interned strings against std::string on a corpus of 10M strings drawn from
+// 100k distinct names of 3-20 letters, the frequent ones far more often
+// (Zipf, s = 1), as names and keys repeat in real data:
+// - Memory: heap bytes, counted by alloc_profiler, of the corpus as
+//   std::vector<std::string> and as std::vector<strings::symbol> plus the
+//   interner
+// - Intern: a symbol for every string of the corpus, from an empty table:
+//   std::unordered_map<std::string, std::uint32_t>, string_interner, and
+//   concurrent_string_interner with 1 and 4 threads sharing the corpus
+// - Find: the same lookups once every string is known
+// - Equal: counting the strings equal to one name, std::string == against
+//   symbol ==
+#include "alloc_profiler/alloc_profiler.hpp"
+#include "strings/interner.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t corpus_size = 10'000'000;
+constexpr std::size_t vocabulary_size = 100'000;
+
+std::int64_t liveBytes() { return alloc_profiler::takeSnapshot().live_bytes; }
+
+std::vector<std::string> makeVocabulary() {
+  std::mt19937 gen(42);
+  std::vector<std::string> words(vocabulary_size);
+  for (std::string &word : words) {
+    const std::size_t length = 3 + gen() % 18;
+    for (std::size_t i = 0; i < length; ++i) {
+      word += static_cast<char>((i == 0 ? 'A' : 'a') + gen() % 26);
+    }
+  }
+  return words;
+}
+
+struct corpus {
+  std::vector<std::string> strings;
+  std::int64_t bytes = 0;
+};
+
+const corpus &theCorpus() {
+  static const corpus c = [] {
+    const std::vector<std::string> vocabulary = makeVocabulary();
+    std::vector<double> weights(vocabulary_size);
+    for (std::size_t rank = 0; rank < vocabulary_size; ++rank) {
+      weights[rank] = 1.0 / static_cast<double>(rank + 1);
+    }
+    std::discrete_distribution<std::size_t> zipf(weights.begin(), weights.end());
+    std::mt19937 gen(7);
+    std::vector<std::size_t> picks(corpus_size);
+    for (std::size_t &pick : picks) {
+      pick = zipf(gen);
+    }
+    corpus result;
+    const std::int64_t before = liveBytes();
+    result.strings.reserve(corpus_size);
+    for (const std::size_t pick : picks) {
+      result.strings.push_back(vocabulary[pick]);
+    }
+    result.bytes = liveBytes() - before;
+    return result;
+  }();
+  return c;
+}
+
+void perString(benchmark::State &state, std::size_t strings = corpus_size) {
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * strings));
+}
+
+void BM_MemoryStdString(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(c.strings.data());
+  }
+  state.counters["MB"] = static_cast<double>(c.bytes) / 1e6;
+  state.counters["bytes_per_string"] = static_cast<double>(c.bytes) / corpus_size;
+}
+
+void BM_MemoryInterned(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  std::int64_t bytes = 0;
+  std::size_t distinct = 0;
+  for (auto _ : state) {
+    const std::int64_t before = liveBytes();
+    {
+      strings::string_interner interner;
+      std::vector<strings::symbol> symbols;
+      symbols.reserve(corpus_size);
+      for (const std::string &s : c.strings) {
+        symbols.push_back(interner.intern(s));
+      }
+      bytes = liveBytes() - before;
+      distinct = interner.size();
+    }
+  }
+  state.counters["MB"] = static_cast<double>(bytes) / 1e6;
+  state.counters["bytes_per_string"] = static_cast<double>(bytes) / corpus_size;
+  state.counters["distinct"] = static_cast<double>(distinct);
+}
+
+void BM_InternUnorderedMap(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  for (auto _ : state) {
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::uint64_t sum = 0;
+    for (const std::string &s : c.strings) {
+      sum += ids.try_emplace(s, static_cast<std::uint32_t>(ids.size())).first->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perString(state);
+}
+
+void BM_Intern(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  for (auto _ : state) {
+    strings::string_interner interner;
+    std::uint64_t sum = 0;
+    for (const std::string &s : c.strings) {
+      sum += static_cast<std::uint32_t>(interner.intern(s));
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perString(state);
+}
+
+// Each thread interns its share of the corpus into one interner. Thread 0
+// creates it before the loop and deletes it after; the loop starts and ends
+// with all threads together. One iteration, so that every string is new to
+// the interner once.
+strings::concurrent_string_interner *shared = nullptr;
+
+void BM_InternConcurrent(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  const auto threads = static_cast<std::size_t>(state.threads());
+  const std::size_t share = corpus_size / threads;
+  const std::size_t first = share * static_cast<std::size_t>(state.thread_index());
+  if (state.thread_index() == 0) {
+    shared = new strings::concurrent_string_interner;
+  }
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = first; i < first + share; ++i) {
+      sum += static_cast<std::uint32_t>(shared->intern(c.strings[i]));
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  if (state.thread_index() == 0) {
+    delete shared;
+  }
+  perString(state, share);
+}
+
+void BM_FindUnorderedMap(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  std::unordered_map<std::string, std::uint32_t> ids;
+  for (const std::string &s : c.strings) {
+    ids.try_emplace(s, static_cast<std::uint32_t>(ids.size()));
+  }
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (const std::string &s : c.strings) {
+      sum += ids.find(s)->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perString(state);
+}
+
+template <typename Interner> void BM_Find(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  Interner interner;
+  for (const std::string &s : c.strings) {
+    interner.intern(s);
+  }
+  for (auto _ : state) {
+    std::uint64_t sum = 0;
+    for (const std::string &s : c.strings) {
+      sum += static_cast<std::uint32_t>(*interner.find(s));
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perString(state);
+}
+
+// The 100th most frequent name: about 1 string in 1200.
+void BM_EqualStdString(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  const std::string name = makeVocabulary()[99];
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for (const std::string &s : c.strings) {
+      count += s == name;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  perString(state);
+}
+
+void BM_EqualSymbol(benchmark::State &state) {
+  const corpus &c = theCorpus();
+  strings::string_interner interner;
+  std::vector<strings::symbol> symbols;
+  symbols.reserve(corpus_size);
+  for (const std::string &s : c.strings) {
+    symbols.push_back(interner.intern(s));
+  }
+  const strings::symbol name = interner.intern(makeVocabulary()[99]);
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for (const strings::symbol s : symbols) {
+      count += s == name;
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  perString(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_MemoryStdString)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MemoryInterned)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_InternUnorderedMap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Intern)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InternConcurrent)
+    ->Iterations(1)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_FindUnorderedMap)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Find, strings::string_interner)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Find, strings::concurrent_string_interner)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_EqualStdString)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EqualSymbol)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+#include "strings/numbers.hpp"
+
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// stringNumberConversion() from string.cpp. std::to_string(10.3) is
+// "10.300000" and std::stoi() stops quietly at the '.'; toString() writes the
+// shortest text that reads back as the same double, and toNumber() wants all
+// of the text to be the number.
+void stringNumberConversion() {
+  std::cout << "-------- stringNumberConversion() --------" << std::endl;
+  std::cout << "std::to_string(10.3): " << std::to_string(10.3) << std::endl;
+  const std::string strNumber = strings::toString(10.3);
+  std::cout << "strings::toString(10.3): " << strNumber << std::endl;
+
+  const float f = strings::toNumber<float>(strNumber);
+  const double d = strings::toNumber<double>(strNumber);
+  std::cout << "float: " << f << ", double: " << d << std::endl;
+  try {
+    strings::toNumber<int>(strNumber);
+  } catch (const std::invalid_argument &e) {
+    std::cout << e.what() << std::endl;
+  }
+  // The leading integer, as std::stoi() reads it: fromChars() says where it
+  // stopped.
+  int i = 0;
+  const char *last = strNumber.data() + strNumber.size();
+  const auto [end, ec] = strings::fromChars(strNumber.data(), last, i);
+  std::cout << "int: " << i << ", rest: \"" << std::string_view(end, last) << "\"" << std::endl;
+}
+
+// The doubles that the usual six digits of precision lose, and that a fixed
+// 17 digits print as 0.10000000000000001.
+void shortestRoundTrip() {
+  std::cout << "-------- shortest round trip --------" << std::endl;
+  for (const double value : {0.1, 0.1 + 0.2, 1.0 / 3, 123456789.125, 1e-7, 6.02214076e23,
+                             std::numeric_limits<double>::denorm_min()}) {
+    const std::string text = strings::toString(value);
+    std::cout << std::to_string(value) << " -> " << text << " -> "
+              << (strings::toNumber<double>(text) == value ? "same" : "different") << std::endl;
+  }
+}
+
+// stringstreamExample() reads "23 4 5.0" word by word with operator>>.
+// parseNumbers() reads a whole buffer of numbers at once.
+void stringstreamExample() {
+  std::cout << "-------- stringstreamExample() --------" << std::endl;
+  std::vector<double> numbers;
+  const std::size_t count = strings::parseNumbers<double>("23 4 5.0", numbers);
+  std::cout << count << " numbers:";
+  for (const double number : numbers) {
+    std::cout << " " << number;
+  }
+  std::cout << std::endl;
+
+  // Commas and any whitespace separate numbers; anything else is an error.
+  strings::parseNumbers<double>("1.5, -2e3,\t0.25\n", numbers);
+  std::string line;
+  strings::formatNumbers<double>(numbers, line, ',');
+  std::cout << "formatNumbers: " << line << std::endl;
+  try {
+    std::vector<int> ints;
+    strings::parseNumbers<int>("1 2 three 4", ints);
+  } catch (const std::invalid_argument &e) {
+    std::cout << e.what() << std::endl;
+  }
+}
+
+int main() {
+  stringNumberConversion();
+  shortestRoundTrip();
+  stringstreamExample();
+}
@@ -0,0 +1,601 @@
+#ifndef NUMBERS_HPP
+#define NUMBERS_HPP
+
+#include "strings/number_tables.hpp"
+
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+///
+/// Converting numbers to and from text without allocations or locales, in
+/// place of std::stoi, std::stod, std::to_string and std::stringstream in
+/// stringNumberConversion() (string.cpp) and stringstreamExample().
+///
+/// - fromChars() and toChars() have the interface of std::from_chars and
+///   std::to_chars. Integers go straight to those. Doubles are parsed with
+///   the Eisel-Lemire algorithm (as in fast_float): the decimal significand,
+///   up to 19 digits, is multiplied by a 128-bit approximation of the power
+///   of ten, which is exact enough to round correctly. Doubles are written
+///   with the Schubfach algorithm (Giulietti): the shortest decimal that
+///   parses back to the same double, in the format std::to_chars chooses
+///   (fixed or scientific, whichever is shorter).
+/// - toNumber() and toString() are the drop-in replacements for std::stoi,
+///   std::stod and std::to_string: toNumber() throws std::invalid_argument
+///   or std::out_of_range as they do, but also if the text does not end
+///   after the number.
+/// - parseNumbers() and formatNumbers() convert whole buffers: numbers
+///   separated by whitespace or commas into a vector, and a span of numbers
+///   into one string.
+///
+/// The 128-bit tables come from scripts/generate_number_tables.py. A double
+/// with more than 19 significant digits, "inf" and "nan" are parsed by
+/// std::from_chars.
+///
+
+namespace strings {
+
+template <typename T>
+concept number = (std::integral<T> && !std::same_as<T, bool>) || std::floating_point<T>;
+
+/// The longest text toChars() writes for a T.
+template <number T>
+inline constexpr std::size_t max_chars = std::is_same_v<T, double> ? 24
+                                         : std::floating_point<T>
+                                             ? 64
+                                             : std::numeric_limits<T>::digits10 + 2;
+
+namespace detail {
+
+struct uint128 {
+  std::uint64_t high;
+  std::uint64_t low;
+};
+
+inline uint128 multiply(std::uint64_t a, std::uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<std::uint64_t>(p >> 64), static_cast<std::uint64_t>(p)};
+#else
+  const std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+  const std::uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+  const std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+  const std::uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  return {hi_hi + (hi_lo >> 32) + (cross >> 32), (cross << 32) | (lo_lo & 0xFFFFFFFF)};
+#endif
+}
+
+inline bool isDigit(char c) noexcept { return static_cast<unsigned char>(c - '0') < 10; }
+
+// Eight digits at a time, as in fast_float: the chars loaded little-endian,
+// checked and combined in one register.
+inline bool readEightDigits(const char *p, const char *last, std::uint64_t &w) noexcept {
+  if constexpr (std::endian::native != std::endian::little) {
+    return false;
+  }
+  if (last - p < 8) {
+    return false;
+  }
+  std::uint64_t chunk;
+  std::memcpy(&chunk, p, 8);
+  if ((((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080) != 0) {
+    return false;
+  }
+  constexpr std::uint64_t mask = 0x000000FF000000FF;
+  chunk -= 0x3030303030303030;
+  chunk = chunk * 10 + (chunk >> 8);
+  chunk = ((chunk & mask) * 0x000F424000000064 + ((chunk >> 16) & mask) * 0x0000271000000001) >> 32;
+  w = w * 100000000 + static_cast<std::uint32_t>(chunk);
+  return true;
+}
+
+// Fields of an IEEE 754 double.
+constexpr int mantissa_bits = 52;
+constexpr int exponent_bias = 1023;
+constexpr int infinite_exponent = 0x7FF;
+
+// A number as the integer w times 10^q, as written.
+struct decimal {
+  std::uint64_t w = 0;
+  std::int64_t q = 0;
+  bool negative = false;
+  // More than 19 significant digits: w is not exact.
+  bool truncated = false;
+  const char *end = nullptr;
+};
+
+// Reads [-]digits[.digits][(e|E)[+|-]digits], as std::from_chars with
+// chars_format::general does. Returns false if there are no digits.
+inline bool readDecimal(const char *first, const char *last, decimal &d) noexcept {
+  const char *p = first;
+  d.negative = p != last && *p == '-';
+  p += d.negative;
+  const char *digits = p;
+  std::uint64_t w = 0;
+  while (readEightDigits(p, last, w)) {
+    p += 8;
+  }
+  while (p != last && isDigit(*p)) {
+    w = 10 * w + static_cast<std::uint64_t>(*p - '0');
+    ++p;
+  }
+  std::int64_t count = p - digits;
+  std::int64_t q = 0;
+  if (p != last && *p == '.') {
+    ++p;
+    const char *fraction = p;
+    while (readEightDigits(p, last, w)) {
+      p += 8;
+    }
+    while (p != last && isDigit(*p)) {
+      w = 10 * w + static_cast<std::uint64_t>(*p - '0');
+      ++p;
+    }
+    q = -(p - fraction);
+    count += p - fraction;
+  }
+  if (count == 0) {
+    return false;
+  }
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    const char *e = p + 1;
+    const bool negative_exponent = e != last && *e == '-';
+    e += e != last && (*e == '-' || *e == '+');
+    if (e != last && isDigit(*e)) {
+      std::int64_t exponent = 0;
+      for (; e != last && isDigit(*e); ++e) {
+        // Past the range of doubles the exact value no longer matters.
+        if (exponent < 0x10000000) {
+          exponent = 10 * exponent + (*e - '0');
+        }
+      }
+      q += negative_exponent ? -exponent : exponent;
+      p = e;
+    }
+  }
+  if (count > 19) {
+    // Leading zeros, as in 0.000123, do not count.
+    for (const char *z = digits; z != p && (*z == '0' || *z == '.'); ++z) {
+      count -= *z == '0';
+    }
+    d.truncated = count > 19;
+  }
+  d.w = w;
+  d.q = q;
+  d.end = p;
+  return true;
+}
+
+// The 128 most significant bits of w * 5^q, or enough of them to round w
+// (shifted to have its top bit set) to 55 bits.
+inline uint128 productOfPowerOfFive(std::int64_t q, std::uint64_t w) noexcept {
+  const auto &power = powers_of_five[q - smallest_power_of_five];
+  constexpr std::uint64_t precision_mask = ~std::uint64_t{0} >> 55;
+  uint128 first = multiply(w, power[0]);
+  if ((first.high & precision_mask) == precision_mask) {
+    const uint128 second = multiply(w, power[1]);
+    first.low += second.high;
+    first.high += second.high > first.low;
+  }
+  return first;
+}
+
+// Eisel-Lemire: the bits of the double nearest to w * 10^q, w != 0, without
+// the sign. From fast_float's compute_float<binary64>.
+inline std::uint64_t eiselLemire(std::int64_t q, std::uint64_t w) noexcept {
+  if (q < smallest_power_of_five) {
+    return 0;
+  }
+  if (q > largest_power_of_five) {
+    return std::uint64_t{infinite_exponent} << mantissa_bits;
+  }
+  const int lz = std::countl_zero(w);
+  w <<= lz;
+  const uint128 product = productOfPowerOfFive(q, w);
+  const int upper_bit = static_cast<int>(product.high >> 63);
+  const int shift = upper_bit + 64 - mantissa_bits - 3;
+  std::uint64_t mantissa = product.high >> shift;
+  // floor(log2(10^q)) + 63, from 217706 / 2^16 ~ log2(10).
+  const int power_of_two = static_cast<int>(((217706 * q) >> 16) + 63);
+  int exponent = power_of_two + upper_bit - lz + exponent_bias;
+
+  if (exponent <= 0) {
+    // Subnormal, or zero.
+    if (-exponent + 1 >= 64) {
+      return 0;
+    }
+    mantissa >>= -exponent + 1;
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    exponent = mantissa < (std::uint64_t{1} << mantissa_bits) ? 0 : 1;
+    return (static_cast<std::uint64_t>(exponent) << mantissa_bits) |
+           (mantissa & ((std::uint64_t{1} << mantissa_bits) - 1));
+  }
+  // Exactly halfway between two doubles: round to even rather than up. Only
+  // 10^-4..10^23 times a 64-bit integer can land there.
+  if (product.low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+      (mantissa << shift) == product.high) {
+    mantissa &= ~std::uint64_t{1};
+  }
+  mantissa += mantissa & 1;
+  mantissa >>= 1;
+  if (mantissa >= (std::uint64_t{2} << mantissa_bits)) {
+    mantissa = std::uint64_t{1} << mantissa_bits;
+    ++exponent;
+  }
+  mantissa &= ~(std::uint64_t{1} << mantissa_bits);
+  if (exponent >= infinite_exponent) {
+    return std::uint64_t{infinite_exponent} << mantissa_bits;
+  }
+  return (static_cast<std::uint64_t>(exponent) << mantissa_bits) | mantissa;
+}
+
+// The powers of ten that are exact doubles.
+inline constexpr double exact_powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                          1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                          1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline std::from_chars_result parseDouble(const char *first, const char *last,
+                                          double &value) noexcept {
+  decimal d;
+  if (!readDecimal(first, last, d) || d.truncated) {
+    return std::from_chars(first, last, value);
+  }
+  double result;
+  // Clinger's fast path: w and 10^|q| are exact doubles, so one correctly
+  // rounded multiplication or division gives the answer.
+  if (FLT_EVAL_METHOD == 0 && d.q >= -22 && d.q <= 22 && d.w <= (std::uint64_t{1} << 53)) {
+    result = static_cast<double>(d.w);
+    result = d.q < 0 ? result / exact_powers[-d.q] : result * exact_powers[d.q];
+  } else if (d.w == 0) {
+    result = 0;
+  } else {
+    const std::uint64_t bits = eiselLemire(d.q, d.w);
+    if (bits == 0 || bits == std::uint64_t{infinite_exponent} << mantissa_bits) {
+      // Underflow to zero or overflow, reported as std::from_chars does.
+      return {d.end, std::errc::result_out_of_range};
+    }
+    result = std::bit_cast<double>(bits);
+  }
+  value = d.negative ? -result : result;
+  return {d.end, std::errc()};
+}
+
+// Schubfach. A double is c * 2^q; among the decimals in its rounding
+// interval, pick one with the fewest digits, and of those the closest.
+
+inline int floorLog10Pow2(int e) noexcept {
+  return static_cast<int>((e * std::int64_t{661971961083}) >> 41);
+}
+inline int floorLog10ThreeQuartersPow2(int e) noexcept {
+  return static_cast<int>((e * std::int64_t{661971961083} - 274743187321) >> 41);
+}
+inline int floorLog2Pow10(int e) noexcept {
+  return static_cast<int>((e * std::int64_t{913124641741}) >> 38);
+}
+
+// Rounds g * cp / 2^127 to odd, g being the 126-bit power of ten.
+inline std::uint64_t roundToOdd(std::uint64_t g1, std::uint64_t g0, std::uint64_t cp) noexcept {
+  const std::uint64_t x1 = multiply(g0, cp).high;
+  const uint128 y = multiply(g1, cp);
+  const std::uint64_t z = (y.low >> 1) + x1;
+  const std::uint64_t vbp = y.high + (z >> 63);
+  constexpr std::uint64_t mask_63 = (std::uint64_t{1} << 63) - 1;
+  return vbp | (((z & mask_63) + mask_63) >> 63);
+}
+
+// The shortest decimal f * 10^e of c * 2^q.
+struct shortest {
+  std::uint64_t f;
+  int e;
+};
+
+inline shortest schubfach(int q, std::uint64_t c) noexcept {
+  constexpr int min_exponent = -1074;
+  constexpr std::uint64_t hidden_bit = std::uint64_t{1} << mantissa_bits;
+  const std::uint64_t out = c & 1;
+  const std::uint64_t cb = c << 2;
+  const std::uint64_t cbr = cb + 2;
+  std::uint64_t cbl;
+  int k;
+  // At a power of two the interval below is half as wide as the one above.
+  if (c != hidden_bit || q == min_exponent) {
+    cbl = cb - 2;
+    k = floorLog10Pow2(q);
+  } else {
+    cbl = cb - 1;
+    k = floorLog10ThreeQuartersPow2(q);
+  }
+  const int h = q + floorLog2Pow10(-k) + 2;
+  const auto &g = powers_of_ten[k - smallest_power_of_ten];
+  const std::uint64_t vb = roundToOdd(g[0], g[1], cb << h);
+  const std::uint64_t vbl = roundToOdd(g[0], g[1], cbl << h);
+  const std::uint64_t vbr = roundToOdd(g[0], g[1], cbr << h);
+
+  const std::uint64_t s = vb >> 2;
+  if (s >= 10) {
+    // One digit fewer, if a multiple of 10 is inside the interval.
+    const std::uint64_t sp10 = s / 10 * 10;
+    const std::uint64_t tp10 = sp10 + 10;
+    const bool upin = vbl + out <= sp10 << 2;
+    const bool wpin = (tp10 << 2) + out <= vbr;
+    if (upin != wpin) {
+      return {upin ? sp10 : tp10, k};
+    }
+  }
+  const std::uint64_t t = s + 1;
+  const bool uin = vbl + out <= s << 2;
+  const bool win = (t << 2) + out <= vbr;
+  if (uin != win) {
+    return {uin ? s : t, k};
+  }
+  // Both s and s + 1 are inside: the closer one, or the even one on a tie.
+  const std::int64_t cmp = static_cast<std::int64_t>(vb - ((s + t) << 1));
+  return {cmp < 0 || (cmp == 0 && (s & 1) == 0) ? s : t, k};
+}
+
+inline constexpr char digit_pairs[] = "00010203040506070809101112131415161718192021222324"
+                                      "25262728293031323334353637383940414243444546474849"
+                                      "50515253545556575859606162636465666768697071727374"
+                                      "75767778798081828384858687888990919293949596979899";
+
+// Writes the digits of f, ending at `end`: eight at a time with 32-bit
+// arithmetic, two at a time from the table.
+inline void writeDigits(char *end, std::uint64_t f) noexcept {
+  while (f >= 100000000) {
+    auto low = static_cast<std::uint32_t>(f % 100000000);
+    f /= 100000000;
+    for (int i = 0; i < 4; ++i) {
+      end -= 2;
+      std::memcpy(end, digit_pairs + (low % 100) * 2, 2);
+      low /= 100;
+    }
+  }
+  auto high = static_cast<std::uint32_t>(f);
+  while (high >= 100) {
+    end -= 2;
+    std::memcpy(end, digit_pairs + (high % 100) * 2, 2);
+    high /= 100;
+  }
+  if (high >= 10) {
+    std::memcpy(end - 2, digit_pairs + high * 2, 2);
+  } else {
+    end[-1] = static_cast<char>('0' + high);
+  }
+}
+
+inline constexpr std::uint64_t integer_powers_of_ten[] = {1,
+                                                          10,
+                                                          100,
+                                                          1000,
+                                                          10000,
+                                                          100000,
+                                                          1000000,
+                                                          10000000,
+                                                          100000000,
+                                                          1000000000,
+                                                          10000000000,
+                                                          100000000000,
+                                                          1000000000000,
+                                                          10000000000000,
+                                                          100000000000000,
+                                                          1000000000000000,
+                                                          10000000000000000,
+                                                          100000000000000000,
+                                                          1000000000000000000,
+                                                          10000000000000000000u};
+
+// The number of digits of f: log10 from the bit length (1233 / 2^12 ~
+// log10(2)), then one comparison.
+inline int digitCount(std::uint64_t f) noexcept {
+  const int t = ((64 - std::countl_zero(f | 1)) * 1233) >> 12;
+  return t + (f >= integer_powers_of_ten[t]);
+}
+
+// Writes f * 10^e as std::to_chars does: fixed unless scientific is shorter.
+inline char *writeDecimal(char *out, std::uint64_t f, int e) noexcept {
+  while (f % 10 == 0) {
+    f /= 10;
+    ++e;
+  }
+  const int n = digitCount(f);
+  const int sci_exponent = e + n - 1;
+  const int abs_exponent = sci_exponent < 0 ? -sci_exponent : sci_exponent;
+  const int sci_length = n + (n > 1) + 2 + (abs_exponent >= 100 ? 3 : 2);
+  const int fixed_length = e >= 0 ? n + e : sci_exponent >= 0 ? n + 1 : n + 1 - sci_exponent;
+  if (fixed_length <= sci_length) {
+    if (e >= 0) {
+      writeDigits(out + n, f);
+      std::memset(out + n, '0', static_cast<std::size_t>(e));
+      return out + n + e;
+    }
+    if (sci_exponent >= 0) {
+      // ddd.ddd: write the digits one place right, then move the integer
+      // part back over the gap.
+      const int integer_digits = sci_exponent + 1;
+      writeDigits(out + n + 1, f);
+      std::memmove(out, out + 1, static_cast<std::size_t>(integer_digits));
+      out[integer_digits] = '.';
+      return out + n + 1;
+    }
+    // 0.000ddd
+    const int zeros = -sci_exponent - 1;
+    out[0] = '0';
+    out[1] = '.';
+    std::memset(out + 2, '0', static_cast<std::size_t>(zeros));
+    writeDigits(out + 2 + zeros + n, f);
+    return out + 2 + zeros + n;
+  }
+  // d.ddde+XX
+  writeDigits(out + n + 1, f);
+  out[0] = out[1];
+  char *p = out + 1;
+  if (n > 1) {
+    *p = '.';
+    p += n;
+  }
+  *p++ = 'e';
+  *p++ = sci_exponent < 0 ? '-' : '+';
+  if (abs_exponent >= 100) {
+    *p++ = static_cast<char>('0' + abs_exponent / 100);
+  }
+  std::memcpy(p, digit_pairs + (abs_exponent % 100) * 2, 2);
+  return p + 2;
+}
+
+inline std::to_chars_result formatDouble(char *first, char *last, double value) noexcept {
+  const auto bits = std::bit_cast<std::uint64_t>(value);
+  const std::uint64_t t = bits & ((std::uint64_t{1} << mantissa_bits) - 1);
+  const int bq = static_cast<int>(bits >> mantissa_bits) & infinite_exponent;
+  if (bq == infinite_exponent || static_cast<std::size_t>(last - first) < max_chars<double> ||
+      (bq > exponent_bias + mantissa_bits && std::abs(value) < 1e22)) {
+    // inf, nan, or a buffer that may be too small: the checks are std's. So
+    // are the integers from 2^53 to 10^22, which std writes in full when it
+    // picks fixed notation, with all the digits of the exact value rather
+    // than the shortest ones padded with zeros.
+    return std::to_chars(first, last, value);
+  }
+  char *p = first;
+  if (bits >> 63) {
+    *p++ = '-';
+  }
+  if (bq == 0 && t == 0) {
+    *p++ = '0';
+    return {p, std::errc()};
+  }
+  shortest d;
+  if (bq != 0) {
+    const int mq = exponent_bias + mantissa_bits - bq;
+    const std::uint64_t c = (std::uint64_t{1} << mantissa_bits) | t;
+    if (mq > 0 && mq < 53 && ((c >> mq) << mq) == c) {
+      // An integer below 2^53: its own digits are the shortest.
+      d = {c >> mq, 0};
+    } else {
+      d = schubfach(-mq, c);
+    }
+  } else {
+    d = schubfach(-1074, t);
+  }
+  return {writeDecimal(p, d.f, d.e), std::errc()};
+}
+
+[[noreturn]] inline void throwConversionError(std::errc ec, std::string_view text) {
+  const std::string what = "strings::toNumber: \"" + std::string(text) + "\"";
+  if (ec == std::errc::result_out_of_range) {
+    throw std::out_of_range(what + " is out of range");
+  }
+  throw std::invalid_argument(what + " is not a number");
+}
+
+inline bool isSeparator(char c) noexcept {
+  return c == ' ' || c == ',' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+} // namespace detail
+
+/// std::from_chars, with Eisel-Lemire for doubles.
+template <number T>
+std::from_chars_result fromChars(const char *first, const char *last, T &value) noexcept {
+  if constexpr (std::is_same_v<T, double>) {
+    return detail::parseDouble(first, last, value);
+  } else {
+    return std::from_chars(first, last, value);
+  }
+}
+
+/// std::to_chars, with Schubfach for doubles.
+template <number T> std::to_chars_result toChars(char *first, char *last, T value) noexcept {
+  if constexpr (std::is_same_v<T, double>) {
+    return detail::formatDouble(first, last, value);
+  } else {
+    return std::to_chars(first, last, value);
+  }
+}
+
+/// The number that is all of `text`, like std::stoi/std::stod but without
+/// leading whitespace, a leading '+' or trailing characters. Throws
+/// std::invalid_argument or std::out_of_range.
+template <number T> T toNumber(std::string_view text) {
+  T value{};
+  const auto [end, ec] = fromChars(text.data(), text.data() + text.size(), value);
+  if (ec != std::errc() || end != text.data() + text.size()) {
+    detail::throwConversionError(ec, text);
+  }
+  return value;
+}
+
+/// Like std::to_string, but doubles come out as short as they can while
+/// still parsing back to the same value (0.1, not 0.100000).
+template <number T> std::string toString(T value) {
+  char buffer[max_chars<T>];
+  const auto [end, ec] = toChars(buffer, buffer + sizeof(buffer), value);
+  return std::string(buffer, end);
+}
+
+/// Appends the numbers of `text`, separated by any mix of whitespace and
+/// commas, to `out` and returns how many there were. Throws
+/// std::invalid_argument, with the offset, at the first field that is not
+/// a number, and std::out_of_range for one that does not fit in T.
+template <number T> std::size_t parseNumbers(std::string_view text, std::vector<T> &out) {
+  const char *p = text.data();
+  const char *last = p + text.size();
+  const std::size_t before = out.size();
+  for (;;) {
+    while (p != last && detail::isSeparator(*p)) {
+      ++p;
+    }
+    if (p == last) {
+      return out.size() - before;
+    }
+    T value{};
+    const auto [end, ec] = fromChars(p, last, value);
+    if (ec != std::errc() || (end != last && !detail::isSeparator(*end))) {
+      const std::string where = "strings::parseNumbers: offset " +
+                                std::to_string(p - text.data()) + ": ";
+      if (ec == std::errc::result_out_of_range) {
+        throw std::out_of_range(where + "out of range");
+      }
+      throw std::invalid_argument(where + "not a number");
+    }
+    out.push_back(value);
+    p = end;
+  }
+}
+
+/// Appends `values` to `out`, separated by `separator`. The string grows
+/// once, by the most the numbers can take, and is trimmed at the end.
+template <number T>
+void formatNumbers(std::span<const T> values, std::string &out, char separator = ' ') {
+  if (values.empty()) {
+    return;
+  }
+  const std::size_t start = out.size();
+  out.resize(start + values.size() * (max_chars<T> + 1));
+  char *p = out.data() + start;
+  char *const last = out.data() + out.size();
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (i != 0) {
+      *p++ = separator;
+    }
+    p = toChars(p, last, values[i]).ptr;
+  }
+  out.resize(static_cast<std::size_t>(p - out.data()));
+}
+
+} // namespace strings
+
+#endif
@@ -0,0 +1,337 @@
+// Number conversions of string.cpp and stringstreamExample() against
+// strings/numbers.hpp, in ns per number, on 4096 numbers:
+// - ParseInt: std::stoi, std::istringstream >>, std::from_chars,
+//   strings::fromChars, and strings::parseNumbers on the same numbers as one
+//   space-separated buffer
+// - ParseDouble: std::stod, std::strtod, std::istringstream >>,
+//   std::from_chars, strings::fromChars and strings::parseNumbers, on doubles
+//   as %.17g writes them (random bits) and on short ones like "31.41"
+// - FormatInt/FormatDouble: std::to_string, std::ostringstream <<,
+//   std::to_chars, strings::toChars and strings::formatNumbers
+#include "strings/numbers.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t count = 4096;
+
+std::vector<int> makeInts() {
+  std::mt19937 gen(42);
+  std::vector<int> ints(count);
+  for (int &i : ints) {
+    // Numbers of all lengths, not mostly 10-digit ones.
+    i = static_cast<int>(gen() >> (gen() % 32)) * (gen() % 2 ? 1 : -1);
+  }
+  return ints;
+}
+
+// Doubles from random bits: 15 to 17 significant digits. Not subnormals,
+// for which std::stod throws std::out_of_range.
+std::vector<double> makeDoubles() {
+  std::mt19937_64 gen(42);
+  std::vector<double> doubles;
+  while (doubles.size() < count) {
+    const double d = std::bit_cast<double>(gen());
+    if (std::isnormal(d)) {
+      doubles.push_back(d);
+    }
+  }
+  return doubles;
+}
+
+// Prices and measurements: up to 4 digits before and 2 after the point.
+std::vector<double> makeShortDoubles() {
+  std::mt19937 gen(42);
+  std::vector<double> doubles(count);
+  for (double &d : doubles) {
+    d = static_cast<double>(gen() % 1000000) / 100;
+  }
+  return doubles;
+}
+
+template <typename T> std::vector<std::string> toStrings(const std::vector<T> &values) {
+  std::vector<std::string> texts;
+  for (const T value : values) {
+    if constexpr (std::is_same_v<T, double>) {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+      texts.emplace_back(buffer);
+    } else {
+      texts.push_back(std::to_string(value));
+    }
+  }
+  return texts;
+}
+
+std::string join(const std::vector<std::string> &texts) {
+  std::string joined;
+  for (const auto &text : texts) {
+    joined += text;
+    joined += ' ';
+  }
+  return joined;
+}
+
+const std::vector<std::string> &intTexts() {
+  static const auto texts = toStrings(makeInts());
+  return texts;
+}
+
+const std::vector<std::string> &doubleTexts(bool short_doubles) {
+  static const auto texts = toStrings(makeDoubles());
+  static const auto short_texts = toStrings(makeShortDoubles());
+  return short_doubles ? short_texts : texts;
+}
+
+// Every benchmark converts `count` numbers per iteration; the rate printed
+// is numbers per second and the time per iteration divided by 4096 is ns
+// per number.
+void perNumber(benchmark::State &state) {
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+void BM_ParseIntStoi(benchmark::State &state) {
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &text : intTexts()) {
+      sum += std::stoi(text);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseIntStream(benchmark::State &state) {
+  const std::string joined = join(intTexts());
+  for (auto _ : state) {
+    std::istringstream in(joined);
+    int sum = 0;
+    for (int value; in >> value;) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseIntStdFromChars(benchmark::State &state) {
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &text : intTexts()) {
+      int value = 0;
+      std::from_chars(text.data(), text.data() + text.size(), value);
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseIntFromChars(benchmark::State &state) {
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto &text : intTexts()) {
+      int value = 0;
+      strings::fromChars(text.data(), text.data() + text.size(), value);
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseIntBulk(benchmark::State &state) {
+  const std::string joined = join(intTexts());
+  std::vector<int> values;
+  for (auto _ : state) {
+    values.clear();
+    strings::parseNumbers(joined, values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  perNumber(state);
+}
+
+// range(0): 0 for %.17g doubles, 1 for short ones.
+void BM_ParseDoubleStod(benchmark::State &state) {
+  for (auto _ : state) {
+    double sum = 0;
+    for (const auto &text : doubleTexts(state.range(0))) {
+      sum += std::stod(text);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseDoubleStrtod(benchmark::State &state) {
+  for (auto _ : state) {
+    double sum = 0;
+    for (const auto &text : doubleTexts(state.range(0))) {
+      sum += std::strtod(text.c_str(), nullptr);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseDoubleStream(benchmark::State &state) {
+  const std::string joined = join(doubleTexts(state.range(0)));
+  for (auto _ : state) {
+    std::istringstream in(joined);
+    double sum = 0;
+    for (double value; in >> value;) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseDoubleStdFromChars(benchmark::State &state) {
+  for (auto _ : state) {
+    double sum = 0;
+    for (const auto &text : doubleTexts(state.range(0))) {
+      double value = 0;
+      std::from_chars(text.data(), text.data() + text.size(), value);
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseDoubleFromChars(benchmark::State &state) {
+  for (auto _ : state) {
+    double sum = 0;
+    for (const auto &text : doubleTexts(state.range(0))) {
+      double value = 0;
+      strings::fromChars(text.data(), text.data() + text.size(), value);
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  perNumber(state);
+}
+
+void BM_ParseDoubleBulk(benchmark::State &state) {
+  const std::string joined = join(doubleTexts(state.range(0)));
+  std::vector<double> values;
+  for (auto _ : state) {
+    values.clear();
+    strings::parseNumbers(joined, values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  perNumber(state);
+}
+
+template <typename T> const std::vector<T> &numbers(bool short_doubles = false) {
+  if constexpr (std::is_same_v<T, int>) {
+    static const auto ints = makeInts();
+    return ints;
+  } else {
+    static const auto doubles = makeDoubles();
+    static const auto short_doubles_ = makeShortDoubles();
+    return short_doubles ? short_doubles_ : doubles;
+  }
+}
+
+template <typename T> void BM_FormatToString(benchmark::State &state) {
+  for (auto _ : state) {
+    std::size_t total = 0;
+    for (const T value : numbers<T>(state.range(0))) {
+      total += std::to_string(value).size();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  perNumber(state);
+}
+
+// max_digits10, so that the doubles come back, as toChars() guarantees.
+template <typename T> void BM_FormatStream(benchmark::State &state) {
+  for (auto _ : state) {
+    std::ostringstream out;
+    out.precision(std::numeric_limits<T>::max_digits10);
+    for (const T value : numbers<T>(state.range(0))) {
+      out << value << ' ';
+    }
+    benchmark::DoNotOptimize(out.str().size());
+  }
+  perNumber(state);
+}
+
+template <typename T> void BM_FormatStdToChars(benchmark::State &state) {
+  char buffer[strings::max_chars<T>];
+  for (auto _ : state) {
+    std::size_t total = 0;
+    for (const T value : numbers<T>(state.range(0))) {
+      total += static_cast<std::size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr -
+                                        buffer);
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  perNumber(state);
+}
+
+template <typename T> void BM_FormatToChars(benchmark::State &state) {
+  char buffer[strings::max_chars<T>];
+  for (auto _ : state) {
+    std::size_t total = 0;
+    for (const T value : numbers<T>(state.range(0))) {
+      total += static_cast<std::size_t>(
+          strings::toChars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  perNumber(state);
+}
+
+template <typename T> void BM_FormatBulk(benchmark::State &state) {
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    strings::formatNumbers<T>(numbers<T>(state.range(0)), out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  perNumber(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_ParseIntStoi);
+BENCHMARK(BM_ParseIntStream);
+BENCHMARK(BM_ParseIntStdFromChars);
+BENCHMARK(BM_ParseIntFromChars);
+BENCHMARK(BM_ParseIntBulk);
+
+BENCHMARK(BM_ParseDoubleStod)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDoubleStrtod)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDoubleStream)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDoubleStdFromChars)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDoubleFromChars)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDoubleBulk)->Arg(0)->Arg(1);
+
+BENCHMARK_TEMPLATE(BM_FormatToString, int)->Arg(0);
+BENCHMARK_TEMPLATE(BM_FormatStream, int)->Arg(0);
+BENCHMARK_TEMPLATE(BM_FormatStdToChars, int)->Arg(0);
+BENCHMARK_TEMPLATE(BM_FormatToChars, int)->Arg(0);
+BENCHMARK_TEMPLATE(BM_FormatBulk, int)->Arg(0);
+
+BENCHMARK_TEMPLATE(BM_FormatToString, double)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_FormatStream, double)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_FormatStdToChars, double)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_FormatToChars, double)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_FormatBulk, double)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
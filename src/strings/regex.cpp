@@ -0,0 +1,128 @@
+#include "strings/regex.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// regex_mathch_search.cpp's findFileWithRegexPattern(), with the pattern
+// compiled once to a DFA.
+std::optional<std::filesystem::path> findFileWithRegexPattern(const std::filesystem::path &dir,
+                                                              const strings::regex &regex) {
+  for (const auto &entry : std::filesystem::directory_iterator{dir}) {
+    if (entry.is_regular_file() && regex.match(entry.path().filename().string())) {
+      return entry.path();
+    }
+  }
+  return std::nullopt;
+}
+
+void findFile() {
+  std::cout << "-------- findFileWithRegexPattern() --------" << std::endl;
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "regex_example";
+  std::filesystem::create_directories(dir);
+  for (const char *name : {"notes.txt", "00000-2023-02-23_16-13-23.ulg_06531353AC6AFC26.hash",
+                           "00000-2023-02-23_16-13-23.ulg"}) {
+    std::ofstream(dir / name) << name;
+  }
+  const strings::regex hash_file(
+      "\\d{5}-\\d{4}-\\d{2}-\\d{2}_\\d{2}-\\d{2}-\\d{2}\\.ulg_[A-F0-9]*\\.hash");
+  if (const auto path = findFileWithRegexPattern(dir, hash_file)) {
+    std::cout << "found " << path->filename() << std::endl;
+  }
+  std::filesystem::remove_all(dir);
+}
+
+// vectorFindingRegex() copied the regex and the vector, and searched each
+// item twice. One search per item, on the caller's vector.
+void vectorFinding() {
+  std::cout << "-------- vectorFindingRegex() --------" << std::endl;
+  const strings::regex filename_regex("[0-5]+([a-z][A-Z])*");
+  const std::vector<std::string> file_names = {"eybI7", "3bghIU", "kINgtd", "9wpmdcI"};
+  const auto it = std::find_if(file_names.begin(), file_names.end(), [&](const std::string &name) {
+    return filename_regex.search(name);
+  });
+  if (it != file_names.end()) {
+    std::cout << "The first valid regex is " << *it
+              << " and the index is: " << it - file_names.begin() << std::endl;
+  }
+  std::cout << "DFA states built: " << filename_regex.cachedStates() << std::endl;
+}
+
+// No capture groups in a DFA: find() the match, then let std::regex take
+// the group out of those few bytes only.
+void findAndCapture() {
+  std::cout << "-------- find() and a capture group --------" << std::endl;
+  const std::string path = "/home/toto/FILE_mysymbol_EVENT.DAT";
+  const strings::regex event("FILE_\\w+_EVENT\\.DAT");
+  if (const auto match = event.find(path)) {
+    std::cout << "match: " << *match << " at " << match->data() - path.data() << std::endl;
+    std::cmatch groups;
+    if (std::regex_match(match->data(), match->data() + match->size(), groups,
+                         std::regex("FILE_(\\w+)_EVENT\\.DAT"))) {
+      std::cout << "symbol: " << groups[1] << std::endl;
+    }
+  }
+  // Leftmost, then longest: [0-9]+ takes all the digits, "a|ab" both letters.
+  std::cout << *strings::regex("[0-9]+").find("abc 12345 678") << ", "
+            << *strings::regex("a|ab").find("xaby") << std::endl;
+}
+
+// The DFA built by the compiler: checked by static_assert, no setup at run
+// time.
+using ulg_file = strings::static_regex<"\\d{5}-\\d{4}-\\d{2}-\\d{2}_\\d{2}-\\d{2}-\\d{2}\\.ulg.*">;
+static_assert(ulg_file::match("00000-2023-02-23_16-13-23.ulg"));
+static_assert(!ulg_file::match("0000-2023-02-23_16-13-23.ulg"));
+
+void staticRegex() {
+  std::cout << "-------- static_regex --------" << std::endl;
+  for (const char *name : {"00000-2023-02-23_16-13-23.ulg_06531353.hash", "notes.txt"}) {
+    std::cout << name << ": " << (ulg_file::match(name) ? "log" : "not a log") << std::endl;
+  }
+}
+
+// Lines of a service log that mention a slow request, and every request id
+// in it: the buffer is read in one sweep, without a std::string per line.
+void grepLog() {
+  std::cout << "-------- forEachMatchingLine() and forEachMatch() --------" << std::endl;
+  const std::string log = "12:00:01 INFO request id=17 latency=12ms\n"
+                          "12:00:02 WARN request id=18 latency=2150ms\n"
+                          "12:00:03 ERROR request id=19 latency=5003ms upstream timeout\n"
+                          "12:00:04 INFO request id=20 latency=40ms\n";
+  const strings::regex slow("latency=[0-9]{4,}ms");
+  const std::size_t lines = slow.forEachMatchingLine(
+      log, [](std::string_view line) { std::cout << "slow: " << line << std::endl; });
+  std::cout << lines << " slow requests, ids:";
+  strings::regex("id=[0-9]+").forEachMatch(log, [](std::string_view id) {
+    std::cout << " " << id.substr(3);
+  });
+  std::cout << std::endl;
+}
+
+// What a DFA cannot do is an error when the regex is made, not a wrong
+// answer later.
+void errors() {
+  std::cout << "-------- errors --------" << std::endl;
+  for (const char *pattern : {"(a)\\1", "\\bword\\b", "a**", "[z-a]"}) {
+    try {
+      strings::regex{pattern};
+    } catch (const std::invalid_argument &e) {
+      std::cout << e.what() << std::endl;
+    }
+  }
+}
+
+int main() {
+  findFile();
+  vectorFinding();
+  findAndCapture();
+  staticRegex();
+  grepLog();
+  errors();
+}
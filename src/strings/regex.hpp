@@ -0,0 +1,1118 @@
+#ifndef REGEX_HPP
+#define REGEX_HPP
+
+#include "containers/flat_hash_map.hpp"
+#include "hashing.hpp"
+#include "strings/strings.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// Regular expressions compiled to a DFA, for matching many strings or a
+/// large buffer fast.
+///
+/// std::regex is a backtracking matcher that interprets its pattern one
+/// node at a time: every char costs a handful of virtual-looking dispatches
+/// and a pattern like (a*)*b can take exponential time. A DFA reads each
+/// byte of the text exactly once, with one table lookup.
+///
+/// - regex: the pattern is parsed into an NFA (Thompson's construction)
+///   and the DFA is built lazily while matching: a DFA state is the set of
+///   NFA states that the text read so far can be in, created the first
+///   time a (state, byte) transition is taken and cached in a table. Text
+///   like the text already seen runs on the cached table only. Bytes that
+///   no part of the pattern tells apart share a column of the table (byte
+///   classes), so [a-z]+ has 3 columns, not 256. The cache, with the NFA
+///   state sets of the states, is bounded to about 4 MB per DFA (a regex
+///   has three); when full it is dropped and rebuilt, so a pathological
+///   pattern runs at NFA speed instead of taking all the memory.
+/// - static_regex<"pattern">: the whole DFA built by the compiler, in
+///   constexpr, stored as constant tables. Usable in constant expressions
+///   too; a bad pattern is a compile error.
+///
+/// match() is std::regex_match (the whole text), search() is
+/// std::regex_search without results (any substring), find() returns the
+/// leftmost-longest match as a string_view, forEachMatch() all of them in
+/// one pass over the text, and forEachMatchingLine() is grep over a buffer:
+/// one sweep, the DFA restarted at each line.
+///
+/// Syntax, a subset of ECMAScript (std::regex's default): literals, '.'
+/// (any byte but \n and \r), [...] and [^...] with ranges, \d \w \s \D \W
+/// \S, \t \n \r \f \v \0 \xHH, escaped punctuation, (...) and (?:...), |,
+/// the quantifiers * + ? {n} {n,} {n,m} (a lazy '?' after them is accepted;
+/// it changes nothing for a DFA), ^ at the very start and $ at the very
+/// end. There are no capture groups, backreferences, lookarounds or \b:
+/// they are what a DFA cannot do. To extract a group, find() the match and
+/// run std::regex on that short string_view only. Matching is on bytes:
+/// UTF-8 text works, but '.' and classes see single bytes.
+///
+/// A regex is not thread-safe, even through const: its DFA grows as it
+/// matches. Give each thread its own copy.
+///
+
+namespace strings {
+
+namespace detail {
+
+/// A set of bytes, usable in constexpr.
+struct byte_set {
+  std::array<std::uint64_t, 4> bits{};
+
+  constexpr void add(unsigned char c) { bits[c >> 6] |= std::uint64_t{1} << (c & 63); }
+  constexpr void addRange(unsigned char first, unsigned char last) {
+    for (unsigned c = first; c <= last; ++c) {
+      add(static_cast<unsigned char>(c));
+    }
+  }
+  constexpr void addAll(const byte_set &other) {
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+      bits[i] |= other.bits[i];
+    }
+  }
+  constexpr void invert() {
+    for (std::uint64_t &word : bits) {
+      word = ~word;
+    }
+  }
+  constexpr bool contains(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+  constexpr int count() const {
+    int n = 0;
+    for (const std::uint64_t word : bits) {
+      n += std::popcount(word);
+    }
+    return n;
+  }
+};
+
+enum class nfa_op : std::uint8_t {
+  bytes, // one byte of sets[set], then out
+  split, // out and out1, without reading
+  jump,  // out, without reading
+  text_begin, // out, where the scan starts: ^, or $ reversed
+  text_end,   // out, where the scan ends: $, or ^ reversed
+  match,
+};
+
+struct nfa_state {
+  nfa_op op = nfa_op::jump;
+  int set = -1;
+  int out = -1;
+  int out1 = -1;
+};
+
+struct nfa {
+  std::vector<nfa_state> states;
+  std::vector<byte_set> sets;
+  int start = -1;
+};
+
+// Larger patterns, mostly from counted repetition like (...){1000}, throw.
+inline constexpr std::size_t max_nfa_states = 20000;
+
+[[noreturn]] inline void regexError(std::string_view pattern, std::size_t position,
+                                    const char *what) {
+  throw std::invalid_argument("strings::regex: " + std::string(what) + " at " +
+                              std::to_string(position) + " in \"" + std::string(pattern) +
+                              "\"");
+}
+
+/// Thompson's construction by recursive descent. Counted repetition parses
+/// its atom again for each copy, so no syntax tree is needed. With
+/// `reverse` the NFA matches the reversed strings: find() runs it backward
+/// to learn where matches start.
+class regex_compiler {
+public:
+  constexpr regex_compiler(std::string_view pattern, bool reverse)
+      : m_pattern(pattern), m_reverse(reverse) {}
+
+  constexpr nfa compile() {
+    fragment body = alternation();
+    if (m_pos != m_pattern.size()) {
+      regexError(m_pattern, m_pos, "unmatched ')'");
+    }
+    patch(body.outs, add({nfa_op::match}));
+    m_nfa.start = body.start;
+    return std::move(m_nfa);
+  }
+
+private:
+  // A piece of NFA: its entry state and its dangling exits, each encoded as
+  // state * 2 + (0 for out, 1 for out1).
+  struct fragment {
+    int start = -1;
+    std::vector<int> outs;
+  };
+
+  constexpr bool peek(char c) const { return m_pos < m_pattern.size() && m_pattern[m_pos] == c; }
+
+  constexpr int add(nfa_state state) {
+    if (m_nfa.states.size() >= max_nfa_states) {
+      regexError(m_pattern, m_pos, "pattern too large");
+    }
+    m_nfa.states.push_back(state);
+    return static_cast<int>(m_nfa.states.size() - 1);
+  }
+
+  constexpr void patch(const std::vector<int> &outs, int target) {
+    for (const int out : outs) {
+      nfa_state &state = m_nfa.states[static_cast<std::size_t>(out >> 1)];
+      (out & 1 ? state.out1 : state.out) = target;
+    }
+  }
+
+  constexpr fragment bytes(const byte_set &set) {
+    m_nfa.sets.push_back(set);
+    const int s = add({nfa_op::bytes, static_cast<int>(m_nfa.sets.size() - 1)});
+    return {s, {s * 2}};
+  }
+
+  constexpr fragment empty() {
+    const int s = add({nfa_op::jump});
+    return {s, {s * 2}};
+  }
+
+  constexpr fragment concat(fragment first, fragment second) {
+    if (m_reverse) {
+      std::swap(first, second);
+    }
+    patch(first.outs, second.start);
+    return {first.start, std::move(second.outs)};
+  }
+
+  constexpr fragment alternate(fragment a, fragment b) {
+    const int s = add({nfa_op::split, -1, a.start, b.start});
+    a.outs.insert(a.outs.end(), b.outs.begin(), b.outs.end());
+    return {s, std::move(a.outs)};
+  }
+
+  constexpr fragment star(fragment a) {
+    const int s = add({nfa_op::split, -1, a.start});
+    patch(a.outs, s);
+    return {s, {s * 2 + 1}};
+  }
+
+  constexpr fragment plus(fragment a) {
+    const int s = add({nfa_op::split, -1, a.start});
+    patch(a.outs, s);
+    return {a.start, {s * 2 + 1}};
+  }
+
+  constexpr fragment optional(fragment a) {
+    const int s = add({nfa_op::split, -1, a.start});
+    a.outs.push_back(s * 2 + 1);
+    return {s, std::move(a.outs)};
+  }
+
+  constexpr fragment alternation() {
+    fragment f = sequence();
+    while (peek('|')) {
+      ++m_pos;
+      f = alternate(std::move(f), sequence());
+    }
+    return f;
+  }
+
+  // Appends `part` to `f`, which may still be unset (start -1).
+  constexpr void append(fragment &f, fragment part) {
+    if (f.start < 0) {
+      f = std::move(part);
+    } else {
+      f = concat(std::move(f), std::move(part));
+    }
+  }
+
+  constexpr fragment sequence() {
+    fragment f;
+    while (m_pos < m_pattern.size() && m_pattern[m_pos] != '|' && m_pattern[m_pos] != ')') {
+      append(f, repeat());
+    }
+    if (f.start < 0) {
+      return empty();
+    }
+    return f;
+  }
+
+  constexpr bool isQuantifier() const {
+    return peek('*') || peek('+') || peek('?') || (peek('{') && m_pos + 1 < m_pattern.size() &&
+                                                   m_pattern[m_pos + 1] >= '0' &&
+                                                   m_pattern[m_pos + 1] <= '9');
+  }
+
+  constexpr int number() {
+    int n = 0;
+    const std::size_t begin = m_pos;
+    while (m_pos < m_pattern.size() && m_pattern[m_pos] >= '0' && m_pattern[m_pos] <= '9') {
+      n = n * 10 + (m_pattern[m_pos++] - '0');
+      if (n > 1000) {
+        regexError(m_pattern, begin, "repetition count above 1000");
+      }
+    }
+    if (m_pos == begin) {
+      regexError(m_pattern, begin, "expected a number");
+    }
+    return n;
+  }
+
+  constexpr fragment repeat() {
+    const std::size_t atom_begin = m_pos;
+    fragment f = atom();
+    if (m_pattern[atom_begin] == '^' || m_pattern[atom_begin] == '$' || !isQuantifier()) {
+      return f;
+    }
+    int min = 0;
+    int max = -1; // unbounded
+    const std::size_t quantifier = m_pos;
+    switch (m_pattern[m_pos++]) {
+    case '*':
+      break;
+    case '+':
+      min = 1;
+      break;
+    case '?':
+      max = 1;
+      break;
+    default: // {n}, {n,} or {n,m}
+      min = max = number();
+      if (peek(',')) {
+        ++m_pos;
+        max = peek('}') ? -1 : number();
+      }
+      if (!peek('}')) {
+        regexError(m_pattern, m_pos, "missing '}'");
+      }
+      ++m_pos;
+      if (max != -1 && max < min) {
+        regexError(m_pattern, quantifier, "repetition range out of order");
+      }
+    }
+    if (peek('?')) {
+      ++m_pos;
+    }
+    if (isQuantifier()) {
+      regexError(m_pattern, m_pos, "nothing to repeat");
+    }
+    return counted(std::move(f), atom_begin, min, max);
+  }
+
+  // min copies of the atom, then a star or (max - min) optional copies.
+  constexpr fragment counted(fragment f, std::size_t atom_begin, int min, int max) {
+    if (max == -1 && min == 0) {
+      return star(std::move(f));
+    }
+    if (max == -1 && min == 1) {
+      return plus(std::move(f));
+    }
+    if (min == 0 && max == 1) {
+      return optional(std::move(f));
+    }
+    const std::size_t after = m_pos;
+    bool first_used = false;
+    auto copy = [&] {
+      if (!first_used) {
+        first_used = true;
+        return std::move(f);
+      }
+      m_pos = atom_begin;
+      return atom();
+    };
+    fragment result;
+    for (int i = 0; i < min; ++i) {
+      append(result, copy());
+    }
+    if (max == -1) {
+      append(result, star(copy()));
+    }
+    for (int i = min; i < max; ++i) {
+      append(result, optional(copy()));
+    }
+    m_pos = after;
+    if (result.start < 0) {
+      return empty();
+    }
+    return result;
+  }
+
+  constexpr fragment atom() {
+    const std::size_t begin = m_pos;
+    const char c = m_pattern[m_pos++];
+    switch (c) {
+    case '(': {
+      if (peek('?')) {
+        if (m_pos + 1 >= m_pattern.size() || m_pattern[m_pos + 1] != ':') {
+          regexError(m_pattern, begin, "only (?: groups are supported");
+        }
+        m_pos += 2;
+      }
+      fragment f = alternation();
+      if (!peek(')')) {
+        regexError(m_pattern, begin, "missing ')'");
+      }
+      ++m_pos;
+      return f;
+    }
+    case '[':
+      return bytes(charClass(begin));
+    case '.': {
+      byte_set any;
+      any.add('\n');
+      any.add('\r');
+      any.invert();
+      return bytes(any);
+    }
+    case '\\':
+      return bytes(escape());
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+      regexError(m_pattern, begin, "nothing to repeat");
+    case '^':
+    case '$': {
+      const int s = add({(c == '^') != m_reverse ? nfa_op::text_begin : nfa_op::text_end});
+      return {s, {s * 2}};
+    }
+    default: {
+      byte_set literal;
+      literal.add(static_cast<unsigned char>(c));
+      return bytes(literal);
+    }
+    }
+  }
+
+  // After a backslash, in or out of [...].
+  constexpr byte_set escape() {
+    if (m_pos == m_pattern.size()) {
+      regexError(m_pattern, m_pos, "trailing backslash");
+    }
+    const std::size_t begin = m_pos - 1;
+    const char c = m_pattern[m_pos++];
+    byte_set set;
+    switch (c) {
+    case 'd':
+    case 'D':
+      set.addRange('0', '9');
+      break;
+    case 'w':
+    case 'W':
+      set.addRange('a', 'z');
+      set.addRange('A', 'Z');
+      set.addRange('0', '9');
+      set.add('_');
+      break;
+    case 's':
+    case 'S':
+      for (const char space : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+        set.add(static_cast<unsigned char>(space));
+      }
+      break;
+    case 't':
+      set.add('\t');
+      break;
+    case 'n':
+      set.add('\n');
+      break;
+    case 'r':
+      set.add('\r');
+      break;
+    case 'f':
+      set.add('\f');
+      break;
+    case 'v':
+      set.add('\v');
+      break;
+    case '0':
+      set.add('\0');
+      break;
+    case 'x': {
+      int value = 0;
+      for (int i = 0; i < 2; ++i) {
+        const char h = m_pos < m_pattern.size() ? m_pattern[m_pos++] : '\0';
+        const int digit = h >= '0' && h <= '9'   ? h - '0'
+                          : h >= 'a' && h <= 'f' ? h - 'a' + 10
+                          : h >= 'A' && h <= 'F' ? h - 'A' + 10
+                                                 : -1;
+        if (digit < 0) {
+          regexError(m_pattern, begin, "\\x needs two hex digits");
+        }
+        value = value * 16 + digit;
+      }
+      set.add(static_cast<unsigned char>(value));
+      break;
+    }
+    default:
+      if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+        regexError(m_pattern, begin, "unsupported escape");
+      }
+      set.add(static_cast<unsigned char>(c));
+    }
+    if (c == 'D' || c == 'W' || c == 'S') {
+      set.invert();
+    }
+    return set;
+  }
+
+  // One byte of a [...] item, or -1 with `set` filled for \d and the like.
+  constexpr int classItem(byte_set &set) {
+    if (m_pattern[m_pos] != '\\') {
+      return static_cast<unsigned char>(m_pattern[m_pos++]);
+    }
+    ++m_pos;
+    set = escape();
+    if (set.count() != 1) {
+      return -1;
+    }
+    int c = 0;
+    while (!set.contains(static_cast<unsigned char>(c))) {
+      ++c;
+    }
+    return c;
+  }
+
+  constexpr byte_set charClass(std::size_t begin) {
+    byte_set set;
+    const bool negate = peek('^');
+    if (negate) {
+      ++m_pos;
+    }
+    for (bool first = true;; first = false) {
+      if (m_pos == m_pattern.size()) {
+        regexError(m_pattern, begin, "missing ']'");
+      }
+      if (m_pattern[m_pos] == ']' && !first) {
+        ++m_pos;
+        break;
+      }
+      byte_set item;
+      const int low = classItem(item);
+      if (low >= 0 && m_pos + 1 < m_pattern.size() && m_pattern[m_pos] == '-' &&
+          m_pattern[m_pos + 1] != ']') {
+        ++m_pos;
+        byte_set ignored;
+        const int high = classItem(ignored);
+        if (high < low) {
+          regexError(m_pattern, m_pos - 1, "bad range in [...]");
+        }
+        set.addRange(static_cast<unsigned char>(low), static_cast<unsigned char>(high));
+      } else if (low >= 0) {
+        set.add(static_cast<unsigned char>(low));
+      } else {
+        set.addAll(item);
+      }
+    }
+    if (negate) {
+      set.invert();
+    }
+    return set;
+  }
+
+  std::string_view m_pattern;
+  std::size_t m_pos = 0;
+  bool m_reverse;
+  nfa m_nfa;
+};
+
+/// Bytes that no set of the NFA tells apart form one class; the DFA has a
+/// column per class. Classes are runs of consecutive bytes.
+struct byte_classes {
+  std::array<std::uint8_t, 256> of{};
+  std::array<std::uint8_t, 256> first{}; // a byte of each class
+  int count = 0;
+};
+
+constexpr byte_classes classify(const nfa &n) {
+  byte_classes classes;
+  int current = 0;
+  for (int b = 1; b < 256; ++b) {
+    const auto byte = static_cast<unsigned char>(b);
+    const auto previous = static_cast<unsigned char>(b - 1);
+    if (std::any_of(n.sets.begin(), n.sets.end(), [&](const byte_set &set) {
+          return set.contains(byte) != set.contains(previous);
+        })) {
+      classes.first[static_cast<std::size_t>(++current)] = byte;
+    }
+    classes.of[byte] = static_cast<std::uint8_t>(current);
+  }
+  classes.count = current + 1;
+  return classes;
+}
+
+// Adds to `set` the states reachable from `root` without reading that read
+// a byte, match, or wait for the end of the text. ^ is passed only at the
+// start of the text and $ only at the end.
+constexpr void closure(const nfa &n, int root, bool at_begin, bool at_end, std::vector<char> &seen,
+                       std::vector<int> &set) {
+  std::vector<int> stack{root};
+  while (!stack.empty()) {
+    const int s = stack.back();
+    stack.pop_back();
+    if (s < 0 || seen[static_cast<std::size_t>(s)]) {
+      continue;
+    }
+    seen[static_cast<std::size_t>(s)] = 1;
+    const nfa_state &state = n.states[static_cast<std::size_t>(s)];
+    switch (state.op) {
+    case nfa_op::split:
+      stack.push_back(state.out1);
+      stack.push_back(state.out);
+      break;
+    case nfa_op::jump:
+      stack.push_back(state.out);
+      break;
+    case nfa_op::text_begin:
+      if (at_begin) {
+        stack.push_back(state.out);
+      }
+      break;
+    case nfa_op::text_end:
+      if (at_end) {
+        stack.push_back(state.out);
+      } else {
+        set.push_back(s);
+      }
+      break;
+    default:
+      set.push_back(s);
+    }
+  }
+}
+
+/// The DFA state to start from, at the start of the text or later (where ^
+/// fails): sorted NFA states.
+constexpr std::vector<int> startSet(const nfa &n, bool at_begin) {
+  std::vector<char> seen(n.states.size());
+  std::vector<int> set;
+  closure(n, n.start, at_begin, false, seen, set);
+  std::sort(set.begin(), set.end());
+  return set;
+}
+
+/// The DFA state after reading `byte` in `from`. Unanchored, a match may
+/// also begin at the next byte: the start states are added back.
+constexpr std::vector<int> step(const nfa &n, std::span<const int> from, unsigned char byte,
+                                bool unanchored) {
+  std::vector<char> seen(n.states.size());
+  std::vector<int> set;
+  for (const int s : from) {
+    const nfa_state &state = n.states[static_cast<std::size_t>(s)];
+    if (state.op == nfa_op::bytes && n.sets[static_cast<std::size_t>(state.set)].contains(byte)) {
+      closure(n, state.out, false, false, seen, set);
+    }
+  }
+  if (unanchored) {
+    closure(n, n.start, false, false, seen, set);
+  }
+  std::sort(set.begin(), set.end());
+  return set;
+}
+
+constexpr bool accepts(const nfa &n, const std::vector<int> &set) {
+  return std::any_of(set.begin(), set.end(), [&](int s) {
+    return n.states[static_cast<std::size_t>(s)].op == nfa_op::match;
+  });
+}
+
+/// Whether the text read so far matches if it ends here: $ passes.
+constexpr bool acceptsAtEnd(const nfa &n, const std::vector<int> &set) {
+  std::vector<char> seen(n.states.size());
+  std::vector<int> reached;
+  for (const int s : set) {
+    closure(n, s, false, true, seen, reached);
+  }
+  return accepts(n, reached);
+}
+
+/// The bytes a match can begin with after the first byte of the text, when
+/// there are few enough to look for with SIMD. Where no DFA thread is alive
+/// but the start, search() skips to the next of them instead of running
+/// the DFA over bytes that only lead back to the start.
+constexpr std::optional<char_set> firstBytes(const nfa &n) {
+  byte_set first;
+  for (const int s : startSet(n, false)) {
+    const nfa_state &state = n.states[static_cast<std::size_t>(s)];
+    if (state.op != nfa_op::bytes) {
+      return std::nullopt; // matches without reading
+    }
+    first.addAll(n.sets[static_cast<std::size_t>(state.set)]);
+  }
+  if (first.count() == 0 || first.count() > static_cast<int>(char_set::max_simd_size)) {
+    return std::nullopt;
+  }
+  std::array<char, char_set::max_simd_size> chars{};
+  std::size_t size = 0;
+  for (int c = 0; c < 256; ++c) {
+    if (first.contains(static_cast<unsigned char>(c))) {
+      chars[size++] = static_cast<char>(c);
+    }
+  }
+  return char_set(std::string_view(chars.data(), size));
+}
+
+/// The DFA, built while matching. A state is the offset of its row in the
+/// transition table: a column per byte class holding the next state (-1
+/// until computed), then a column of flags, so that reading a byte is one
+/// load and checking for a match another from the same row. Row 0 is the
+/// dead state (no match can follow), row 1 the start at the beginning of
+/// the text.
+class lazy_dfa {
+public:
+  static constexpr int dead = 0;
+
+  lazy_dfa() = default;
+  lazy_dfa(nfa program, const byte_classes &classes, bool unanchored)
+      : m_nfa(std::move(program)), m_classes(classes), m_unanchored(unanchored),
+        m_stride(m_classes.count + 1) {
+    reset();
+  }
+
+  int start() const noexcept { return m_stride; }
+  /// The start state for a match that begins after the first byte.
+  int startInside() const noexcept { return m_start_inside; }
+
+  /// A match ends at the byte just read.
+  bool accepting(int s) const noexcept { return flags(s) & 1; }
+  /// A match ends here if the text does.
+  bool acceptingAtEnd(int s) const noexcept { return flags(s) & 2; }
+
+  int next(int s, char c) {
+    const auto byte = static_cast<unsigned char>(c);
+    const int n = m_next[static_cast<std::size_t>(s) + m_classes.of[byte]];
+    return n >= 0 ? n : add(s, byte);
+  }
+
+  std::size_t states() const noexcept { return m_same_hash.size(); }
+
+private:
+  // What the cache may hold before it is dropped: the transition table, the
+  // NFA state set of every DFA state and the index over the sets, 4 MB in
+  // all. A regex has three of these.
+  static constexpr std::size_t cache_bytes = std::size_t{4} << 20;
+  // Per DFA state besides its row and its set: where the set begins, the
+  // link to the previous state with the same hash and a slot in m_ids, which
+  // is at least half full.
+  static constexpr std::size_t state_bytes =
+      sizeof(std::size_t) + sizeof(int) + 2 * sizeof(std::pair<std::uint64_t, int>);
+
+  int flags(int s) const noexcept {
+    return m_next[static_cast<std::size_t>(s) + static_cast<std::size_t>(m_classes.count)];
+  }
+
+  std::span<const int> setOf(std::size_t state) const noexcept {
+    return std::span<const int>(m_set_items).subspan(
+        m_set_begin[state], m_set_begin[state + 1] - m_set_begin[state]);
+  }
+
+  std::size_t cacheBytes() const noexcept {
+    return (m_next.size() + m_set_items.size()) * sizeof(int) + states() * state_bytes;
+  }
+
+  static std::uint64_t hashOf(const std::vector<int> &set) noexcept {
+    return hashing::hashBytes(set.data(), set.size() * sizeof(int));
+  }
+
+  void reset() {
+    m_set_items.clear();
+    m_set_begin.assign(1, 0);
+    m_same_hash.clear();
+    m_ids.clear();
+    m_next.clear();
+    intern({});
+    intern(startSet(m_nfa, true));
+    m_start_inside = intern(startSet(m_nfa, false));
+  }
+
+  // The state whose set is `set`, or -1.
+  int find(const std::vector<int> &set, std::uint64_t hash) const {
+    const auto it = m_ids.find(hash);
+    for (int i = it == m_ids.end() ? -1 : it->second; i >= 0;
+         i = m_same_hash[static_cast<std::size_t>(i)]) {
+      if (std::ranges::equal(setOf(static_cast<std::size_t>(i)), set)) {
+        return i * m_stride;
+      }
+    }
+    return -1;
+  }
+
+  // Adds the state; its set must not have one yet.
+  int insert(const std::vector<int> &set, std::uint64_t hash) {
+    const int id = static_cast<int>(states());
+    const auto [it, inserted] = m_ids.try_emplace(hash, -1);
+    m_same_hash.push_back(it->second);
+    it->second = id;
+    m_set_items.insert(m_set_items.end(), set.begin(), set.end());
+    m_set_begin.push_back(m_set_items.size());
+    m_next.resize(m_next.size() + static_cast<std::size_t>(m_classes.count), -1);
+    m_next.push_back(accepts(m_nfa, set) | acceptsAtEnd(m_nfa, set) << 1);
+    return id * m_stride;
+  }
+
+  int intern(const std::vector<int> &set) {
+    const std::uint64_t hash = hashOf(set);
+    const int s = find(set, hash);
+    return s >= 0 ? s : insert(set, hash);
+  }
+
+  int add(int from, unsigned char byte) {
+    const std::vector<int> set =
+        step(m_nfa, setOf(static_cast<std::size_t>(from / m_stride)), byte, m_unanchored);
+    const std::uint64_t hash = hashOf(set);
+    int to = find(set, hash);
+    if (to < 0) {
+      const std::size_t added =
+          (set.size() + static_cast<std::size_t>(m_stride)) * sizeof(int) + state_bytes;
+      if (cacheBytes() + added > cache_bytes) {
+        // `from` is gone with the cache; only the state returned is needed.
+        reset();
+        return intern(set);
+      }
+      to = insert(set, hash);
+    }
+    m_next[static_cast<std::size_t>(from) + m_classes.of[byte]] = to;
+    return to;
+  }
+
+  nfa m_nfa;
+  byte_classes m_classes;
+  bool m_unanchored = false;
+  int m_stride = 0;
+  int m_start_inside = 0;
+  // The NFA state sets of all DFA states, each stored once, one after the
+  // other: state i has m_set_items[m_set_begin[i], m_set_begin[i + 1]).
+  std::vector<int> m_set_items;
+  std::vector<std::size_t> m_set_begin;
+  // Hash of a set -> the last state added with that hash; m_same_hash[i] is
+  // the state added before i with the same hash, or -1.
+  containers::flat_hash_map<std::uint64_t, int> m_ids;
+  std::vector<int> m_same_hash;
+  std::vector<int> m_next;
+};
+
+} // namespace detail
+
+class regex {
+public:
+  explicit regex(std::string_view pattern) : m_pattern(pattern) {
+    detail::nfa forward = detail::regex_compiler(pattern, false).compile();
+    detail::nfa backward = detail::regex_compiler(pattern, true).compile();
+    const detail::byte_classes classes = detail::classify(forward);
+    m_first_bytes = detail::firstBytes(forward);
+    m_anchored = detail::lazy_dfa(forward, classes, false);
+    m_searching = detail::lazy_dfa(std::move(forward), classes, true);
+    m_reverse = detail::lazy_dfa(std::move(backward), classes, true);
+  }
+
+  const std::string &pattern() const noexcept { return m_pattern; }
+
+  /// True if the pattern matches all of `text`, like std::regex_match.
+  bool match(std::string_view text) const {
+    int s = m_anchored.start();
+    for (const char c : text) {
+      s = m_anchored.next(s, c);
+      if (s == detail::lazy_dfa::dead) {
+        return false;
+      }
+    }
+    return m_anchored.acceptingAtEnd(s);
+  }
+
+  /// True if the pattern matches some substring of `text`, like
+  /// std::regex_search. Stops at the first byte where a match ends.
+  bool search(std::string_view text) const {
+    int s = m_searching.start();
+    if (m_searching.accepting(s)) {
+      return true;
+    }
+    const int idle = m_searching.startInside();
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      if (s == idle && m_first_bytes) {
+        i = findFirstOf(text, *m_first_bytes, i);
+        if (i == npos) {
+          return false;
+        }
+      }
+      s = m_searching.next(s, text[i]);
+      if (s == detail::lazy_dfa::dead) {
+        return false;
+      }
+      if (m_searching.accepting(s)) {
+        return true;
+      }
+    }
+    return m_searching.acceptingAtEnd(s);
+  }
+
+  /// The leftmost-longest match in text[from, end), as a view into `text`.
+  /// ^ matches only at the start of `text`. Reads text[from, end) twice at
+  /// most: backward with the reversed pattern, to find where the leftmost
+  /// match starts, then forward from there, to find where it ends. For all
+  /// the matches of a long text, forEachMatch() reads it only once.
+  std::optional<std::string_view> find(std::string_view text, std::size_t from = 0) const {
+    if (from > text.size()) {
+      return std::nullopt;
+    }
+    // Every accepting position of the backward scan is the start of a
+    // match; the last one seen is the leftmost.
+    std::size_t begin = npos;
+    int s = m_reverse.start();
+    if (m_reverse.accepting(s)) {
+      begin = text.size();
+    }
+    for (std::size_t i = text.size(); i > from && s != detail::lazy_dfa::dead; --i) {
+      s = m_reverse.next(s, text[i - 1]);
+      if (m_reverse.accepting(s)) {
+        begin = i - 1;
+      }
+    }
+    if (from == 0 && m_reverse.acceptingAtEnd(s)) {
+      begin = 0;
+    }
+    if (begin == npos) {
+      return std::nullopt;
+    }
+    return text.substr(begin, matchEnd(text, begin) - begin);
+  }
+
+  /// Calls f(match) for each leftmost-longest match of `text`, left to
+  /// right and not overlapping, like std::sregex_iterator. One backward
+  /// pass marks where matches start, in a bitmap of a bit per byte; then
+  /// each match is read forward from its start. Returns the number of
+  /// matches.
+  template <typename F> std::size_t forEachMatch(std::string_view text, F &&f) const {
+    std::vector<std::uint64_t> starts(text.size() / 64 + 1);
+    auto mark = [&](std::size_t i) { starts[i / 64] |= std::uint64_t{1} << (i % 64); };
+    int s = m_reverse.start();
+    if (m_reverse.accepting(s)) {
+      mark(text.size());
+    }
+    for (std::size_t i = text.size(); i > 0 && s != detail::lazy_dfa::dead; --i) {
+      s = m_reverse.next(s, text[i - 1]);
+      if (m_reverse.accepting(s)) {
+        mark(i - 1);
+      }
+    }
+    if (m_reverse.acceptingAtEnd(s)) {
+      mark(0);
+    }
+    // The first start at or after `i`.
+    auto nextStart = [&](std::size_t i) {
+      std::size_t word = i / 64;
+      if (word >= starts.size()) {
+        return npos;
+      }
+      std::uint64_t bits = starts[word] & (~std::uint64_t{0} << (i % 64));
+      while (bits == 0) {
+        if (++word == starts.size()) {
+          return npos;
+        }
+        bits = starts[word];
+      }
+      return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+    };
+    std::size_t matches = 0;
+    for (std::size_t begin = nextStart(0); begin != npos;) {
+      const std::size_t end = matchEnd(text, begin);
+      ++matches;
+      f(text.substr(begin, end - begin));
+      // After an empty match the next one starts one byte further.
+      begin = nextStart(end == begin ? end + 1 : end);
+    }
+    return matches;
+  }
+
+  /// Calls f(line) for each '\n'-separated line of `buffer` that contains a
+  /// match (as search() would say), without the '\n'; ^ and $ are the ends
+  /// of the line. Returns the number of such lines.
+  template <typename F> std::size_t forEachMatchingLine(std::string_view buffer, F &&f) const {
+    std::size_t lines = 0;
+    for (std::size_t begin = 0; begin < buffer.size();) {
+      std::size_t end = strings::find(buffer, '\n', begin);
+      if (end == npos) {
+        end = buffer.size();
+      }
+      const std::string_view line = buffer.substr(begin, end - begin);
+      if (search(line)) {
+        ++lines;
+        f(line);
+      }
+      begin = end + 1;
+    }
+    return lines;
+  }
+
+  /// DFA states built so far, by all the functions together.
+  std::size_t cachedStates() const noexcept {
+    return m_anchored.states() + m_searching.states() + m_reverse.states();
+  }
+
+private:
+  // Where the longest match starting at `begin` ends; a match is known to
+  // start there.
+  std::size_t matchEnd(std::string_view text, std::size_t begin) const {
+    int s = begin == 0 ? m_anchored.start() : m_anchored.startInside();
+    std::size_t end = begin;
+    for (std::size_t i = begin; i < text.size() && s != detail::lazy_dfa::dead; ++i) {
+      s = m_anchored.next(s, text[i]);
+      if (m_anchored.accepting(s)) {
+        end = i + 1;
+      }
+    }
+    if (m_anchored.acceptingAtEnd(s)) {
+      end = text.size();
+    }
+    return end;
+  }
+
+  std::string m_pattern;
+  std::optional<char_set> m_first_bytes;
+  mutable detail::lazy_dfa m_anchored;  // match(), and where matches end
+  mutable detail::lazy_dfa m_searching; // search()
+  mutable detail::lazy_dfa m_reverse;   // where matches start
+};
+
+/// A pattern as a template argument: static_regex<"[0-9]+">.
+template <std::size_t N> struct pattern_string {
+  char chars[N]{};
+
+  constexpr pattern_string(const char (&text)[N]) { std::copy_n(text, N, chars); }
+  constexpr std::string_view view() const { return {chars, N - 1}; }
+};
+
+namespace detail {
+
+// More DFA states than this for a static_regex is a compile error.
+inline constexpr std::size_t max_static_states = 4096;
+
+struct dfa_tables {
+  byte_classes classes;
+  std::vector<int> next;
+  std::vector<std::uint8_t> flags; // as lazy_dfa's
+  std::size_t idle = 0;            // lazy_dfa::startInside(), if reached
+};
+
+// Subset construction of the whole DFA, in constexpr, with lazy_dfa's
+// numbering. Sets are compared one by one: fine for the few hundred states
+// of a pattern worth compiling in.
+constexpr dfa_tables buildDfa(std::string_view pattern, bool unanchored) {
+  const nfa n = regex_compiler(pattern, false).compile();
+  dfa_tables dfa{classify(n), {}, {}, max_static_states};
+  std::vector<std::vector<int>> sets{{}, startSet(n, true)};
+  for (std::size_t i = 0; i < sets.size(); ++i) {
+    dfa.flags.push_back(static_cast<std::uint8_t>(accepts(n, sets[i]) |
+                                                  acceptsAtEnd(n, sets[i]) << 1));
+    for (int c = 0; c < dfa.classes.count; ++c) {
+      std::vector<int> set;
+      if (i != 0) {
+        set = step(n, sets[i], dfa.classes.first[static_cast<std::size_t>(c)], unanchored);
+      }
+      const auto it = std::find(sets.begin(), sets.end(), set);
+      dfa.next.push_back(static_cast<int>(it - sets.begin()));
+      if (it == sets.end()) {
+        if (sets.size() == max_static_states) {
+          regexError(pattern, 0, "too many DFA states for static_regex");
+        }
+        sets.push_back(std::move(set));
+      }
+    }
+  }
+  const auto idle = std::find(sets.begin(), sets.end(), startSet(n, false));
+  if (idle != sets.end()) {
+    dfa.idle = static_cast<std::size_t>(idle - sets.begin());
+  }
+  return dfa;
+}
+
+template <std::size_t States, std::size_t Classes> struct static_dfa {
+  std::array<std::uint8_t, 256> classes{};
+  std::array<std::uint16_t, States * Classes> next{};
+  std::array<std::uint8_t, States> flags{};
+  std::size_t idle = 0;
+
+  constexpr std::size_t step(std::size_t s, char c) const {
+    return next[s * Classes + classes[static_cast<unsigned char>(c)]];
+  }
+  constexpr bool accepting(std::size_t s) const { return flags[s] & 1; }
+  constexpr bool acceptingAtEnd(std::size_t s) const { return flags[s] & 2; }
+};
+
+template <pattern_string Pattern, bool Unanchored> constexpr auto makeStaticDfa() {
+  constexpr auto size = [] {
+    const dfa_tables dfa = buildDfa(Pattern.view(), Unanchored);
+    return std::pair{dfa.flags.size(), static_cast<std::size_t>(dfa.classes.count)};
+  }();
+  const dfa_tables dfa = buildDfa(Pattern.view(), Unanchored);
+  static_dfa<size.first, size.second> result;
+  result.classes = dfa.classes.of;
+  std::copy(dfa.next.begin(), dfa.next.end(), result.next.begin());
+  std::copy(dfa.flags.begin(), dfa.flags.end(), result.flags.begin());
+  result.idle = dfa.idle;
+  return result;
+}
+
+} // namespace detail
+
+/// regex with the DFA built at compile time:
+///
+///   using log_file = strings::static_regex<"[0-9]{5}-.*\\.ulg">;
+///   static_assert(log_file::match("00000-2023.ulg"));
+///   if (log_file::search(name)) ...
+template <pattern_string Pattern> class static_regex {
+public:
+  static constexpr std::string_view pattern() { return Pattern.view(); }
+
+  static constexpr bool match(std::string_view text) noexcept {
+    std::size_t s = 1;
+    for (const char c : text) {
+      s = anchored.step(s, c);
+      if (s == 0) {
+        return false;
+      }
+    }
+    return anchored.acceptingAtEnd(s);
+  }
+
+  static constexpr bool search(std::string_view text) noexcept {
+    std::size_t s = 1;
+    if (searching.accepting(s)) {
+      return true;
+    }
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      if constexpr (first_bytes.has_value()) {
+        if (s == searching.idle && !std::is_constant_evaluated()) {
+          i = findFirstOf(text, *first_bytes, i);
+          if (i == npos) {
+            return false;
+          }
+        }
+      }
+      s = searching.step(s, text[i]);
+      if (s == 0) {
+        return false;
+      }
+      if (searching.accepting(s)) {
+        return true;
+      }
+    }
+    return searching.acceptingAtEnd(s);
+  }
+
+private:
+  static constexpr std::optional<char_set> first_bytes =
+      detail::firstBytes(detail::regex_compiler(Pattern.view(), false).compile());
+  static constexpr auto anchored = detail::makeStaticDfa<Pattern, false>();
+  static constexpr auto searching = detail::makeStaticDfa<Pattern, true>();
+};
+
+} // namespace strings
+
+#endif
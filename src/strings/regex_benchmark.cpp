@@ -0,0 +1,301 @@
+// std::regex against strings::regex (lazy DFA) and strings::static_regex
+// (DFA built at compile time):
+// - Filename: 100k file names, half PX4 logs like regex_mathch_search.cpp's
+//   "00000-2023-02-23_16-13-23.ulg_<64 hex digits>.hash", half short
+//   names like its "3bghIU" and paths like "/home/toto/FILE_x_EVENT.DAT".
+//   The three patterns of its main(): regex_search with
+//   "[0-5]+([a-z][A-Z])*", regex_match of the .ulg hash names, and
+//   regex_search with ".*FILE_(\w+)_EVENT\.DAT.*"
+// - VectorFinding: vectorFindingRegex() as written (regex and vector
+//   copied, regex_search twice per item, printing removed) against a
+//   const& std::regex searched once and against strings::regex, to the
+//   last name
+// - LogLine: 200k service log lines of ~100 bytes, 5% ERROR, searched one
+//   by one for "ERROR.*timeout" and for slow requests,
+//   "latency=[0-9]{4,}ms"
+// - LogGrep: the same log as one buffer: std::getline on a stream plus
+//   regex_search, against regex::forEachMatchingLine()
+// - LogExtract: every "id=[0-9]+" of the buffer, std::sregex_iterator
+//   against regex::forEachMatch()
+#include "strings/regex.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A random number below n, as the unsigned that %u wants.
+unsigned roll(std::mt19937 &gen, unsigned n) { return static_cast<unsigned>(gen() % n); }
+
+constexpr std::size_t filename_count = 100'000;
+constexpr std::size_t line_count = 200'000;
+
+const std::vector<std::string> &filenames() {
+  static const std::vector<std::string> names = [] {
+    std::mt19937 gen(42);
+    const std::string alnum = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::vector<std::string> result;
+    for (std::size_t i = 0; i < filename_count; ++i) {
+      std::string name;
+      switch (i % 4) {
+      case 0:
+      case 1: {
+        char prefix[64];
+        std::snprintf(prefix, sizeof(prefix), "%05u-2023-%02u-%02u_%02u-%02u-%02u.ulg_",
+                      roll(gen, 100), 1 + roll(gen, 12), 1 + roll(gen, 28), roll(gen, 24),
+                      roll(gen, 60), roll(gen, 60));
+        name = prefix;
+        for (int k = 0; k < 64; ++k) {
+          name += "0123456789ABCDEF"[gen() % 16];
+        }
+        name += gen() % 8 ? ".hash" : ".tmp";
+        break;
+      }
+      case 2:
+        for (std::size_t k = 0, n = 5 + gen() % 3; k < n; ++k) {
+          name += alnum[gen() % alnum.size()];
+        }
+        break;
+      default:
+        name = "/home/toto/";
+        name += gen() % 2 ? "FILE_" : "DATA_";
+        for (std::size_t k = 0, n = 4 + gen() % 8; k < n; ++k) {
+          name += alnum[gen() % 26];
+        }
+        name += gen() % 2 ? "_EVENT.DAT" : "_EVENT.LOG";
+      }
+      result.push_back(std::move(name));
+    }
+    return result;
+  }();
+  return names;
+}
+
+const std::vector<std::string> &logLines() {
+  static const std::vector<std::string> lines = [] {
+    std::mt19937 gen(7);
+    const char *services[] = {"order-service", "payment", "inventory", "gateway"};
+    const char *paths[] = {"/api/v1/orders", "/api/v1/items/42", "/health", "/api/v1/pay"};
+    std::vector<std::string> result;
+    char line[256];
+    for (std::size_t i = 0; i < line_count; ++i) {
+      const unsigned level = roll(gen, 100);
+      const unsigned latency = roll(gen, 100) == 0 ? 1000 + roll(gen, 9000) : 1 + roll(gen, 400);
+      std::snprintf(line, sizeof(line),
+                    "2023-02-23 %02u:%02u:%02u.%03u %-5s [%s] request id=%u path=%s status=%u "
+                    "latency=%ums%s",
+                    roll(gen, 24), roll(gen, 60), roll(gen, 60), roll(gen, 1000),
+                    level < 80 ? "INFO" : level < 95 ? "WARN" : "ERROR", services[roll(gen, 4)],
+                    roll(gen, 1000000), paths[roll(gen, 4)], level < 95 ? 200u : 500u, latency,
+                    level >= 95 && roll(gen, 2) ? " upstream timeout" : "");
+      result.emplace_back(line);
+    }
+    return result;
+  }();
+  return lines;
+}
+
+const std::string &logBuffer() {
+  static const std::string buffer = [] {
+    std::string joined;
+    for (const std::string &line : logLines()) {
+      joined += line;
+      joined += '\n';
+    }
+    return joined;
+  }();
+  return buffer;
+}
+
+constexpr strings::pattern_string short_name = "[0-5]+([a-z][A-Z])*";
+constexpr strings::pattern_string ulg_hash =
+    "\\d{5}-\\d{4}-\\d{2}-\\d{2}_\\d{2}-\\d{2}-\\d{2}\\.ulg_[A-F0-9]*\\.hash";
+constexpr strings::pattern_string event_file = ".*FILE_(\\w+)_EVENT\\.DAT.*";
+constexpr strings::pattern_string error_timeout = "ERROR.*timeout";
+constexpr strings::pattern_string slow_request = "latency=[0-9]{4,}ms";
+
+using texts_function = const std::vector<std::string> &(*)();
+
+void perString(benchmark::State &state, std::size_t strings) {
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * strings));
+}
+
+template <strings::pattern_string Pattern, bool Match, texts_function Texts>
+void BM_StdRegex(benchmark::State &state) {
+  const std::regex regex{std::string(Pattern.view())};
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for (const std::string &text : Texts()) {
+      count += Match ? std::regex_match(text, regex) : std::regex_search(text, regex);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  perString(state, Texts().size());
+}
+
+template <strings::pattern_string Pattern, bool Match, texts_function Texts>
+void BM_Regex(benchmark::State &state) {
+  const strings::regex regex(Pattern.view());
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for (const std::string &text : Texts()) {
+      count += Match ? regex.match(text) : regex.search(text);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  perString(state, Texts().size());
+  state.counters["dfa_states"] = static_cast<double>(regex.cachedStates());
+}
+
+template <strings::pattern_string Pattern, bool Match, texts_function Texts>
+void BM_StaticRegex(benchmark::State &state) {
+  using regex = strings::static_regex<Pattern>;
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for (const std::string &text : Texts()) {
+      count += Match ? regex::match(text) : regex::search(text);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  perString(state, Texts().size());
+}
+
+// regex_mathch_search.cpp's vectorFindingRegex(), without the printing.
+template <typename T>
+typename std::vector<T>::iterator vectorFindingRegex(std::regex regex, std::vector<T> vec) {
+  return std::find_if(vec.begin(), vec.end(), [regex](T item) {
+    benchmark::DoNotOptimize(regex_search(item, regex));
+    return regex_search(item, regex);
+  });
+}
+
+// Nothing matches until the last name.
+std::vector<std::string> namesEndingInMatch() {
+  const std::regex regex(std::string(short_name.view()));
+  std::vector<std::string> names;
+  for (const std::string &name : filenames()) {
+    if (!std::regex_search(name, regex)) {
+      names.push_back(name);
+    }
+    if (names.size() == 10'000) {
+      break;
+    }
+  }
+  names.emplace_back("3bghIU");
+  return names;
+}
+
+void BM_VectorFindingAsWritten(benchmark::State &state) {
+  const std::regex regex(std::string(short_name.view()));
+  const std::vector<std::string> names = namesEndingInMatch();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vectorFindingRegex(regex, names));
+  }
+  perString(state, names.size());
+}
+
+void BM_VectorFindingStdRegex(benchmark::State &state) {
+  const std::regex regex(std::string(short_name.view()));
+  const std::vector<std::string> names = namesEndingInMatch();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find_if(names.begin(), names.end(), [&](const std::string &name) {
+      return std::regex_search(name, regex);
+    }));
+  }
+  perString(state, names.size());
+}
+
+void BM_VectorFindingRegex(benchmark::State &state) {
+  const strings::regex regex(short_name.view());
+  const std::vector<std::string> names = namesEndingInMatch();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find_if(names.begin(), names.end(), [&](const std::string &name) {
+      return regex.search(name);
+    }));
+  }
+  perString(state, names.size());
+}
+
+template <strings::pattern_string Pattern> void BM_LogGrepStdRegex(benchmark::State &state) {
+  const std::regex regex{std::string(Pattern.view())};
+  for (auto _ : state) {
+    std::istringstream in(logBuffer());
+    std::size_t count = 0;
+    for (std::string line; std::getline(in, line);) {
+      count += std::regex_search(line, regex);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  perString(state, line_count);
+}
+
+template <strings::pattern_string Pattern> void BM_LogGrepRegex(benchmark::State &state) {
+  const strings::regex regex(Pattern.view());
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    regex.forEachMatchingLine(logBuffer(), [&](std::string_view line) { bytes += line.size(); });
+    benchmark::DoNotOptimize(bytes);
+  }
+  perString(state, line_count);
+}
+
+void BM_LogExtractStdRegex(benchmark::State &state) {
+  const std::regex regex("id=[0-9]+");
+  const std::string &buffer = logBuffer();
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    for (std::sregex_iterator it(buffer.begin(), buffer.end(), regex), end; it != end; ++it) {
+      bytes += static_cast<std::size_t>(it->length());
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+  perString(state, line_count);
+}
+
+void BM_LogExtractRegex(benchmark::State &state) {
+  const strings::regex regex("id=[0-9]+");
+  for (auto _ : state) {
+    std::size_t bytes = 0;
+    regex.forEachMatch(logBuffer(), [&](std::string_view id) { bytes += id.size(); });
+    benchmark::DoNotOptimize(bytes);
+  }
+  perString(state, line_count);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_StdRegex, short_name, false, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Regex, short_name, false, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StaticRegex, short_name, false, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdRegex, ulg_hash, true, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Regex, ulg_hash, true, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StaticRegex, ulg_hash, true, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdRegex, event_file, false, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Regex, event_file, false, filenames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StaticRegex, event_file, false, filenames)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_VectorFindingAsWritten)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_VectorFindingStdRegex)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_VectorFindingRegex)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_StdRegex, error_timeout, false, logLines)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Regex, error_timeout, false, logLines)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StaticRegex, error_timeout, false, logLines)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdRegex, slow_request, false, logLines)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Regex, slow_request, false, logLines)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StaticRegex, slow_request, false, logLines)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_LogGrepStdRegex, slow_request)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LogGrepRegex, slow_request)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_LogExtractStdRegex)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LogExtractRegex)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
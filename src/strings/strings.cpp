@@ -0,0 +1,76 @@
+#include "strings/strings.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// spitingByDelimiter() from string.cpp: the same text, split without copies.
+// The loop there stops at the last delimiter and never stores "mushroom";
+// split() hands out every field.
+void splitByString() {
+  std::cout << "-------- spitingByDelimiter() --------" << std::endl;
+  const std::string s = "scott>=tiger>=mushroom";
+  for (std::string_view field : strings::split(s, ">=")) {
+    std::cout << field << std::endl;
+  }
+}
+
+// Empty fields are kept by split() and dropped by tokenize().
+void splitAndTokenize() {
+  std::cout << "-------- split and tokenize --------" << std::endl;
+  const std::string_view csv_line = "42,Behnam,,Munich,";
+  std::cout << "split(',') :";
+  for (std::string_view field : strings::split(csv_line, ',')) {
+    std::cout << " [" << field << "]";
+  }
+  std::cout << std::endl;
+
+  const strings::char_set whitespace(" \t\n");
+  const std::string_view sentence = "  the quick\tbrown\n\nfox  ";
+  std::cout << "tokenize(\" \\t\\n\") :";
+  for (std::string_view word : strings::tokenize(sentence, whitespace)) {
+    std::cout << " [" << word << "]";
+  }
+  std::cout << std::endl;
+
+  // The fields are a range like any other; they are copied into strings only
+  // here, where the caller asks for it.
+  auto fields = strings::split("b,c,a", ',');
+  std::vector<std::string> sorted(fields.begin(), fields.end());
+  std::sort(sorted.begin(), sorted.end());
+  std::cout << "sorted:";
+  for (const auto &field : sorted) {
+    std::cout << " " << field;
+  }
+  std::cout << std::endl;
+}
+
+// findStringCaseInsensitive() from string.cpp, and the position of the match.
+bool findStringCaseInsensitive(const std::string &sentence, const std::string &word) {
+  auto it = std::search(sentence.begin(), sentence.end(), word.begin(), word.end(),
+                        [](char ch1, char ch2) { return std::toupper(ch1) == std::toupper(ch2); });
+  return (it != sentence.end());
+}
+
+void caseInsensitiveSearch() {
+  std::cout << "-------- case-insensitive search --------" << std::endl;
+  const std::string sentence = "The Quick Brown Fox Jumps Over The Lazy Dog";
+  std::cout << std::boolalpha;
+  for (const std::string word : {"brown fox", "LAZY", "cat"}) {
+    const std::size_t pos = strings::findCaseInsensitive(sentence, word);
+    std::cout << "\"" << word << "\": std::search " << findStringCaseInsensitive(sentence, word)
+              << ", findCaseInsensitive "
+              << (pos == strings::npos ? std::string("npos") : std::to_string(pos)) << std::endl;
+  }
+  std::cout << "equalsCaseInsensitive(\"Hello\", \"hELLO\"): "
+            << strings::equalsCaseInsensitive("Hello", "hELLO") << std::endl;
+}
+
+int main() {
+  splitByString();
+  splitAndTokenize();
+  caseInsensitiveSearch();
+}
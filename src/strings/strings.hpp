@@ -0,0 +1,525 @@
+#ifndef STRINGS_HPP
+#define STRINGS_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+///
+/// Splitting and searching strings without copying them, the engine behind
+/// spitingByDelimiter() and findStringCaseInsensitive() in string.cpp.
+///
+/// - split(text, delimiter) is a lazy range of the fields between delimiters,
+///   as std::string_views into `text`: nothing is allocated, and a field is
+///   found only when the loop gets to it. The delimiter is a char, a string
+///   or a char_set (any of several chars). Like std::views::split, adjacent
+///   delimiters give empty fields and an empty text gives none.
+///   tokenize(text, delimiter) is the same range without the empty fields,
+///   as for words between runs of spaces.
+/// - find() and findFirstOf() look for a char, a string or any char of a
+///   char_set, a block of 16 (SSE2) or 32 (AVX2) bytes per step instead of
+///   one. A string is found by comparing its first and last byte with every
+///   position of a block at once; only positions where both match are
+///   compared in full.
+/// - findCaseInsensitive() does the same on ASCII letters folded to lower
+///   case in the registers, instead of std::toupper() on every pair of chars
+///   that std::search compares.
+///
+/// All positions are offsets into the text, and std::string_view::npos
+/// means not found, as for std::string_view::find.
+///
+
+namespace strings {
+
+inline constexpr std::size_t npos = std::string_view::npos;
+
+/// A set of chars to split at or search for. Sets of up to max_simd_size
+/// chars are compared with SIMD, larger ones through a bitmap.
+class char_set {
+public:
+  static constexpr std::size_t max_simd_size = 8;
+
+  constexpr char_set() noexcept = default;
+  constexpr explicit char_set(std::string_view chars) noexcept {
+    for (char c : chars) {
+      if (!contains(c)) {
+        const auto u = static_cast<unsigned char>(c);
+        m_bits[u / 64] |= std::uint64_t{1} << (u % 64);
+        if (m_size < max_simd_size) {
+          m_chars[m_size] = c;
+        }
+        ++m_size;
+      }
+    }
+  }
+
+  constexpr bool contains(char c) const noexcept {
+    const auto u = static_cast<unsigned char>(c);
+    return (m_bits[u / 64] >> (u % 64)) & 1;
+  }
+  constexpr std::size_t size() const noexcept { return m_size; }
+
+private:
+  friend std::size_t findFirstOf(std::string_view, const char_set &, std::size_t) noexcept;
+
+  std::array<std::uint64_t, 4> m_bits{};
+  std::array<char, max_simd_size> m_chars{};
+  std::size_t m_size = 0;
+};
+
+namespace detail {
+
+constexpr char foldCase(char c) noexcept {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+#if defined(__AVX2__)
+constexpr std::size_t block_size = 32;
+using block = __m256i;
+
+inline block load(const char *p) noexcept {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+inline block broadcast(char c) noexcept { return _mm256_set1_epi8(c); }
+inline block equal(block a, block b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+inline block either(block a, block b) noexcept { return _mm256_or_si256(a, b); }
+inline block both(block a, block b) noexcept { return _mm256_and_si256(a, b); }
+// Bit i set if byte i of a comparison result is set.
+inline std::uint32_t bits(block b) noexcept {
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(b));
+}
+// 'A'..'Z' minus 'A' is 0..25: test <= 25 unsigned as min(x, 25) == x.
+inline block foldCase(block b) noexcept {
+  const block offset = _mm256_sub_epi8(b, broadcast('A'));
+  const block upper = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, broadcast(25)), offset);
+  return _mm256_or_si256(b, _mm256_and_si256(upper, broadcast('a' - 'A')));
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+constexpr std::size_t block_size = 16;
+using block = __m128i;
+
+inline block load(const char *p) noexcept {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline block broadcast(char c) noexcept { return _mm_set1_epi8(c); }
+inline block equal(block a, block b) noexcept { return _mm_cmpeq_epi8(a, b); }
+inline block either(block a, block b) noexcept { return _mm_or_si128(a, b); }
+inline block both(block a, block b) noexcept { return _mm_and_si128(a, b); }
+inline std::uint32_t bits(block b) noexcept {
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(b));
+}
+inline block foldCase(block b) noexcept {
+  const block offset = _mm_sub_epi8(b, broadcast('A'));
+  const block upper = _mm_cmpeq_epi8(_mm_min_epu8(offset, broadcast(25)), offset);
+  return _mm_or_si128(b, _mm_and_si128(upper, broadcast('a' - 'A')));
+}
+#else
+constexpr std::size_t block_size = 16;
+using block = std::array<char, block_size>;
+
+inline block load(const char *p) noexcept {
+  block b;
+  std::memcpy(b.data(), p, block_size);
+  return b;
+}
+inline block broadcast(char c) noexcept {
+  block b;
+  b.fill(c);
+  return b;
+}
+template <typename Op> block byteWise(block a, block b, Op op) noexcept {
+  for (std::size_t i = 0; i < block_size; ++i) {
+    a[i] = op(a[i], b[i]);
+  }
+  return a;
+}
+inline block equal(block a, block b) noexcept {
+  return byteWise(a, b, [](char x, char y) { return static_cast<char>(x == y ? -1 : 0); });
+}
+inline block either(block a, block b) noexcept {
+  return byteWise(a, b, [](char x, char y) { return static_cast<char>(x | y); });
+}
+inline block both(block a, block b) noexcept {
+  return byteWise(a, b, [](char x, char y) { return static_cast<char>(x & y); });
+}
+inline std::uint32_t bits(block b) noexcept {
+  std::uint32_t mask = 0;
+  for (std::size_t i = 0; i < block_size; ++i) {
+    mask |= static_cast<std::uint32_t>(b[i] != 0) << i;
+  }
+  return mask;
+}
+inline block foldCase(block b) noexcept {
+  for (char &c : b) {
+    c = foldCase(c);
+  }
+  return b;
+}
+#endif
+
+// The first position in [from, size) where match(data + position) holds.
+// blockMask(p, relevant) has bit i set if match(p + i) holds, at least for
+// the lowest such i among the bits set in `relevant`. A text of at least one
+// block is scanned in whole blocks; the last one overlaps the one before it
+// instead of falling back to a char-by-char loop.
+template <typename BlockMask, typename Match>
+std::size_t scan(const char *data, std::size_t size, std::size_t from, BlockMask blockMask,
+                 Match match) noexcept {
+  std::size_t i = from;
+  for (; i + block_size <= size; i += block_size) {
+    if (const std::uint32_t mask = blockMask(data + i, ~std::uint32_t{0})) {
+      return i + static_cast<std::size_t>(std::countr_zero(mask));
+    }
+  }
+  if (i >= size) {
+    return npos;
+  }
+  if (size >= block_size) {
+    const std::size_t start = size - block_size;
+    if (const std::uint32_t mask = blockMask(data + start, ~std::uint32_t{0} << (i - start))) {
+      return start + static_cast<std::size_t>(std::countr_zero(mask));
+    }
+    return npos;
+  }
+  for (; i < size; ++i) {
+    if (match(data + i)) {
+      return i;
+    }
+  }
+  return npos;
+}
+
+inline bool equalFolded(const char *a, const char *b, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (foldCase(a[i]) != foldCase(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+/// The first `c` at or after `from`, like memchr.
+inline std::size_t find(std::string_view text, char c, std::size_t from = 0) noexcept {
+  const detail::block needle = detail::broadcast(c);
+  // Long stretches without `c` go four blocks per step, with one mask test.
+  const char *data = text.data();
+  for (; from + 4 * detail::block_size <= text.size(); from += 4 * detail::block_size) {
+    const char *p = data + from;
+    const detail::block any = detail::either(
+        detail::either(detail::equal(detail::load(p), needle),
+                       detail::equal(detail::load(p + detail::block_size), needle)),
+        detail::either(detail::equal(detail::load(p + 2 * detail::block_size), needle),
+                       detail::equal(detail::load(p + 3 * detail::block_size), needle)));
+    if (detail::bits(any) != 0) {
+      break;
+    }
+  }
+  return detail::scan(
+      text.data(), text.size(), from,
+      [needle](const char *p, std::uint32_t relevant) {
+        return detail::bits(detail::equal(detail::load(p), needle)) & relevant;
+      },
+      [c](const char *p) { return *p == c; });
+}
+
+/// The first occurrence of `needle` starting at or after `from`.
+inline std::size_t find(std::string_view text, std::string_view needle,
+                        std::size_t from = 0) noexcept {
+  const std::size_t m = needle.size();
+  if (m <= 1) {
+    return m == 1 ? find(text, needle[0], from) : (from <= text.size() ? from : npos);
+  }
+  if (text.size() < m || from > text.size() - m) {
+    return npos;
+  }
+  // Positions 0..size() - m can start a match; the block loaded at p + m - 1
+  // holds the last byte of each of them.
+  const char *inner = needle.data() + 1;
+  const detail::block first = detail::broadcast(needle.front());
+  const detail::block last = detail::broadcast(needle.back());
+  return detail::scan(
+      text.data(), text.size() - m + 1, from,
+      [&](const char *p, std::uint32_t relevant) {
+        std::uint32_t candidates =
+            detail::bits(detail::both(detail::equal(detail::load(p), first),
+                                      detail::equal(detail::load(p + m - 1), last))) &
+            relevant;
+        if (m == 2) {
+          return candidates;
+        }
+        for (; candidates != 0; candidates &= candidates - 1) {
+          const int i = std::countr_zero(candidates);
+          if (std::memcmp(p + i + 1, inner, m - 2) == 0) {
+            return std::uint32_t{1} << i;
+          }
+        }
+        return std::uint32_t{0};
+      },
+      [&](const char *p) {
+        return p[0] == needle.front() && std::memcmp(p + 1, inner, m - 1) == 0;
+      });
+}
+
+/// The first char at or after `from` that is in `set`.
+inline std::size_t findFirstOf(std::string_view text, const char_set &set,
+                               std::size_t from = 0) noexcept {
+  if (set.size() <= 1) {
+    return set.size() == 1 ? find(text, set.m_chars[0], from) : npos;
+  }
+  if (set.size() > char_set::max_simd_size) {
+    for (std::size_t i = from; i < text.size(); ++i) {
+      if (set.contains(text[i])) {
+        return i;
+      }
+    }
+    return npos;
+  }
+  detail::block needles[char_set::max_simd_size];
+  for (std::size_t k = 0; k < set.size(); ++k) {
+    needles[k] = detail::broadcast(set.m_chars[k]);
+  }
+  const std::size_t count = set.size();
+  return detail::scan(
+      text.data(), text.size(), from,
+      [&](const char *p, std::uint32_t relevant) {
+        const detail::block bytes = detail::load(p);
+        detail::block any = detail::equal(bytes, needles[0]);
+        for (std::size_t k = 1; k < count; ++k) {
+          any = detail::either(any, detail::equal(bytes, needles[k]));
+        }
+        return detail::bits(any) & relevant;
+      },
+      [&set](const char *p) { return set.contains(*p); });
+}
+
+/// Whether `a` and `b` are equal with ASCII letters compared case-insensitively.
+inline bool equalsCaseInsensitive(std::string_view a, std::string_view b) noexcept {
+  return a.size() == b.size() && detail::equalFolded(a.data(), b.data(), a.size());
+}
+
+/// find() with ASCII letters compared case-insensitively; other bytes,
+/// including those of UTF-8 sequences, must match exactly.
+inline std::size_t findCaseInsensitive(std::string_view text, std::string_view needle,
+                                       std::size_t from = 0) noexcept {
+  const std::size_t m = needle.size();
+  if (m == 0) {
+    return from <= text.size() ? from : npos;
+  }
+  if (text.size() < m || from > text.size() - m) {
+    return npos;
+  }
+  const char front = detail::foldCase(needle.front());
+  const char back = detail::foldCase(needle.back());
+  const detail::block first = detail::broadcast(front);
+  const detail::block last = detail::broadcast(back);
+  return detail::scan(
+      text.data(), text.size() - m + 1, from,
+      [&](const char *p, std::uint32_t relevant) {
+        std::uint32_t candidates =
+            detail::bits(detail::both(
+                detail::equal(detail::foldCase(detail::load(p)), first),
+                detail::equal(detail::foldCase(detail::load(p + m - 1)), last))) &
+            relevant;
+        for (; candidates != 0; candidates &= candidates - 1) {
+          const int i = std::countr_zero(candidates);
+          if (detail::equalFolded(p + i + 1, needle.data() + 1, m - 1)) {
+            return std::uint32_t{1} << i;
+          }
+        }
+        return std::uint32_t{0};
+      },
+      [&](const char *p) { return detail::equalFolded(p, needle.data(), m); });
+}
+
+inline bool containsCaseInsensitive(std::string_view text, std::string_view needle) noexcept {
+  return findCaseInsensitive(text, needle) != npos;
+}
+
+namespace detail {
+
+struct char_delimiter {
+  char c;
+
+  std::size_t find(std::string_view text, std::size_t from) const noexcept {
+    return strings::find(text, c, from);
+  }
+  bool startsAt(std::string_view text, std::size_t pos) const noexcept { return text[pos] == c; }
+  static constexpr std::size_t size() noexcept { return 1; }
+};
+
+struct string_delimiter {
+  std::string_view s;
+
+  std::size_t find(std::string_view text, std::size_t from) const noexcept {
+    return strings::find(text, s, from);
+  }
+  bool startsAt(std::string_view text, std::size_t pos) const noexcept {
+    return text.substr(pos).starts_with(s);
+  }
+  std::size_t size() const noexcept { return s.size(); }
+};
+
+struct any_of_delimiter {
+  char_set set;
+
+  std::size_t find(std::string_view text, std::size_t from) const noexcept {
+    return findFirstOf(text, set, from);
+  }
+  bool startsAt(std::string_view text, std::size_t pos) const noexcept {
+    return set.contains(text[pos]);
+  }
+  static constexpr std::size_t size() noexcept { return 1; }
+};
+
+} // namespace detail
+
+/// The fields of `text` between delimiters, found one at a time. Iterators
+/// hold their own copy of the text and the delimiter, so they stay valid
+/// after the view is gone; the string_views they return point into the
+/// text. end() is a default-constructed iterator, so the view also works
+/// with the iterator-pair algorithms and constructors.
+template <typename Delimiter, bool SkipEmpty>
+class split_view : public std::ranges::view_interface<split_view<Delimiter, SkipEmpty>> {
+public:
+  class iterator {
+  public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+
+    std::string_view operator*() const noexcept { return m_field; }
+    const std::string_view *operator->() const noexcept { return &m_field; }
+
+    iterator &operator++() noexcept {
+      advance();
+      return *this;
+    }
+    iterator operator++(int) noexcept {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const iterator &a, const iterator &b) noexcept {
+      return a.m_done == b.m_done && (a.m_done || a.m_field.data() == b.m_field.data());
+    }
+
+  private:
+    friend class split_view;
+
+    iterator(std::string_view text, const Delimiter &delimiter) noexcept
+        : m_text(text), m_delimiter(delimiter), m_done(text.empty()) {
+      if (!m_done) {
+        ++*this;
+      }
+    }
+
+    void advance() noexcept {
+      if constexpr (SkipEmpty) {
+        // A run of delimiters is stepped over here rather than searched
+        // for once per empty field.
+        while (m_next < m_text.size() && m_delimiter.startsAt(m_text, m_next)) {
+          m_next += m_delimiter.size();
+        }
+        if (m_next >= m_text.size()) {
+          m_done = true;
+          return;
+        }
+      }
+      if (m_next == npos) {
+        m_done = true;
+        return;
+      }
+      const std::size_t pos = m_delimiter.find(m_text, m_next);
+      if (pos == npos) {
+        m_field = m_text.substr(m_next);
+        m_next = npos;
+      } else {
+        m_field = m_text.substr(m_next, pos - m_next);
+        m_next = pos + m_delimiter.size();
+      }
+    }
+
+    std::string_view m_text;
+    Delimiter m_delimiter{};
+    std::string_view m_field;
+    // Start of the field after m_field, npos if m_field is the last one.
+    std::size_t m_next = 0;
+    bool m_done = true;
+  };
+
+  split_view(std::string_view text, Delimiter delimiter) noexcept
+      : m_text(text), m_delimiter(delimiter) {}
+
+  iterator begin() const noexcept { return iterator(m_text, m_delimiter); }
+  iterator end() const noexcept { return iterator(); }
+
+private:
+  std::string_view m_text;
+  Delimiter m_delimiter;
+};
+
+namespace detail {
+
+inline string_delimiter checkedDelimiter(std::string_view delimiter, const char *who) {
+  if (delimiter.empty()) {
+    throw std::invalid_argument(std::string(who) + ": empty delimiter");
+  }
+  return {delimiter};
+}
+
+} // namespace detail
+
+inline split_view<detail::char_delimiter, false> split(std::string_view text,
+                                                       char delimiter) noexcept {
+  return {text, {delimiter}};
+}
+/// Throws std::invalid_argument if `delimiter` is empty.
+inline split_view<detail::string_delimiter, false> split(std::string_view text,
+                                                         std::string_view delimiter) {
+  return {text, detail::checkedDelimiter(delimiter, "strings::split")};
+}
+inline split_view<detail::any_of_delimiter, false> split(std::string_view text,
+                                                         const char_set &delimiters) noexcept {
+  return {text, {delimiters}};
+}
+
+inline split_view<detail::char_delimiter, true> tokenize(std::string_view text,
+                                                         char delimiter) noexcept {
+  return {text, {delimiter}};
+}
+/// Throws std::invalid_argument if `delimiter` is empty.
+inline split_view<detail::string_delimiter, true> tokenize(std::string_view text,
+                                                           std::string_view delimiter) {
+  return {text, detail::checkedDelimiter(delimiter, "strings::tokenize")};
+}
+inline split_view<detail::any_of_delimiter, true> tokenize(std::string_view text,
+                                                           const char_set &delimiters) noexcept {
+  return {text, {delimiters}};
+}
+
+} // namespace strings
+
+template <typename Delimiter, bool SkipEmpty>
+inline constexpr bool
+    std::ranges::enable_borrowed_range<strings::split_view<Delimiter, SkipEmpty>> = true;
+
+#endif
@@ -0,0 +1,293 @@
+// The string functions of string.cpp against strings.hpp on generated text of
+// 64 KiB to 16 MiB (words of 1-10 mixed-case letters):
+// - Split: the fields between ">=" delimiters. spitingByDelimiter()'s loop
+//   (find, substr, erase the front), the same with find from an offset,
+//   std::views::split and strings::split
+// - SplitChar/Tokenize: CSV fields between ',' (std::getline, views::split,
+//   strings::split) and words between runs of whitespace (operator>>,
+//   strings::tokenize)
+// - FindChar: counting the lines of the text, one search per '\n'
+// - FindCaseInsensitive: a word that is not in the text, with
+//   findStringCaseInsensitive()'s std::search and std::toupper, with
+//   std::boyer_moore_horspool_searcher on folded chars, and with
+//   strings::findCaseInsensitive; and case-sensitive for comparison
+#include "strings/strings.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Words of 1-10 letters separated by `separator`, with a newline about every
+// 80 chars.
+std::string makeText(std::size_t size, std::string_view separator) {
+  std::mt19937 gen(42);
+  std::string text;
+  text.reserve(size + 16);
+  std::size_t line = 0;
+  while (text.size() < size) {
+    const std::size_t length = 1 + gen() % 10;
+    for (std::size_t i = 0; i < length; ++i) {
+      const char letter = static_cast<char>('a' + gen() % 26);
+      text += gen() % 4 == 0 ? static_cast<char>(std::toupper(letter)) : letter;
+    }
+    line += length;
+    if (line > 80) {
+      text += '\n';
+      line = 0;
+    } else {
+      text += separator;
+    }
+  }
+  return text;
+}
+
+// spitingByDelimiter() from string.cpp, on a copy of `text`.
+std::vector<std::string> splitErasingFront(std::string s, const std::string &delimiter) {
+  std::vector<std::string> spilitedString;
+  size_t pos = 0;
+  std::string token;
+  while ((pos = s.find(delimiter)) != std::string::npos) {
+    token = s.substr(0, pos);
+    spilitedString.push_back(token);
+    s.erase(0, pos + delimiter.length());
+  }
+  return spilitedString;
+}
+
+std::vector<std::string> splitWithOffsets(const std::string &s, const std::string &delimiter) {
+  std::vector<std::string> fields;
+  std::size_t start = 0;
+  for (std::size_t pos; (pos = s.find(delimiter, start)) != std::string::npos;
+       start = pos + delimiter.size()) {
+    fields.push_back(s.substr(start, pos - start));
+  }
+  fields.push_back(s.substr(start));
+  return fields;
+}
+
+void BM_SplitErasingFront(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ">=");
+  for (auto _ : state) {
+    auto fields = splitErasingFront(text, ">=");
+    benchmark::DoNotOptimize(fields.data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_SplitWithOffsets(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ">=");
+  for (auto _ : state) {
+    auto fields = splitWithOffsets(text, ">=");
+    benchmark::DoNotOptimize(fields.data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+// The views only find the fields; summing their sizes makes sure every one
+// is visited.
+template <typename Range> std::size_t totalSize(Range &&fields) {
+  std::size_t total = 0;
+  for (auto &&field : fields) {
+    total += std::ranges::distance(field);
+  }
+  return total;
+}
+
+void BM_SplitStdViews(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ">=");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        totalSize(std::views::split(std::string_view(text), std::string_view(">="))));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_Split(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ">=");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(totalSize(strings::split(text, ">=")));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_SplitCharGetline(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ",");
+  for (auto _ : state) {
+    std::istringstream in(text);
+    std::size_t total = 0;
+    for (std::string field; std::getline(in, field, ',');) {
+      total += field.size();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_SplitCharStdViews(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ",");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(totalSize(std::views::split(std::string_view(text), ',')));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_SplitChar(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), ",");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(totalSize(strings::split(text, ',')));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_TokenizeStream(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " \t ");
+  for (auto _ : state) {
+    std::istringstream in(text);
+    std::size_t total = 0;
+    for (std::string word; in >> word;) {
+      total += word.size();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_Tokenize(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " \t ");
+  const strings::char_set whitespace(" \t\n");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(totalSize(strings::tokenize(text, whitespace)));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+template <typename Find> void countLines(benchmark::State &state, Find find) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " ");
+  for (auto _ : state) {
+    std::size_t lines = 0;
+    for (std::size_t pos = find(text, 0); pos != strings::npos; pos = find(text, pos + 1)) {
+      ++lines;
+    }
+    benchmark::DoNotOptimize(lines);
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_FindCharLoop(benchmark::State &state) {
+  countLines(state, [](std::string_view text, std::size_t from) -> std::size_t {
+    const auto it = std::find(text.begin() + static_cast<std::ptrdiff_t>(from), text.end(), '\n');
+    return it == text.end() ? strings::npos : static_cast<std::size_t>(it - text.begin());
+  });
+}
+
+void BM_FindCharMemchr(benchmark::State &state) {
+  countLines(state, [](std::string_view text, std::size_t from) -> std::size_t {
+    const void *p = std::memchr(text.data() + from, '\n', text.size() - from);
+    return p == nullptr ? strings::npos
+                        : static_cast<std::size_t>(static_cast<const char *>(p) - text.data());
+  });
+}
+
+void BM_FindChar(benchmark::State &state) {
+  countLines(state, [](std::string_view text, std::size_t from) {
+    return strings::find(text, '\n', from);
+  });
+}
+
+// A needle that occurs nowhere in the text: every search reads all of it.
+const std::string needle = "Quick>Brown";
+
+// findStringCaseInsensitive() from string.cpp.
+bool findStringCaseInsensitive(const std::string &sentence, const std::string &word) {
+  auto it = std::search(sentence.begin(), sentence.end(), word.begin(), word.end(),
+                        [](char ch1, char ch2) { return std::toupper(ch1) == std::toupper(ch2); });
+  return (it != sentence.end());
+}
+
+void BM_FindCaseInsensitiveStdSearch(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " ");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(findStringCaseInsensitive(text, needle));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_FindCaseInsensitiveHorspool(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " ");
+  const auto hash = [](char c) { return std::hash<char>()(strings::detail::foldCase(c)); };
+  const auto equal = [](char a, char b) {
+    return strings::detail::foldCase(a) == strings::detail::foldCase(b);
+  };
+  const std::boyer_moore_horspool_searcher searcher(needle.begin(), needle.end(), hash, equal);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::search(text.begin(), text.end(), searcher) != text.end());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_FindCaseInsensitive(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " ");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(strings::containsCaseInsensitive(text, needle));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_FindStringStd(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " ");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::string_view(text).find(needle));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void BM_FindString(benchmark::State &state) {
+  const std::string text = makeText(static_cast<std::size_t>(state.range(0)), " ");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(strings::find(text, needle));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void sizes(benchmark::internal::Benchmark *b) {
+  b->Arg(64 << 10)->Arg(1 << 20)->Arg(16 << 20)->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+// Erasing the front of the string after every field is quadratic: 16 MiB
+// would take minutes.
+BENCHMARK(BM_SplitErasingFront)->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SplitWithOffsets)->Apply(sizes);
+BENCHMARK(BM_SplitStdViews)->Apply(sizes);
+BENCHMARK(BM_Split)->Apply(sizes);
+
+BENCHMARK(BM_SplitCharGetline)->Apply(sizes);
+BENCHMARK(BM_SplitCharStdViews)->Apply(sizes);
+BENCHMARK(BM_SplitChar)->Apply(sizes);
+BENCHMARK(BM_TokenizeStream)->Apply(sizes);
+BENCHMARK(BM_Tokenize)->Apply(sizes);
+
+BENCHMARK(BM_FindCharLoop)->Apply(sizes);
+BENCHMARK(BM_FindCharMemchr)->Apply(sizes);
+BENCHMARK(BM_FindChar)->Apply(sizes);
+
+BENCHMARK(BM_FindCaseInsensitiveStdSearch)->Apply(sizes);
+BENCHMARK(BM_FindCaseInsensitiveHorspool)->Apply(sizes);
+BENCHMARK(BM_FindCaseInsensitive)->Apply(sizes);
+BENCHMARK(BM_FindStringStd)->Apply(sizes);
+BENCHMARK(BM_FindString)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -1,23 +1,19 @@
+#include "alloc_profiler/alloc_profiler.hpp"
+
 #include <iostream>
+#include <map>
 #include <memory>
-
-#include <stdio.h>
 #include <string>
+#include <thread>
+#include <vector>
 
-void *operator new(size_t size) {
-  std::cout << "Allocating " << size << " bytes" << std::endl;
-  return malloc(size);
-}
-
-void operator delete(void *memory, size_t size) {
-  std::cout << "Freeing " << size << " bytes" << std::endl;
-  free(memory);
-}
-
-void operator delete(void *memory) {
-  std::cout << "Freeing " << std::endl;
-  free(memory);
-}
+/*
+The global operator new/delete are replaced by the alloc_profiler library
+(src/alloc_profiler/alloc_profiler.cpp). Printing every call, as a first
+attempt would, costs a system call per allocation and says nothing about where
+the allocation came from. The profiler only bumps per-thread counters and
+samples the call stack now and then; the numbers are read when needed.
+*/
 
 struct S {
   double a;
@@ -25,35 +21,73 @@ struct S {
   float c;
 };
 
+// Prints what happened between two snapshots.
+void printDelta(const char *what, const alloc_profiler::snapshot &before,
+                const alloc_profiler::snapshot &after) {
+  std::cout << what << ": " << after.allocations - before.allocations
+            << " allocations, " << after.deallocations - before.deallocations
+            << " deallocations, "
+            << after.bytes_allocated - before.bytes_allocated << " bytes"
+            << std::endl;
+}
+
+std::map<int, std::string> buildIndex(int n) {
+  std::map<int, std::string> index;
+  for (int i = 0; i < n; ++i) {
+    index[i] = "a string long enough to need the heap " + std::to_string(i);
+  }
+  return index;
+}
+
 int main() {
+  alloc_profiler::setSampleInterval(64 * 1024);
+  alloc_profiler::reportAtExit();
 
   {
-    std::cout << "allocating and freeing memory for struct S" << std::endl;
     std::cout << "size of struct S is: " << sizeof(S) << " bytes" << std::endl;
+    auto before = alloc_profiler::takeSnapshot();
     S *my_S = new S;
+    // printing the pointer keeps the compiler from eliding the new/delete pair
+    std::cout << "allocated at " << my_S << std::endl;
     delete my_S;
+    printDelta("new/delete S", before, alloc_profiler::takeSnapshot());
   }
 
-  std::cout << "************************************************" << std::endl;
-
   {
-    std::cout
-        << "allocating and freeing memory for struct S with unique pointers: "
-        << std::endl;
+    auto before = alloc_profiler::takeSnapshot();
     std::unique_ptr<S> my_S = std::unique_ptr<S>(new S);
     std::unique_ptr<S> bject_ptr = std::make_unique<S>();
+    std::cout << "allocated at " << my_S.get() << " and " << bject_ptr.get()
+              << std::endl;
+    bject_ptr.reset();
+    my_S.reset();
+    printDelta("unique pointers", before, alloc_profiler::takeSnapshot());
   }
 
-  std::cout << "************************************************" << std::endl;
-
   {
+    // Strings of up to 15 characters live inside the std::string object
+    // itself (Small String Optimization); only longer ones allocate.
+    auto before = alloc_profiler::takeSnapshot();
     std::string str;
-    std::cout << "allocating and freeing memory for strings" << std::endl;
     for (std::size_t i = 0; i < 25; i++) {
       str = str + std::to_string(i);
-      std::cout << "size of string is: " << str.size()
-                << " bytes and string is: " << str << std::endl;
     }
+    printDelta("growing a string", before, alloc_profiler::takeSnapshot());
+  }
+
+  {
+    // Allocation from several threads; buildIndex() should show up as the
+    // top call site in the report printed at exit.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([] { buildIndex(20000); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto s = alloc_profiler::takeSnapshot();
+    std::cout << "live bytes: " << s.live_bytes
+              << ", peak live bytes: " << s.peak_live_bytes << std::endl;
   }
   return 0;
 }
@@ -151,6 +151,8 @@ void vectorExample() {
 very important tip, since here pushing during the loop, the destination vector
 might need to resize couple of times, so we resize it once in the begining
 */
+// For a handful of elements even the first allocation can be avoided:
+// containers/small_vector.cpp
 void vectorPushBack() {
   int size = 10;
   int value = 0;
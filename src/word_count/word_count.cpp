@@ -0,0 +1,91 @@
+#include "word_count/word_count.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+// Usage: word_count [file] [top_k] [threads]
+//
+// Counts the words of `file` three ways and prints the throughput of each and
+// the top_k words:
+// - the stringstream loop of wordFrequencyInString() in set_map_pair_tuple.cpp
+//   (`ss >> word` into std::unordered_map<std::string, int>)
+// - word_count::countWords() on one thread
+// - word_count::countWordsParallel() on a thread pool
+// Without a file, a 256 MiB text with Zipf-distributed words is generated in
+// the temp directory.
+
+namespace {
+
+template <typename F> double seconds(F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char *name, std::size_t bytes, double s) {
+  std::printf("%-28s %8.3f s %8.3f GB/s\n", name, s, static_cast<double>(bytes) / s / 1e9);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string path;
+  if (argc > 1) {
+    path = argv[1];
+  } else {
+    path = (std::filesystem::temp_directory_path() / "word_count_sample.txt").string();
+    if (!std::filesystem::exists(path)) {
+      std::cout << "generating " << path << std::endl;
+      std::ofstream(path, std::ios::binary) << word_count::generateText(std::size_t{256} << 20);
+    }
+  }
+  const std::size_t top_k = argc > 2 ? std::stoul(argv[2]) : 10;
+  const std::size_t threads =
+      argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+
+  const word_count::mapped_file file(path);
+  const std::string_view text = file.text();
+  std::cout << path << ": " << text.size() << " bytes, " << threads << " threads" << std::endl;
+
+  std::unordered_map<std::string, int> baseline;
+  report("stringstream + unordered_map", text.size(), seconds([&] {
+           std::stringstream ss{std::string(text)};
+           std::string word;
+           while (ss >> word) {
+             baseline[word]++;
+           }
+         }));
+
+  word_count::word_counts single;
+  report("countWords", text.size(), seconds([&] { single = word_count::countWords(text); }));
+
+  thread_pool pool(threads);
+  word_count::word_counts parallel;
+  report("countWordsParallel", text.size(),
+         seconds([&] { parallel = word_count::countWordsParallel(text, pool); }));
+
+  bool same = baseline.size() == single.size() && single.size() == parallel.size();
+  for (const auto &[word, count] : baseline) {
+    const auto it = parallel.find(std::string_view(word));
+    same = same && it != parallel.end() && it->second == static_cast<std::uint64_t>(count) &&
+           single.at(word) == it->second;
+  }
+  std::cout << baseline.size() << " distinct words, counts "
+            << (same ? "match" : "DIFFER") << std::endl;
+
+  std::cout << "top " << top_k << ":" << std::endl;
+  for (const auto &[word, count] : word_count::topWords(parallel, top_k)) {
+    std::cout << "  " << word << " " << count << std::endl;
+  }
+  return same ? 0 : 1;
+}
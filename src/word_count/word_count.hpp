@@ -0,0 +1,305 @@
+#ifndef WORD_COUNT_HPP
+#define WORD_COUNT_HPP
+
+#include "containers/flat_hash_map.hpp"
+#include "hashing.hpp"
+#include "multithreading/thread_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+///
+/// Word counting over large texts, the engine behind wordFrequencyInString()
+/// in set_map_pair_tuple.cpp.
+///
+/// - forEachWord() splits on the same whitespace as `stream >> word` (space,
+///   \t, \n, \v, \f, \r) and hands out std::string_views into the text: no
+///   copy and no allocation per word. The whitespace test runs on 32 bytes
+///   (AVX2) or 16 bytes (SSE2) at a time and turns them into a bitmask; word
+///   boundaries are then found with count-trailing-zeros.
+/// - countWords() counts into a containers::flat_hash_map keyed by those
+///   views. The map refers into the text, which must outlive it.
+/// - countWordsParallel() cuts the text at whitespace into one chunk per
+///   thread-pool worker, counts each chunk into its own map and merges the
+///   maps at the end. The hot loop shares nothing between threads.
+/// - mapped_file maps a file read-only (mmap on POSIX), so a multi-GB file is
+///   paged in by the kernel as the workers stream through it instead of being
+///   copied into a buffer first.
+///
+
+namespace word_count {
+
+using word_counts =
+    containers::flat_hash_map<std::string_view, std::uint64_t, hashing::hash<>,
+                              std::equal_to<>>;
+
+namespace detail {
+
+inline bool isSpace(char c) noexcept {
+  const auto u = static_cast<unsigned char>(c);
+  return u == ' ' || static_cast<unsigned char>(u - '\t') <= '\r' - '\t';
+}
+
+#if defined(__AVX2__)
+constexpr std::size_t block_size = 32;
+
+// Bit i set if p[i] is whitespace.
+inline std::uint64_t spaceMask(const char *p) noexcept {
+  const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  const __m256i space = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+  // \t..\r are 9..13: subtract 9 and test <= 4 unsigned, as min(x, 4) == x.
+  const __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+  const __m256i control =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, control)));
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+constexpr std::size_t block_size = 16;
+
+inline std::uint64_t spaceMask(const char *p) noexcept {
+  const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  const __m128i space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+  const __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+  const __m128i control =
+      _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(space, control)));
+}
+#else
+constexpr std::size_t block_size = 16;
+
+inline std::uint64_t spaceMask(const char *p) noexcept {
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < block_size; ++i) {
+    mask |= static_cast<std::uint64_t>(isSpace(p[i])) << i;
+  }
+  return mask;
+}
+#endif
+
+constexpr std::uint64_t block_bits = (std::uint64_t{1} << block_size) - 1;
+
+} // namespace detail
+
+/// Calls f(word) for every whitespace-separated word of `text`, in order.
+template <typename F> void forEachWord(std::string_view text, F &&f) {
+  const char *data = text.data();
+  const std::size_t size = text.size();
+  std::size_t start = 0;
+  bool in_word = false;
+
+  std::size_t i = 0;
+  for (; i + detail::block_size <= size; i += detail::block_size) {
+    const std::uint64_t spaces = detail::spaceMask(data + i);
+    const std::uint64_t letters = ~spaces & detail::block_bits;
+    // Alternate between looking for the end of the current word (the next
+    // space bit) and the start of the next one (the next letter bit).
+    std::size_t pos = 0;
+    for (;;) {
+      const std::uint64_t next = (in_word ? spaces : letters) >> pos;
+      if (next == 0) {
+        break;
+      }
+      pos += static_cast<std::size_t>(std::countr_zero(next));
+      if (in_word) {
+        f(std::string_view(data + start, i + pos - start));
+      } else {
+        start = i + pos;
+      }
+      in_word = !in_word;
+    }
+  }
+  for (; i < size; ++i) {
+    if (detail::isSpace(data[i]) == in_word) {
+      if (in_word) {
+        f(std::string_view(data + start, i - start));
+      } else {
+        start = i;
+      }
+      in_word = !in_word;
+    }
+  }
+  if (in_word) {
+    f(std::string_view(data + start, size - start));
+  }
+}
+
+inline word_counts countWords(std::string_view text) {
+  word_counts counts;
+  forEachWord(text, [&](std::string_view word) { ++counts[word]; });
+  return counts;
+}
+
+/// Cuts `text` into about `parts` pieces of equal size, each ending at
+/// whitespace so that no word is split.
+inline std::vector<std::string_view> splitAtSpaces(std::string_view text, std::size_t parts) {
+  std::vector<std::string_view> chunks;
+  std::size_t begin = 0;
+  for (std::size_t p = 1; p <= parts && begin < text.size(); ++p) {
+    std::size_t end = p == parts ? text.size() : std::max(begin, text.size() / parts * p);
+    while (end < text.size() && !detail::isSpace(text[end])) {
+      ++end;
+    }
+    chunks.push_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+
+/// Counts on every worker of `pool`, one chunk per worker, and merges the
+/// per-chunk maps into the largest one.
+inline word_counts countWordsParallel(std::string_view text, thread_pool &pool) {
+  std::vector<std::future<word_counts>> pending;
+  for (std::string_view chunk : splitAtSpaces(text, pool.size())) {
+    pending.push_back(pool.submit([chunk] { return countWords(chunk); }));
+  }
+  std::vector<word_counts> partial;
+  for (auto &f : pending) {
+    partial.push_back(f.get());
+  }
+  if (partial.empty()) {
+    return {};
+  }
+  auto largest = std::max_element(partial.begin(), partial.end(),
+                                  [](const auto &a, const auto &b) { return a.size() < b.size(); });
+  word_counts result = std::move(*largest);
+  for (auto it = partial.begin(); it != partial.end(); ++it) {
+    if (it != largest) {
+      for (const auto &[word, count] : *it) {
+        result[word] += count;
+      }
+    }
+  }
+  return result;
+}
+
+/// The k most frequent words, most frequent first; ties in word order.
+inline std::vector<std::pair<std::string_view, std::uint64_t>> topWords(const word_counts &counts,
+                                                                        std::size_t k) {
+  std::vector<std::pair<std::string_view, std::uint64_t>> words(counts.begin(), counts.end());
+  k = std::min(k, words.size());
+  std::partial_sort(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(k), words.end(),
+                    [](const auto &a, const auto &b) {
+                      return a.second != b.second ? a.second > b.second : a.first < b.first;
+                    });
+  words.resize(k);
+  return words;
+}
+
+/// About `bytes` of text (a word more at most) for the demo and the
+/// benchmark: words drawn from a 50000-word vocabulary with frequency ~ 1/rank,
+/// like natural-language text, separated by spaces and the odd newline.
+inline std::string generateText(std::size_t bytes, std::uint64_t seed = 42) {
+  std::mt19937_64 gen(seed);
+  std::vector<std::string> vocabulary(50000);
+  std::vector<double> weights(vocabulary.size());
+  for (std::size_t i = 0; i < vocabulary.size(); ++i) {
+    const std::size_t length = 2 + gen() % 10;
+    for (std::size_t c = 0; c < length; ++c) {
+      vocabulary[i].push_back(static_cast<char>('a' + gen() % 26));
+    }
+    weights[i] = 1.0 / static_cast<double>(i + 1);
+  }
+  std::discrete_distribution<std::size_t> zipf(weights.begin(), weights.end());
+  std::string text;
+  text.reserve(bytes + 16);
+  while (text.size() < bytes) {
+    text += vocabulary[zipf(gen)];
+    text.push_back(gen() % 16 == 0 ? '\n' : ' ');
+  }
+  return text;
+}
+
+/// A read-only view of a whole file. On POSIX the file is mapped, not read:
+/// pages are loaded on first touch and can be dropped again under memory
+/// pressure, so files larger than RAM work.
+class mapped_file {
+public:
+  explicit mapped_file(const std::string &path) {
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      throw std::runtime_error("word_count::mapped_file: cannot open " + path);
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("word_count::mapped_file: cannot open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("word_count::mapped_file: cannot stat " + path);
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size > 0) {
+      m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // the mapping keeps the file open
+    if (m_data == MAP_FAILED) {
+      m_data = nullptr;
+      throw std::runtime_error("word_count::mapped_file: cannot map " + path);
+    }
+    if (m_data != nullptr) {
+      // Read ahead aggressively and drop pages behind the readers.
+      ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+#endif
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  ~mapped_file() {
+#if !defined(_WIN32)
+    if (m_data != nullptr) {
+      ::munmap(m_data, m_size);
+    }
+#endif
+  }
+
+  std::string_view text() const noexcept {
+#if defined(_WIN32)
+    return m_buffer;
+#else
+    return {static_cast<const char *>(m_data), m_size};
+#endif
+  }
+
+private:
+#if defined(_WIN32)
+  std::string m_buffer;
+#else
+  void *m_data = nullptr;
+  std::size_t m_size = 0;
+#endif
+};
+
+} // namespace word_count
+
+#endif
@@ -0,0 +1,77 @@
+// Word counting on a 32 MiB in-memory text with Zipf-distributed words from a
+// 50000-word vocabulary, in bytes/s:
+// - the stringstream loop of wordFrequencyInString() in set_map_pair_tuple.cpp:
+//   `ss >> word` into std::unordered_map<std::string, int>
+// - word_count::forEachWord() alone, to show what the tokenizer costs
+// - word_count::countWords(), string_views into a flat_hash_map
+// - word_count::countWordsParallel() with 1, 2, 4 and 8 pool threads
+#include "word_count/word_count.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+const std::string &sampleText() {
+  static const std::string text = word_count::generateText(std::size_t{32} << 20);
+  return text;
+}
+
+void BM_StringStream(benchmark::State &state) {
+  const std::string &text = sampleText();
+  for (auto _ : state) {
+    std::unordered_map<std::string, int> counts;
+    std::stringstream ss(text);
+    std::string word;
+    while (ss >> word) {
+      counts[word]++;
+    }
+    benchmark::DoNotOptimize(counts.size());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void BM_ForEachWord(benchmark::State &state) {
+  const std::string &text = sampleText();
+  for (auto _ : state) {
+    std::size_t letters = 0;
+    word_count::forEachWord(text, [&](std::string_view word) { letters += word.size(); });
+    benchmark::DoNotOptimize(letters);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void BM_CountWords(benchmark::State &state) {
+  const std::string &text = sampleText();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(word_count::countWords(text).size());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void BM_CountWordsParallel(benchmark::State &state) {
+  const std::string &text = sampleText();
+  thread_pool pool(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(word_count::countWordsParallel(text, pool).size());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_StringStream)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ForEachWord)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountWords)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountWordsParallel)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();